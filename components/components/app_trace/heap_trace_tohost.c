@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -82,6 +82,56 @@ void heap_trace_dump_caps(__attribute__((unused)) const uint32_t caps)
     return;
 }
 
+esp_err_t heap_trace_sampling_init(heap_trace_site_t *site_buffer, size_t num_sites)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t heap_trace_sampling_start(size_t sample_interval)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t heap_trace_sampling_stop(void)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t heap_trace_sampling_get(size_t index, heap_trace_site_t *site)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t heap_trace_sampling_summary(heap_trace_sampling_summary_t *summary)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t heap_trace_sampling_dump(heap_trace_profile_format_t format)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static HEAP_IRAM_ATTR bool recording_allocations(void)
+{
+    return s_tracing;
+}
+
+static HEAP_IRAM_ATTR bool recording_frees(void)
+{
+    return s_tracing;
+}
+
+/* The sampling profiler is only supported by standalone heap tracing */
+static HEAP_IRAM_ATTR size_t sample_allocation(const void *p, size_t size)
+{
+    return 0;
+}
+
+static HEAP_IRAM_ATTR void record_sample(size_t size, size_t samples, void **callers)
+{
+}
+
 /* Add a new allocation to the heap trace records */
 static HEAP_IRAM_ATTR void record_allocation(const heap_trace_record_t *record)
 {
@@ -0,0 +1,68 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Masks or unmasks the payload of a WebSocket frame (RFC6455 Section 5.3)
+ *
+ * Shared by the WebSocket server (esp_http_server) and client (tcp_transport).
+ * Whole words are used once dst is aligned, if src is then aligned as well.
+ * dst and src may be the same buffer.
+ *
+ * @param dst       Masked data
+ * @param src       Data to mask
+ * @param len       Length of the data
+ * @param mask_key  Mask key
+ * @param offset    Position of the data in the payload, as the key repeats every 4 bytes
+ */
+static inline void websocket_mask(uint8_t *dst, const uint8_t *src, size_t len, const uint8_t *mask_key, size_t offset)
+{
+    size_t i = 0;
+
+    // Bytes up to the first aligned word of dst
+    for (; i < len && ((uintptr_t)(dst + i) % sizeof(size_t)) != 0; i++) {
+        dst[i] = src[i] ^ mask_key[(offset + i) % 4];
+    }
+
+    // Whole words, with the mask key repeated and rotated to start at offset + i.
+    // The words are accessed with memcpy() to keep within the aliasing rules, which
+    // compiles to single loads and stores as both pointers are aligned here.
+    if (len - i >= sizeof(size_t) && ((uintptr_t)(src + i) % sizeof(size_t)) == 0) {
+        uint8_t key_bytes[sizeof(size_t)];
+        size_t key, word;
+        for (size_t k = 0; k < sizeof(size_t); k++) {
+            key_bytes[k] = mask_key[(offset + i + k) % 4];
+        }
+        memcpy(&key, key_bytes, sizeof(key));
+        uint8_t *dst_words = (uint8_t *)__builtin_assume_aligned(dst + i, sizeof(size_t));
+        const uint8_t *src_words = (const uint8_t *)__builtin_assume_aligned(src + i, sizeof(size_t));
+        size_t words = (len - i) / sizeof(size_t);
+        for (size_t w = 0; w < words; w++) {
+            memcpy(&word, src_words + w * sizeof(size_t), sizeof(word));
+            word ^= key;
+            memcpy(dst_words + w * sizeof(size_t), &word, sizeof(word));
+        }
+        i += words * sizeof(size_t);
+    }
+
+    // Remaining bytes
+    for (; i < len; i++) {
+        dst[i] = src[i] ^ mask_key[(offset + i) % 4];
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -76,6 +76,35 @@ esp_err_t esp_event_post(esp_event_base_t event_base, int32_t event_id,
                              event_data, event_data_size, ticks_to_wait);
 }
 
+esp_err_t esp_event_payload_acquire(size_t size, void** payload)
+{
+    if (s_default_loop == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return esp_event_payload_acquire_with(s_default_loop, size, payload);
+}
+
+esp_err_t esp_event_payload_release(void* payload)
+{
+    if (s_default_loop == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return esp_event_payload_release_with(s_default_loop, payload);
+}
+
+esp_err_t esp_event_post_payload(esp_event_base_t event_base, int32_t event_id,
+                                 void* payload, TickType_t ticks_to_wait)
+{
+    if (s_default_loop == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return esp_event_post_payload_to(s_default_loop, event_base, event_id,
+                                     payload, ticks_to_wait);
+}
+
 #if CONFIG_ESP_EVENT_POST_FROM_ISR
 esp_err_t esp_event_isr_post(esp_event_base_t event_base, int32_t event_id,
                              const void* event_data, size_t event_data_size, BaseType_t* task_unblocked)
@@ -100,7 +129,12 @@ esp_err_t esp_event_loop_create_default(void)
         .task_name = "sys_evt",
         .task_stack_size = ESP_TASKD_EVENT_STACK,
         .task_priority = ESP_TASKD_EVENT_PRIO,
-        .task_core_id = 0
+        .task_core_id = 0,
+#if CONFIG_ESP_EVENT_DEFAULT_LOOP_PAYLOAD_POOL_SIZE
+        .payload_pool_size = CONFIG_ESP_EVENT_DEFAULT_LOOP_PAYLOAD_POOL_SIZE,
+        .payload_size = CONFIG_ESP_EVENT_DEFAULT_LOOP_PAYLOAD_SIZE,
+#endif
+        .run_batch_size = CONFIG_ESP_EVENT_DEFAULT_LOOP_RUN_BATCH_SIZE,
     };
 
     esp_err_t err;
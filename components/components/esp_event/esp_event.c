@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -22,8 +22,8 @@
 /* ---------------------------- Definitions --------------------------------- */
 
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
-// LOOP @<address, name> rx:<received events no.> dr:<dropped events no.>
-#define LOOP_DUMP_FORMAT              "LOOP @%p,%s rx:%" PRIu32 " dr:%" PRIu32 "\n"
+// LOOP @<address, name> rx:<received events no.> dr:<dropped events no.> bt:<batches no.> ev/bt:<events per batch> time:<runtime>
+#define LOOP_DUMP_FORMAT              "LOOP @%p,%s rx:%" PRIu32 " dr:%" PRIu32 " bt:%" PRIu32 " ev/bt:%" PRIu32 ".%02" PRIu32 " time:%lld us\n"
 // handler @<address> ev:<base, id> inv:<times invoked> time:<runtime>
 #define HANDLER_DUMP_FORMAT           "  HANDLER @%p ev:%s,%s inv:%" PRIu32 " time:%lld us\n"
 
@@ -88,7 +88,7 @@ static int esp_event_dump_prepare(void)
 
     // Reserve slightly more memory than computed
     int allowance = 3;
-    int size = (((loops + allowance) * (sizeof(LOOP_DUMP_FORMAT) + 10 + 20 + 2 * 11)) +
+    int size = (((loops + allowance) * (sizeof(LOOP_DUMP_FORMAT) + 10 + 20 + 5 * 11 + 20)) +
                 ((handlers + allowance) * (sizeof(HANDLER_DUMP_FORMAT) + 10 + 2 * 20 + 11 + 20)));
 
     return size;
@@ -382,6 +382,7 @@ static esp_err_t loop_remove_handler(esp_event_remove_handler_context_t* ctx)
         esp_err_t res = loop_node_remove_handler(it, ctx->event_base, ctx->event_id, ctx->handler_ctx, ctx->legacy);
 
         if (res == ESP_OK) {
+            ctx->loop->dispatch_index_stale = true;
             if (SLIST_EMPTY(&(it->base_nodes)) && SLIST_EMPTY(&(it->handlers))) {
                 SLIST_REMOVE(&(ctx->loop->loop_nodes), it, esp_event_loop_node, next);
                 free(it);
@@ -426,17 +427,163 @@ static void loop_node_remove_all_handler(esp_event_loop_node_t* loop_node)
     }
 }
 
-static void inline __attribute__((always_inline)) post_instance_delete(esp_event_post_instance_t* post)
+// The payload pool is a single allocation holding the bitmap of the buffers in use followed by the buffers.
+// Buffers are acquired and released with atomic operations on the bitmap, so that posting does not need to
+// take the loop mutex or allocate memory.
+#define PAYLOAD_POOL_WORD_BITS        32
+
+static esp_err_t payload_pool_init(esp_event_payload_pool_t* pool, uint32_t count, size_t buffer_size)
+{
+    memset(pool, 0, sizeof(*pool));
+
+    if (count == 0) {
+        return ESP_OK;
+    }
+
+    if (buffer_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const size_t align = sizeof(void*);
+    size_t words = (count + PAYLOAD_POOL_WORD_BITS - 1) / PAYLOAD_POOL_WORD_BITS;
+    size_t bitmap_size = (words * sizeof(atomic_uint_least32_t) + align - 1) & ~(align - 1);
+    size_t stride = (buffer_size + align - 1) & ~(align - 1);
+
+    if (stride < buffer_size || count > (SIZE_MAX - bitmap_size) / stride) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t* storage = calloc(1, bitmap_size + count * stride);
+    if (storage == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    pool->in_use = (atomic_uint_least32_t*) storage;
+    for (size_t i = 0; i < words; i++) {
+        atomic_init(&pool->in_use[i], 0);
+    }
+    // Mark the bits past the last buffer as in use, so that they are never handed out
+    if (count % PAYLOAD_POOL_WORD_BITS != 0) {
+        atomic_init(&pool->in_use[words - 1], UINT32_MAX << (count % PAYLOAD_POOL_WORD_BITS));
+    }
+
+    pool->buffers = storage + bitmap_size;
+    pool->buffer_size = buffer_size;
+    pool->stride = stride;
+    pool->count = count;
+
+    return ESP_OK;
+}
+
+static void payload_pool_deinit(esp_event_payload_pool_t* pool)
+{
+    // The bitmap is at the start of the allocation
+    free(pool->in_use);
+    memset(pool, 0, sizeof(*pool));
+}
+
+static void* payload_pool_acquire(esp_event_payload_pool_t* pool)
+{
+    size_t words = (pool->count + PAYLOAD_POOL_WORD_BITS - 1) / PAYLOAD_POOL_WORD_BITS;
+
+    for (size_t i = 0; i < words; i++) {
+        uint32_t in_use = atomic_load(&pool->in_use[i]);
+        while (in_use != UINT32_MAX) {
+            uint32_t bit = __builtin_ctz(~in_use);
+            if (atomic_compare_exchange_weak(&pool->in_use[i], &in_use, in_use | (1UL << bit))) {
+                return pool->buffers + (i * PAYLOAD_POOL_WORD_BITS + bit) * pool->stride;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static inline bool payload_pool_contains(const esp_event_payload_pool_t* pool, const void* ptr)
+{
+    const uint8_t* p = (const uint8_t*) ptr;
+    return pool->buffers != NULL && p >= pool->buffers && p < pool->buffers + pool->count * pool->stride;
+}
+
+// Checks that ptr is the start of a buffer of the pool which is in use
+static bool payload_pool_is_acquired(const esp_event_payload_pool_t* pool, const void* ptr)
+{
+    if (!payload_pool_contains(pool, ptr)) {
+        return false;
+    }
+
+    size_t offset = (const uint8_t*) ptr - pool->buffers;
+    if (offset % pool->stride != 0) {
+        return false;
+    }
+
+    size_t n = offset / pool->stride;
+    return (atomic_load(&pool->in_use[n / PAYLOAD_POOL_WORD_BITS]) & (1UL << (n % PAYLOAD_POOL_WORD_BITS))) != 0;
+}
+
+static void payload_pool_release(esp_event_payload_pool_t* pool, void* ptr)
+{
+    size_t n = ((uint8_t*) ptr - pool->buffers) / pool->stride;
+    atomic_fetch_and(&pool->in_use[n / PAYLOAD_POOL_WORD_BITS], ~(1UL << (n % PAYLOAD_POOL_WORD_BITS)));
+}
+
+static void inline __attribute__((always_inline)) post_instance_delete(esp_event_loop_instance_t* loop, esp_event_post_instance_t* post)
 {
 #if CONFIG_ESP_EVENT_POST_FROM_ISR
     if (post->data_allocated)
 #endif
     {
-        free(post->data.ptr);
+        if (payload_pool_contains(&loop->payload_pool, post->data.ptr)) {
+            payload_pool_release(&loop->payload_pool, post->data.ptr);
+        } else {
+            free(post->data.ptr);
+        }
     }
     memset(post, 0, sizeof(*post));
 }
 
+static esp_err_t loop_post(esp_event_loop_instance_t* loop, esp_event_post_instance_t* post, TickType_t ticks_to_wait)
+{
+    BaseType_t result = pdFALSE;
+
+    // Find the task that currently executes the loop. It is safe to query loop->task since it is
+    // not mutated since loop creation. ENSURE THIS REMAINS TRUE.
+    if (loop->task == NULL) {
+        // The loop has no dedicated task. Find out what task is currently running it.
+        result = xSemaphoreTakeRecursive(loop->mutex, ticks_to_wait);
+
+        if (result == pdTRUE) {
+            if (loop->running_task != xTaskGetCurrentTaskHandle()) {
+                xSemaphoreGiveRecursive(loop->mutex);
+                result = xQueueSendToBack(loop->queue, post, ticks_to_wait);
+            } else {
+                xSemaphoreGiveRecursive(loop->mutex);
+                result = xQueueSendToBack(loop->queue, post, 0);
+            }
+        }
+    } else {
+        // The loop has a dedicated task.
+        if (loop->task != xTaskGetCurrentTaskHandle()) {
+            result = xQueueSendToBack(loop->queue, post, ticks_to_wait);
+        } else {
+            result = xQueueSendToBack(loop->queue, post, 0);
+        }
+    }
+
+    if (result != pdTRUE) {
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+        atomic_fetch_add(&loop->events_dropped, 1);
+#endif
+        return ESP_ERR_TIMEOUT;
+    }
+
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+    atomic_fetch_add(&loop->events_received, 1);
+#endif
+
+    return ESP_OK;
+}
+
 static esp_err_t find_and_unregister_handler(esp_event_remove_handler_context_t* ctx)
 {
     esp_event_handler_node_t *handler_to_unregister = NULL;
@@ -535,6 +682,292 @@ static esp_err_t find_and_unregister_handler(esp_event_remove_handler_context_t*
     return esp_event_post_to(ctx->loop, esp_event_handler_cleanup, 0, ctx, sizeof(esp_event_remove_handler_context_t), portMAX_DELAY);
 }
 
+// Executes the handlers of the event by walking the lists of the loop, returns whether any was executed
+static bool loop_dispatch_from_lists(esp_event_loop_instance_t* loop, esp_event_post_instance_t post)
+{
+    bool exec = false;
+
+    esp_event_handler_node_t *handler, *temp_handler;
+    esp_event_loop_node_t *loop_node, *temp_node;
+    esp_event_base_node_t *base_node, *temp_base;
+    esp_event_id_node_t *id_node, *temp_id_node;
+
+    SLIST_FOREACH_SAFE(loop_node, &(loop->loop_nodes), next, temp_node) {
+        // Execute loop level handlers
+        SLIST_FOREACH_SAFE(handler, &(loop_node->handlers), next, temp_handler) {
+            if (!handler->unregistered) {
+                handler_execute(loop, handler, post);
+                exec |= true;
+            }
+        }
+
+        SLIST_FOREACH_SAFE(base_node, &(loop_node->base_nodes), next, temp_base) {
+            if (base_node->base == post.base) {
+                // Execute base level handlers
+                SLIST_FOREACH_SAFE(handler, &(base_node->handlers), next, temp_handler) {
+                    if (!handler->unregistered) {
+                        handler_execute(loop, handler, post);
+                        exec |= true;
+                    }
+                }
+
+                SLIST_FOREACH_SAFE(id_node, &(base_node->id_nodes), next, temp_id_node) {
+                    if (id_node->id == post.id) {
+                        // Execute id level handlers
+                        SLIST_FOREACH_SAFE(handler, &(id_node->handlers), next, temp_handler) {
+                            if (!handler->unregistered) {
+                                handler_execute(loop, handler, post);
+                                exec |= true;
+                            }
+                        }
+                        // Skip to next base node
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    return exec;
+}
+
+static inline size_t dispatch_index_hash(esp_event_base_t base, int32_t id)
+{
+    uint32_t hash = ((uint32_t)((uintptr_t) base >> 2) ^ ((uint32_t) id * 0x9E3779B1u)) * 0x85EBCA6Bu;
+    return hash ^ (hash >> 16);
+}
+
+static esp_event_dispatch_entry_t* dispatch_index_find(const esp_event_dispatch_index_t* index, esp_event_base_t base, int32_t id)
+{
+    esp_event_dispatch_entry_t* it = index->buckets[dispatch_index_hash(base, id) & index->buckets_mask];
+    while (it != NULL && (it->base != base || it->id != id)) {
+        it = it->next;
+    }
+    return it;
+}
+
+static void dispatch_index_add_entry(esp_event_dispatch_index_t* index, esp_event_base_t base, int32_t id)
+{
+    if (dispatch_index_find(index, base, id) != NULL) {
+        return;
+    }
+    esp_event_dispatch_entry_t* entry = &(index->entries[index->entries_count++]);
+    entry->base = base;
+    entry->id = id;
+    size_t bucket = dispatch_index_hash(base, id) & index->buckets_mask;
+    entry->next = index->buckets[bucket];
+    index->buckets[bucket] = entry;
+}
+
+// Collects the handlers executed for an event, in the order esp_event_loop_run executes them.
+// With base NULL, only the loop level handlers are collected. Returns their number,
+// handlers may be NULL to only count them.
+static size_t dispatch_index_collect(esp_event_loop_instance_t* loop, esp_event_base_t base, int32_t id, esp_event_handler_node_t** handlers)
+{
+    size_t count = 0;
+    esp_event_handler_node_t *handler;
+    esp_event_loop_node_t *loop_node;
+    esp_event_base_node_t *base_node;
+    esp_event_id_node_t *id_node;
+
+    SLIST_FOREACH(loop_node, &(loop->loop_nodes), next) {
+        SLIST_FOREACH(handler, &(loop_node->handlers), next) {
+            if (handlers) {
+                handlers[count] = handler;
+            }
+            count++;
+        }
+
+        if (base == NULL) {
+            continue;
+        }
+
+        SLIST_FOREACH(base_node, &(loop_node->base_nodes), next) {
+            if (base_node->base != base) {
+                continue;
+            }
+
+            SLIST_FOREACH(handler, &(base_node->handlers), next) {
+                if (handlers) {
+                    handlers[count] = handler;
+                }
+                count++;
+            }
+
+            if (id == ESP_EVENT_ANY_ID) {
+                continue;
+            }
+
+            SLIST_FOREACH(id_node, &(base_node->id_nodes), next) {
+                if (id_node->id == id) {
+                    SLIST_FOREACH(handler, &(id_node->handlers), next) {
+                        if (handlers) {
+                            handlers[count] = handler;
+                        }
+                        count++;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+static void dispatch_index_free(esp_event_dispatch_index_t* index)
+{
+    if (index != NULL) {
+        free(index->handlers);
+        free(index);
+    }
+}
+
+static esp_event_dispatch_index_t* dispatch_index_build(esp_event_loop_instance_t* loop)
+{
+    esp_event_loop_node_t *loop_node;
+    esp_event_base_node_t *base_node;
+    esp_event_id_node_t *id_node;
+
+    // Every event base and id with id level handlers gets an entry, and so does every event
+    // base with base level handlers (for the events of the base without id level handlers).
+    size_t max_entries = 0;
+    SLIST_FOREACH(loop_node, &(loop->loop_nodes), next) {
+        SLIST_FOREACH(base_node, &(loop_node->base_nodes), next) {
+            if (!SLIST_EMPTY(&(base_node->handlers))) {
+                max_entries++;
+            }
+            SLIST_FOREACH(id_node, &(base_node->id_nodes), next) {
+                max_entries++;
+            }
+        }
+    }
+
+    size_t buckets = 1;
+    while (buckets < 2 * max_entries) {
+        buckets <<= 1;
+    }
+
+    esp_event_dispatch_index_t* index = calloc(1, sizeof(*index) + buckets * sizeof(esp_event_dispatch_entry_t*) +
+                                               max_entries * sizeof(esp_event_dispatch_entry_t));
+    if (index == NULL) {
+        return NULL;
+    }
+    index->buckets_mask = buckets - 1;
+    index->buckets = (esp_event_dispatch_entry_t**)(index + 1);
+    index->entries = (esp_event_dispatch_entry_t*)(index->buckets + buckets);
+
+    SLIST_FOREACH(loop_node, &(loop->loop_nodes), next) {
+        SLIST_FOREACH(base_node, &(loop_node->base_nodes), next) {
+            if (!SLIST_EMPTY(&(base_node->handlers))) {
+                dispatch_index_add_entry(index, base_node->base, ESP_EVENT_ANY_ID);
+            }
+            SLIST_FOREACH(id_node, &(base_node->id_nodes), next) {
+                dispatch_index_add_entry(index, base_node->base, id_node->id);
+            }
+        }
+    }
+
+    size_t handlers_count = dispatch_index_collect(loop, NULL, ESP_EVENT_ANY_ID, NULL);
+    for (size_t i = 0; i < index->entries_count; i++) {
+        handlers_count += dispatch_index_collect(loop, index->entries[i].base, index->entries[i].id, NULL);
+    }
+
+    if (handlers_count > 0) {
+        index->handlers = malloc(handlers_count * sizeof(esp_event_handler_node_t*));
+        if (index->handlers == NULL) {
+            free(index);
+            return NULL;
+        }
+    }
+
+    esp_event_handler_node_t** handlers = index->handlers;
+    index->loop_entry.handlers = handlers;
+    index->loop_entry.handlers_count = dispatch_index_collect(loop, NULL, ESP_EVENT_ANY_ID, handlers);
+    handlers += index->loop_entry.handlers_count;
+    for (size_t i = 0; i < index->entries_count; i++) {
+        esp_event_dispatch_entry_t* entry = &(index->entries[i]);
+        entry->handlers = handlers;
+        entry->handlers_count = dispatch_index_collect(loop, entry->base, entry->id, handlers);
+        handlers += entry->handlers_count;
+    }
+
+    return index;
+}
+
+// Returns the handlers to execute for an event, or NULL if the index can not be used
+// and the lists of the loop have to be walked instead.
+static esp_event_dispatch_entry_t* loop_get_dispatch_entry(esp_event_loop_instance_t* loop, esp_event_base_t base, int32_t id)
+{
+    if (loop->dispatch_index == NULL || loop->dispatch_index_stale) {
+        if (loop->dispatch_depth > 0) {
+            // an event is being dispatched using the index, it can not be freed yet
+            return NULL;
+        }
+        dispatch_index_free(loop->dispatch_index);
+        loop->dispatch_index = dispatch_index_build(loop);
+        loop->dispatch_index_stale = false;
+        if (loop->dispatch_index == NULL) {
+            ESP_LOGD(TAG, "alloc for dispatch index of loop %p failed", loop);
+            return NULL;
+        }
+    }
+
+    esp_event_dispatch_entry_t* entry = dispatch_index_find(loop->dispatch_index, base, id);
+    if (entry == NULL) {
+        entry = dispatch_index_find(loop->dispatch_index, base, ESP_EVENT_ANY_ID);
+    }
+    if (entry == NULL) {
+        entry = &(loop->dispatch_index->loop_entry);
+    }
+    return entry;
+}
+
+// Dispatches a post received from the queue of the loop and deletes it, must be called with the loop mutex taken
+static void loop_dispatch_post(esp_event_loop_instance_t* loop, esp_event_post_instance_t* post)
+{
+    // check if the event retrieve from the queue is the internal event that is
+    // triggered when a handler needs to be removed..
+    if (post->base == esp_event_handler_cleanup) {
+        assert(post->data.ptr != NULL);
+        esp_event_remove_handler_context_t* ctx = (esp_event_remove_handler_context_t*)post->data.ptr;
+        loop_remove_handler(ctx);
+
+        // if the handler unregistration request came from legacy code,
+        // we have to free handler_ctx pointer since it points to memory
+        // allocated by esp_event_handler_unregister_with_internal
+        if (ctx->legacy) {
+            free(ctx->handler_ctx);
+        }
+    }
+
+    bool exec = false;
+
+    esp_event_dispatch_entry_t* entry = loop_get_dispatch_entry(loop, post->base, post->id);
+    loop->dispatch_depth++;
+
+    if (entry != NULL) {
+        for (size_t i = 0; i < entry->handlers_count; i++) {
+            esp_event_handler_node_t* handler = entry->handlers[i];
+            if (!handler->unregistered) {
+                handler_execute(loop, handler, *post);
+                exec |= true;
+            }
+        }
+    } else {
+        exec = loop_dispatch_from_lists(loop, *post);
+    }
+
+    loop->dispatch_depth--;
+
+    if (!exec) {
+        // No handlers were registered, not even loop/base level handlers
+        ESP_LOGD(TAG, "no handlers have been registered for event %s:%"PRIu32" posted to loop %p", post->base, post->id, loop);
+    }
+
+    post_instance_delete(loop, post);
+}
+
 /* ---------------------------- Public API --------------------------------- */
 
 esp_err_t esp_event_loop_create(const esp_event_loop_args_t* event_loop_args, esp_event_loop_handle_t* event_loop)
@@ -570,6 +1003,15 @@ esp_err_t esp_event_loop_create(const esp_event_loop_args_t* event_loop_args, es
         goto on_err;
     }
 
+    err = payload_pool_init(&loop->payload_pool, event_loop_args->payload_pool_size, event_loop_args->payload_size);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "create event loop payload pool failed");
+        goto on_err;
+    }
+    err = ESP_ERR_NO_MEM;
+
+    loop->run_batch_size = (event_loop_args->run_batch_size > 1) ? event_loop_args->run_batch_size : 1;
+
     SLIST_INIT(&(loop->loop_nodes));
 
     // Create the loop task if requested
@@ -615,17 +1057,19 @@ on_err:
         vSemaphoreDelete(loop->mutex);
     }
 
+    payload_pool_deinit(&loop->payload_pool);
     free(loop);
 
     return err;
 }
 
-// On event lookup performance: The library implements the event list as a linked list, which results to O(n)
-// lookup time. The test comparing this implementation to the O(lg n) performance of rbtrees
-// (https://github.com/freebsd/freebsd/blob/master/sys/sys/tree.h)
-// indicate that the difference is not that substantial, especially considering the additional
-// pointers per node of rbtrees. Code for the rbtree implementation of the event loop library is archived
-// in feature/esp_event_loop_library_rbtrees if needed.
+// On event lookup performance: The library keeps the registered handlers in linked lists, which results
+// in O(n) lookup time. To dispatch an event, a hash table indexed by event base and id is used instead,
+// which holds the handlers to execute for each event in an array. It is built from the lists when an
+// event is dispatched after handlers were registered or unregistered, so registration does not get slower.
+// Handlers registered by a handler of the event being dispatched are executed starting with the next event.
+// The lists are walked only when the index can not be used (it is stale while another event is being
+// dispatched by the same task, or there is not enough memory to build it).
 esp_err_t esp_event_loop_run(esp_event_loop_handle_t event_loop, TickType_t ticks_to_run)
 {
     assert(event_loop);
@@ -645,70 +1089,25 @@ esp_err_t esp_event_loop_run(esp_event_loop_handle_t event_loop, TickType_t tick
         // The event has already been unqueued, so ensure it gets executed.
         xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
 
-        // check if the event retrieve from the queue is the internal event that is
-        // triggered when a handler needs to be removed..
-        if (post.base == esp_event_handler_cleanup) {
-            assert(post.data.ptr != NULL);
-            esp_event_remove_handler_context_t* ctx = (esp_event_remove_handler_context_t*)post.data.ptr;
-            loop_remove_handler(ctx);
-
-            // if the handler unregistration request came from legacy code,
-            // we have to free handler_ctx pointer since it points to memory
-            // allocated by esp_event_handler_unregister_with_internal
-            if (ctx->legacy) {
-                free(ctx->handler_ctx);
-            }
-        }
-
         loop->running_task = xTaskGetCurrentTaskHandle();
 
-        bool exec = false;
-
-        esp_event_handler_node_t *handler, *temp_handler;
-        esp_event_loop_node_t *loop_node, *temp_node;
-        esp_event_base_node_t *base_node, *temp_base;
-        esp_event_id_node_t *id_node, *temp_id_node;
-
-        SLIST_FOREACH_SAFE(loop_node, &(loop->loop_nodes), next, temp_node) {
-            // Execute loop level handlers
-            SLIST_FOREACH_SAFE(handler, &(loop_node->handlers), next, temp_handler) {
-                if (!handler->unregistered) {
-                    handler_execute(loop, handler, post);
-                    exec |= true;
-                }
-            }
-
-            SLIST_FOREACH_SAFE(base_node, &(loop_node->base_nodes), next, temp_base) {
-                if (base_node->base == post.base) {
-                    // Execute base level handlers
-                    SLIST_FOREACH_SAFE(handler, &(base_node->handlers), next, temp_handler) {
-                        if (!handler->unregistered) {
-                            handler_execute(loop, handler, post);
-                            exec |= true;
-                        }
-                    }
-
-                    SLIST_FOREACH_SAFE(id_node, &(base_node->id_nodes), next, temp_id_node) {
-                        if (id_node->id == post.id) {
-                            // Execute id level handlers
-                            SLIST_FOREACH_SAFE(handler, &(id_node->handlers), next, temp_handler) {
-                                if (!handler->unregistered) {
-                                    handler_execute(loop, handler, post);
-                                    exec |= true;
-                                }
-                            }
-                            // Skip to next base node
-                            break;
-                        }
-                    }
-                }
-            }
-        }
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+        int64_t start = esp_timer_get_time();
+#endif
 
-        esp_event_base_t base = post.base;
-        int32_t id = post.id;
+        // Dispatch the events already in the queue along with the received one, up to the batch size,
+        // so that the mutex is taken once for a burst of events.
+        uint32_t dispatched = 0;
+        do {
+            loop_dispatch_post(loop, &post);
+            dispatched++;
+        } while (dispatched < loop->run_batch_size && xQueueReceive(loop->queue, &post, 0) == pdTRUE);
 
-        post_instance_delete(&post);
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+        loop->time += esp_timer_get_time() - start;
+        loop->batches++;
+        loop->events_dispatched += dispatched;
+#endif
 
         if (ticks_to_run != portMAX_DELAY) {
             end = xTaskGetTickCount();
@@ -725,11 +1124,6 @@ esp_err_t esp_event_loop_run(esp_event_loop_handle_t event_loop, TickType_t tick
         loop->running_task = NULL;
 
         xSemaphoreGiveRecursive(loop->mutex);
-
-        if (!exec) {
-            // No handlers were registered, not even loop/base level handlers
-            ESP_LOGD(TAG, "no handlers have been registered for event %s:%"PRIu32" posted to loop %p", base, id, event_loop);
-        }
     }
 
     return ESP_OK;
@@ -763,15 +1157,17 @@ esp_err_t esp_event_loop_delete(esp_event_loop_handle_t event_loop)
         SLIST_REMOVE(&(loop->loop_nodes), it, esp_event_loop_node, next);
         free(it);
     }
+    dispatch_index_free(loop->dispatch_index);
 
     // Drop existing posts on the queue
     esp_event_post_instance_t post;
     while (xQueueReceive(loop->queue, &post, 0) == pdTRUE) {
-        post_instance_delete(&post);
+        post_instance_delete(loop, &post);
     }
 
     // Cleanup loop
     vQueueDelete(loop->queue);
+    payload_pool_deinit(&loop->payload_pool);
     free(loop);
     // Free loop mutex before deleting
     xSemaphoreGiveRecursive(loop_mutex);
@@ -838,6 +1234,10 @@ esp_err_t esp_event_handler_register_with_internal(esp_event_loop_handle_t event
         err = loop_node_add_handler(last_loop_node, event_base, event_id, event_handler, event_handler_arg, handler_ctx_arg, legacy);
     }
 
+    if (err == ESP_OK) {
+        loop->dispatch_index_stale = true;
+    }
+
 on_err:
     xSemaphoreGiveRecursive(loop->mutex);
     return err;
@@ -924,11 +1324,20 @@ esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop, esp_event_base_t
     memset((void*)(&post), 0, sizeof(post));
 
     if (event_data != NULL && event_data_size != 0) {
-        // Make persistent copy of event data on heap.
-        void* event_data_copy = calloc(1, event_data_size);
+        // Make persistent copy of event data, in a buffer of the payload pool if the data fits and
+        // a buffer is free, on heap otherwise.
+        void* event_data_copy = NULL;
+
+        if (event_data_size <= loop->payload_pool.buffer_size) {
+            event_data_copy = payload_pool_acquire(&loop->payload_pool);
+        }
 
         if (event_data_copy == NULL) {
-            return ESP_ERR_NO_MEM;
+            event_data_copy = calloc(1, event_data_size);
+
+            if (event_data_copy == NULL) {
+                return ESP_ERR_NO_MEM;
+            }
         }
 
         memcpy(event_data_copy, event_data, event_data_size);
@@ -941,48 +1350,83 @@ esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop, esp_event_base_t
     post.base = event_base;
     post.id = event_id;
 
-    BaseType_t result = pdFALSE;
+    esp_err_t err = loop_post(loop, &post, ticks_to_wait);
+    if (err != ESP_OK) {
+        post_instance_delete(loop, &post);
+    }
 
-    // Find the task that currently executes the loop. It is safe to query loop->task since it is
-    // not mutated since loop creation. ENSURE THIS REMAINS TRUE.
-    if (loop->task == NULL) {
-        // The loop has no dedicated task. Find out what task is currently running it.
-        result = xSemaphoreTakeRecursive(loop->mutex, ticks_to_wait);
+    return err;
+}
 
-        if (result == pdTRUE) {
-            if (loop->running_task != xTaskGetCurrentTaskHandle()) {
-                xSemaphoreGiveRecursive(loop->mutex);
-                result = xQueueSendToBack(loop->queue, &post, ticks_to_wait);
-            } else {
-                xSemaphoreGiveRecursive(loop->mutex);
-                result = xQueueSendToBack(loop->queue, &post, 0);
-            }
-        }
-    } else {
-        // The loop has a dedicated task.
-        if (loop->task != xTaskGetCurrentTaskHandle()) {
-            result = xQueueSendToBack(loop->queue, &post, ticks_to_wait);
-        } else {
-            result = xQueueSendToBack(loop->queue, &post, 0);
-        }
+esp_err_t esp_event_payload_acquire_with(esp_event_loop_handle_t event_loop, size_t size, void** payload)
+{
+    assert(event_loop);
+
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+
+    if (payload == NULL) {
+        return ESP_ERR_INVALID_ARG;
     }
 
-    if (result != pdTRUE) {
-        post_instance_delete(&post);
+    if (loop->payload_pool.count == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
 
-#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
-        atomic_fetch_add(&loop->events_dropped, 1);
-#endif
-        return ESP_ERR_TIMEOUT;
+    if (size > loop->payload_pool.buffer_size) {
+        return ESP_ERR_INVALID_ARG;
     }
 
-#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
-    atomic_fetch_add(&loop->events_received, 1);
-#endif
+    *payload = payload_pool_acquire(&loop->payload_pool);
+
+    return (*payload != NULL) ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_event_payload_release_with(esp_event_loop_handle_t event_loop, void* payload)
+{
+    assert(event_loop);
+
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+
+    if (!payload_pool_is_acquired(&loop->payload_pool, payload)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    payload_pool_release(&loop->payload_pool, payload);
 
     return ESP_OK;
 }
 
+esp_err_t esp_event_post_payload_to(esp_event_loop_handle_t event_loop, esp_event_base_t event_base, int32_t event_id,
+                                    void* payload, TickType_t ticks_to_wait)
+{
+    assert(event_loop);
+
+    if (event_base == ESP_EVENT_ANY_BASE || event_id == ESP_EVENT_ANY_ID) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+
+    if (!payload_pool_is_acquired(&loop->payload_pool, payload)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_event_post_instance_t post;
+    memset((void*)(&post), 0, sizeof(post));
+
+    // The loop takes the ownership of the buffer only if the event is queued, it is
+    // returned to the pool by post_instance_delete() once the event is handled.
+    post.data.ptr = payload;
+#if CONFIG_ESP_EVENT_POST_FROM_ISR
+    post.data_allocated = true;
+    post.data_set = true;
+#endif
+    post.base = event_base;
+    post.id = event_id;
+
+    return loop_post(loop, &post, ticks_to_wait);
+}
+
 #if CONFIG_ESP_EVENT_POST_FROM_ISR
 esp_err_t esp_event_isr_post_to(esp_event_loop_handle_t event_loop, esp_event_base_t event_base, int32_t event_id,
                                 const void* event_data, size_t event_data_size, BaseType_t* task_unblocked)
@@ -1016,7 +1460,7 @@ esp_err_t esp_event_isr_post_to(esp_event_loop_handle_t event_loop, esp_event_ba
     result = xQueueSendToBackFromISR(loop->queue, &post, task_unblocked);
 
     if (result != pdTRUE) {
-        post_instance_delete(&post);
+        post_instance_delete(loop, &post);
 
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
         atomic_fetch_add(&loop->events_dropped, 1);
@@ -1054,13 +1498,16 @@ esp_err_t esp_event_dump(FILE* file)
     portENTER_CRITICAL(&s_event_loops_spinlock);
 
     SLIST_FOREACH(loop_it, &s_event_loops, next) {
-        uint32_t events_received, events_dropped;
+        uint32_t events_received, events_dropped, events_per_batch;
 
         events_received = atomic_load(&loop_it->events_received);
         events_dropped = atomic_load(&loop_it->events_dropped);
+        // Average number of events per batch, in hundredths
+        events_per_batch = (loop_it->batches != 0) ? (uint32_t)((100ULL * loop_it->events_dispatched) / loop_it->batches) : 0;
 
         PRINT_DUMP_INFO(dst, sz, LOOP_DUMP_FORMAT, loop_it, loop_it->task != NULL ? loop_it->name : "none",
-                        events_received, events_dropped);
+                        events_received, events_dropped, loop_it->batches, events_per_batch / 100, events_per_batch % 100,
+                        loop_it->time);
 
         int sz_bak = sz;
 
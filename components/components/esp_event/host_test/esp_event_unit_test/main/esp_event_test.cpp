@@ -8,6 +8,8 @@
 */
 
 #include <stdio.h>
+#include <string.h>
+#include <chrono>
 #include "esp_event.h"
 
 #include <catch2/catch_test_macros.hpp>
@@ -17,6 +19,10 @@
 extern "C" {
 #include "Mocktask.h"
 #include "Mockqueue.h"
+
+// malloc and calloc are wrapped by the linker to count the allocations, see CMakeLists.txt
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
 }
 
 namespace {
@@ -40,6 +46,137 @@ static esp_event_loop_args_t test_event_get_default_loop_args(void)
 
 void dummy_handler(void* event_handler_arg, esp_event_base_t event_base, int32_t event_id, void* event_data) { }
 
+void counting_handler(void* event_handler_arg, esp_event_base_t event_base, int32_t event_id, void* event_data)
+{
+    (*static_cast<uint32_t*>(event_handler_arg))++;
+}
+
+void summing_handler(void* event_handler_arg, esp_event_base_t event_base, int32_t event_id, void* event_data)
+{
+    uint32_t value;
+    memcpy(&value, event_data, sizeof(value));
+    *static_cast<uint32_t*>(event_handler_arg) += value;
+}
+
+// Event queue faked by the stubs below, posted items are copied in and out like a FreeRTOS queue does.
+// The storage is static, so that the fake queue does not allocate memory itself.
+const size_t FAKE_QUEUE_ITEM_MAX_SIZE = 64;
+uint8_t s_fake_queue[QUEUE_SIZE][FAKE_QUEUE_ITEM_MAX_SIZE];
+UBaseType_t s_fake_queue_length;
+UBaseType_t s_fake_queue_item_size;
+UBaseType_t s_fake_queue_head;
+UBaseType_t s_fake_queue_count;
+
+QueueHandle_t fake_queue_create(const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, const uint8_t ucQueueType, int cmock_num_calls)
+{
+    if (uxQueueLength > QUEUE_SIZE || uxItemSize > FAKE_QUEUE_ITEM_MAX_SIZE) {
+        return nullptr;
+    }
+    s_fake_queue_length = uxQueueLength;
+    s_fake_queue_item_size = uxItemSize;
+    s_fake_queue_head = 0;
+    s_fake_queue_count = 0;
+    return reinterpret_cast<QueueHandle_t>(0xcafe);
+}
+
+BaseType_t fake_queue_send(QueueHandle_t xQueue, const void * const pvItemToQueue, TickType_t xTicksToWait, const BaseType_t xCopyPosition, int cmock_num_calls)
+{
+    // giving a mutex sends no item
+    if (pvItemToQueue != nullptr) {
+        if (s_fake_queue_count == s_fake_queue_length) {
+            return pdFALSE;
+        }
+        memcpy(s_fake_queue[(s_fake_queue_head + s_fake_queue_count) % s_fake_queue_length], pvItemToQueue, s_fake_queue_item_size);
+        s_fake_queue_count++;
+    }
+    return pdTRUE;
+}
+
+BaseType_t fake_queue_receive(QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait, int cmock_num_calls)
+{
+    if (s_fake_queue_count == 0) {
+        return pdFALSE;
+    }
+    memcpy(pvBuffer, s_fake_queue[s_fake_queue_head], s_fake_queue_item_size);
+    s_fake_queue_head = (s_fake_queue_head + 1) % s_fake_queue_length;
+    s_fake_queue_count--;
+    return pdTRUE;
+}
+
+// Stubs for a loop without a task whose events go through the fake queue, for the lifetime of the fixture.
+// Taking the mutex succeeds, or calls mutex_take if given.
+struct FakeQueueFix {
+    explicit FakeQueueFix(CMOCK_xQueueTakeMutexRecursive_CALLBACK mutex_take = nullptr)
+    {
+        xQueueGenericCreate_Stub(fake_queue_create);
+        xQueueGenericSend_Stub(fake_queue_send);
+        xQueueReceive_Stub(fake_queue_receive);
+        vQueueDelete_Ignore();
+        if (mutex_take != nullptr) {
+            xQueueTakeMutexRecursive_Stub(mutex_take);
+        } else {
+            xQueueTakeMutexRecursive_IgnoreAndReturn(pdTRUE);
+        }
+        xQueueGiveMutexRecursive_IgnoreAndReturn(pdTRUE);
+        xTaskGetTickCount_IgnoreAndReturn(0);
+        xTaskGetCurrentTaskHandle_IgnoreAndReturn(nullptr);
+    }
+
+    ~FakeQueueFix()
+    {
+        xQueueGenericCreate_Stub(nullptr);
+        xQueueGenericSend_Stub(nullptr);
+        xQueueReceive_Stub(nullptr);
+        vQueueDelete_StopIgnore();
+        xQueueTakeMutexRecursive_StopIgnore();
+        xQueueTakeMutexRecursive_Stub(nullptr);
+        xQueueGiveMutexRecursive_StopIgnore();
+        xTaskGetTickCount_StopIgnore();
+        xTaskGetCurrentTaskHandle_StopIgnore();
+    }
+
+    MockMutex sem{CreateAnd::IGNORE};
+};
+
+struct registering_handler_arg_t {
+    esp_event_loop_handle_t loop;
+    uint32_t calls;
+};
+
+// Registers a counting handler for the event it is called for
+void registering_handler(void* event_handler_arg, esp_event_base_t event_base, int32_t event_id, void* event_data)
+{
+    registering_handler_arg_t* arg = static_cast<registering_handler_arg_t*>(event_handler_arg);
+    esp_event_handler_register_with(arg->loop, event_base, event_id, counting_handler, &arg->calls);
+}
+
+bool s_count_allocations;
+uint32_t s_allocations;
+
+static uint32_t s_mutex_takes;
+
+BaseType_t counting_mutex_take(QueueHandle_t xMutex, TickType_t xTicksToWait, int cmock_num_calls)
+{
+    s_mutex_takes++;
+    return pdTRUE;
+}
+
+}
+
+extern "C" void *__wrap_malloc(size_t size)
+{
+    if (s_count_allocations) {
+        s_allocations++;
+    }
+    return __real_malloc(size);
+}
+
+extern "C" void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    if (s_count_allocations) {
+        s_allocations++;
+    }
+    return __real_calloc(nmemb, size);
 }
 
 // TODO: IDF-2693, function definition just to satisfy linker, implement esp_common instead
@@ -149,3 +286,214 @@ TEST_CASE("registering with ANY_BASE but specific ID fails")
                                           dummy_handler,
                                           nullptr) == ESP_ERR_INVALID_ARG);
 }
+
+TEST_CASE("dispatch throughput with many registered handlers")
+{
+    const int BASES = 16;
+    const int IDS = 8;
+    const int POSTED_IDS = IDS + 2; // two of the posted ids have no id level handlers
+    const int EVENTS = 20000;
+    static char base_names[BASES][8];
+    uint32_t id_calls[BASES][IDS] = {};
+    uint32_t base_calls[BASES] = {};
+    uint32_t loop_calls = 0;
+
+    FakeQueueFix fix;
+
+    esp_event_loop_handle_t loop = nullptr;
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.task_name = nullptr;
+    REQUIRE(ESP_OK == esp_event_loop_create(&loop_args, &loop));
+
+    // Registrations similar to a default loop shared by several components
+    REQUIRE(ESP_OK == esp_event_handler_register_with(loop, ESP_EVENT_ANY_BASE, ESP_EVENT_ANY_ID, counting_handler, &loop_calls));
+    for (int base = 0; base < BASES; base++) {
+        snprintf(base_names[base], sizeof(base_names[base]), "BASE%d", base);
+        for (int id = 0; id < IDS; id++) {
+            REQUIRE(ESP_OK == esp_event_handler_register_with(loop, base_names[base], id, counting_handler, &id_calls[base][id]));
+        }
+        REQUIRE(ESP_OK == esp_event_handler_register_with(loop, base_names[base], ESP_EVENT_ANY_ID, counting_handler, &base_calls[base]));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < EVENTS; i++) {
+        int base = i % BASES;
+        int id = (i / BASES) % POSTED_IDS;
+        CHECK(ESP_OK == esp_event_post_to(loop, base_names[base], id, nullptr, 0, 0));
+        CHECK(ESP_OK == esp_event_loop_run(loop, portMAX_DELAY));
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    printf("dispatch of %d events to a loop with %d handlers: %lld ns per event\n",
+           EVENTS, BASES * (IDS + 1) + 1, static_cast<long long>(elapsed.count() / EVENTS));
+
+    uint32_t total_id_calls = 0, total_base_calls = 0;
+    for (int base = 0; base < BASES; base++) {
+        for (int id = 0; id < IDS; id++) {
+            total_id_calls += id_calls[base][id];
+        }
+        total_base_calls += base_calls[base];
+    }
+    CHECK(loop_calls == EVENTS);
+    CHECK(total_base_calls == EVENTS);
+    CHECK(total_id_calls < EVENTS);
+    CHECK(total_id_calls > 0);
+    CHECK(id_calls[1][2] == base_calls[1] / POSTED_IDS + ((base_calls[1] % POSTED_IDS) > 2));
+
+    CHECK(ESP_OK == esp_event_loop_delete(loop));
+}
+
+TEST_CASE("a handler registered during dispatch is called starting with the next event")
+{
+    FakeQueueFix fix;
+
+    esp_event_loop_handle_t loop = nullptr;
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.task_name = nullptr;
+    REQUIRE(ESP_OK == esp_event_loop_create(&loop_args, &loop));
+    registering_handler_arg_t arg = { loop, 0 };
+    REQUIRE(ESP_OK == esp_event_handler_register_with(loop, "BASE", 1, registering_handler, &arg));
+
+    // The handler registered for the event is not called for the event being dispatched
+    CHECK(ESP_OK == esp_event_post_to(loop, "BASE", 1, nullptr, 0, 0));
+    CHECK(ESP_OK == esp_event_loop_run(loop, portMAX_DELAY));
+    CHECK(arg.calls == 0);
+
+    CHECK(ESP_OK == esp_event_post_to(loop, "BASE", 1, nullptr, 0, 0));
+    CHECK(ESP_OK == esp_event_loop_run(loop, portMAX_DELAY));
+    CHECK(arg.calls == 1);
+
+    CHECK(ESP_OK == esp_event_loop_delete(loop));
+}
+
+TEST_CASE("posting to a loop with a payload pool does not allocate")
+{
+    const int EVENTS = 1000;
+    const uint32_t POOL_SIZE = 4;
+    uint8_t small_data[16] = {};
+    uint8_t large_data[128] = {};
+    uint32_t sum = 0;
+    uint32_t expected_sum = 0;
+    int failures = 0;
+
+    FakeQueueFix fix;
+
+    esp_event_loop_handle_t loop = nullptr;
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.task_name = nullptr;
+    loop_args.payload_pool_size = POOL_SIZE;
+    loop_args.payload_size = 32;
+    REQUIRE(ESP_OK == esp_event_loop_create(&loop_args, &loop));
+    REQUIRE(ESP_OK == esp_event_handler_register_with(loop, "BASE", ESP_EVENT_ANY_ID, summing_handler, &sum));
+
+    // The first event builds the dispatch index of the loop
+    CHECK(ESP_OK == esp_event_post_to(loop, "BASE", 0, small_data, sizeof(small_data), 0));
+    CHECK(ESP_OK == esp_event_loop_run(loop, portMAX_DELAY));
+
+    // Event data copied into the pool
+    s_allocations = 0;
+    s_count_allocations = true;
+    for (uint32_t i = 0; i < EVENTS; i++) {
+        memcpy(small_data, &i, sizeof(i));
+        expected_sum += i;
+        failures += esp_event_post_to(loop, "BASE", i, small_data, sizeof(small_data), 0) != ESP_OK;
+        failures += esp_event_loop_run(loop, portMAX_DELAY) != ESP_OK;
+    }
+    s_count_allocations = false;
+    uint32_t copied_allocations = s_allocations;
+
+    // Event data written into an acquired buffer
+    s_allocations = 0;
+    s_count_allocations = true;
+    for (uint32_t i = 0; i < EVENTS; i++) {
+        void *payload = nullptr;
+        if (esp_event_payload_acquire_with(loop, sizeof(i), &payload) != ESP_OK) {
+            failures++;
+            continue;
+        }
+        memcpy(payload, &i, sizeof(i));
+        expected_sum += i;
+        failures += esp_event_post_payload_to(loop, "BASE", i, payload, 0) != ESP_OK;
+        failures += esp_event_loop_run(loop, portMAX_DELAY) != ESP_OK;
+    }
+    s_count_allocations = false;
+    uint32_t acquired_allocations = s_allocations;
+
+    // Event data larger than the buffers is copied to the heap
+    s_allocations = 0;
+    s_count_allocations = true;
+    for (uint32_t i = 0; i < EVENTS; i++) {
+        memcpy(large_data, &i, sizeof(i));
+        expected_sum += i;
+        failures += esp_event_post_to(loop, "BASE", i, large_data, sizeof(large_data), 0) != ESP_OK;
+        failures += esp_event_loop_run(loop, portMAX_DELAY) != ESP_OK;
+    }
+    s_count_allocations = false;
+    uint32_t large_allocations = s_allocations;
+
+    printf("heap allocations per post: %.2f copied to the pool, %.2f acquired from the pool, %.2f larger than the pool\n",
+           static_cast<double>(copied_allocations) / EVENTS, static_cast<double>(acquired_allocations) / EVENTS,
+           static_cast<double>(large_allocations) / EVENTS);
+
+    CHECK(failures == 0);
+    CHECK(sum == expected_sum);
+    CHECK(copied_allocations == 0);
+    CHECK(acquired_allocations == 0);
+    CHECK(large_allocations == EVENTS);
+
+    void *payloads[POOL_SIZE];
+    void *payload = nullptr;
+    CHECK(ESP_ERR_INVALID_ARG == esp_event_payload_acquire_with(loop, 33, &payload));
+    for (uint32_t i = 0; i < POOL_SIZE; i++) {
+        CHECK(ESP_OK == esp_event_payload_acquire_with(loop, 32, &payloads[i]));
+    }
+    CHECK(ESP_ERR_NO_MEM == esp_event_payload_acquire_with(loop, 1, &payload));
+    CHECK(ESP_ERR_INVALID_ARG == esp_event_payload_release_with(loop, small_data));
+    CHECK(ESP_ERR_INVALID_ARG == esp_event_post_payload_to(loop, "BASE", 0, small_data, 0));
+
+    // A payload which could not be posted still belongs to the caller
+    for (uint32_t i = 0; i < QUEUE_SIZE; i++) {
+        CHECK(ESP_OK == esp_event_post_to(loop, "BASE", 0, nullptr, 0, 0));
+    }
+    CHECK(ESP_ERR_TIMEOUT == esp_event_post_payload_to(loop, "BASE", 0, payloads[0], 0));
+    for (uint32_t i = 0; i < POOL_SIZE; i++) {
+        CHECK(ESP_OK == esp_event_payload_release_with(loop, payloads[i]));
+    }
+    CHECK(ESP_ERR_INVALID_ARG == esp_event_payload_release_with(loop, payloads[0]));
+
+    CHECK(ESP_OK == esp_event_loop_delete(loop));
+}
+
+TEST_CASE("queued events are dispatched in batches")
+{
+    const uint32_t BATCH_SIZE = 4;
+    const uint32_t EVENTS = 10;
+    uint32_t calls = 0;
+
+    FakeQueueFix fix(counting_mutex_take);
+
+    esp_event_loop_handle_t loop = nullptr;
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.task_name = nullptr;
+    loop_args.run_batch_size = BATCH_SIZE;
+    REQUIRE(ESP_OK == esp_event_loop_create(&loop_args, &loop));
+    REQUIRE(ESP_OK == esp_event_handler_register_with(loop, "BASE", ESP_EVENT_ANY_ID, counting_handler, &calls));
+
+    for (uint32_t i = 0; i < EVENTS; i++) {
+        CHECK(ESP_OK == esp_event_post_to(loop, "BASE", i, nullptr, 0, 0));
+    }
+
+    // The mutex is taken once per batch of queued events
+    s_mutex_takes = 0;
+    CHECK(ESP_OK == esp_event_loop_run(loop, portMAX_DELAY));
+    CHECK(calls == EVENTS);
+    CHECK(s_mutex_takes == (EVENTS + BATCH_SIZE - 1) / BATCH_SIZE);
+
+    // A batch is not delayed waiting for more events
+    CHECK(ESP_OK == esp_event_post_to(loop, "BASE", 0, nullptr, 0, 0));
+    s_mutex_takes = 0;
+    CHECK(ESP_OK == esp_event_loop_run(loop, portMAX_DELAY));
+    CHECK(calls == EVENTS + 1);
+    CHECK(s_mutex_takes == 1);
+
+    CHECK(ESP_OK == esp_event_loop_delete(loop));
+}
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -29,6 +29,12 @@ typedef struct {
     uint32_t task_stack_size;                   /**< stack size of the event loop task, ignored if task name is NULL */
     BaseType_t task_core_id;                    /**< core to which the event loop task is pinned to,
                                                         ignored if task name is NULL */
+    uint32_t payload_pool_size;                 /**< number of buffers for event data allocated with the loop,
+                                                        0 to allocate the data of each event from the heap */
+    size_t payload_size;                        /**< size of each buffer of the payload pool, event data up to
+                                                        this size is posted without allocating memory */
+    uint32_t run_batch_size;                    /**< maximum number of queued events dispatched each time the loop
+                                                        mutex is taken, 0 or 1 to take it for every event */
 } esp_event_loop_args_t;
 
 /**
@@ -92,6 +98,10 @@ esp_err_t esp_event_loop_delete_default(void);
  * execution. The guaranteed time of exit is therefore the allotted time + amount of time required to dispatch
  * the last dequeued event.
  *
+ * If the loop was created with esp_event_loop_args_t::run_batch_size greater than 1, the events already in the queue
+ * are dequeued and dispatched in batches of up to that many events, holding the loop mutex for the whole batch.
+ * The allotted time is then checked after each batch instead of after each event.
+ *
  * In cases where waiting on the queue times out, ESP_OK is returned and not ESP_ERR_TIMEOUT, since it is
  * normal behavior.
  *
@@ -156,6 +166,9 @@ esp_err_t esp_event_handler_register(esp_event_base_t event_base,
  * @note the event loop library does not maintain a copy of event_handler_arg, therefore the user should
  * ensure that event_handler_arg still points to a valid location by the time the handler gets called
  *
+ * @note a handler registered while the loop dispatches an event, e.g. by another handler, is called starting with
+ * the next event dispatched by the loop
+ *
  * @return
  *  - ESP_OK: Success
  *  - ESP_ERR_NO_MEM: Cannot allocate memory for the handler
@@ -203,6 +216,9 @@ esp_err_t esp_event_handler_register_with(esp_event_loop_handle_t event_loop,
  *
  * @note Calling this function with instance set to NULL is equivalent to calling esp_event_handler_register_with.
  *
+ * @note a handler registered while the loop dispatches an event, e.g. by another handler, is called starting with
+ * the next event dispatched by the loop
+ *
  * @return
  *  - ESP_OK: Success
  *  - ESP_ERR_NO_MEM: Cannot allocate memory for the handler
@@ -376,6 +392,9 @@ esp_err_t esp_event_post(esp_event_base_t event_base,
  * This function behaves in the same manner as esp_event_post, except the additional specification of the event loop
  * to post the event to.
  *
+ * If the loop has a payload pool and event_data fits into its buffers, the copy is made into a free buffer
+ * of the pool instead of memory allocated from the heap.
+ *
  * @param[in] event_loop the event loop to post to, must not be NULL
  * @param[in] event_base the event base that identifies the event
  * @param[in] event_id the event ID that identifies the event
@@ -397,6 +416,118 @@ esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop,
                             size_t event_data_size,
                             TickType_t ticks_to_wait);
 
+/**
+ * @brief Acquires a buffer from the payload pool of the system default event loop, to be filled with event
+ * data and posted by esp_event_post_payload() without copying it.
+ *
+ * @param[in] size the size of the event data
+ * @param[out] payload the buffer, of at least the requested size
+ *
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_NO_MEM: All the buffers of the pool are in use
+ *  - ESP_ERR_INVALID_ARG: Size larger than the buffers of the pool
+ *  - ESP_ERR_INVALID_STATE: The default event loop has not been created or has no payload pool
+ */
+esp_err_t esp_event_payload_acquire(size_t size, void **payload);
+
+/**
+ * @brief Acquires a buffer from the payload pool of the specified event loop, to be filled with event
+ * data and posted by esp_event_post_payload_to() without copying it.
+ *
+ * The size of the buffers and their number are set by esp_event_loop_args_t::payload_size and
+ * esp_event_loop_args_t::payload_pool_size when the loop is created. This function does not block
+ * and does not allocate memory. A buffer which is not posted must be released with
+ * esp_event_payload_release_with() before the loop is deleted.
+ *
+ * @param[in] event_loop the event loop, must not be NULL
+ * @param[in] size the size of the event data
+ * @param[out] payload the buffer, of at least the requested size
+ *
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_NO_MEM: All the buffers of the pool are in use
+ *  - ESP_ERR_INVALID_ARG: Size larger than the buffers of the pool
+ *  - ESP_ERR_INVALID_STATE: The loop has no payload pool
+ */
+esp_err_t esp_event_payload_acquire_with(esp_event_loop_handle_t event_loop, size_t size, void **payload);
+
+/**
+ * @brief Returns a buffer acquired by esp_event_payload_acquire(), which was not posted, to the pool of the
+ * system default event loop.
+ *
+ * @param[in] payload the buffer
+ *
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_INVALID_ARG: The buffer is not from the pool of the loop
+ *  - ESP_ERR_INVALID_STATE: The default event loop has not been created
+ */
+esp_err_t esp_event_payload_release(void *payload);
+
+/**
+ * @brief Returns a buffer acquired by esp_event_payload_acquire_with(), which was not posted, to the pool of
+ * the specified event loop.
+ *
+ * @param[in] event_loop the event loop, must not be NULL
+ * @param[in] payload the buffer
+ *
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_INVALID_ARG: The buffer is not from the pool of the loop
+ */
+esp_err_t esp_event_payload_release_with(esp_event_loop_handle_t event_loop, void *payload);
+
+/**
+ * @brief Posts an event to the system default event loop, with data in a buffer acquired by
+ * esp_event_payload_acquire(). The data is not copied.
+ *
+ * @param[in] event_base the event base that identifies the event
+ * @param[in] event_id the event ID that identifies the event
+ * @param[in] payload the buffer with the event data, passed to the handlers
+ * @param[in] ticks_to_wait number of ticks to block on a full event queue
+ *
+ * @return
+ *  - ESP_OK: Success, the loop returns the buffer to the pool once the handlers have run
+ *  - ESP_ERR_TIMEOUT: Time to wait for event queue to unblock expired
+ *  - ESP_ERR_INVALID_ARG: Invalid combination of event base and event ID, buffer not from the pool of the loop
+ *  - ESP_ERR_INVALID_STATE: The default event loop has not been created
+ *
+ * @note On failure, the buffer still belongs to the caller, who can post it again or release it with
+ *       esp_event_payload_release().
+ */
+esp_err_t esp_event_post_payload(esp_event_base_t event_base,
+                                 int32_t event_id,
+                                 void *payload,
+                                 TickType_t ticks_to_wait);
+
+/**
+ * @brief Posts an event to the specified event loop, with data in a buffer acquired by
+ * esp_event_payload_acquire_with(). The data is not copied.
+ *
+ * This function behaves in the same manner as esp_event_post_payload, except the additional specification
+ * of the event loop to post the event to.
+ *
+ * @param[in] event_loop the event loop to post to, must not be NULL
+ * @param[in] event_base the event base that identifies the event
+ * @param[in] event_id the event ID that identifies the event
+ * @param[in] payload the buffer with the event data, passed to the handlers
+ * @param[in] ticks_to_wait number of ticks to block on a full event queue
+ *
+ * @return
+ *  - ESP_OK: Success, the loop returns the buffer to the pool once the handlers have run
+ *  - ESP_ERR_TIMEOUT: Time to wait for event queue to unblock expired
+ *  - ESP_ERR_INVALID_ARG: Invalid combination of event base and event ID, buffer not from the pool of the loop
+ *
+ * @note On failure, the buffer still belongs to the caller, who can post it again or release it with
+ *       esp_event_payload_release_with().
+ */
+esp_err_t esp_event_post_payload_to(esp_event_loop_handle_t event_loop,
+                                    esp_event_base_t event_base,
+                                    int32_t event_id,
+                                    void *payload,
+                                    TickType_t ticks_to_wait);
+
 #if CONFIG_ESP_EVENT_POST_FROM_ISR
 /**
  * @brief Special variant of esp_event_post for posting events from interrupt handlers.
@@ -475,12 +606,15 @@ esp_err_t esp_event_isr_post_to(esp_event_loop_handle_t event_loop,
   where:
 
    event loop
-       format: address,name rx:total_received dr:total_dropped
+       format: address,name rx:total_received dr:total_dropped bt:total_batches ev/bt:events_per_batch time:total_runtime
        where:
            address - memory address of the event loop
            name - name of the event loop, 'none' if no dedicated task
            total_received - number of successfully posted events
            total_dropped - number of events unsuccessfully posted due to queue being full
+           total_batches - number of times the loop mutex was taken to dispatch events
+           events_per_batch - average number of events dispatched per batch
+           total_runtime - total amount of time used for dispatching events
 
    handler
        format: address ev:base,id inv:total_invoked run:total_runtime
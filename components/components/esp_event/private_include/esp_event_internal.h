@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -66,6 +66,37 @@ typedef struct esp_event_loop_node {
 
 typedef SLIST_HEAD(esp_event_loop_nodes, esp_event_loop_node) esp_event_loop_nodes_t;
 
+/// Handlers to execute for an event, in the order they are executed
+typedef struct esp_event_dispatch_entry {
+    esp_event_base_t base;                                          /**< base identifier of the event */
+    int32_t id;                                                     /**< id of the event, ESP_EVENT_ANY_ID for the events
+                                                                            of the base without id level handlers */
+    size_t handlers_count;                                          /**< number of handlers to execute */
+    esp_event_handler_node_t** handlers;                            /**< handlers to execute */
+    struct esp_event_dispatch_entry* next;                          /**< next entry in the same hash bucket */
+} esp_event_dispatch_entry_t;
+
+/// Index of the registered handlers by event base and id, built from the lists of the loop
+typedef struct esp_event_dispatch_index {
+    size_t buckets_mask;                                            /**< number of hash buckets - 1 */
+    esp_event_dispatch_entry_t** buckets;                           /**< hash buckets of the entries */
+    esp_event_dispatch_entry_t* entries;                            /**< entries, one per event base and id with
+                                                                            id level handlers and one per event base */
+    size_t entries_count;                                           /**< number of entries used */
+    esp_event_dispatch_entry_t loop_entry;                          /**< loop level handlers only, for events of
+                                                                            the bases without handlers */
+    esp_event_handler_node_t** handlers;                            /**< storage of the handlers of all the entries */
+} esp_event_dispatch_index_t;
+
+/// Preallocated buffers for the data of the events posted to a loop
+typedef struct esp_event_payload_pool {
+    uint8_t* buffers;                                               /**< storage of the buffers, NULL if the loop has no pool */
+    size_t buffer_size;                                             /**< usable size of each buffer */
+    size_t stride;                                                  /**< distance between the starts of two buffers */
+    uint32_t count;                                                 /**< number of buffers */
+    atomic_uint_least32_t* in_use;                                  /**< bitmap of the buffers in use, one bit per buffer */
+} esp_event_payload_pool_t;
+
 /// Event loop
 typedef struct esp_event_loop_instance {
     const char* name;                                               /**< name of this event loop */
@@ -76,9 +107,20 @@ typedef struct esp_event_loop_instance {
     SemaphoreHandle_t mutex;                                        /**< mutex for updating the events linked list */
     esp_event_loop_nodes_t loop_nodes;                              /**< set of linked lists containing the
                                                                             registered handlers for the loop */
+    esp_event_dispatch_index_t* dispatch_index;                     /**< index of loop_nodes used to dispatch events */
+    bool dispatch_index_stale;                                      /**< handlers were registered or removed since
+                                                                            the index was built */
+    uint32_t dispatch_depth;                                        /**< number of events being dispatched, the index is
+                                                                            only rebuilt when it is not in use */
+    esp_event_payload_pool_t payload_pool;                          /**< buffers for the event data */
+    uint32_t run_batch_size;                                        /**< maximum number of events dispatched per
+                                                                            acquisition of the mutex */
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
     atomic_uint_least32_t events_received;                          /**< number of events successfully posted to the loop */
     atomic_uint_least32_t events_dropped;                           /**< number of events dropped due to queue being full */
+    uint32_t batches;                                               /**< number of batches of events dispatched */
+    uint32_t events_dispatched;                                     /**< number of events dispatched */
+    int64_t time;                                                   /**< total time spent dispatching events */
     SLIST_ENTRY(esp_event_loop_instance) next;                      /**< next event loop in the list */
 #endif
 } esp_event_loop_instance_t;
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -55,6 +55,7 @@ initializer that should be kept in sync
         .stack_size         = 4096,                     \
         .core_id            = tskNO_AFFINITY,           \
         .task_caps          = (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT),       \
+        .worker_count       = 0,                        \
         .max_req_hdr_len    = CONFIG_HTTPD_MAX_REQ_HDR_LEN,    \
         .max_uri_len        = CONFIG_HTTPD_MAX_URI_LEN,        \
         .server_port        = 80,                       \
@@ -175,6 +176,23 @@ typedef struct httpd_config {
     BaseType_t  core_id;            /*!< The core the HTTP server task will run on */
     uint32_t    task_caps;          /*!< The memory capabilities to use when allocating the HTTP server task's stack */
 
+    /**
+     * Number of worker tasks running the requests, 0 to run them in the server task.
+     *
+     * With worker tasks, the server task waits for data on the sessions and accepts
+     * connections, and hands each session with incoming data over to a worker, so that
+     * a slow URI handler does not hold up the other clients. The requests of a session
+     * are always run by the same worker, one after the other, and a slow request still
+     * delays the other sessions of its worker. The workers are created with the priority,
+     * stack size, core and stack memory capabilities of the server task.
+     *
+     * URI handlers of different sessions then run concurrently, and must protect the
+     * data they share. The sessions belong to the server task: the changes the handlers
+     * make with httpd_sess_set_pending_override() and httpd_sess_update_lru_counter()
+     * are made by the server task, after the work they queue with httpd_queue_work().
+     */
+    uint16_t    worker_count;
+
     /**
      * Size limits for the header and URI buffers respectively.
      * These are just limits, allocation would depend upon actual size of URI/header.
@@ -710,6 +728,32 @@ esp_err_t httpd_register_err_handler(httpd_handle_t handle,
  */
 typedef int (*httpd_send_func_t)(httpd_handle_t hd, int sockfd, const char *buf, size_t buf_len, int flags);
 
+struct iovec;
+
+/**
+ * @brief  Prototype for HTTPDs low-level gathered send function
+ *
+ * Sends the buffers one after the other, like sendmsg() or writev(), so that
+ * a response made of several buffers can be sent with a single call.
+ *
+ * @note   User specified sendv function must handle errors internally,
+ *         depending upon the set value of errno, and return specific
+ *         HTTPD_SOCK_ERR_ codes, which will eventually be conveyed as
+ *         return value of the response functions
+ *
+ * @param[in] hd        server instance
+ * @param[in] sockfd    session socket file descriptor
+ * @param[in] iov       buffers with bytes to send
+ * @param[in] iovcnt    number of buffers
+ * @param[in] flags     flags for the sendmsg() function
+ * @return
+ *  - Bytes : The number of bytes sent successfully, possibly ending in the middle of a buffer
+ *  - HTTPD_SOCK_ERR_INVALID  : Invalid arguments
+ *  - HTTPD_SOCK_ERR_TIMEOUT  : Timeout/interrupted while calling socket sendmsg()
+ *  - HTTPD_SOCK_ERR_FAIL     : Unrecoverable error while calling socket sendmsg()
+ */
+typedef int (*httpd_sendv_func_t)(httpd_handle_t hd, int sockfd, const struct iovec *iov, int iovcnt, int flags);
+
 /**
  * @brief  Prototype for HTTPDs low-level recv function
  *
@@ -802,6 +846,31 @@ esp_err_t httpd_sess_set_recv_override(httpd_handle_t hd, int sockfd, httpd_recv
  */
 esp_err_t httpd_sess_set_send_override(httpd_handle_t hd, int sockfd, httpd_send_func_t send_func);
 
+/**
+ * @brief   Override web server's gathered send function (by session FD)
+ *
+ * This function overrides the web server's gathered send function. This function
+ * is used to send out responses made of several buffers, like the headers and the
+ * body, in one call. Without it, the buffers are sent one by one with the send function.
+ *
+ * @note    Overriding the send function with httpd_sess_set_send_override() removes the
+ *          gathered send function, as the default one would bypass the new send function.
+ *          A transport providing both must set the gathered send function after the send function.
+ *
+ * @note    This API is supposed to be called either from the context of
+ *          - an http session APIs where sockfd is a valid parameter
+ *          - a URI handler where sockfd is obtained using httpd_req_to_sockfd()
+ *
+ * @param[in] hd         HTTPD instance handle
+ * @param[in] sockfd     Session socket FD
+ * @param[in] sendv_func The gathered send function to be set for this session, NULL to send buffers one by one
+ *
+ * @return
+ *  - ESP_OK : On successfully registering override
+ *  - ESP_ERR_INVALID_ARG : Null arguments
+ */
+esp_err_t httpd_sess_set_sendv_override(httpd_handle_t hd, int sockfd, httpd_sendv_func_t sendv_func);
+
 /**
  * @brief   Override web server's pending function (by session FD)
  *
@@ -812,6 +881,11 @@ esp_err_t httpd_sess_set_send_override(httpd_handle_t hd, int sockfd, httpd_send
  *          - an http session APIs where sockfd is a valid parameter
  *          - a URI handler where sockfd is obtained using httpd_req_to_sockfd()
  *
+ * @note    With worker tasks (see httpd_config_t::worker_count), the server
+ *          task takes the new function into account with httpd_queue_work(),
+ *          when this API is called from another task, e.g. a URI handler run
+ *          by a worker.
+ *
  * @param[in] hd           HTTPD instance handle
  * @param[in] sockfd       Session socket FD
  * @param[in] pending_func The receive function to be set for this session
@@ -1598,6 +1672,10 @@ esp_err_t httpd_sess_trigger_close(httpd_handle_t handle, int sockfd);
  * @note    Calling this API is only necessary if the LRU Purge Enable option
  *          is enabled.
  *
+ * @note    With worker tasks (see httpd_config_t::worker_count), the LRU
+ *          counter is updated by the server task, with httpd_queue_work(), when
+ *          this API is called from another task, e.g. a URI handler run by a worker.
+ *
  * @param[in] handle    Handle to server returned by httpd_start
  * @param[in] sockfd    The socket descriptor of the session for which LRU counter
  *                      is to be updated
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -9,6 +9,7 @@
 #define _HTTPD_PRIV_H_
 
 #include <stdbool.h>
+#include <stdatomic.h>
 #include <sys/socket.h>
 #include <sys/param.h>
 #include <netinet/in.h>
@@ -16,6 +17,8 @@
 #include <esp_err.h>
 
 #include <esp_http_server.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
 #include "osal.h"
 
 #ifdef __cplusplus
@@ -62,6 +65,7 @@ struct sock_db {
     httpd_free_ctx_fn_t free_ctx;      /*!< Function for freeing the context */
     httpd_free_ctx_fn_t free_transport_ctx; /*!< Function for freeing the 'transport' context */
     httpd_send_func_t send_fn;              /*!< Send function for this socket */
+    httpd_sendv_func_t sendv_fn;            /*!< Gathered send function for this socket, NULL to use send_fn */
     httpd_recv_func_t recv_fn;              /*!< Receive function for this socket */
     httpd_pending_func_t pending_fn;        /*!< Pending function for this socket */
     uint64_t lru_counter;                   /*!< LRU Counter indicating when the socket was last used */
@@ -69,6 +73,8 @@ struct sock_db {
     char pending_data[PARSER_BLOCK_SIZE];   /*!< Buffer for pending data to be received */
     size_t pending_len;                     /*!< Length of pending data to be received */
     bool for_async_req;                     /*!< If true, the socket will not be LRU purged */
+    bool in_worker;                         /*!< A worker task is processing a request of this socket */
+    bool close_pending;                     /*!< Close the socket once its worker task is done with it */
 #ifdef CONFIG_HTTPD_WS_SUPPORT
     bool ws_handshake_done;                 /*!< True if it has done WebSocket handshake (if this socket is a valid WS) */
     bool ws_close;                          /*!< Set to true to close the socket later (when WS Close frame received) */
@@ -108,6 +114,17 @@ struct httpd_req_aux {
 #endif
 };
 
+/**
+ * @brief   Worker task running requests, see httpd_config_t::worker_count
+ */
+struct httpd_worker {
+    struct httpd_data *hd;                  /*!< Server instance data */
+    struct thread_data td;                  /*!< Information for the worker thread */
+    QueueHandle_t queue;                    /*!< Sessions with a request to run, NULL to stop */
+    struct httpd_req req;                   /*!< The request being run */
+    struct httpd_req_aux req_aux;           /*!< Additional data about the request */
+};
+
 /**
  * @brief   Server data for each instance. This is exposed publicly as
  *          httpd_handle_t but internal structure/members are kept private.
@@ -123,9 +140,20 @@ struct httpd_data {
     struct thread_data hd_td;               /*!< Information for the HTTPD thread */
     struct sock_db *hd_sd;                  /*!< The socket database */
     int hd_sd_active_count;                 /*!< The number of the active sockets */
+    struct sock_db *hd_fd_map[FD_SETSIZE];  /*!< The active sessions, indexed by socket descriptor */
+    fd_set hd_read_set;                     /*!< Descriptors to wait for: listener, ctrl and sessions not used asynchronously */
+    fd_set hd_pending_set;                  /*!< Sessions which may have pending data, see httpd_sess_pending() */
+    fd_set hd_async_set;                    /*!< Sessions in use by asynchronous request handlers */
+    int hd_async_count;                     /*!< The number of sessions in hd_async_set */
+    int hd_max_fd;                          /*!< Highest descriptor of hd_read_set and hd_async_set */
     httpd_uri_t **hd_calls;                 /*!< Registered URI handlers */
+    struct httpd_uri_router *hd_router;     /*!< Radix tree of the URIs of hd_calls, NULL to scan them one by one */
+    SemaphoreHandle_t hd_calls_mutex;       /*!< Guards hd_calls and hd_router against the worker tasks, NULL without them */
     struct httpd_req hd_req;                /*!< The current HTTPD request */
     struct httpd_req_aux hd_req_aux;        /*!< Additional data about the HTTPD request kept unexposed */
+    struct httpd_worker *hd_workers;        /*!< Worker tasks running the requests, NULL to run them in the server task */
+    QueueHandle_t hd_workers_done;          /*!< Results of the requests run by the worker tasks */
+    atomic_bool hd_workers_wake;            /*!< A worker task woke up the server task, which did not collect the results yet */
     uint64_t lru_counter;                   /*!< LRU counter */
 
     /* Array of registered error handler functions */
@@ -180,6 +208,8 @@ void httpd_sess_delete_invalid(struct httpd_data *hd);
 
 /**
  * @brief   Initializes an http session by resetting the sockets database.
+ *          The listener and ctrl sockets must be created beforehand, as
+ *          they are added to the descriptors to wait for.
  *
  * @param[in] hd    Server instance data
  */
@@ -228,15 +258,77 @@ void httpd_sess_delete(struct httpd_data *hd, struct sock_db *session);
 void httpd_sess_free_ctx(void **ctx, httpd_free_ctx_fn_t free_fn);
 
 /**
- * @brief   Add descriptors present in the socket database to an fdset and
- *          update the value of maxfd which are needed by the select function
- *          for looking through all available sockets for incoming data.
+ * @brief   Get the descriptors to wait for incoming data, to pass to select().
+ *
+ * The set is maintained as sessions are opened, closed and used by asynchronous
+ * request handlers, so this only copies it. Sessions whose asynchronous request
+ * handler completed since the last call are waited for again.
  *
  * @param[in]  hd    Server instance data
- * @param[out] fdset File descriptor set to be updated.
- * @param[out] maxfd Maximum value among all file descriptors.
+ * @param[out] fdset File descriptor set to be filled
+ *
+ * @return  Maximum value among the descriptors of the set
+ */
+int httpd_sess_get_descriptors(struct httpd_data *hd, fd_set *fdset);
+
+/**
+ * @brief   Process the sessions which received data, or which have pending data
+ *
+ * Only the sessions whose descriptor is in the set returned by select(), or which
+ * may have pending data, are looked at. The sessions which fail to process a
+ * request are closed.
+ *
+ * @param[in] hd      Server instance data
+ * @param[in] fdset   Descriptors ready for reading, as returned by select()
+ * @param[in] maxfd   Maximum descriptor passed to select()
+ */
+void httpd_sess_process_ready(struct httpd_data *hd, const fd_set *fdset, int maxfd);
+
+/**
+ * @brief   Track whether a session may have pending data, after its
+ *          pending function or its pending data buffer changed
+ *
+ * With worker tasks, the other tasks than the server task queue the
+ * update as work for the server task.
+ *
+ * @param[in] hd      Server instance data
+ * @param[in] session Session
+ */
+void httpd_sess_update_pending(struct httpd_data *hd, struct sock_db *session);
+
+/**
+ * @brief   Hand a session over to an asynchronous request handler
+ *
+ * The server stops waiting for data on the session until the handler
+ * completes, i.e. until for_async_req is cleared.
+ *
+ * @param[in] hd      Server instance data
+ * @param[in] session Session
  */
-void httpd_sess_set_descriptors(struct httpd_data *hd, fd_set *fdset, int *maxfd);
+void httpd_sess_async_begin(struct httpd_data *hd, struct sock_db *session);
+
+/**
+ * @brief   Hand a session over to a worker task, see httpd_worker_dispatch()
+ *
+ * The server stops waiting for data on the session until httpd_sess_worker_done().
+ *
+ * @param[in] hd      Server instance data
+ * @param[in] session Session
+ */
+void httpd_sess_worker_begin(struct httpd_data *hd, struct sock_db *session);
+
+/**
+ * @brief   Take a session back from a worker task which ran a request of it
+ *
+ * The session is closed if the request failed or a close was requested meanwhile,
+ * else the server waits for data on it again, unless an asynchronous request
+ * handler still uses it.
+ *
+ * @param[in] hd      Server instance data
+ * @param[in] session Session
+ * @param[in] ret     Result of the request
+ */
+void httpd_sess_worker_done(struct httpd_data *hd, struct sock_db *session, esp_err_t ret);
 
 /**
  * @brief   Checks if session can accept another connection from new client.
@@ -307,12 +399,13 @@ void httpd_sess_close_all(struct httpd_data *hd);
  *          and invokes the appropriate one if found
  *
  * @param[in] hd  Server instance data for which handler needs to be invoked
+ * @param[in] r   The parsed request
  *
  * @return
  *  - ESP_OK    : if handler found and executed successfully
  *  - ESP_FAIL  : otherwise
  */
-esp_err_t httpd_uri(struct httpd_data *hd);
+esp_err_t httpd_uri(struct httpd_data *hd, httpd_req_t *r);
 
 /**
  * @brief   Unregister all URI handlers
@@ -361,25 +454,27 @@ bool httpd_validate_req_ptr(httpd_req_t *r);
  * http_recv() after this reads the body of the request.
  *
  * @param[in] hd  Server instance data
+ * @param[in] r   Request to fill, hd_req or the request of a worker task
+ * @param[in] ra  Additional data of the request
  * @param[in] sd  Pointer to socket which is needed for receiving TCP packets.
  *
  * @return
  *  - ESP_OK    : if request packet is valid
  *  - ESP_FAIL  : otherwise
  */
-esp_err_t httpd_req_new(struct httpd_data *hd, struct sock_db *sd);
+esp_err_t httpd_req_new(struct httpd_data *hd, httpd_req_t *r, struct httpd_req_aux *ra, struct sock_db *sd);
 
 /**
  * @brief   For an HTTP request, resets the resources allocated for it and
  *          purges any data left to be received
  *
- * @param[in] hd  Server instance data
+ * @param[in] r   Request filled by httpd_req_new()
  *
  * @return
  *  - ESP_OK    : if request packet deleted and resources cleaned.
  *  - ESP_FAIL  : otherwise.
  */
-esp_err_t httpd_req_delete(struct httpd_data *hd);
+esp_err_t httpd_req_delete(httpd_req_t *r);
 
 /**
  * @brief   For handling HTTP errors by invoking registered
@@ -476,6 +571,23 @@ size_t httpd_unrecv(struct httpd_req *r, const char *buf, size_t buf_len);
  */
 int httpd_default_send(httpd_handle_t hd, int sockfd, const char *buf, size_t buf_len, int flags);
 
+/**
+ * @brief   This is the low level default gathered send function of the HTTPD. This
+ *          should NEVER be called directly. The semantics of this is exactly similar
+ *          to sendmsg() of the BSD socket API, with the buffers given as an iovec array.
+ *
+ * @param[in] hd      Server instance data
+ * @param[in] sockfd  Socket descriptor for sending data
+ * @param[in] iov     Buffers to send, in order
+ * @param[in] iovcnt  Number of buffers
+ * @param[in] flags   Flags for mode selection
+ *
+ * @return
+ *  - Length of data : if successful
+ *  - -1             : if failed (appropriate errno is set)
+ */
+int httpd_default_sendv(httpd_handle_t hd, int sockfd, const struct iovec *iov, int iovcnt, int flags);
+
 /**
  * @brief   This is the low level default recv function of the HTTPD. This should
  *          NEVER be called directly. The semantics of this is exactly similar to
@@ -497,6 +609,79 @@ int httpd_default_recv(httpd_handle_t hd, int sockfd, char *buf, size_t buf_len,
  * @}
  */
 
+/****************** Group : Workers ********************/
+/** @name Workers
+ * Methods for running the requests in worker tasks, see httpd_config_t::worker_count
+ * @{
+ */
+
+/**
+ * @brief   Allocate the worker tasks data, if the configuration asks for workers
+ *
+ * @param[in] hd  Server instance data
+ *
+ * @return
+ *  - ESP_OK                  : on success, or without workers
+ *  - ESP_ERR_HTTPD_ALLOC_MEM : failed to allocate memory
+ */
+esp_err_t httpd_workers_create(struct httpd_data *hd);
+
+/**
+ * @brief   Free the worker tasks data, after httpd_workers_stop()
+ *
+ * @param[in] hd  Server instance data
+ */
+void httpd_workers_delete(struct httpd_data *hd);
+
+/**
+ * @brief   Launch the worker tasks
+ *
+ * @param[in] hd  Server instance data
+ *
+ * @return
+ *  - ESP_OK             : on success, or without workers
+ *  - ESP_ERR_HTTPD_TASK : failed to launch a task, the ones launched are stopped
+ */
+esp_err_t httpd_workers_start(struct httpd_data *hd);
+
+/**
+ * @brief   Stop the worker tasks, once they ran the requests handed over to them
+ *
+ * @param[in] hd  Server instance data
+ */
+void httpd_workers_stop(struct httpd_data *hd);
+
+/**
+ * @brief   Get the worker task running the requests of a session
+ *
+ * @param[in] hd      Server instance data, with workers
+ * @param[in] session Session
+ *
+ * @return  The worker task of the session
+ */
+struct httpd_worker *httpd_worker_get(struct httpd_data *hd, struct sock_db *session);
+
+/**
+ * @brief   Hand a session with incoming data over to its worker task.
+ *          To be called from the server task only.
+ *
+ * @param[in] hd      Server instance data
+ * @param[in] session Session
+ */
+void httpd_worker_dispatch(struct httpd_data *hd, struct sock_db *session);
+
+/**
+ * @brief   Take back the sessions the worker tasks are done with.
+ *          To be called from the server task only.
+ *
+ * @param[in] hd  Server instance data
+ */
+void httpd_workers_collect(struct httpd_data *hd);
+
+/** End of Group : Workers
+ * @}
+ */
+
 /* ************** Group: WebSocket ************** */
 /** @name WebSocket
  * Functions for WebSocket header parsing
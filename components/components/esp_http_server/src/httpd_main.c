@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2023 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -31,11 +31,6 @@ static const int DEFAULT_KEEP_ALIVE_IDLE = 5;
 static const int DEFAULT_KEEP_ALIVE_INTERVAL= 5;
 static const int DEFAULT_KEEP_ALIVE_COUNT= 3;
 
-typedef struct {
-    fd_set *fdset;
-    struct httpd_data *hd;
-} process_session_context_t;
-
 static const char *TAG = "httpd";
 
 ESP_EVENT_DEFINE_BASE(ESP_HTTP_SERVER_EVENT);
@@ -243,52 +238,17 @@ static void httpd_process_ctrl_msg(struct httpd_data *hd)
 #endif
 }
 
-// Called for each session from httpd_server
-static int httpd_process_session(struct sock_db *session, void *context)
-{
-    if ((!session) || (!context)) {
-        return 0;
-    }
-
-    if (session->fd < 0) {
-        return 1;
-    }
-
-    // session is busy in an async task, do not process here.
-    if (session->for_async_req) {
-        return 1;
-    }
-
-    process_session_context_t *ctx = (process_session_context_t *)context;
-    int fd = session->fd;
-
-    if (FD_ISSET(fd, ctx->fdset) || httpd_sess_pending(ctx->hd, session)) {
-        ESP_LOGD(TAG, LOG_FMT("processing socket %d"), fd);
-        if (httpd_sess_process(ctx->hd, session) != ESP_OK) {
-            httpd_sess_delete(ctx->hd, session); // Delete session
-        }
-    }
-    return 1;
-}
-
 /* Manage in-coming connection or data requests */
 static esp_err_t httpd_server(struct httpd_data *hd)
 {
     fd_set read_set;
-    FD_ZERO(&read_set);
-    if (hd->config.lru_purge_enable || httpd_is_sess_available(hd)) {
-        /* Only listen for new connections if server has capacity to
-         * handle more (or when LRU purge is enabled, in which case
+    int maxfd = httpd_sess_get_descriptors(hd, &read_set);
+    if (!hd->config.lru_purge_enable && !httpd_is_sess_available(hd)) {
+        /* Do not listen for new connections if server has no capacity
+         * to handle more (unless LRU purge is enabled, in which case
          * older connections will be closed) */
-        FD_SET(hd->listen_fd, &read_set);
+        FD_CLR(hd->listen_fd, &read_set);
     }
-    FD_SET(hd->ctrl_fd, &read_set);
-
-    int tmp_max_fd;
-    httpd_sess_set_descriptors(hd, &read_set, &tmp_max_fd);
-    int maxfd = MAX(hd->listen_fd, tmp_max_fd);
-    tmp_max_fd = maxfd;
-    maxfd = MAX(hd->ctrl_fd, tmp_max_fd);
 
     ESP_LOGD(TAG, LOG_FMT("doing select maxfd+1 = %d"), maxfd + 1);
     int active_cnt = select(maxfd + 1, &read_set, NULL, NULL, NULL);
@@ -310,11 +270,7 @@ static esp_err_t httpd_server(struct httpd_data *hd)
 
     /* Case1: Do we have any activity on the current data
      * sessions? */
-    process_session_context_t context = {
-        .fdset = &read_set,
-        .hd = hd
-    };
-    httpd_sess_enum(hd, httpd_process_session, &context);
+    httpd_sess_process_ready(hd, &read_set, maxfd);
 
     /* Case2: Do we have any incoming connection requests to
      * process? */
@@ -343,6 +299,8 @@ static void httpd_thread(void *arg)
     }
 
     ESP_LOGD(TAG, LOG_FMT("web server exiting"));
+    /* Let the workers finish their requests before closing the sessions */
+    httpd_workers_stop(hd);
     close(hd->msg_fd);
     cs_free_ctrl_sock(hd->ctrl_fd);
     httpd_sess_close_all(hd);
@@ -463,6 +421,14 @@ static struct httpd_data *httpd_create(const httpd_config_t *config)
     }
     /* Save the configuration for this instance */
     hd->config = *config;
+    if (httpd_workers_create(hd) != ESP_OK) {
+        free(hd->err_handler_fns);
+        free(ra->resp_hdrs);
+        free(hd->hd_sd);
+        free(hd->hd_calls);
+        free(hd);
+        return NULL;
+    }
     return hd;
 }
 
@@ -477,6 +443,7 @@ static void httpd_delete(struct httpd_data *hd)
     /* Free registered URI handlers */
     httpd_unregister_all_uri_handlers(hd);
     free(hd->hd_calls);
+    httpd_workers_delete(hd);
     free(hd);
 }
 
@@ -527,6 +494,10 @@ esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config)
     }
 
     httpd_sess_init(hd);
+    if (httpd_workers_start(hd) != ESP_OK) {
+        httpd_delete(hd);
+        return ESP_ERR_HTTPD_TASK;
+    }
     if (httpd_os_thread_create(&hd->hd_td.handle, "httpd",
                                hd->config.stack_size,
                                hd->config.task_priority,
@@ -534,6 +505,7 @@ esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config)
                                hd->config.core_id,
                                hd->config.task_caps) != ESP_OK) {
         /* Failed to launch task */
+        httpd_workers_stop(hd);
         httpd_delete(hd);
         return ESP_ERR_HTTPD_TASK;
     }
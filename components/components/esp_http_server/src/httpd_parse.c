@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -640,9 +640,8 @@ static void parse_init(httpd_req_t *r, http_parser *parser, parser_data_t *data)
 
 /* Function that receives TCP data and runs parser on it
  */
-static esp_err_t httpd_parse_req(struct httpd_data *hd)
+static esp_err_t httpd_parse_req(struct httpd_data *hd, httpd_req_t *r)
 {
-    httpd_req_t *r = &hd->hd_req;
     int blk_len,  offset;
     http_parser   parser = {};
     parser_data_t parser_data = {};
@@ -682,7 +681,7 @@ static esp_err_t httpd_parse_req(struct httpd_data *hd)
     } while (parser_data.status != PARSING_COMPLETE);
 
     ESP_LOGD(TAG, LOG_FMT("parsing complete"));
-    return httpd_uri(hd);
+    return httpd_uri(hd, r);
 }
 
 static void init_req(httpd_req_t *r, httpd_config_t *config)
@@ -754,16 +753,14 @@ static void httpd_req_cleanup(httpd_req_t *r)
 /* Function that processes incoming TCP data and
  * updates the http request data httpd_req_t
  */
-esp_err_t httpd_req_new(struct httpd_data *hd, struct sock_db *sd)
+esp_err_t httpd_req_new(struct httpd_data *hd, httpd_req_t *r, struct httpd_req_aux *ra, struct sock_db *sd)
 {
-    httpd_req_t *r = &hd->hd_req;
     init_req(r, &hd->config);
-    init_req_aux(&hd->hd_req_aux, &hd->config);
+    init_req_aux(ra, &hd->config);
     r->handle = hd;
-    r->aux = &hd->hd_req_aux;
+    r->aux = ra;
 
     /* Associate the request to the socket */
-    struct httpd_req_aux *ra = r->aux;
     ra->sd = sd;
 
     /* Set defaults */
@@ -818,7 +815,7 @@ esp_err_t httpd_req_new(struct httpd_data *hd, struct sock_db *sd)
 #endif
 
     /* Parse request */
-    ret = httpd_parse_req(hd);
+    ret = httpd_parse_req(hd, r);
     if (ret != ESP_OK) {
         httpd_req_cleanup(r);
     }
@@ -827,9 +824,8 @@ esp_err_t httpd_req_new(struct httpd_data *hd, struct sock_db *sd)
 
 /* Function that resets the http request data
  */
-esp_err_t httpd_req_delete(struct httpd_data *hd)
+esp_err_t httpd_req_delete(httpd_req_t *r)
 {
-    httpd_req_t *r = &hd->hd_req;
     struct httpd_req_aux *ra = r->aux;
 
     /* Finish off reading any pending/leftover data */
@@ -873,6 +869,12 @@ bool httpd_validate_req_ptr(httpd_req_t *r)
             if (httpd_os_thread_handle() == hd->hd_td.handle) {
                 return true;
             }
+            /* or of the worker task processing the request */
+            struct httpd_req_aux *ra = r->aux;
+            if (hd->hd_workers && ra && ra->sd &&
+                httpd_os_thread_handle() == httpd_worker_get(hd, ra->sd)->td.handle) {
+                return true;
+            }
         }
     }
     return false;
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2021 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -20,8 +20,6 @@ typedef enum {
     HTTPD_TASK_INIT,            // Init session
     HTTPD_TASK_GET_ACTIVE,      // Get active session (fd!=-1)
     HTTPD_TASK_GET_FREE,        // Get free session slot (fd<0)
-    HTTPD_TASK_FIND_FD,         // Find session with specific fd
-    HTTPD_TASK_SET_DESCRIPTOR,  // Set descriptor
     HTTPD_TASK_DELETE_INVALID,  // Delete invalid session
     HTTPD_TASK_FIND_LOWEST_LRU, // Find session with lowest lru
     HTTPD_TASK_CLOSE            // Close session
@@ -30,8 +28,6 @@ typedef enum {
 typedef struct {
     task_t task;
     int fd;
-    fd_set *fdset;
-    int max_fd;
     struct httpd_data *hd;
     uint64_t lru_counter;
     struct sock_db    *session;
@@ -82,22 +78,10 @@ static int enum_function(struct sock_db *session, void *context)
     case HTTPD_TASK_GET_FREE:
         found = (session->fd < 0);
         break;
-    // Find fd
-    case HTTPD_TASK_FIND_FD:
-        found = (session->fd == ctx->fd);
-        break;
-    // Set descriptor
-    case HTTPD_TASK_SET_DESCRIPTOR:
-        if (session->fd != -1 && !session->for_async_req) {
-            FD_SET(session->fd, ctx->fdset);
-            if (session->fd > ctx->max_fd) {
-                ctx->max_fd = session->fd;
-            }
-        }
-        break;
     // Delete invalid session
     case HTTPD_TASK_DELETE_INVALID:
-        if (!fd_is_valid(session->fd)) {
+        // Sessions handed over to a worker task are deleted once it is done
+        if (!session->in_worker && !fd_is_valid(session->fd)) {
             ESP_LOGW(TAG, LOG_FMT("Closing invalid socket %d"), session->fd);
             httpd_sess_delete(ctx->hd, session);
         }
@@ -109,7 +93,7 @@ static int enum_function(struct sock_db *session, void *context)
             return 0;
         }
         // Only close sockets that are not in use
-        if (session->for_async_req == false) {
+        if ((session->in_worker == false) && (session->for_async_req == false)) {
             // Check/update lowest lru
             if (session->lru_counter < ctx->lru_counter) {
                 ctx->lru_counter = session->lru_counter;
@@ -145,6 +129,11 @@ static void httpd_sess_close(void *arg)
         return;
     }
     sock_db->lru_socket = false;
+    if (sock_db->in_worker) {
+        // A worker task is using the session, close it when done
+        sock_db->close_pending = true;
+        return;
+    }
     struct httpd_data *hd = (struct httpd_data *) sock_db->handle;
     httpd_sess_delete(hd, sock_db);
 }
@@ -163,7 +152,7 @@ struct sock_db *httpd_sess_get_free(struct httpd_data *hd)
 
 bool httpd_is_sess_available(struct httpd_data *hd)
 {
-    return httpd_sess_get_free(hd) ? true : false;
+    return hd->hd_sd_active_count < hd->config.max_open_sockets;
 }
 
 struct sock_db *httpd_sess_get(struct httpd_data *hd, int sockfd)
@@ -178,18 +167,32 @@ struct sock_db *httpd_sess_get(struct httpd_data *hd, int sockfd)
         return hd->hd_req_aux.sd;
     }
 
-    enum_context_t context = {
-        .task = HTTPD_TASK_FIND_FD,
-        .fd = sockfd
-    };
-    httpd_sess_enum(hd, enum_function, &context);
-    return context.session;
+    if ((sockfd < 0) || (sockfd >= FD_SETSIZE)) {
+        return NULL;
+    }
+    return hd->hd_fd_map[sockfd];
+}
+
+// Lower hd_max_fd after its descriptor was removed from the sets
+static void update_max_fd(struct httpd_data *hd)
+{
+    while ((hd->hd_max_fd >= 0) &&
+            !FD_ISSET(hd->hd_max_fd, &hd->hd_read_set) &&
+            !FD_ISSET(hd->hd_max_fd, &hd->hd_async_set)) {
+        hd->hd_max_fd--;
+    }
 }
 
 esp_err_t httpd_sess_new(struct httpd_data *hd, int newfd)
 {
     ESP_LOGD(TAG, LOG_FMT("fd = %d"), newfd);
 
+    // select() can only wait for descriptors below FD_SETSIZE
+    if ((newfd < 0) || (newfd >= FD_SETSIZE)) {
+        ESP_LOGE(TAG, LOG_FMT("fd = %d out of range"), newfd);
+        return ESP_FAIL;
+    }
+
     if (httpd_sess_get(hd, newfd)) {
         ESP_LOGE(TAG, LOG_FMT("session already exists with fd = %d"), newfd);
         return ESP_FAIL;
@@ -206,11 +209,17 @@ esp_err_t httpd_sess_new(struct httpd_data *hd, int newfd)
     session->fd = newfd;
     session->handle = (httpd_handle_t) hd;
     session->send_fn = httpd_default_send;
+    session->sendv_fn = httpd_default_sendv;
     session->recv_fn = httpd_default_recv;
 
     // increment number of sessions
     hd->hd_sd_active_count++;
 
+    // wait for data on the new session
+    hd->hd_fd_map[newfd] = session;
+    FD_SET(newfd, &hd->hd_read_set);
+    hd->hd_max_fd = MAX(hd->hd_max_fd, newfd);
+
     // Call user-defined session opening function
     if (hd->config.open_fn) {
         esp_err_t ret = hd->config.open_fn(hd, session->fd);
@@ -258,6 +267,17 @@ void httpd_sess_clear_ctx(struct sock_db *session)
     }
 }
 
+// Get the request being processed for the session, if any
+static httpd_req_t *httpd_sess_get_req(struct httpd_data *hd, struct sock_db *session)
+{
+    httpd_req_t *req = &hd->hd_req;
+    if (hd->hd_workers) {
+        req = &httpd_worker_get(hd, session)->req;
+    }
+    struct httpd_req_aux *ra = req->aux;
+    return (ra && (ra->sd == session)) ? req : NULL;
+}
+
 void *httpd_sess_get_ctx(httpd_handle_t handle, int sockfd)
 {
     struct sock_db *session = httpd_sess_get(handle, sockfd);
@@ -269,8 +289,9 @@ void *httpd_sess_get_ctx(httpd_handle_t handle, int sockfd)
     // request handler, in which case fetch the context from
     // the httpd_req_t structure
     struct httpd_data *hd = (struct httpd_data *) handle;
-    if (hd->hd_req_aux.sd == session) {
-        return hd->hd_req.sess_ctx;
+    httpd_req_t *req = httpd_sess_get_req(hd, session);
+    if (req) {
+        return req->sess_ctx;
     }
     return session->ctx;
 }
@@ -286,16 +307,17 @@ void httpd_sess_set_ctx(httpd_handle_t handle, int sockfd, void *ctx, httpd_free
     // request handler, in which case set the context inside
     // the httpd_req_t structure
     struct httpd_data *hd = (struct httpd_data *) handle;
-    if (hd->hd_req_aux.sd == session) {
-        if (hd->hd_req.sess_ctx != ctx) {
+    httpd_req_t *req = httpd_sess_get_req(hd, session);
+    if (req) {
+        if (req->sess_ctx != ctx) {
             // Don't free previous context if it is in sockdb
             // as it will be freed inside httpd_req_cleanup()
-            if (session->ctx != hd->hd_req.sess_ctx) {
-                httpd_sess_free_ctx(&hd->hd_req.sess_ctx, hd->hd_req.free_ctx); // Free previous context
+            if (session->ctx != req->sess_ctx) {
+                httpd_sess_free_ctx(&req->sess_ctx, req->free_ctx); // Free previous context
             }
-            hd->hd_req.sess_ctx = ctx;
+            req->sess_ctx = ctx;
         }
-        hd->hd_req.free_ctx = free_fn;
+        req->free_ctx = free_fn;
         return;
     }
 
@@ -329,16 +351,161 @@ void httpd_sess_set_transport_ctx(httpd_handle_t handle, int sockfd, void *ctx,
     session->free_transport_ctx = free_fn;
 }
 
-void httpd_sess_set_descriptors(struct httpd_data *hd, fd_set *fdset, int *maxfd)
+// Wait for data on a session again
+static void httpd_sess_resume(struct httpd_data *hd, struct sock_db *session)
 {
-    enum_context_t context = {
-        .task = HTTPD_TASK_SET_DESCRIPTOR,
-        .max_fd = -1,
-        .fdset = fdset
-    };
-    httpd_sess_enum(hd, enum_function, &context);
-    if (maxfd) {
-        *maxfd = context.max_fd;
+    FD_CLR(session->fd, &hd->hd_async_set);
+    hd->hd_async_count--;
+    FD_SET(session->fd, &hd->hd_read_set);
+    httpd_sess_update_pending(hd, session);
+}
+
+/* With this many sessions or less, the session table is walked instead of the descriptor range. The range
+ * includes the descriptors of other sockets, and starts at LWIP_SOCKET_OFFSET with lwIP. */
+#define HTTPD_SESS_SCAN_MAX 16
+
+// Sessions whose asynchronous request handler completed are waited for again
+static void httpd_sess_resume_fd(struct httpd_data *hd, int fd)
+{
+    if (FD_ISSET(fd, &hd->hd_async_set) &&
+            !hd->hd_fd_map[fd]->in_worker && !hd->hd_fd_map[fd]->for_async_req) {
+        httpd_sess_resume(hd, hd->hd_fd_map[fd]);
+    }
+}
+
+int httpd_sess_get_descriptors(struct httpd_data *hd, fd_set *fdset)
+{
+    if (hd->hd_workers) {
+        httpd_workers_collect(hd);
+    }
+
+    // Asynchronous request handlers complete from other tasks: the sessions
+    // are waited for again from here, so that only this task changes the sets
+    if (hd->config.max_open_sockets <= HTTPD_SESS_SCAN_MAX) {
+        for (int i = 0; (hd->hd_async_count > 0) && (i < hd->config.max_open_sockets); i++) {
+            if (hd->hd_sd[i].fd >= 0) {
+                httpd_sess_resume_fd(hd, hd->hd_sd[i].fd);
+            }
+        }
+    } else {
+        for (int fd = 0; (hd->hd_async_count > 0) && (fd <= hd->hd_max_fd); fd++) {
+            httpd_sess_resume_fd(hd, fd);
+        }
+    }
+
+    *fdset = hd->hd_read_set;
+    return hd->hd_max_fd;
+}
+
+// Processes the session of a descriptor which is ready or may have pending data
+static void httpd_sess_process_fd(struct httpd_data *hd, int fd, bool ready)
+{
+    // The listener and ctrl sockets have no session. The handler run by a worker
+    // may be beginning an asynchronous request, for_async_req is only read after.
+    struct sock_db *session = hd->hd_fd_map[fd];
+    if ((!session) || session->in_worker || session->for_async_req) {
+        return;
+    }
+
+    if (ready || httpd_sess_pending(hd, session)) {
+        if (hd->hd_workers) {
+            httpd_worker_dispatch(hd, session);
+            return;
+        }
+        ESP_LOGD(TAG, LOG_FMT("processing socket %d"), fd);
+        if (httpd_sess_process(hd, session) != ESP_OK) {
+            httpd_sess_delete(hd, session); // Delete session
+        }
+    }
+}
+
+void httpd_sess_process_ready(struct httpd_data *hd, const fd_set *fdset, int maxfd)
+{
+    if (hd->config.max_open_sockets <= HTTPD_SESS_SCAN_MAX) {
+        for (int i = 0; i < hd->config.max_open_sockets; i++) {
+            int fd = hd->hd_sd[i].fd;
+            if ((fd < 0) || (fd > maxfd)) {
+                continue;
+            }
+            bool ready = FD_ISSET(fd, fdset);
+            if (ready || FD_ISSET(fd, &hd->hd_pending_set)) {
+                httpd_sess_process_fd(hd, fd, ready);
+            }
+        }
+        return;
+    }
+
+    for (int fd = 0; fd <= maxfd; fd++) {
+        bool ready = FD_ISSET(fd, fdset);
+        if (ready || FD_ISSET(fd, &hd->hd_pending_set)) {
+            httpd_sess_process_fd(hd, fd, ready);
+        }
+    }
+}
+
+/* With worker tasks, the sessions and the descriptor sets are only changed by the
+ * server task: the other tasks queue the changes as work for it, and give up on
+ * them once it is stopping */
+static bool httpd_sess_queue_change(struct httpd_data *hd, httpd_work_fn_t work, struct sock_db *session)
+{
+    if (!hd->hd_workers || httpd_os_thread_handle() == hd->hd_td.handle) {
+        return false;
+    }
+    if (hd->hd_td.status == THREAD_RUNNING && httpd_queue_work(hd, work, session) != ESP_OK) {
+        ESP_LOGW(TAG, LOG_FMT("failed to queue session update for fd = %d"), session->fd);
+    }
+    return true;
+}
+
+static void httpd_sess_update_pending_work(void *arg)
+{
+    struct sock_db *session = (struct sock_db *) arg;
+    httpd_sess_update_pending((struct httpd_data *) session->handle, session);
+}
+
+void httpd_sess_update_pending(struct httpd_data *hd, struct sock_db *session)
+{
+    if ((!hd) || (!session) || (session->fd < 0)) {
+        return;
+    }
+
+    if (httpd_sess_queue_change(hd, httpd_sess_update_pending_work, session)) {
+        return;
+    }
+
+    if (session->pending_fn || session->pending_len) {
+        FD_SET(session->fd, &hd->hd_pending_set);
+    } else {
+        FD_CLR(session->fd, &hd->hd_pending_set);
+    }
+}
+
+void httpd_sess_async_begin(struct httpd_data *hd, struct sock_db *session)
+{
+    session->for_async_req = true;
+    if (!FD_ISSET(session->fd, &hd->hd_async_set)) {
+        FD_CLR(session->fd, &hd->hd_read_set);
+        FD_SET(session->fd, &hd->hd_async_set);
+        hd->hd_async_count++;
+    }
+}
+
+void httpd_sess_worker_begin(struct httpd_data *hd, struct sock_db *session)
+{
+    session->lru_counter = ++hd->lru_counter;
+    session->in_worker = true;
+    FD_CLR(session->fd, &hd->hd_read_set);
+    FD_SET(session->fd, &hd->hd_async_set);
+    hd->hd_async_count++;
+}
+
+void httpd_sess_worker_done(struct httpd_data *hd, struct sock_db *session, esp_err_t ret)
+{
+    session->in_worker = false;
+    if ((ret != ESP_OK) || session->close_pending) {
+        httpd_sess_delete(hd, session);
+    } else if (!session->for_async_req) {
+        httpd_sess_resume(hd, session);
     }
 }
 
@@ -379,6 +546,16 @@ void httpd_sess_delete(struct httpd_data *hd, struct sock_db *session)
     // clear all contexts
     httpd_sess_clear_ctx(session);
 
+    // stop waiting for data on the session
+    hd->hd_fd_map[session->fd] = NULL;
+    FD_CLR(session->fd, &hd->hd_read_set);
+    FD_CLR(session->fd, &hd->hd_pending_set);
+    if (FD_ISSET(session->fd, &hd->hd_async_set)) {
+        FD_CLR(session->fd, &hd->hd_async_set);
+        hd->hd_async_count--;
+    }
+    update_max_fd(hd);
+
     // mark session slot as available
     session->fd = -1;
 
@@ -396,6 +573,16 @@ void httpd_sess_init(struct httpd_data *hd)
         .task = HTTPD_TASK_INIT
     };
     httpd_sess_enum(hd, enum_function, &context);
+
+    memset(hd->hd_fd_map, 0, sizeof(hd->hd_fd_map));
+    FD_ZERO(&hd->hd_read_set);
+    FD_ZERO(&hd->hd_pending_set);
+    FD_ZERO(&hd->hd_async_set);
+    hd->hd_async_count = 0;
+
+    FD_SET(hd->listen_fd, &hd->hd_read_set);
+    FD_SET(hd->ctrl_fd, &hd->hd_read_set);
+    hd->hd_max_fd = MAX(hd->listen_fd, hd->ctrl_fd);
 }
 
 bool httpd_sess_pending(struct httpd_data *hd, struct sock_db *session)
@@ -424,18 +611,29 @@ esp_err_t httpd_sess_process(struct httpd_data *hd, struct sock_db *session)
     }
 
     ESP_LOGD(TAG, LOG_FMT("httpd_req_new"));
-    if (httpd_req_new(hd, session) != ESP_OK) {
+    if (httpd_req_new(hd, &hd->hd_req, &hd->hd_req_aux, session) != ESP_OK) {
         return ESP_FAIL;
     }
     ESP_LOGD(TAG, LOG_FMT("httpd_req_delete"));
-    if (httpd_req_delete(hd) != ESP_OK) {
+    if (httpd_req_delete(&hd->hd_req) != ESP_OK) {
         return ESP_FAIL;
     }
     ESP_LOGD(TAG, LOG_FMT("success"));
     session->lru_counter = ++hd->lru_counter;
+    httpd_sess_update_pending(hd, session);
     return ESP_OK;
 }
 
+static void httpd_sess_update_lru_work(void *arg)
+{
+    struct sock_db *session = (struct sock_db *) arg;
+    struct httpd_data *hd = (struct httpd_data *) session->handle;
+    // The session may have been closed since
+    if (session->fd >= 0) {
+        session->lru_counter = ++hd->lru_counter;
+    }
+}
+
 esp_err_t httpd_sess_update_lru_counter(httpd_handle_t handle, int sockfd)
 {
     if (handle == NULL) {
@@ -444,13 +642,11 @@ esp_err_t httpd_sess_update_lru_counter(httpd_handle_t handle, int sockfd)
 
     struct httpd_data *hd = (struct httpd_data *) handle;
 
-    enum_context_t context = {
-        .task = HTTPD_TASK_FIND_FD,
-        .fd = sockfd
-    };
-    httpd_sess_enum(hd, enum_function, &context);
-    if (context.session) {
-        context.session->lru_counter = ++hd->lru_counter;
+    struct sock_db *session = httpd_sess_get(hd, sockfd);
+    if (session) {
+        if (!httpd_sess_queue_change(hd, httpd_sess_update_lru_work, session)) {
+            httpd_sess_update_lru_work(session);
+        }
         return ESP_OK;
     }
     return ESP_ERR_NOT_FOUND;
@@ -1,11 +1,12 @@
 /*
- * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
 
 
 #include <errno.h>
+#include <stdarg.h>
 #include <esp_log.h>
 #include <esp_err.h>
 
@@ -22,6 +23,18 @@ esp_err_t httpd_sess_set_send_override(httpd_handle_t hd, int sockfd, httpd_send
         return ESP_ERR_INVALID_ARG;
     }
     sess->send_fn = send_func;
+    /* The default gathered send function would bypass the new send function */
+    sess->sendv_fn = NULL;
+    return ESP_OK;
+}
+
+esp_err_t httpd_sess_set_sendv_override(httpd_handle_t hd, int sockfd, httpd_sendv_func_t sendv_func)
+{
+    struct sock_db *sess = httpd_sess_get(hd, sockfd);
+    if (!sess) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sess->sendv_fn = sendv_func;
     return ESP_OK;
 }
 
@@ -42,6 +55,7 @@ esp_err_t httpd_sess_set_pending_override(httpd_handle_t hd, int sockfd, httpd_p
         return ESP_ERR_INVALID_ARG;
     }
     sess->pending_fn = pending_func;
+    httpd_sess_update_pending(hd, sess);
     return ESP_OK;
 }
 
@@ -82,6 +96,54 @@ static esp_err_t httpd_send_all(httpd_req_t *r, const char *buf, size_t buf_len)
     return ESP_OK;
 }
 
+/* Send buffers in order, with a single call to the gathered send function
+ * unless it sends them partially. The buffers are updated while sending,
+ * the length of the buffers sent entirely is set to 0, also on failure. */
+static esp_err_t httpd_send_all_iov(httpd_req_t *r, struct iovec *iov, int iovcnt)
+{
+    struct httpd_req_aux *ra = r->aux;
+
+    while (iovcnt > 0) {
+        if (iov->iov_len == 0) {
+            iov++;
+            iovcnt--;
+            continue;
+        }
+
+        if (!ra->sd->sendv_fn) {
+            /* Send the buffers one by one */
+            if (httpd_send_all(r, iov->iov_base, iov->iov_len) != ESP_OK) {
+                return ESP_FAIL;
+            }
+            iov->iov_len = 0;
+            iov++;
+            iovcnt--;
+            continue;
+        }
+
+        int ret = ra->sd->sendv_fn(ra->sd->handle, ra->sd->fd, iov, iovcnt, 0);
+        if (ret < 0) {
+            ESP_LOGD(TAG, LOG_FMT("error in sendv_fn"));
+            return ESP_FAIL;
+        }
+        ESP_LOGD(TAG, LOG_FMT("sent = %d"), ret);
+
+        /* Skip the buffers sent, and what was sent of the next one */
+        size_t sent = ret;
+        while (iovcnt > 0 && sent >= iov->iov_len) {
+            sent -= iov->iov_len;
+            iov->iov_len = 0;
+            iov++;
+            iovcnt--;
+        }
+        if (sent > 0) {
+            iov->iov_base = (char *) iov->iov_base + sent;
+            iov->iov_len -= sent;
+        }
+    }
+    return ESP_OK;
+}
+
 static size_t httpd_recv_pending(httpd_req_t *r, char *buf, size_t buf_len)
 {
     struct httpd_req_aux *ra = r->aux;
@@ -225,6 +287,62 @@ esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type)
     return ESP_OK;
 }
 
+/* Format the header section of a response into the scratch buffer: the status line
+ * and essential headers from fmt, the headers set with httpd_resp_set_hdr(), and
+ * the empty line ending the section. The request headers kept in the scratch buffer
+ * are no longer available at this point, so it is reused to send the whole header
+ * section at once. */
+static esp_err_t httpd_resp_format_hdrs(httpd_req_t *r, size_t *hdrs_len, const char *fmt, ...)
+{
+    struct httpd_req_aux *ra = r->aux;
+    const char *colon_separator = ": ";
+    const char *cr_lf_seperator = "\r\n";
+    va_list args;
+
+    /* Calculate the size of the essential headers. +1 for the null terminator */
+    va_start(args, fmt);
+    int essential_len = vsnprintf(NULL, 0, fmt, args);
+    va_end(args);
+    if (essential_len < 0 || (size_t) essential_len + 1 > ra->max_req_hdr_len) {
+        return ESP_ERR_HTTPD_RESP_HDR;
+    }
+
+    /* Add the size of the additional headers and of the end of the header section */
+    size_t required_size = essential_len + 1 + strlen(cr_lf_seperator);
+    for (unsigned i = 0; i < ra->resp_hdrs_count; i++) {
+        required_size += strlen(ra->resp_hdrs[i].field) + strlen(colon_separator) +
+                         strlen(ra->resp_hdrs[i].value) + strlen(cr_lf_seperator);
+    }
+
+    if (ra->scratch_cur_size < required_size) {
+        char *scratch = realloc(ra->scratch, required_size);
+        if (scratch == NULL) {
+            ESP_LOGE(TAG, "Unable to allocate httpd send buffer");
+            return ESP_ERR_HTTPD_ALLOC_MEM;
+        }
+        ra->scratch = scratch;
+        ra->scratch_cur_size = required_size;
+    }
+
+    va_start(args, fmt);
+    int ret = vsnprintf(ra->scratch, required_size, fmt, args);
+    va_end(args);
+    if (ret != essential_len) {
+        return ESP_ERR_HTTPD_RESP_HDR;
+    }
+
+    size_t len = essential_len;
+    for (unsigned i = 0; i < ra->resp_hdrs_count; i++) {
+        len += snprintf(ra->scratch + len, required_size - len, "%s%s%s%s", ra->resp_hdrs[i].field,
+                        colon_separator, ra->resp_hdrs[i].value, cr_lf_seperator);
+    }
+    len += snprintf(ra->scratch + len, required_size - len, "%s", cr_lf_seperator);
+
+    *hdrs_len = len;
+    ESP_LOGD(TAG, "httpd send buffer size = %"NEWLIB_NANO_COMPAT_FORMAT, NEWLIB_NANO_COMPAT_CAST(len));
+    return ESP_OK;
+}
+
 esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len)
 {
     if (r == NULL) {
@@ -237,8 +355,6 @@ esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len)
 
     struct httpd_req_aux *ra = r->aux;
     const char *httpd_hdr_str = "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %d\r\n";
-    const char *colon_separator = ": ";
-    const char *cr_lf_seperator = "\r\n";
 
     if (buf_len == HTTPD_RESP_USE_STRLEN) {
         buf_len = strlen(buf);
@@ -247,61 +363,22 @@ esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len)
     /* Request headers are no longer available */
     ra->req_hdrs_count = 0;
 
-    /* Calculate the size of the headers. +1 for the null terminator */
-    size_t required_size = snprintf(NULL, 0, httpd_hdr_str, ra->status, ra->content_type, buf_len) + 1;
-    if (required_size > ra->max_req_hdr_len) {
-        return ESP_ERR_HTTPD_RESP_HDR;
-    }
-    char *res_buf = malloc(required_size); /* Temporary buffer to store the headers */
-    if (res_buf == NULL) {
-        ESP_LOGE(TAG, "Unable to allocate httpd send buffer");
-        return ESP_ERR_HTTPD_ALLOC_MEM;
-    }
-
-    esp_err_t ret = snprintf(res_buf, required_size, httpd_hdr_str, ra->status, ra->content_type, buf_len);
-    if (ret < 0 || ret >= required_size) {
-        free(res_buf);
-        return ESP_ERR_HTTPD_RESP_HDR;
-    }
-    ESP_LOGD(TAG, "httpd send buffer size = %d", strlen(res_buf));
-    ret = httpd_send_all(r, res_buf, strlen(res_buf));
-    free(res_buf);
+    size_t hdrs_len;
+    esp_err_t ret = httpd_resp_format_hdrs(r, &hdrs_len, httpd_hdr_str, ra->status, ra->content_type, buf_len);
     if (ret != ESP_OK) {
-        return ESP_ERR_HTTPD_RESP_SEND;
-    }
-
-    /* Sending additional headers based on set_header */
-    for (unsigned i = 0; i < ra->resp_hdrs_count; i++) {
-        /* Send header field */
-        if (httpd_send_all(r, ra->resp_hdrs[i].field, strlen(ra->resp_hdrs[i].field)) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
-        /* Send ': ' */
-        if (httpd_send_all(r, colon_separator, strlen(colon_separator)) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
-        /* Send header value */
-        if (httpd_send_all(r, ra->resp_hdrs[i].value, strlen(ra->resp_hdrs[i].value)) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
-        /* Send CR + LF */
-        if (httpd_send_all(r, cr_lf_seperator, strlen(cr_lf_seperator)) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
+        return ret;
     }
 
-    /* End header section */
-    if (httpd_send_all(r, cr_lf_seperator, strlen(cr_lf_seperator)) != ESP_OK) {
+    /* Send the headers and the content together */
+    struct iovec iov[] = {
+        { .iov_base = ra->scratch, .iov_len = hdrs_len },
+        { .iov_base = (void *) buf, .iov_len = buf ? buf_len : 0 },
+    };
+    if (httpd_send_all_iov(r, iov, sizeof(iov) / sizeof(iov[0])) != ESP_OK) {
         return ESP_ERR_HTTPD_RESP_SEND;
     }
     esp_http_server_dispatch_event(HTTP_SERVER_EVENT_HEADERS_SENT, &(ra->sd->fd), sizeof(int));
 
-    /* Sending content */
-    if (buf && buf_len) {
-        if (httpd_send_all(r, buf, buf_len) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
-    }
     esp_http_server_event_data evt_data = {
         .fd = ra->sd->fd,
         .data_len = buf_len,
@@ -326,80 +403,40 @@ esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf, ssize_t buf_len
 
     struct httpd_req_aux *ra = r->aux;
     const char *httpd_chunked_hdr_str = "HTTP/1.1 %s\r\nContent-Type: %s\r\nTransfer-Encoding: chunked\r\n";
-    const char *colon_separator = ": ";
-    const char *cr_lf_seperator = "\r\n";
 
     /* Request headers are no longer available */
     ra->req_hdrs_count = 0;
 
+    /* The headers go out with the first chunk */
+    esp_err_t ret;
+    size_t hdrs_len = 0;
     if (!ra->first_chunk_sent) {
-        /* Calculate the size of the headers. +1 for the null terminator */
-        size_t required_size = snprintf(NULL, 0, httpd_chunked_hdr_str, ra->status, ra->content_type) + 1;
-        if (required_size > ra->max_req_hdr_len) {
-            return ESP_ERR_HTTPD_RESP_HDR;
-        }
-        char *res_buf = malloc(required_size); /* Temporary buffer to store the headers */
-        if (res_buf == NULL) {
-            ESP_LOGE(TAG, "Unable to allocate httpd send chunk buffer");
-            return ESP_ERR_HTTPD_ALLOC_MEM;
-        }
-        esp_err_t ret = snprintf(res_buf, required_size, httpd_chunked_hdr_str, ra->status, ra->content_type);
-        if (ret < 0 || ret >= required_size) {
-            free(res_buf);
-            return ESP_ERR_HTTPD_RESP_HDR;
-        }
-        ESP_LOGD(TAG, "httpd send chunk buffer size = %d", strlen(res_buf));
-        /* Size of essential headers is limited by scratch buffer size */
-        ret = httpd_send_all(r, res_buf, strlen(res_buf));
-        free(res_buf);
+        ret = httpd_resp_format_hdrs(r, &hdrs_len, httpd_chunked_hdr_str, ra->status, ra->content_type);
         if (ret != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
+            return ret;
         }
-
-        /* Sending additional headers based on set_header */
-        for (unsigned i = 0; i < ra->resp_hdrs_count; i++) {
-            /* Send header field */
-            if (httpd_send_all(r, ra->resp_hdrs[i].field, strlen(ra->resp_hdrs[i].field)) != ESP_OK) {
-                return ESP_ERR_HTTPD_RESP_SEND;
-            }
-            /* Send ': ' */
-            if (httpd_send_all(r, colon_separator, strlen(colon_separator)) != ESP_OK) {
-                return ESP_ERR_HTTPD_RESP_SEND;
-            }
-            /* Send header value */
-            if (httpd_send_all(r, ra->resp_hdrs[i].value, strlen(ra->resp_hdrs[i].value)) != ESP_OK) {
-                return ESP_ERR_HTTPD_RESP_SEND;
-            }
-            /* Send CR + LF */
-            if (httpd_send_all(r, cr_lf_seperator, strlen(cr_lf_seperator)) != ESP_OK) {
-                return ESP_ERR_HTTPD_RESP_SEND;
-            }
-        }
-
-        /* End header section */
-        if (httpd_send_all(r, cr_lf_seperator, strlen(cr_lf_seperator)) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
-        ra->first_chunk_sent = true;
     }
 
     /* Sending chunked content */
     char len_str[10];
     snprintf(len_str, sizeof(len_str), "%lx\r\n", (long)buf_len);
-    if (httpd_send_all(r, len_str, strlen(len_str)) != ESP_OK) {
-        return ESP_ERR_HTTPD_RESP_SEND;
-    }
 
-    if (buf) {
-        if (httpd_send_all(r, buf, (size_t) buf_len) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
+    struct iovec iov[] = {
+        { .iov_base = ra->scratch, .iov_len = hdrs_len },
+        { .iov_base = len_str, .iov_len = strlen(len_str) },
+        { .iov_base = (void *) buf, .iov_len = buf ? buf_len : 0 },
+        /* Indicate end of chunk */
+        { .iov_base = (void *) "\r\n", .iov_len = strlen("\r\n") },
+    };
+    ret = httpd_send_all_iov(r, iov, sizeof(iov) / sizeof(iov[0]));
+    /* Once the headers are out they aren't sent again, even if the rest of the chunk failed */
+    if (iov[0].iov_len == 0) {
+        ra->first_chunk_sent = true;
     }
-
-    /* Indicate end of chunk */
-    if (httpd_send_all(r, "\r\n", strlen("\r\n")) != ESP_OK) {
+    if (ret != ESP_OK) {
         return ESP_ERR_HTTPD_RESP_SEND;
     }
+
     esp_http_server_event_data evt_data = {
         .fd = ra->sd->fd,
         .data_len = buf_len,
@@ -671,7 +708,7 @@ esp_err_t httpd_req_async_handler_begin(httpd_req_t *r, httpd_req_t **out)
     r_aux->remaining_len = 0;
 
     // mark socket as "in use"
-    r_aux->sd->for_async_req = true;
+    httpd_sess_async_begin(hd, r_aux->sd);
 
     *out = async;
 
@@ -748,6 +785,24 @@ int httpd_default_send(httpd_handle_t hd, int sockfd, const char *buf, size_t bu
     return ret;
 }
 
+int httpd_default_sendv(httpd_handle_t hd, int sockfd, const struct iovec *iov, int iovcnt, int flags)
+{
+    (void)hd;
+    if (iov == NULL) {
+        return HTTPD_SOCK_ERR_INVALID;
+    }
+
+    struct msghdr msg = {
+        .msg_iov = (struct iovec *) iov,
+        .msg_iovlen = iovcnt,
+    };
+    int ret = sendmsg(sockfd, &msg, flags);
+    if (ret < 0) {
+        return httpd_sock_err("sendmsg", sockfd);
+    }
+    return ret;
+}
+
 int httpd_default_recv(httpd_handle_t hd, int sockfd, char *buf, size_t buf_len, int flags)
 {
     (void)hd;
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -80,6 +80,216 @@ bool httpd_uri_match_wildcard(const char *template, const char *uri, size_t len)
     }
 }
 
+/* The URI router is a radix tree of the URIs the registered handlers match.
+ * Each handler is compiled into one or two rules, a rule matching either
+ * the URI ending at its node exactly, or any URI starting with it:
+ *  - without uri_match_fn    "/a"   : "/a" exactly
+ *  - httpd_uri_match_wildcard "/a*"  : "/a" prefix
+ *                             "/a/?" : "/a" exactly, "/a/" exactly
+ *                             "/a/?*": "/a" exactly, "/a/" prefix
+ * A lookup walks down the tree along the URI once, and among the rules met
+ * which match, picks the handler registered first with a matching method, like
+ * the linear scan does. The labels of the nodes point into the URIs of the
+ * handlers, so the router is rebuilt whenever the handlers change. */
+struct httpd_uri_rule {
+    const httpd_uri_t *handler;         /*!< Handler matching the URIs of the rule */
+    int order;                          /*!< Index of the handler in hd_calls */
+    bool prefix;                        /*!< Match the URIs starting with the node, not only the node */
+    struct httpd_uri_rule *next;        /*!< Next rule of the node */
+};
+
+struct httpd_uri_node {
+    const char *label;                  /*!< Characters from the parent node */
+    size_t label_len;                   /*!< Number of characters of the label */
+    struct httpd_uri_node *child;       /*!< First child node */
+    struct httpd_uri_node *next;        /*!< Next sibling node */
+    struct httpd_uri_rule *rules;       /*!< Rules ending at this node */
+};
+
+struct httpd_uri_router {
+    struct httpd_uri_node *nodes;       /*!< Nodes, the first one is the root */
+    size_t node_count;                  /*!< Number of nodes in use */
+    struct httpd_uri_rule *rules;       /*!< Rules */
+    size_t rule_count;                  /*!< Number of rules in use */
+};
+
+/* The router supports the default and the wildcard URI matching, other
+ * matching functions are only known by their result */
+static bool httpd_uri_router_supported(struct httpd_data *hd)
+{
+    return hd->config.uri_match_fn == NULL || hd->config.uri_match_fn == httpd_uri_match_wildcard;
+}
+
+/* Find the node of a string, adding and splitting nodes as needed */
+static struct httpd_uri_node *httpd_uri_router_insert(struct httpd_uri_router *router, const char *str, size_t len)
+{
+    struct httpd_uri_node *node = &router->nodes[0];
+    while (len > 0) {
+        struct httpd_uri_node **link = &node->child;
+        while (*link && (*link)->label[0] != str[0]) {
+            link = &(*link)->next;
+        }
+
+        struct httpd_uri_node *child = *link;
+        if (!child) {
+            child = &router->nodes[router->node_count++];
+            child->label = str;
+            child->label_len = len;
+            *link = child;
+            return child;
+        }
+
+        size_t common = 1;
+        while (common < MIN(len, child->label_len) && child->label[common] == str[common]) {
+            common++;
+        }
+        if (common < child->label_len) {
+            /* Split the node where the string diverges from its label */
+            struct httpd_uri_node *split = &router->nodes[router->node_count++];
+            split->label = child->label;
+            split->label_len = common;
+            split->child = child;
+            split->next = child->next;
+            child->label += common;
+            child->label_len -= common;
+            child->next = NULL;
+            *link = split;
+            child = split;
+        }
+        node = child;
+        str += common;
+        len -= common;
+    }
+    return node;
+}
+
+static void httpd_uri_router_add_rule(struct httpd_uri_router *router, const char *str, size_t len,
+                                      bool prefix, const httpd_uri_t *handler, int order)
+{
+    struct httpd_uri_node *node = httpd_uri_router_insert(router, str, len);
+    struct httpd_uri_rule *rule = &router->rules[router->rule_count++];
+    rule->handler = handler;
+    rule->order = order;
+    rule->prefix = prefix;
+    rule->next = node->rules;
+    node->rules = rule;
+}
+
+/* Add the rules of a handler, following the template syntax of httpd_uri_match_wildcard() */
+static void httpd_uri_router_add(struct httpd_data *hd, struct httpd_uri_router *router, int order)
+{
+    const httpd_uri_t *handler = hd->hd_calls[order];
+    const size_t tpl_len = strlen(handler->uri);
+    if (hd->config.uri_match_fn == NULL) {
+        httpd_uri_router_add_rule(router, handler->uri, tpl_len, false, handler, order);
+        return;
+    }
+
+    const char last = (const char) (tpl_len > 0 ? handler->uri[tpl_len - 1] : 0);
+    const char prevlast = (const char) (tpl_len > 1 ? handler->uri[tpl_len - 2] : 0);
+    const bool asterisk = last == '*' || (prevlast == '*' && last == '?');
+    const bool quest = last == '?' || (prevlast == '?' && last == '*');
+    if (tpl_len < asterisk + quest*2) {
+        /* Invalid template, never matches */
+        return;
+    }
+
+    /* With a question mark, the character following the mandatory part is optional */
+    const size_t exact_match_chars = tpl_len - (asterisk + quest*2);
+    httpd_uri_router_add_rule(router, handler->uri, exact_match_chars, asterisk && !quest, handler, order);
+    if (quest) {
+        httpd_uri_router_add_rule(router, handler->uri, exact_match_chars + 1, asterisk, handler, order);
+    }
+}
+
+static void httpd_uri_router_free(void *router)
+{
+    free(router);
+}
+
+/* Build the router of the registered handlers, and replace the current one */
+static void httpd_uri_router_update(struct httpd_data *hd)
+{
+    struct httpd_uri_router *router = NULL;
+
+    int count = 0;
+    while (count < hd->config.max_uri_handlers && hd->hd_calls[count]) {
+        count++;
+    }
+
+    if (count > 0 && httpd_uri_router_supported(hd)) {
+        /* Each rule adds a node and may split another one */
+        const size_t max_rules = 2 * count;
+        const size_t max_nodes = 1 + 2 * max_rules;
+        router = calloc(1, sizeof(struct httpd_uri_router) +
+                        max_nodes * sizeof(struct httpd_uri_node) +
+                        max_rules * sizeof(struct httpd_uri_rule));
+        if (router) {
+            router->nodes = (struct httpd_uri_node *) (router + 1);
+            router->node_count = 1;
+            router->rules = (struct httpd_uri_rule *) (router->nodes + max_nodes);
+            for (int i = 0; i < count; i++) {
+                httpd_uri_router_add(hd, router, i);
+            }
+        } else {
+            /* Not fatal, the handlers are then looked up one by one */
+            ESP_LOGW(TAG, LOG_FMT("failed to allocate URI router"));
+        }
+    }
+
+    struct httpd_uri_router *old = hd->hd_router;
+    hd->hd_router = router;
+
+    /* Lookups run in the server task: free the old router from there if the server
+     * may be using it. If that fails, or during a request, it can be freed here.
+     * With worker tasks, lookups hold hd_calls_mutex, as the caller does. */
+    if (old && (hd->hd_calls_mutex || hd->hd_td.status != THREAD_RUNNING || httpd_os_thread_handle() == hd->hd_td.handle ||
+                httpd_queue_work(hd, httpd_uri_router_free, old) != ESP_OK)) {
+        httpd_uri_router_free(old);
+    }
+}
+
+static httpd_uri_t* httpd_uri_router_find(struct httpd_uri_router *router,
+                                          const char *uri, size_t uri_len,
+                                          httpd_method_t method,
+                                          httpd_err_code_t *err)
+{
+    const struct httpd_uri_node *node = &router->nodes[0];
+    const struct httpd_uri_rule *found = NULL;
+    bool uri_found = false;
+    size_t pos = 0;
+
+    while (node) {
+        for (const struct httpd_uri_rule *rule = node->rules; rule; rule = rule->next) {
+            if (!rule->prefix && pos != uri_len) {
+                continue;
+            }
+            uri_found = true;
+            if ((rule->handler->method == method || rule->handler->method == HTTP_ANY) &&
+                    (!found || rule->order < found->order)) {
+                found = rule;
+            }
+        }
+
+        if (pos == uri_len) {
+            break;
+        }
+        for (node = node->child; node && node->label[0] != uri[pos]; node = node->next) {
+        }
+        if (node) {
+            if (node->label_len > uri_len - pos || memcmp(node->label, uri + pos, node->label_len) != 0) {
+                break;
+            }
+            pos += node->label_len;
+        }
+    }
+
+    if (err) {
+        *err = found ? 0 : (uri_found ? HTTPD_405_METHOD_NOT_ALLOWED : HTTPD_404_NOT_FOUND);
+    }
+    return found ? (httpd_uri_t *) found->handler : NULL;
+}
+
 /* Find handler with matching URI and method, and set
  * appropriate error code if URI or method not found */
 static httpd_uri_t* httpd_find_uri_handler(struct httpd_data *hd,
@@ -87,6 +297,11 @@ static httpd_uri_t* httpd_find_uri_handler(struct httpd_data *hd,
                                            httpd_method_t method,
                                            httpd_err_code_t *err)
 {
+    struct httpd_uri_router *router = hd->hd_router;
+    if (router) {
+        return httpd_uri_router_find(router, uri, uri_len, method, err);
+    }
+
     if (err) {
         *err = HTTPD_404_NOT_FOUND;
     }
@@ -123,20 +338,31 @@ static httpd_uri_t* httpd_find_uri_handler(struct httpd_data *hd,
     return NULL;
 }
 
-esp_err_t httpd_register_uri_handler(httpd_handle_t handle,
-                                     const httpd_uri_t *uri_handler)
+/* With worker tasks, the handlers are looked up and (un)registered
+ * from several tasks */
+static void httpd_uri_lock(struct httpd_data *hd)
 {
-    if (handle == NULL || uri_handler == NULL) {
-        return ESP_ERR_INVALID_ARG;
+    if (hd->hd_calls_mutex) {
+        xSemaphoreTake(hd->hd_calls_mutex, portMAX_DELAY);
     }
+}
 
-    struct httpd_data *hd = (struct httpd_data *) handle;
+static void httpd_uri_unlock(struct httpd_data *hd)
+{
+    if (hd->hd_calls_mutex) {
+        xSemaphoreGive(hd->hd_calls_mutex);
+    }
+}
+
+static esp_err_t httpd_register_uri_handler_locked(struct httpd_data *hd,
+                                                   const httpd_uri_t *uri_handler)
+{
 
     /* Make sure another handler with matching URI and method
      * is not already registered. This will also catch cases
      * when a registered URI wildcard pattern already accounts
      * for the new URI being registered */
-    if (httpd_find_uri_handler(handle, uri_handler->uri,
+    if (httpd_find_uri_handler(hd, uri_handler->uri,
                                strlen(uri_handler->uri),
                                uri_handler->method, NULL) != NULL) {
         ESP_LOGW(TAG, LOG_FMT("handler %s with method %d already registered"),
@@ -182,6 +408,7 @@ esp_err_t httpd_register_uri_handler(httpd_handle_t handle,
             }
 #endif
             ESP_LOGD(TAG, LOG_FMT("[%d] installed %s"), i, uri_handler->uri);
+            httpd_uri_router_update(hd);
             return ESP_OK;
         }
         ESP_LOGD(TAG, LOG_FMT("[%d] exists %s"), i, hd->hd_calls[i]->uri);
@@ -190,14 +417,23 @@ esp_err_t httpd_register_uri_handler(httpd_handle_t handle,
     return ESP_ERR_HTTPD_HANDLERS_FULL;
 }
 
-esp_err_t httpd_unregister_uri_handler(httpd_handle_t handle,
-                                       const char *uri, httpd_method_t method)
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle,
+                                     const httpd_uri_t *uri_handler)
 {
-    if (handle == NULL || uri == NULL) {
+    if (handle == NULL || uri_handler == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
 
     struct httpd_data *hd = (struct httpd_data *) handle;
+    httpd_uri_lock(hd);
+    esp_err_t ret = httpd_register_uri_handler_locked(hd, uri_handler);
+    httpd_uri_unlock(hd);
+    return ret;
+}
+
+static esp_err_t httpd_unregister_uri_handler_locked(struct httpd_data *hd,
+                                                     const char *uri, httpd_method_t method)
+{
     for (int i = 0; i < hd->config.max_uri_handlers; i++) {
         if (!hd->hd_calls[i]) {
             break;
@@ -220,6 +456,7 @@ esp_err_t httpd_unregister_uri_handler(httpd_handle_t handle,
             }
             /* Nullify the following non null entry */
             hd->hd_calls[i-1] = NULL;
+            httpd_uri_router_update(hd);
             return ESP_OK;
         }
     }
@@ -227,13 +464,22 @@ esp_err_t httpd_unregister_uri_handler(httpd_handle_t handle,
     return ESP_ERR_NOT_FOUND;
 }
 
-esp_err_t httpd_unregister_uri(httpd_handle_t handle, const char *uri)
+esp_err_t httpd_unregister_uri_handler(httpd_handle_t handle,
+                                       const char *uri, httpd_method_t method)
 {
     if (handle == NULL || uri == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
 
     struct httpd_data *hd = (struct httpd_data *) handle;
+    httpd_uri_lock(hd);
+    esp_err_t ret = httpd_unregister_uri_handler_locked(hd, uri, method);
+    httpd_uri_unlock(hd);
+    return ret;
+}
+
+static esp_err_t httpd_unregister_uri_locked(struct httpd_data *hd, const char *uri)
+{
     bool found = false;
 
     int i = 0, j = 0; // For keeping count of removed entries
@@ -263,10 +509,25 @@ esp_err_t httpd_unregister_uri(httpd_handle_t handle, const char *uri)
 
     if (!found) {
         ESP_LOGW(TAG, LOG_FMT("no handler found for URI %s"), uri);
+    } else {
+        httpd_uri_router_update(hd);
     }
     return (found ? ESP_OK : ESP_ERR_NOT_FOUND);
 }
 
+esp_err_t httpd_unregister_uri(httpd_handle_t handle, const char *uri)
+{
+    if (handle == NULL || uri == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct httpd_data *hd = (struct httpd_data *) handle;
+    httpd_uri_lock(hd);
+    esp_err_t ret = httpd_unregister_uri_locked(hd, uri);
+    httpd_uri_unlock(hd);
+    return ret;
+}
+
 void httpd_unregister_all_uri_handlers(struct httpd_data *hd)
 {
     for (unsigned i = 0; i < hd->config.max_uri_handlers; i++) {
@@ -279,13 +540,15 @@ void httpd_unregister_all_uri_handlers(struct httpd_data *hd)
         free(hd->hd_calls[i]);
         hd->hd_calls[i] = NULL;
     }
+    httpd_uri_router_update(hd);
 }
 
-esp_err_t httpd_uri(struct httpd_data *hd)
+esp_err_t httpd_uri(struct httpd_data *hd, httpd_req_t *req)
 {
     httpd_uri_t            *uri = NULL;
-    httpd_req_t            *req = &hd->hd_req;
-    struct http_parser_url *res = &hd->hd_req_aux.url_parse_res;
+    httpd_uri_t             found;
+    struct httpd_req_aux   *aux = req->aux;
+    struct http_parser_url *res = &aux->url_parse_res;
 
     /* For conveying URI not found/method not allowed */
     httpd_err_code_t err = 0;
@@ -294,8 +557,16 @@ esp_err_t httpd_uri(struct httpd_data *hd)
 
     /* URL parser result contains offset and length of path string */
     if (res->field_set & (1 << UF_PATH)) {
+        httpd_uri_lock(hd);
         uri = httpd_find_uri_handler(hd, req->uri + res->field_data[UF_PATH].off,
                                      res->field_data[UF_PATH].len, req->method, &err);
+        if (uri) {
+            /* The handler may get unregistered from another
+             * task while this request is being processed */
+            found = *uri;
+            uri = &found;
+        }
+        httpd_uri_unlock(hd);
     }
 
     /* If URI with method not found, respond with error code */
@@ -318,10 +589,9 @@ esp_err_t httpd_uri(struct httpd_data *hd)
 
     /* Final step for a WebSocket handshake verification */
 #ifdef CONFIG_HTTPD_WS_SUPPORT
-    struct httpd_req_aux   *aux = req->aux;
     if (uri->is_websocket && aux->ws_handshake_detect && uri->method == HTTP_GET) {
         ESP_LOGD(TAG, LOG_FMT("Responding WS handshake to sock %d"), aux->sd->fd);
-        esp_err_t ret = httpd_ws_respond_server_handshake(&hd->hd_req, uri->supported_subprotocol);
+        esp_err_t ret = httpd_ws_respond_server_handshake(req, uri->supported_subprotocol);
         if (ret != ESP_OK) {
             return ret;
         }
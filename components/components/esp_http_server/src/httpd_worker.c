@@ -0,0 +1,188 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <esp_log.h>
+#include <esp_err.h>
+
+#include <esp_http_server.h>
+#include "esp_httpd_priv.h"
+
+static const char *TAG = "httpd_worker";
+
+/* The server task keeps waiting for data and accepting connections, and owns
+ * the sessions: it hands a session with incoming data over to a worker, which
+ * runs one request of it, and posts the result back to the server task, which
+ * then closes the session or waits for data on it again. A session is handed
+ * over to a single worker at a time, which is always the same one. */
+struct httpd_worker_result {
+    struct sock_db *session;                /*!< Session the worker is done with */
+    esp_err_t ret;                          /*!< Result of the request */
+};
+
+static void httpd_workers_wake(void *arg)
+{
+    /* Nothing to do, the results are collected before select() */
+    (void)arg;
+}
+
+static void httpd_worker_thread(void *arg)
+{
+    struct httpd_worker *worker = (struct httpd_worker *) arg;
+    struct httpd_data *hd = worker->hd;
+    struct sock_db *session;
+
+    worker->td.status = THREAD_RUNNING;
+    while (xQueueReceive(worker->queue, &session, portMAX_DELAY) == pdTRUE && session) {
+        struct httpd_worker_result result = {
+            .session = session,
+            .ret = ESP_FAIL,
+        };
+        ESP_LOGD(TAG, LOG_FMT("processing socket %d"), session->fd);
+        if (httpd_req_new(hd, &worker->req, &worker->req_aux, session) == ESP_OK) {
+            result.ret = httpd_req_delete(&worker->req);
+        }
+
+        /* The queue has room for every session */
+        xQueueSend(hd->hd_workers_done, &result, portMAX_DELAY);
+
+        /* Wake up the server task, unless another worker already did and
+         * the results were not collected since, or it is stopping */
+        if (!atomic_exchange(&hd->hd_workers_wake, true) && hd->hd_td.status == THREAD_RUNNING) {
+            if (httpd_queue_work(hd, httpd_workers_wake, NULL) != ESP_OK) {
+                /* Collected on the next wake up of the server task */
+                ESP_LOGW(TAG, LOG_FMT("failed to wake up server task"));
+            }
+        }
+    }
+
+    ESP_LOGD(TAG, LOG_FMT("worker exiting"));
+    worker->td.status = THREAD_STOPPED;
+    httpd_os_thread_delete();
+}
+
+esp_err_t httpd_workers_create(struct httpd_data *hd)
+{
+    if (hd->config.worker_count == 0) {
+        return ESP_OK;
+    }
+
+    hd->hd_workers = calloc(hd->config.worker_count, sizeof(struct httpd_worker));
+    hd->hd_workers_done = xQueueCreate(hd->config.max_open_sockets, sizeof(struct httpd_worker_result));
+    hd->hd_calls_mutex = xSemaphoreCreateMutex();
+    if (!hd->hd_workers || !hd->hd_workers_done || !hd->hd_calls_mutex) {
+        goto fail;
+    }
+    atomic_init(&hd->hd_workers_wake, false);
+
+    for (int i = 0; i < hd->config.worker_count; i++) {
+        struct httpd_worker *worker = &hd->hd_workers[i];
+        worker->hd = hd;
+        worker->queue = xQueueCreate(hd->config.max_open_sockets + 1, sizeof(struct sock_db *));
+        worker->req_aux.resp_hdrs = calloc(hd->config.max_resp_headers, sizeof(*worker->req_aux.resp_hdrs));
+        if (!worker->queue || !worker->req_aux.resp_hdrs) {
+            goto fail;
+        }
+    }
+    return ESP_OK;
+
+fail:
+    ESP_LOGE(TAG, LOG_FMT("Failed to allocate memory for HTTP worker tasks"));
+    httpd_workers_delete(hd);
+    return ESP_ERR_HTTPD_ALLOC_MEM;
+}
+
+void httpd_workers_delete(struct httpd_data *hd)
+{
+    if (hd->hd_workers) {
+        for (int i = 0; i < hd->config.worker_count; i++) {
+            if (hd->hd_workers[i].queue) {
+                vQueueDelete(hd->hd_workers[i].queue);
+            }
+            free(hd->hd_workers[i].req_aux.resp_hdrs);
+        }
+        free(hd->hd_workers);
+        hd->hd_workers = NULL;
+    }
+    if (hd->hd_workers_done) {
+        vQueueDelete(hd->hd_workers_done);
+        hd->hd_workers_done = NULL;
+    }
+    if (hd->hd_calls_mutex) {
+        vSemaphoreDelete(hd->hd_calls_mutex);
+        hd->hd_calls_mutex = NULL;
+    }
+}
+
+esp_err_t httpd_workers_start(struct httpd_data *hd)
+{
+    for (int i = 0; hd->hd_workers && i < hd->config.worker_count; i++) {
+        struct httpd_worker *worker = &hd->hd_workers[i];
+        if (httpd_os_thread_create(&worker->td.handle, "httpd_worker",
+                                   hd->config.stack_size,
+                                   hd->config.task_priority,
+                                   httpd_worker_thread, worker,
+                                   hd->config.core_id,
+                                   hd->config.task_caps) != ESP_OK) {
+            ESP_LOGE(TAG, LOG_FMT("Failed to launch HTTP worker task %d"), i);
+            httpd_workers_stop(hd);
+            return ESP_ERR_HTTPD_TASK;
+        }
+    }
+    return ESP_OK;
+}
+
+void httpd_workers_stop(struct httpd_data *hd)
+{
+    if (!hd->hd_workers) {
+        return;
+    }
+
+    /* The workers finish the requests queued before stopping */
+    struct sock_db *stop = NULL;
+    for (int i = 0; i < hd->config.worker_count; i++) {
+        if (hd->hd_workers[i].td.handle) {
+            xQueueSend(hd->hd_workers[i].queue, &stop, portMAX_DELAY);
+        }
+    }
+    for (int i = 0; i < hd->config.worker_count; i++) {
+        struct httpd_worker *worker = &hd->hd_workers[i];
+        if (worker->td.handle) {
+            while (worker->td.status != THREAD_STOPPED) {
+                httpd_os_thread_sleep(10);
+            }
+            worker->td.handle = NULL;
+        }
+    }
+    /* The sessions are closed with all the others */
+    xQueueReset(hd->hd_workers_done);
+}
+
+struct httpd_worker *httpd_worker_get(struct httpd_data *hd, struct sock_db *session)
+{
+    return &hd->hd_workers[(session - hd->hd_sd) % hd->config.worker_count];
+}
+
+void httpd_worker_dispatch(struct httpd_data *hd, struct sock_db *session)
+{
+    ESP_LOGD(TAG, LOG_FMT("handing socket %d over"), session->fd);
+    httpd_sess_worker_begin(hd, session);
+
+    /* The queue has room for every session */
+    xQueueSend(httpd_worker_get(hd, session)->queue, &session, portMAX_DELAY);
+}
+
+void httpd_workers_collect(struct httpd_data *hd)
+{
+    struct httpd_worker_result result;
+
+    /* Clear the flag first: the workers posting a result from now on wake
+     * up the server task again */
+    atomic_store(&hd->hd_workers_wake, false);
+    while (xQueueReceive(hd->hd_workers_done, &result, 0) == pdTRUE) {
+        httpd_sess_worker_done(hd, result.session, result.ret);
+    }
+}
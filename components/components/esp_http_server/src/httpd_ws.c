@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2020-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2020-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -17,6 +17,7 @@
 
 #include <esp_http_server.h>
 #include "esp_httpd_priv.h"
+#include "esp_private/websocket_mask.h"
 #include "freertos/event_groups.h"
 #include "sdkconfig.h"
 
@@ -264,13 +265,24 @@ static esp_err_t httpd_ws_unmask_payload(uint8_t *payload, size_t len, const uin
         return ESP_ERR_INVALID_ARG;
     }
 
-    for (size_t idx = 0; idx < len; idx++) {
-        payload[idx] = (payload[idx] ^ mask_key[idx % 4]);
-    }
-
+    websocket_mask(payload, payload, len, mask_key, 0);
     return ESP_OK;
 }
 
+/* Receives exactly len bytes, as a part of the frame header may arrive in several segments */
+static int httpd_ws_recv_exact(httpd_req_t *req, uint8_t *buf, size_t len)
+{
+    size_t offset = 0;
+    while (offset < len) {
+        int read_len = httpd_recv_with_opt(req, (char *)buf + offset, len - offset, false);
+        if (read_len <= 0) {
+            return read_len;
+        }
+        offset += read_len;
+    }
+    return offset;
+}
+
 esp_err_t httpd_ws_recv_frame(httpd_req_t *req, httpd_ws_frame_t *frame, size_t max_len)
 {
     esp_err_t ret = httpd_ws_check_req(req);
@@ -313,7 +325,7 @@ esp_err_t httpd_ws_recv_frame(httpd_req_t *req, httpd_ws_frame_t *frame, size_t
         } else if (init_len == 126) {
             /* Case 2: If length byte is 126, then this frame's length bit is 16 bits */
             uint8_t length_bytes[2] = { 0 };
-            if (httpd_recv_with_opt(req, (char *)length_bytes, sizeof(length_bytes), false) <= 0) {
+            if (httpd_ws_recv_exact(req, length_bytes, sizeof(length_bytes)) <= 0) {
                 ESP_LOGW(TAG, LOG_FMT("Failed to receive 2 bytes length"));
                 return ESP_FAIL;
             }
@@ -322,7 +334,7 @@ esp_err_t httpd_ws_recv_frame(httpd_req_t *req, httpd_ws_frame_t *frame, size_t
         } else if (init_len == 127) {
             /* Case 3: If length is byte 127, then this frame's length bit is 64 bits */
             uint8_t length_bytes[8] = { 0 };
-            if (httpd_recv_with_opt(req, (char *)length_bytes, sizeof(length_bytes), false) <= 0) {
+            if (httpd_ws_recv_exact(req, length_bytes, sizeof(length_bytes)) <= 0) {
                 ESP_LOGW(TAG, LOG_FMT("Failed to receive 2 bytes length"));
                 return ESP_FAIL;
             }
@@ -338,7 +350,7 @@ esp_err_t httpd_ws_recv_frame(httpd_req_t *req, httpd_ws_frame_t *frame, size_t
         }
         /* If this frame is masked, dump the mask as well */
         if (masked) {
-            if (httpd_recv_with_opt(req, (char *)aux->mask_key, sizeof(aux->mask_key), false) <= 0) {
+            if (httpd_ws_recv_exact(req, aux->mask_key, sizeof(aux->mask_key)) <= 0) {
                 ESP_LOGW(TAG, LOG_FMT("Failed to receive mask key"));
                 return ESP_FAIL;
             }
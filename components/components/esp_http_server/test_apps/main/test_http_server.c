@@ -1,12 +1,22 @@
 /*
- * SPDX-FileCopyrightText: 2018-2021 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
 #include <esp_system.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include <esp_http_server.h>
 
 #include "unity.h"
@@ -244,6 +254,589 @@ TEST_CASE("Max Allowed Sockets Test", "[HTTP SERVER]")
     TEST_ASSERT(httpd_start(&hd, &config) != ESP_OK);
 }
 
+/********************* Requests over loopback *******************/
+
+#define TEST_RESPONSE_SIZE 512
+
+static int test_connect(uint16_t port)
+{
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    TEST_ASSERT(fd >= 0);
+    struct timeval timeout = { .tv_sec = 5 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    TEST_ASSERT_EQUAL(0, connect(fd, (struct sockaddr *)&addr, sizeof(addr)));
+    return fd;
+}
+
+/* Sends a request on a connection, returns the status code of the
+ * response, or -1 on error, and copies its body to body */
+static int test_request_on(int fd, const char *method, const char *uri, char *body, size_t body_size)
+{
+    char buf[TEST_RESPONSE_SIZE];
+    int len = snprintf(buf, sizeof(buf), "%s %s HTTP/1.1\r\nHost: test\r\nContent-Length: 0\r\n\r\n", method, uri);
+    TEST_ASSERT_EQUAL(len, send(fd, buf, len, 0));
+
+    /* Receive the headers, then the body of Content-Length bytes */
+    int received = 0;
+    const char *content = NULL;
+    int content_length = 0;
+    while ((content == NULL) || (received < (content - buf) + content_length)) {
+        int ret = recv(fd, buf + received, sizeof(buf) - 1 - received, 0);
+        if (ret <= 0) {
+            break;
+        }
+        received += ret;
+        buf[received] = '\0';
+        const char *end = strstr(buf, "\r\n\r\n");
+        if ((content == NULL) && end) {
+            const char *length = strstr(buf, "Content-Length: ");
+            content = end + 4;
+            content_length = length ? atoi(length + strlen("Content-Length: ")) : 0;
+        }
+    }
+
+    int status = -1;
+    if ((content == NULL) || (received < (content - buf) + content_length) ||
+            (sscanf(buf, "HTTP/1.1 %d", &status) != 1)) {
+        return -1;
+    }
+    if (body) {
+        snprintf(body, body_size, "%.*s", content_length, content);
+    }
+    return status;
+}
+
+/* Same as test_request_on(), on a new connection */
+static int test_request(uint16_t port, const char *method, const char *uri, char *body, size_t body_size)
+{
+    int fd = test_connect(port);
+    int status = test_request_on(fd, method, uri, body, body_size);
+    close(fd);
+    return status;
+}
+
+/********************* URI Router Tests *******************/
+
+/* Responds with the index of the handler */
+static esp_err_t router_test_handler(httpd_req_t *req)
+{
+    char body[8];
+    snprintf(body, sizeof(body), "%d", (int)(intptr_t)req->user_ctx);
+    return httpd_resp_sendstr(req, body);
+}
+
+/* Looks up the handlers one by one with httpd_uri_match_wildcard(), as the server does without the router:
+ * returns the index of the first handler matching the URI and the method, or the expected error status */
+static int router_expected(const httpd_uri_t *uris, int count, httpd_method_t method, const char *uri, int *status)
+{
+    *status = 404;
+    for (int i = 0; i < count; i++) {
+        if (httpd_uri_match_wildcard(uris[i].uri, uri, strlen(uri))) {
+            if (uris[i].method == method || uris[i].method == HTTP_ANY) {
+                *status = 200;
+                return i;
+            }
+            *status = 405;
+        }
+    }
+    return -1;
+}
+
+static void test_router(const httpd_uri_t *uris, int count, const char *const *requests)
+{
+    httpd_handle_t hd;
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.uri_match_fn = httpd_uri_match_wildcard;
+    config.max_uri_handlers = count;
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_start(&hd, &config));
+    for (int i = 0; i < count; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &uris[i]));
+    }
+
+    static const struct {
+        const char *name;
+        httpd_method_t method;
+    } methods[] = { { "GET", HTTP_GET }, { "POST", HTTP_POST } };
+
+    for (const char *const *uri = requests; *uri; uri++) {
+        for (int m = 0; m < sizeof(methods) / sizeof(methods[0]); m++) {
+            int expected_status;
+            int expected_handler = router_expected(uris, count, methods[m].method, *uri, &expected_status);
+            char body[16];
+            int status = test_request(config.server_port, methods[m].name, *uri, body, sizeof(body));
+            printf("%s %s: %d %s\n", methods[m].name, *uri, status, (status == 200) ? body : "");
+            TEST_ASSERT_EQUAL(expected_status, status);
+            if (status == 200) {
+                TEST_ASSERT_EQUAL(expected_handler, atoi(body));
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+}
+
+#define ROUTER_URI(template, http_method, index) \
+    { .uri = template, .method = http_method, .handler = router_test_handler, .user_ctx = (void *)(index) }
+
+TEST_CASE("URI Router Wildcard Tests", "[HTTP SERVER]")
+{
+    /* Overlapping templates: the handler registered first wins among the ones
+     * matching the URI and the method, else the status tells which one failed.
+     * A handler can't be registered if an earlier one with its method matches its URI. */
+    static const httpd_uri_t uris[] = {
+        ROUTER_URI("/path/?*", HTTP_GET, 0),
+        ROUTER_URI("/path/exact", HTTP_POST, 1),
+        ROUTER_URI("/path/*", HTTP_POST, 2),
+        ROUTER_URI("/opt/?", HTTP_GET, 3),
+        ROUTER_URI("/opt/*", HTTP_ANY, 4),
+        ROUTER_URI("/exact", HTTP_GET, 5),
+        ROUTER_URI("/pre*", HTTP_POST, 6),
+        ROUTER_URI("/a/*/b", HTTP_GET, 7),
+    };
+    static const char *const requests[] = {
+        "/path", "/path/", "/path/x", "/path/exact", "/pathx", "/pat",
+        "/opt", "/opt/", "/opt/x", "/optx",
+        "/exact", "/exact/", "/exac",
+        "/pre", "/prefix", "/pr",
+        "/a/*/b", "/a/x/b", "/",
+        NULL
+    };
+
+    test_case_uses_tcpip();
+    test_router(uris, sizeof(uris) / sizeof(uris[0]), requests);
+}
+
+TEST_CASE("URI Router Catch-All Wildcard Tests", "[HTTP SERVER]")
+{
+    /* "*" matches every URI, so no request gets 404 */
+    static const httpd_uri_t uris[] = {
+        ROUTER_URI("/api/?*", HTTP_GET, 0),
+        ROUTER_URI("*", HTTP_POST, 1),
+        ROUTER_URI("/?", HTTP_GET, 2),
+    };
+    static const char *const requests[] = {
+        "/", "/api", "/api/", "/api/x", "/other", "/ap",
+        NULL
+    };
+
+    test_case_uses_tcpip();
+    test_router(uris, sizeof(uris) / sizeof(uris[0]), requests);
+}
+
+/********************* Send Tests *******************/
+
+#define TEST_SHORT_WRITE 5
+
+static const char test_send_expected[] =
+    "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: 11\r\n"
+    "X-Test-First: 1\r\nX-Test-Second: 2\r\n\r\nhello world";
+static const char test_chunked_expected[] =
+    "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nTransfer-Encoding: chunked\r\n\r\n"
+    "5\r\nfirst\r\n6\r\nsecond\r\n0\r\n\r\n";
+
+/* Number of calls to the send functions before one fails, or -1 */
+static int s_send_fail_after = -1;
+
+/* Sends at most TEST_SHORT_WRITE bytes, across buffers */
+static int test_short_sendv(httpd_handle_t hd, int sockfd, const struct iovec *iov, int iovcnt, int flags)
+{
+    if (s_send_fail_after >= 0 && s_send_fail_after-- == 0) {
+        return HTTPD_SOCK_ERR_FAIL;
+    }
+    struct iovec short_iov[iovcnt];
+    size_t left = TEST_SHORT_WRITE;
+    int count = 0;
+    for (; count < iovcnt && left > 0; count++) {
+        short_iov[count].iov_base = iov[count].iov_base;
+        short_iov[count].iov_len = MIN(iov[count].iov_len, left);
+        left -= short_iov[count].iov_len;
+    }
+    struct msghdr msg = {
+        .msg_iov = short_iov,
+        .msg_iovlen = count,
+    };
+    int ret = sendmsg(sockfd, &msg, flags);
+    return (ret < 0) ? HTTPD_SOCK_ERR_FAIL : ret;
+}
+
+/* Sends only the first buffer */
+static int test_first_buffer_sendv(httpd_handle_t hd, int sockfd, const struct iovec *iov, int iovcnt, int flags)
+{
+    if (s_send_fail_after >= 0 && s_send_fail_after-- == 0) {
+        return HTTPD_SOCK_ERR_FAIL;
+    }
+    int ret = send(sockfd, iov[0].iov_base, iov[0].iov_len, flags);
+    return (ret < 0) ? HTTPD_SOCK_ERR_FAIL : ret;
+}
+
+static int test_short_send(httpd_handle_t hd, int sockfd, const char *buf, size_t buf_len, int flags)
+{
+    int ret = send(sockfd, buf, MIN(buf_len, TEST_SHORT_WRITE), flags);
+    return (ret < 0) ? HTTPD_SOCK_ERR_FAIL : ret;
+}
+
+static esp_err_t test_short_sendv_open(httpd_handle_t hd, int sockfd)
+{
+    return httpd_sess_set_sendv_override(hd, sockfd, test_short_sendv);
+}
+
+static esp_err_t test_first_buffer_sendv_open(httpd_handle_t hd, int sockfd)
+{
+    return httpd_sess_set_sendv_override(hd, sockfd, test_first_buffer_sendv);
+}
+
+/* Replaces the default gathered send function too, the buffers are then sent one by one */
+static esp_err_t test_short_send_open(httpd_handle_t hd, int sockfd)
+{
+    return httpd_sess_set_send_override(hd, sockfd, test_short_send);
+}
+
+static esp_err_t test_send_handler(httpd_req_t *req)
+{
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_resp_set_hdr(req, "X-Test-First", "1"));
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_resp_set_hdr(req, "X-Test-Second", "2"));
+    return httpd_resp_sendstr(req, "hello world");
+}
+
+/* A chunk which failed is sent again, without the headers if they were sent */
+static esp_err_t test_chunked_handler(httpd_req_t *req)
+{
+    if (httpd_resp_send_chunk(req, "first", HTTPD_RESP_USE_STRLEN) != ESP_OK) {
+        TEST_ASSERT_EQUAL(ESP_OK, httpd_resp_send_chunk(req, "first", HTTPD_RESP_USE_STRLEN));
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_resp_send_chunk(req, "second", HTTPD_RESP_USE_STRLEN));
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+/* Sends a GET request on a new connection and checks that the response is the expected one */
+static void test_response(uint16_t port, const char *uri, const char *expected)
+{
+    char buf[TEST_RESPONSE_SIZE];
+    int fd = test_connect(port);
+    int len = snprintf(buf, sizeof(buf), "GET %s HTTP/1.1\r\nHost: test\r\n\r\n", uri);
+    TEST_ASSERT_EQUAL(len, send(fd, buf, len, 0));
+
+    int received = 0;
+    int expected_len = strlen(expected);
+    while (received < expected_len) {
+        int ret = recv(fd, buf + received, expected_len - received, 0);
+        if (ret <= 0) {
+            break;
+        }
+        received += ret;
+    }
+    buf[received] = '\0';
+    close(fd);
+    TEST_ASSERT_EQUAL_STRING(expected, buf);
+}
+
+static void test_send(httpd_open_func_t open_fn, int fail_after, const char *uri, const char *expected)
+{
+    httpd_handle_t hd;
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.open_fn = open_fn;
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_start(&hd, &config));
+    httpd_uri_t uris[] = {
+        { .uri = "/send", .method = HTTP_GET, .handler = test_send_handler },
+        { .uri = "/chunked", .method = HTTP_GET, .handler = test_chunked_handler },
+    };
+    for (int i = 0; i < sizeof(uris) / sizeof(uris[0]); i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &uris[i]));
+    }
+
+    s_send_fail_after = fail_after;
+    test_response(config.server_port, uri, expected);
+    s_send_fail_after = -1;
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+}
+
+TEST_CASE("Responses sent with short writes", "[HTTP SERVER]")
+{
+    test_case_uses_tcpip();
+    /* The gathered send function continues within the buffer it stopped in */
+    test_send(test_short_sendv_open, -1, "/send", test_send_expected);
+    test_send(test_short_sendv_open, -1, "/chunked", test_chunked_expected);
+    /* The send function overriding the default one sends the buffers one by one */
+    test_send(test_short_send_open, -1, "/send", test_send_expected);
+    test_send(test_short_send_open, -1, "/chunked", test_chunked_expected);
+}
+
+TEST_CASE("Headers are not sent again after a failed first chunk", "[HTTP SERVER]")
+{
+    test_case_uses_tcpip();
+    /* The headers are sent by the first call, the second one fails */
+    test_send(test_first_buffer_sendv_open, 1, "/chunked", test_chunked_expected);
+}
+
+/********************* Worker Tests *******************/
+
+#define TEST_WORKERS 3
+
+
+/* Responds with the task running the handler, after updating the session from it */
+static esp_err_t worker_task_handler(httpd_req_t *req)
+{
+    int fd = httpd_req_to_sockfd(req);
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_sess_update_lru_counter(req->handle, fd));
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_sess_set_pending_override(req->handle, fd, NULL));
+    char body[32];
+    snprintf(body, sizeof(body), "%p", (void *)xTaskGetCurrentTaskHandle());
+    return httpd_resp_sendstr(req, body);
+}
+
+static void worker_wake(void *arg)
+{
+}
+
+static void worker_async_task(void *arg)
+{
+    httpd_req_t *req = (httpd_req_t *)arg;
+    httpd_handle_t hd = req->handle;
+    vTaskDelay(pdMS_TO_TICKS(20));
+    httpd_resp_sendstr(req, "async");
+    httpd_req_async_handler_complete(req);
+    /* The server task waits for the session again once it wakes up */
+    httpd_queue_work(hd, worker_wake, NULL);
+    vTaskDelete(NULL);
+}
+
+/* Responds from another task, once the worker is done with the session */
+static esp_err_t worker_async_handler(httpd_req_t *req)
+{
+    httpd_req_t *async_req;
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_req_async_handler_begin(req, &async_req));
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(worker_async_task, "worker_async", 4096, async_req, 5, NULL));
+    return ESP_OK;
+}
+
+/* Responds after the server task ran the close, which waits for the worker */
+static esp_err_t worker_close_handler(httpd_req_t *req)
+{
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_sess_trigger_close(req->handle, httpd_req_to_sockfd(req)));
+    vTaskDelay(pdMS_TO_TICKS(50));
+    return httpd_resp_sendstr(req, "closing");
+}
+
+static httpd_handle_t test_worker_start(httpd_config_t *config)
+{
+    static const httpd_uri_t uris[] = {
+        { .uri = "/task", .method = HTTP_GET, .handler = worker_task_handler },
+        { .uri = "/async", .method = HTTP_GET, .handler = worker_async_handler },
+        { .uri = "/close", .method = HTTP_GET, .handler = worker_close_handler },
+    };
+    httpd_handle_t hd;
+    config->worker_count = TEST_WORKERS;
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_start(&hd, config));
+    for (int i = 0; i < sizeof(uris) / sizeof(uris[0]); i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &uris[i]));
+    }
+    return hd;
+}
+
+TEST_CASE("Worker Session Affinity Tests", "[HTTP SERVER]")
+{
+    /* More sessions than workers, their requests interleaved */
+    const int session_count = TEST_WORKERS + 1;
+    const int request_count = 4;
+    int fds[session_count];
+    char tasks[session_count][32];
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+
+    test_case_uses_tcpip();
+    httpd_handle_t hd = test_worker_start(&config);
+    for (int i = 0; i < session_count; i++) {
+        fds[i] = test_connect(config.server_port);
+    }
+
+    for (int r = 0; r < request_count; r++) {
+        for (int i = 0; i < session_count; i++) {
+            char task[32];
+            TEST_ASSERT_EQUAL(200, test_request_on(fds[i], "GET", "/task", task, sizeof(task)));
+            if (r == 0) {
+                strcpy(tasks[i], task);
+            }
+            /* A session is always run by the same worker */
+            TEST_ASSERT_EQUAL_STRING(tasks[i], task);
+        }
+    }
+
+    /* and the sessions are spread over the workers */
+    bool spread = false;
+    for (int i = 1; i < session_count; i++) {
+        spread |= (strcmp(tasks[0], tasks[i]) != 0);
+    }
+    TEST_ASSERT_TRUE(spread);
+
+    for (int i = 0; i < session_count; i++) {
+        close(fds[i]);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+}
+
+TEST_CASE("Worker Async Handler Tests", "[HTTP SERVER]")
+{
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    char body[32];
+
+    test_case_uses_tcpip();
+    httpd_handle_t hd = test_worker_start(&config);
+    int fd = test_connect(config.server_port);
+
+    /* The session is waited for again once the asynchronous request completed */
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(200, test_request_on(fd, "GET", "/async", body, sizeof(body)));
+        TEST_ASSERT_EQUAL_STRING("async", body);
+        TEST_ASSERT_EQUAL(200, test_request_on(fd, "GET", "/task", body, sizeof(body)));
+    }
+
+    close(fd);
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+}
+
+TEST_CASE("Worker Trigger Close Tests", "[HTTP SERVER]")
+{
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    char body[32];
+
+    test_case_uses_tcpip();
+    httpd_handle_t hd = test_worker_start(&config);
+    int fd = test_connect(config.server_port);
+
+    /* The session is closed once the handler returned, not while it runs */
+    TEST_ASSERT_EQUAL(200, test_request_on(fd, "GET", "/close", body, sizeof(body)));
+    TEST_ASSERT_EQUAL_STRING("closing", body);
+    TEST_ASSERT_EQUAL(0, recv(fd, body, sizeof(body), 0));
+
+    /* The other sessions are not affected */
+    TEST_ASSERT_EQUAL(200, test_request(config.server_port, "GET", "/task", body, sizeof(body)));
+
+    close(fd);
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+}
+
+#if CONFIG_HTTPD_WS_SUPPORT
+
+/********************* WebSocket Tests *******************/
+
+#define WS_TEST_MAX_LEN 1000
+
+/* Offset of the payload buffer of the next frame from a word boundary */
+static int s_ws_payload_align;
+
+/* Receives the frame at the offset, and sends it back */
+static esp_err_t ws_echo_handler(httpd_req_t *req)
+{
+    static size_t buf[(WS_TEST_MAX_LEN + sizeof(size_t)) / sizeof(size_t) + 1];
+    if (req->method == HTTP_GET) {
+        return ESP_OK;
+    }
+
+    httpd_ws_frame_t frame = { .payload = NULL };
+    esp_err_t ret = httpd_ws_recv_frame(req, &frame, 0);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    frame.payload = (uint8_t *)buf + s_ws_payload_align;
+    ret = httpd_ws_recv_frame(req, &frame, WS_TEST_MAX_LEN);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return httpd_ws_send_frame(req, &frame);
+}
+
+static void ws_recv_exact(int fd, uint8_t *buf, size_t len)
+{
+    for (size_t received = 0; received < len;) {
+        int ret = recv(fd, buf + received, len - received, 0);
+        TEST_ASSERT(ret > 0);
+        received += ret;
+    }
+}
+
+static int ws_connect(uint16_t port)
+{
+    int fd = test_connect(port);
+    const char *request = "GET /ws HTTP/1.1\r\nHost: test\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                          "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+    TEST_ASSERT_EQUAL(strlen(request), send(fd, request, strlen(request), 0));
+
+    /* The response ends with an empty line, read up to it only */
+    char response[TEST_RESPONSE_SIZE] = { 0 };
+    size_t len = 0;
+    while (len < 4 || memcmp(response + len - 4, "\r\n\r\n", 4) != 0) {
+        TEST_ASSERT(len < sizeof(response) - 1);
+        ws_recv_exact(fd, (uint8_t *)response + len, 1);
+        len++;
+    }
+    TEST_ASSERT_EQUAL(0, strncmp(response, "HTTP/1.1 101", strlen("HTTP/1.1 101")));
+    return fd;
+}
+
+TEST_CASE("WebSocket frames unmasked at any alignment", "[HTTP SERVER]")
+{
+    static const size_t lengths[] = { 1, 7, 8, 9, 125, 126, 300, WS_TEST_MAX_LEN };
+    /* The frame is sent in uneven parts, received by the server in as many */
+    static const size_t part_sizes[] = { 1, 3, 40, 7, 2, 13 };
+    static const uint8_t mask_key[] = { 0x12, 0x34, 0x56, 0x78 };
+    static uint8_t payload[WS_TEST_MAX_LEN], frame[WS_TEST_MAX_LEN + 8];
+    httpd_handle_t hd;
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    httpd_uri_t ws = {
+        .uri = "/ws",
+        .method = HTTP_GET,
+        .handler = ws_echo_handler,
+        .is_websocket = true,
+    };
+
+    test_case_uses_tcpip();
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_start(&hd, &config));
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &ws));
+    int fd = ws_connect(config.server_port);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = i * 7 + 1;
+    }
+    for (int l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        size_t len = lengths[l];
+        size_t header_len = (len < 126) ? 2 : 4;
+        frame[0] = 0x80 | HTTPD_WS_TYPE_BINARY;
+        frame[1] = 0x80 | ((len < 126) ? len : 126);
+        frame[2] = len >> 8;
+        frame[3] = len & 0xff;
+        memcpy(frame + header_len, mask_key, sizeof(mask_key));
+        for (size_t i = 0; i < len; i++) {
+            frame[header_len + 4 + i] = payload[i] ^ mask_key[i % 4];
+        }
+
+        for (s_ws_payload_align = 0; s_ws_payload_align < sizeof(size_t); s_ws_payload_align++) {
+            size_t frame_len = header_len + 4 + len;
+            size_t sent = 0;
+            for (int p = 0; sent < frame_len; p++) {
+                size_t part = MIN(part_sizes[p % (sizeof(part_sizes) / sizeof(part_sizes[0]))], frame_len - sent);
+                TEST_ASSERT_EQUAL(part, send(fd, frame + sent, part, 0));
+                sent += part;
+            }
+
+            /* The server sends the payload back unmasked */
+            uint8_t echo[WS_TEST_MAX_LEN + 4];
+            ws_recv_exact(fd, echo, header_len + len);
+            TEST_ASSERT_EQUAL(0x80 | HTTPD_WS_TYPE_BINARY, echo[0]);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(payload, echo + header_len, len);
+        }
+    }
+
+    close(fd);
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+}
+
+#endif // CONFIG_HTTPD_WS_SUPPORT
+
 void app_main(void)
 {
     unity_run_menu();
@@ -0,0 +1,581 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Throughput of the HTTP server, measured with client tasks sending keep-alive requests over the
+ * loopback interface, against the number of sessions, of URI handlers and of worker tasks, response
+ * time of the send functions, and WebSocket throughput. The server and the clients need more sockets than the default configuration
+ * has, the tests are built with sdkconfig.ci.performance.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include <esp_http_server.h>
+#include "esp_transport.h"
+#include "esp_transport_tcp.h"
+#include "esp_transport_ws.h"
+
+#include "unity.h"
+#include "test_utils.h"
+
+#if CONFIG_LWIP_MAX_SOCKETS >= 48
+
+#define IDF_LOG_PERFORMANCE(item, value_fmt, value, ...) \
+    printf("[Performance][%s]: " value_fmt "\n", item, value, ##__VA_ARGS__)
+
+#define PERF_PORT               8090
+#define PERF_DURATION_US        (2 * 1000 * 1000)
+#define PERF_BUSY_CLIENTS       2
+#define PERF_RESPONSE_SIZE      512
+
+static const char perf_body[] = "hello";
+
+static esp_err_t perf_hello_handler(httpd_req_t *req)
+{
+    return httpd_resp_send(req, perf_body, sizeof(perf_body) - 1);
+}
+
+static httpd_handle_t perf_start_server(httpd_config_t *config)
+{
+    httpd_handle_t hd;
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_start(&hd, config));
+    httpd_uri_t uri = {
+        .uri      = "/hello",
+        .method   = HTTP_GET,
+        .handler  = perf_hello_handler,
+        .user_ctx = NULL,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &uri));
+    return hd;
+}
+
+static int perf_connect(uint16_t port)
+{
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* A response ends after Content-Length bytes of body, or with the last chunk */
+static bool perf_response_complete(const char *buf, int received)
+{
+    const char *end = strstr(buf, "\r\n\r\n");
+    if (end == NULL) {
+        return false;
+    }
+    const char *length = strstr(buf, "Content-Length: ");
+    if (length) {
+        return received >= (end + 4 - buf) + atoi(length + strlen("Content-Length: "));
+    }
+    const char *last_chunk = "\r\n0\r\n\r\n";
+    return (received >= strlen(last_chunk)) && (strcmp(buf + received - strlen(last_chunk), last_chunk) == 0);
+}
+
+/* Sends a keep-alive GET request and receives the whole response, returns false on any error */
+static bool perf_request(int fd, const char *uri)
+{
+    char buf[PERF_RESPONSE_SIZE];
+    int len = snprintf(buf, sizeof(buf), "GET %s HTTP/1.1\r\nHost: test\r\n\r\n", uri);
+    if (send(fd, buf, len, 0) != len) {
+        return false;
+    }
+
+    int received = 0;
+    buf[0] = '\0';
+    while (!perf_response_complete(buf, received)) {
+        int ret = recv(fd, buf + received, sizeof(buf) - 1 - received, 0);
+        if (ret <= 0) {
+            return false;
+        }
+        received += ret;
+        buf[received] = '\0';
+    }
+    return strncmp(buf, "HTTP/1.1 200", strlen("HTTP/1.1 200")) == 0;
+}
+
+/* Latencies are counted in buckets of PERF_LATENCY_BUCKET_US, the last one counts the longer ones */
+#define PERF_LATENCY_BUCKET_US  50
+#define PERF_LATENCY_BUCKETS    400
+
+typedef struct {
+    uint16_t port;
+    const char *uri;
+    int64_t end_us;
+    uint32_t requests;
+    uint32_t *latencies;                    /* PERF_LATENCY_BUCKETS counters, or NULL */
+    bool failed;
+    SemaphoreHandle_t done;
+} perf_client_t;
+
+static void perf_client_task(void *arg)
+{
+    perf_client_t *client = (perf_client_t *)arg;
+    int fd = perf_connect(client->port);
+    client->failed = (fd < 0);
+    while (!client->failed && (esp_timer_get_time() < client->end_us)) {
+        int64_t start = esp_timer_get_time();
+        client->failed = !perf_request(fd, client->uri);
+        client->requests++;
+        if (client->latencies) {
+            int64_t bucket = (esp_timer_get_time() - start) / PERF_LATENCY_BUCKET_US;
+            client->latencies[MIN(bucket, PERF_LATENCY_BUCKETS - 1)]++;
+        }
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    xSemaphoreGive(client->done);
+    vTaskDelete(NULL);
+}
+
+/* Starts the clients, each keeps one request in flight until end_us, and gives done when it stops */
+static void perf_start_clients(perf_client_t *clients, int count, uint16_t port, const char *uri,
+                               int64_t end_us, uint32_t *latencies, SemaphoreHandle_t done)
+{
+    for (int i = 0; i < count; i++) {
+        clients[i] = (perf_client_t) {
+            .port = port,
+            .uri = uri,
+            .end_us = end_us,
+            .latencies = latencies ? latencies + i * PERF_LATENCY_BUCKETS : NULL,
+            .done = done,
+        };
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(perf_client_task, "perf_client", 4096, &clients[i],
+                                              uxTaskPriorityGet(NULL), NULL));
+    }
+}
+
+static uint32_t perf_clients_requests(const perf_client_t *clients, int count)
+{
+    uint32_t requests = 0;
+    for (int i = 0; i < count; i++) {
+        TEST_ASSERT_FALSE(clients[i].failed);
+        requests += clients[i].requests;
+    }
+    return requests;
+}
+
+/* Runs the clients for PERF_DURATION_US and returns the requests per second */
+static uint32_t perf_run_clients(uint16_t port, const char *uri, int count)
+{
+    perf_client_t clients[count];
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(count, 0);
+    TEST_ASSERT_NOT_NULL(done);
+
+    int64_t start = esp_timer_get_time();
+    perf_start_clients(clients, count, port, uri, start + PERF_DURATION_US, NULL, done);
+    for (int i = 0; i < count; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(done, portMAX_DELAY));
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start;
+    uint32_t requests = perf_clients_requests(clients, count);
+    vSemaphoreDelete(done);
+    return (uint32_t)((int64_t)requests * 1000000 / elapsed_us);
+}
+
+/*
+ * Two clients keep requests in flight while the other sessions stay open and idle,
+ * so that the server visits a full session table on every request.
+ */
+TEST_CASE("HTTP server requests per second against max_open_sockets", "[HTTP SERVER][performance]")
+{
+    static const int socket_counts[] = { 4, 7, 12, 20 };
+
+    test_case_uses_tcpip();
+
+    for (int i = 0; i < sizeof(socket_counts) / sizeof(socket_counts[0]); i++) {
+        httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+        config.max_open_sockets = socket_counts[i];
+        config.server_port = PERF_PORT + i;
+        httpd_handle_t hd = perf_start_server(&config);
+
+        int idle_fds[socket_counts[i]];
+        int idle_count = socket_counts[i] - PERF_BUSY_CLIENTS;
+        for (int j = 0; j < idle_count; j++) {
+            idle_fds[j] = perf_connect(config.server_port);
+            TEST_ASSERT(idle_fds[j] >= 0);
+        }
+
+        uint32_t rate = perf_run_clients(config.server_port, "/hello", PERF_BUSY_CLIENTS);
+
+        for (int j = 0; j < idle_count; j++) {
+            close(idle_fds[j]);
+        }
+        TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+        IDF_LOG_PERFORMANCE("httpd_requests_per_sec", "%" PRIu32 " req/s with max_open_sockets %d",
+                            rate, socket_counts[i]);
+    }
+}
+
+/* Same matching as httpd_uri_match_wildcard(), but unknown to the server, which then scans the handlers one by one */
+static bool perf_match_linear(const char *uri_template, const char *uri_to_match, size_t match_upto)
+{
+    return httpd_uri_match_wildcard(uri_template, uri_to_match, match_upto);
+}
+
+static uint32_t perf_uri_lookup(int handler_count, httpd_uri_match_func_t match_fn, uint16_t port)
+{
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = port;
+    config.max_uri_handlers = handler_count;
+    config.uri_match_fn = match_fn;
+    httpd_handle_t hd;
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_start(&hd, &config));
+
+    char uri[32];
+    for (int i = 0; i < handler_count; i++) {
+        snprintf(uri, sizeof(uri), "/handler/%d", i);
+        httpd_uri_t handler = {
+            .uri      = uri,
+            .method   = HTTP_GET,
+            .handler  = perf_hello_handler,
+            .user_ctx = NULL,
+        };
+        TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &handler));
+    }
+
+    /* The handler registered last is the one the linear scan finds last */
+    uint32_t rate = perf_run_clients(port, uri, PERF_BUSY_CLIENTS);
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+    return rate;
+}
+
+TEST_CASE("HTTP server URI lookup against the number of handlers", "[HTTP SERVER][performance]")
+{
+    static const int handler_counts[] = { 8, 64, 256 };
+
+    test_case_uses_tcpip();
+
+    for (int i = 0; i < sizeof(handler_counts) / sizeof(handler_counts[0]); i++) {
+        uint32_t router = perf_uri_lookup(handler_counts[i], httpd_uri_match_wildcard, PERF_PORT + 2 * i);
+        uint32_t linear = perf_uri_lookup(handler_counts[i], perf_match_linear, PERF_PORT + 2 * i + 1);
+        IDF_LOG_PERFORMANCE("httpd_uri_router_requests_per_sec", "%" PRIu32 " req/s with %d handlers",
+                            router, handler_counts[i]);
+        IDF_LOG_PERFORMANCE("httpd_uri_linear_requests_per_sec", "%" PRIu32 " req/s with %d handlers",
+                            linear, handler_counts[i]);
+    }
+}
+
+/* Response with headers set by the handler, and chunked response */
+static esp_err_t perf_headers_handler(httpd_req_t *req)
+{
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "X-Request-Id", "1234");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    return httpd_resp_send(req, perf_body, sizeof(perf_body) - 1);
+}
+
+static esp_err_t perf_chunked_handler(httpd_req_t *req)
+{
+    for (int i = 0; i < 3; i++) {
+        esp_err_t ret = httpd_resp_send_chunk(req, perf_body, sizeof(perf_body) - 1);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+static int perf_send(httpd_handle_t hd, int sockfd, const char *buf, size_t buf_len, int flags)
+{
+    int ret = send(sockfd, buf, buf_len, flags);
+    return (ret < 0) ? HTTPD_SOCK_ERR_FAIL : ret;
+}
+
+/* Without a gathered send function, the server sends the parts of a response one by one */
+static esp_err_t perf_send_open(httpd_handle_t hd, int sockfd)
+{
+    return httpd_sess_set_send_override(hd, sockfd, perf_send);
+}
+
+static void perf_response(httpd_open_func_t open_fn, uint16_t port, uint32_t *headers_rate, uint32_t *chunked_rate)
+{
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = port;
+    config.open_fn = open_fn;
+    httpd_handle_t hd;
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_start(&hd, &config));
+    httpd_uri_t uris[] = {
+        { .uri = "/headers", .method = HTTP_GET, .handler = perf_headers_handler },
+        { .uri = "/chunked", .method = HTTP_GET, .handler = perf_chunked_handler },
+    };
+    for (int i = 0; i < sizeof(uris) / sizeof(uris[0]); i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &uris[i]));
+    }
+
+    /* A single client, the time per request is the response time */
+    *headers_rate = perf_run_clients(port, "/headers", 1);
+    *chunked_rate = perf_run_clients(port, "/chunked", 1);
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+}
+
+TEST_CASE("HTTP server response time with gathered and separate sends", "[HTTP SERVER][performance]")
+{
+    uint32_t headers_rate, chunked_rate;
+
+    test_case_uses_tcpip();
+
+    perf_response(NULL, PERF_PORT, &headers_rate, &chunked_rate);
+    IDF_LOG_PERFORMANCE("httpd_resp_send_gathered_us", "%" PRIu32 " us per response with 3 headers",
+                        1000000 / headers_rate);
+    IDF_LOG_PERFORMANCE("httpd_resp_send_chunk_gathered_us", "%" PRIu32 " us per response of 3 chunks",
+                        1000000 / chunked_rate);
+
+    perf_response(perf_send_open, PERF_PORT + 1, &headers_rate, &chunked_rate);
+    IDF_LOG_PERFORMANCE("httpd_resp_send_separate_us", "%" PRIu32 " us per response with 3 headers",
+                        1000000 / headers_rate);
+    IDF_LOG_PERFORMANCE("httpd_resp_send_chunk_separate_us", "%" PRIu32 " us per response of 3 chunks",
+                        1000000 / chunked_rate);
+}
+
+#define PERF_FAST_CLIENTS       6
+#define PERF_SLOW_CLIENTS       2
+#define PERF_SLOW_HANDLER_MS    5
+
+static esp_err_t perf_slow_handler(httpd_req_t *req)
+{
+    vTaskDelay(pdMS_TO_TICKS(PERF_SLOW_HANDLER_MS));
+    return httpd_resp_send(req, perf_body, sizeof(perf_body) - 1);
+}
+
+/* Upper bound of the latency of the given percentage of the requests, from the counters of all the clients */
+static uint32_t perf_latency_percentile(const uint32_t *latencies, int clients, uint32_t requests, int percent)
+{
+    uint64_t counted = 0;
+    for (int bucket = 0; bucket < PERF_LATENCY_BUCKETS; bucket++) {
+        for (int i = 0; i < clients; i++) {
+            counted += latencies[i * PERF_LATENCY_BUCKETS + bucket];
+        }
+        if (counted * 100 >= (uint64_t)requests * percent) {
+            return (bucket + 1) * PERF_LATENCY_BUCKET_US;
+        }
+    }
+    return PERF_LATENCY_BUCKETS * PERF_LATENCY_BUCKET_US;
+}
+
+/*
+ * Clients of a fast handler run along with clients of a handler blocking for PERF_SLOW_HANDLER_MS:
+ * without worker tasks, the fast requests wait for the slow ones.
+ */
+TEST_CASE("HTTP server worker tasks with a slow handler", "[HTTP SERVER][performance]")
+{
+    static const int worker_counts[] = { 0, 2, 4 };
+
+    test_case_uses_tcpip();
+
+    uint32_t *latencies = calloc(PERF_FAST_CLIENTS * PERF_LATENCY_BUCKETS, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(latencies);
+    for (int i = 0; i < sizeof(worker_counts) / sizeof(worker_counts[0]); i++) {
+        httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+        config.server_port = PERF_PORT + i;
+        config.max_open_sockets = PERF_FAST_CLIENTS + PERF_SLOW_CLIENTS;
+        config.worker_count = worker_counts[i];
+        httpd_handle_t hd = perf_start_server(&config);
+        httpd_uri_t slow_uri = {
+            .uri      = "/slow",
+            .method   = HTTP_GET,
+            .handler  = perf_slow_handler,
+            .user_ctx = NULL,
+        };
+        TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &slow_uri));
+
+        perf_client_t fast[PERF_FAST_CLIENTS];
+        perf_client_t slow[PERF_SLOW_CLIENTS];
+        SemaphoreHandle_t done = xSemaphoreCreateCounting(PERF_FAST_CLIENTS + PERF_SLOW_CLIENTS, 0);
+        TEST_ASSERT_NOT_NULL(done);
+        memset(latencies, 0, PERF_FAST_CLIENTS * PERF_LATENCY_BUCKETS * sizeof(uint32_t));
+
+        int64_t start = esp_timer_get_time();
+        perf_start_clients(slow, PERF_SLOW_CLIENTS, config.server_port, "/slow", start + PERF_DURATION_US, NULL, done);
+        perf_start_clients(fast, PERF_FAST_CLIENTS, config.server_port, "/hello", start + PERF_DURATION_US, latencies, done);
+        for (int j = 0; j < PERF_FAST_CLIENTS + PERF_SLOW_CLIENTS; j++) {
+            TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(done, portMAX_DELAY));
+        }
+        int64_t elapsed_us = esp_timer_get_time() - start;
+        uint32_t requests = perf_clients_requests(fast, PERF_FAST_CLIENTS);
+        perf_clients_requests(slow, PERF_SLOW_CLIENTS);
+        vSemaphoreDelete(done);
+        TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+
+        IDF_LOG_PERFORMANCE("httpd_workers_requests_per_sec", "%" PRIu32 " fast req/s with %d workers",
+                            (uint32_t)((int64_t)requests * 1000000 / elapsed_us), worker_counts[i]);
+        IDF_LOG_PERFORMANCE("httpd_workers_latency_p50_us", "%" PRIu32 " us with %d workers",
+                            perf_latency_percentile(latencies, PERF_FAST_CLIENTS, requests, 50), worker_counts[i]);
+        IDF_LOG_PERFORMANCE("httpd_workers_latency_p99_us", "%" PRIu32 " us with %d workers",
+                            perf_latency_percentile(latencies, PERF_FAST_CLIENTS, requests, 99), worker_counts[i]);
+    }
+    free(latencies);
+}
+
+#if CONFIG_HTTPD_WS_SUPPORT
+
+#define PERF_WS_MAX_LEN         (64 * 1024)
+#define PERF_WS_TIMEOUT_MS      5000
+
+/* Receives a frame into the buffer of the handler, and acknowledges it with a one byte frame */
+static esp_err_t perf_ws_handler(httpd_req_t *req)
+{
+    if (req->method == HTTP_GET) {
+        return ESP_OK;
+    }
+
+    httpd_ws_frame_t frame = { .payload = NULL };
+    esp_err_t ret = httpd_ws_recv_frame(req, &frame, 0);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    frame.payload = req->user_ctx;
+    ret = httpd_ws_recv_frame(req, &frame, PERF_WS_MAX_LEN);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    httpd_ws_frame_t ack = {
+        .final = true,
+        .type = HTTPD_WS_TYPE_BINARY,
+        .payload = (uint8_t *)perf_body,
+        .len = 1,
+    };
+    return httpd_ws_send_frame(req, &ack);
+}
+
+/* The header and the payload of an ack frame are sent separately, the payload mustn't wait for the TCP ack of the header */
+static esp_err_t perf_ws_open(httpd_handle_t hd, int sockfd)
+{
+    int one = 1;
+    return (setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) == 0) ? ESP_OK : ESP_FAIL;
+}
+
+typedef struct {
+    httpd_handle_t hd;
+    esp_transport_handle_t tcp;
+    esp_transport_handle_t ws;
+    uint8_t *server_buf;
+    char *client_buf;
+} perf_ws_t;
+
+/* Starts a server with a WebSocket handler, and connects a client of the WebSocket transport to it */
+static void perf_ws_start(perf_ws_t *perf, uint16_t port)
+{
+    perf->server_buf = malloc(PERF_WS_MAX_LEN);
+    perf->client_buf = malloc(PERF_WS_MAX_LEN);
+    TEST_ASSERT_NOT_NULL(perf->server_buf);
+    TEST_ASSERT_NOT_NULL(perf->client_buf);
+    memset(perf->client_buf, 0x5a, PERF_WS_MAX_LEN);
+
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = port;
+    config.open_fn = perf_ws_open;
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_start(&perf->hd, &config));
+    httpd_uri_t ws_uri = {
+        .uri          = "/ws",
+        .method       = HTTP_GET,
+        .handler      = perf_ws_handler,
+        .user_ctx     = perf->server_buf,
+        .is_websocket = true,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(perf->hd, &ws_uri));
+
+    perf->tcp = esp_transport_tcp_init();
+    perf->ws = esp_transport_ws_init(perf->tcp);
+    TEST_ASSERT_NOT_NULL(perf->ws);
+    esp_transport_ws_set_path(perf->ws, "/ws");
+    TEST_ASSERT_EQUAL(0, esp_transport_connect(perf->ws, "127.0.0.1", port, PERF_WS_TIMEOUT_MS));
+}
+
+static void perf_ws_stop(perf_ws_t *perf)
+{
+    esp_transport_close(perf->ws);
+    esp_transport_destroy(perf->ws);
+    esp_transport_destroy(perf->tcp);
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(perf->hd));
+    free(perf->client_buf);
+    free(perf->server_buf);
+}
+
+/*
+ * Sends binary frames of the given size, masked by the client and unmasked by the server, one at a time
+ * for PERF_DURATION_US, and returns the number of frames per second
+ */
+static uint32_t perf_ws_frames(perf_ws_t *perf, int size)
+{
+    uint32_t frames = 0;
+    int64_t start = esp_timer_get_time();
+    int64_t elapsed_us;
+    do {
+        char ack;
+        TEST_ASSERT_EQUAL(size, esp_transport_write(perf->ws, perf->client_buf, size, PERF_WS_TIMEOUT_MS));
+        TEST_ASSERT_EQUAL(1, esp_transport_read(perf->ws, &ack, 1, PERF_WS_TIMEOUT_MS));
+        frames++;
+        elapsed_us = esp_timer_get_time() - start;
+    } while (elapsed_us < PERF_DURATION_US);
+    return (uint32_t)((int64_t)frames * 1000000 / elapsed_us);
+}
+
+/* Throughput of large frames, which includes the masking of both sides */
+TEST_CASE("HTTP server WebSocket throughput against the frame size", "[HTTP SERVER][performance]")
+{
+    static const int frame_sizes[] = { 1024, 4096, 16384, PERF_WS_MAX_LEN };
+    perf_ws_t perf;
+
+    test_case_uses_tcpip();
+
+    perf_ws_start(&perf, PERF_PORT);
+    for (int i = 0; i < sizeof(frame_sizes) / sizeof(frame_sizes[0]); i++) {
+        uint32_t frames = perf_ws_frames(&perf, frame_sizes[i]);
+        IDF_LOG_PERFORMANCE("httpd_ws_throughput_kb_per_sec", "%" PRIu32 " KB/s with %d byte frames",
+                            (uint32_t)((uint64_t)frames * frame_sizes[i] / 1024), frame_sizes[i]);
+    }
+    perf_ws_stop(&perf);
+}
+
+/*
+ * Rate of small frames, each acknowledged by the server once received whole: a frame written by the client
+ * in several parts, whose last part waits for the TCP ack of the first one, takes a delayed ack longer.
+ */
+TEST_CASE("HTTP server WebSocket frames per second against the frame size", "[HTTP SERVER][performance]")
+{
+    static const int frame_sizes[] = { 16, 125, 1024 };
+    perf_ws_t perf;
+
+    test_case_uses_tcpip();
+
+    perf_ws_start(&perf, PERF_PORT);
+    for (int i = 0; i < sizeof(frame_sizes) / sizeof(frame_sizes[0]); i++) {
+        IDF_LOG_PERFORMANCE("httpd_ws_frames_per_sec", "%" PRIu32 " frames/s with %d byte frames",
+                            perf_ws_frames(&perf, frame_sizes[i]), frame_sizes[i]);
+    }
+    perf_ws_stop(&perf);
+}
+
+#endif // CONFIG_HTTPD_WS_SUPPORT
+
+#endif // CONFIG_LWIP_MAX_SOCKETS >= 48
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2023-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2023-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -91,6 +91,28 @@ RingbufHandle_t xRingbufferCreate(size_t xBufferSize, RingbufferType_t xBufferTy
  */
 RingbufHandle_t xRingbufferCreateNoSplit(size_t xItemSize, size_t xItemNum);
 
+/**
+ * @brief       Create a ring buffer for a single sending task and a single receiving task
+ *
+ * The returned ring buffer is used with the same functions as other ring buffers. Sending, receiving
+ * and returning items only update the write and free positions with atomic operations, without entering
+ * a critical section. The critical section is only entered when a task has to block, or to unblock the
+ * task on the other side.
+ *
+ * @param[in]   xBufferSize Size of the buffer in bytes. Byte buffers can hold xBufferSize bytes.
+ *              No-split buffers require one header and alignment per item, see xRingbufferCreate().
+ * @param[in]   xBufferType Type of ring buffer, RINGBUF_TYPE_NOSPLIT or RINGBUF_TYPE_BYTEBUF.
+ *
+ * @note    Items must only be sent by one task (or ISR) at a time, and only be received and returned by one task
+ *          (or ISR) at a time. The sender and the receiver may run concurrently on different cores.
+ * @note    xRingbufferSendAcquire() and xRingbufferSendComplete() are not supported.
+ * @note    vRingbufferGetInfo() and xRingbufferGetCurFreeSize() are only accurate when called by the sender
+ *          or while neither side accesses the ring buffer.
+ *
+ * @return  A handle to the created ring buffer, or NULL in case of failure.
+ */
+RingbufHandle_t xRingbufferCreateSPSC(size_t xBufferSize, RingbufferType_t xBufferType);
+
 /**
  * @brief       Create a ring buffer but manually provide the required memory
  *
@@ -168,6 +190,34 @@ BaseType_t xRingbufferSendFromISR(RingbufHandle_t xRingbuffer,
                                   size_t xItemSize,
                                   BaseType_t *pxHigherPriorityTaskWoken);
 
+/**
+ * @brief       Insert multiple items into the ring buffer
+ *
+ * Attempt to insert items into the ring buffer in a single critical section.
+ * This function will block until the first item fits or until it times out.
+ * The following items are then inserted in order for as long as they fit,
+ * without blocking again. Tasks waiting to receive are woken up once for the
+ * whole batch (one task per item inserted, at most).
+ *
+ * @param[in]   xRingbuffer     Ring buffer to insert the items into
+ * @param[in]   ppvItems        Array of pointers to the data of each item. NULL is allowed for an item of size 0.
+ * @param[in]   pxItemSizes     Array of the sizes of each item
+ * @param[in]   uxItemCount     Number of items in ppvItems and pxItemSizes
+ * @param[in]   xTicksToWait    Ticks to wait for room in the ring buffer for the first item.
+ *
+ * @note    Items are stored the same way as with xRingbufferSend(). For byte
+ *          buffers, the data of all items is simply appended.
+ * @note    Items are only inserted up to the first item that is larger than
+ *          the maximum permissible size of the buffer.
+ *
+ * @return  Number of items inserted, counted from the start of ppvItems. 0 on time-out.
+ */
+UBaseType_t xRingbufferSendMultiple(RingbufHandle_t xRingbuffer,
+                                    const void *const *ppvItems,
+                                    const size_t *pxItemSizes,
+                                    UBaseType_t uxItemCount,
+                                    TickType_t xTicksToWait);
+
 /**
  * @brief Acquire memory from the ring buffer to be written to by an external
  *        source and to be sent later.
@@ -234,6 +284,32 @@ BaseType_t xRingbufferSendComplete(RingbufHandle_t xRingbuffer, void *pvItem);
  */
 void *xRingbufferReceive(RingbufHandle_t xRingbuffer, size_t *pxItemSize, TickType_t xTicksToWait);
 
+/**
+ * @brief   Retrieve multiple items from a no-split ring buffer
+ *
+ * Attempt to retrieve up to uxMaxItems items from the ring buffer in a single
+ * critical section. This function will block until an item is available or
+ * until it times out, then retrieves all further items that are available at
+ * that point, up to uxMaxItems. The items are not copied, the pointers point
+ * into the ring buffer's storage area.
+ *
+ * @param[in]   xRingbuffer     Ring buffer to retrieve the items from
+ * @param[out]  ppvItems        Array of at least uxMaxItems entries to which the pointers to the retrieved items will be written
+ * @param[out]  pxItemSizes     Array of at least uxMaxItems entries to which the sizes of the retrieved items will be written
+ * @param[in]   uxMaxItems      Maximum number of items to retrieve
+ * @param[in]   xTicksToWait    Ticks to wait for items in the ring buffer.
+ *
+ * @note    All retrieved items must be returned, either by vRingbufferReturnMultiple() or one by one with vRingbufferReturnItem().
+ * @note    This function should only be called on no-split buffers
+ *
+ * @return  Number of items retrieved, 0 on timeout.
+ */
+UBaseType_t xRingbufferReceiveMultiple(RingbufHandle_t xRingbuffer,
+                                       void **ppvItems,
+                                       size_t *pxItemSizes,
+                                       UBaseType_t uxMaxItems,
+                                       TickType_t xTicksToWait);
+
 /**
  * @brief   Retrieve an item from the ring buffer in an ISR
  *
@@ -386,6 +462,17 @@ void vRingbufferReturnItem(RingbufHandle_t xRingbuffer, void *pvItem);
  */
 void vRingbufferReturnItemFromISR(RingbufHandle_t xRingbuffer, void *pvItem, BaseType_t *pxHigherPriorityTaskWoken);
 
+/**
+ * @brief   Return multiple previously-retrieved items to the ring buffer
+ *
+ * Same as calling vRingbufferReturnItem() for each item, but in a single critical section.
+ *
+ * @param[in]   xRingbuffer Ring buffer the items were retrieved from
+ * @param[in]   ppvItems    Items that were received earlier, e.g. by xRingbufferReceiveMultiple()
+ * @param[in]   uxItemCount Number of items in ppvItems
+ */
+void vRingbufferReturnMultiple(RingbufHandle_t xRingbuffer, void *const *ppvItems, UBaseType_t uxItemCount);
+
 /**
  * @brief   Delete a ring buffer
  *
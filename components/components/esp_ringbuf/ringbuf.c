@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2023-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2023-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -27,6 +27,9 @@
 #define rbBUFFER_FULL_FLAG          ( ( UBaseType_t ) 4 )   //The ring buffer is currently full (write pointer == free pointer)
 #define rbBUFFER_STATIC_FLAG        ( ( UBaseType_t ) 8 )   //The ring buffer is statically allocated
 #define rbUSING_QUEUE_SET           ( ( UBaseType_t ) 16 )  //The ring buffer has been added to a queue set
+#define rbSPSC_FLAG                 ( ( UBaseType_t ) 32 )  //The ring buffer has a single producer and a single consumer and is accessed without locking
+#define rbSPSC_RECEIVER_WAITING     ( ( UBaseType_t ) 64 )  //(SPSC only) The consumer is about to block or blocked waiting for data
+#define rbSPSC_SENDER_WAITING       ( ( UBaseType_t ) 128 ) //(SPSC only) The producer is about to block or blocked waiting for free space
 
 //Item flags
 #define rbITEM_FREE_FLAG            ( ( UBaseType_t ) 1 )   //Item has been retrieved and returned by application, free to overwrite
@@ -34,6 +37,11 @@
 #define rbITEM_SPLIT_FLAG           ( ( UBaseType_t ) 4 )   //Valid for RINGBUF_TYPE_ALLOWSPLIT, indicating that rest of the data is wrapped around
 #define rbITEM_WRITTEN_FLAG         ( ( UBaseType_t ) 8 )   //Item has been written to by the application, thus can be read
 
+//Memory ordering of pointers shared between the producer and the consumer of SPSC ring buffers
+#define rbLOAD_ACQUIRE( xVar )          __atomic_load_n( &( xVar ), __ATOMIC_ACQUIRE )
+#define rbSTORE_RELEASE( xVar, xVal )   __atomic_store_n( &( xVar ), ( xVal ), __ATOMIC_RELEASE )
+#define rbFULL_BARRIER()                __atomic_thread_fence( __ATOMIC_SEQ_CST )
+
 typedef struct {
     //This size of this structure must be 32-bit aligned
     size_t xItemLen;
@@ -170,29 +178,78 @@ static size_t prvGetCurMaxSizeAllowSplit(Ringbuffer_t *pxRingbuffer);
 static size_t prvGetCurMaxSizeByteBuf(Ringbuffer_t *pxRingbuffer);
 
 /*
-Generic function used to send or acquire an item/buffer.
-- If sending, set ppvItem to NULL. pvItem remains unchanged on failure.
-- If acquiring, set pvItem to NULL. ppvItem remains unchanged on failure.
+Single-producer/single-consumer (SPSC) ring buffers. The producer owns pucAcquire
+(its private write position) and publishes pucWrite once items are complete. The
+consumer owns pucRead and publishes pucFree once items are returned. Only the
+consumer waiting for data, or the producer waiting for space, takes the spinlock.
+The buffer is never completely filled, so pucWrite == pucFree always means empty.
+*/
+
+//Checks if an item/data is available for retrieval by the consumer of an SPSC ring buffer
+static BaseType_t prvCheckItemAvailSPSC(Ringbuffer_t *pxRingbuffer);
+
+//Copy as many of the items as currently fit to an SPSC ring buffer and publish them. Returns the number of items sent.
+static UBaseType_t prvCopyItemsSPSC(Ringbuffer_t *pxRingbuffer,
+                                    const void *const *ppvItems,
+                                    const size_t *pxItemSizes,
+                                    UBaseType_t uxItemCount,
+                                    UBaseType_t *puxItemsCopied);
+
+//Retrieve up to uxMaxItems items (no-split) or up to xMaxSize bytes (byte buffer) from an SPSC ring buffer
+static UBaseType_t prvGetItemsSPSC(Ringbuffer_t *pxRingbuffer,
+                                   void **ppvItems,
+                                   size_t *pxItemSizes,
+                                   size_t xMaxSize,
+                                   UBaseType_t uxMaxItems);
+
+//Return items to an SPSC ring buffer and publish the freed space
+static void prvReturnItemsSPSC(Ringbuffer_t *pxRingbuffer, void *const *ppvItems, UBaseType_t uxItemCount);
+
+//Blocking send of the SPSC ring buffer, see prvSendAcquireGeneric()
+static UBaseType_t prvSendSPSC(Ringbuffer_t *pxRingbuffer,
+                               const void *const *ppvItems,
+                               const size_t *pxItemSizes,
+                               UBaseType_t uxItemCount,
+                               TickType_t xTicksToWait);
+
+//Blocking receive of the SPSC ring buffer, see prvReceiveGeneric()
+static UBaseType_t prvReceiveSPSC(Ringbuffer_t *pxRingbuffer,
+                                  void **ppvItems,
+                                  size_t *pxItemSizes,
+                                  size_t xMaxSize,
+                                  UBaseType_t uxMaxItems,
+                                  TickType_t xTicksToWait);
+
+/*
+Generic function used to send or acquire items/buffers.
+- If sending, set ppvItem to NULL. Copies as many of the uxItemCount items as
+  currently fit (at least one, unless timed out). Returns the number of items sent.
+- If acquiring, set ppvItems to NULL and uxItemCount to 1. ppvItem remains unchanged on failure.
 */
-static BaseType_t prvSendAcquireGeneric(Ringbuffer_t *pxRingbuffer,
-                                        const void *pvItem,
-                                        void **ppvItem,
-                                        size_t xItemSize,
-                                        TickType_t xTicksToWait);
+static UBaseType_t prvSendAcquireGeneric(Ringbuffer_t *pxRingbuffer,
+                                         const void *const *ppvItems,
+                                         const size_t *pxItemSizes,
+                                         UBaseType_t uxItemCount,
+                                         void **ppvItem,
+                                         TickType_t xTicksToWait);
 
 /*
 Generic function used to retrieve an item/data from ring buffers. If called on
 an allow-split buffer, and pvItem2 and xItemSize2 are not NULL, both parts of
 a split item will be retrieved. xMaxSize will only take effect if called on
 byte buffers. xItemSize must remain unchanged if no item is retrieved.
+If called on a no-split buffer with uxMaxItems larger than 1, pvItem1 and
+xItemSize1 are arrays and up to uxMaxItems items available at once are retrieved.
+Returns the number of items retrieved.
 */
-static BaseType_t prvReceiveGeneric(Ringbuffer_t *pxRingbuffer,
-                                    void **pvItem1,
-                                    void **pvItem2,
-                                    size_t *xItemSize1,
-                                    size_t *xItemSize2,
-                                    size_t xMaxSize,
-                                    TickType_t xTicksToWait);
+static UBaseType_t prvReceiveGeneric(Ringbuffer_t *pxRingbuffer,
+                                     void **pvItem1,
+                                     void **pvItem2,
+                                     size_t *xItemSize1,
+                                     size_t *xItemSize2,
+                                     size_t xMaxSize,
+                                     UBaseType_t uxMaxItems,
+                                     TickType_t xTicksToWait);
 
 //From ISR version of prvReceiveGeneric()
 static BaseType_t prvReceiveGenericFromISR(Ringbuffer_t *pxRingbuffer,
@@ -508,6 +565,9 @@ static void prvCopyItemByteBuf(Ringbuffer_t *pxRingbuffer, const uint8_t *pucIte
 
 static BaseType_t prvCheckItemAvail(Ringbuffer_t *pxRingbuffer)
 {
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return prvCheckItemAvailSPSC(pxRingbuffer);
+    }
     if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) && pxRingbuffer->pucRead != pxRingbuffer->pucFree) {
         return pdFALSE;     //Byte buffers do not allow multiple retrievals before return
     }
@@ -755,42 +815,473 @@ static size_t prvGetCurMaxSizeByteBuf(Ringbuffer_t *pxRingbuffer)
     return xFreeSize;
 }
 
-static BaseType_t prvSendAcquireGeneric(Ringbuffer_t *pxRingbuffer,
-                                        const void *pvItem,
-                                        void **ppvItem,
-                                        size_t xItemSize,
-                                        TickType_t xTicksToWait)
+static BaseType_t prvCheckItemFitsNoSplitSPSC(Ringbuffer_t *pxRingbuffer, size_t xItemSize)
+{
+    uint8_t *pucFree = rbLOAD_ACQUIRE(pxRingbuffer->pucFree);
+    uint8_t *pucAcquire = pxRingbuffer->pucAcquire;
+    size_t xTotalItemSize = rbALIGN_SIZE(xItemSize) + rbHEADER_SIZE;    //Rounded up aligned item size with header
+
+    if (pucFree > pucAcquire) {
+        //Free space does not wrap around. The item must not fill it completely
+        return (xTotalItemSize < pucFree - pucAcquire) ? pdTRUE : pdFALSE;
+    }
+    if (xTotalItemSize <= pxRingbuffer->pucTail - pucAcquire) {
+        //Item fits without wrapping around. Check that the next write position does not wrap around onto pucFree
+        uint8_t *pucNext = pucAcquire + xTotalItemSize;
+        if (pxRingbuffer->pucTail - pucNext < rbHEADER_SIZE) {
+            pucNext = pxRingbuffer->pucHead;
+        }
+        return (pucNext != pucFree) ? pdTRUE : pdFALSE;
+    }
+    //Item has to be placed at the head of the buffer, after a dummy header
+    return (xTotalItemSize < pucFree - pxRingbuffer->pucHead) ? pdTRUE : pdFALSE;
+}
+
+static BaseType_t prvCheckItemFitsByteBufSPSC(Ringbuffer_t *pxRingbuffer, size_t xItemSize)
+{
+    uint8_t *pucFree = rbLOAD_ACQUIRE(pxRingbuffer->pucFree);
+    //One byte always stays free to tell a full buffer from an empty one
+    size_t xFreeSize = (pucFree > pxRingbuffer->pucAcquire) ?
+                       pucFree - pxRingbuffer->pucAcquire - 1 :
+                       pxRingbuffer->xSize - (pxRingbuffer->pucAcquire - pucFree) - 1;
+    return (xItemSize <= xFreeSize) ? pdTRUE : pdFALSE;
+}
+
+static void prvCopyItemNoSplitSPSC(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, size_t xItemSize)
+{
+    size_t xAlignedItemSize = rbALIGN_SIZE(xItemSize);                  //Rounded up aligned item size
+
+    //If remaining length can't fit item, set as dummy data and wrap around
+    if (pxRingbuffer->pucTail - pxRingbuffer->pucAcquire < xAlignedItemSize + rbHEADER_SIZE) {
+        ItemHeader_t *pxDummy = (ItemHeader_t *)pxRingbuffer->pucAcquire;
+        pxDummy->uxItemFlags = rbITEM_DUMMY_DATA_FLAG;
+        pxDummy->xItemLen = 0;
+        pxRingbuffer->pucAcquire = pxRingbuffer->pucHead;
+    }
+
+    ItemHeader_t *pxHeader = (ItemHeader_t *)pxRingbuffer->pucAcquire;
+    pxHeader->xItemLen = xItemSize;
+    pxHeader->uxItemFlags = 0;
+    memcpy(pxRingbuffer->pucAcquire + rbHEADER_SIZE, pucItem, xItemSize);
+    pxRingbuffer->pucAcquire += rbHEADER_SIZE + xAlignedItemSize;
+
+    //If current remaining length can't fit a header, wrap around
+    if (pxRingbuffer->pucTail - pxRingbuffer->pucAcquire < rbHEADER_SIZE) {
+        pxRingbuffer->pucAcquire = pxRingbuffer->pucHead;
+    }
+}
+
+static void prvCopyItemByteBufSPSC(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, size_t xItemSize)
+{
+    size_t xRemLen = pxRingbuffer->pucTail - pxRingbuffer->pucAcquire;    //Length from pucAcquire until end of buffer
+    if (xRemLen < xItemSize) {
+        memcpy(pxRingbuffer->pucAcquire, pucItem, xRemLen);
+        pucItem += xRemLen;
+        xItemSize -= xRemLen;
+        pxRingbuffer->pucAcquire = pxRingbuffer->pucHead;
+    }
+    memcpy(pxRingbuffer->pucAcquire, pucItem, xItemSize);
+    pxRingbuffer->pucAcquire += xItemSize;
+    if (pxRingbuffer->pucAcquire == pxRingbuffer->pucTail) {
+        pxRingbuffer->pucAcquire = pxRingbuffer->pucHead;
+    }
+}
+
+static BaseType_t prvCheckItemAvailSPSC(Ringbuffer_t *pxRingbuffer)
+{
+    if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) && pxRingbuffer->pucRead != pxRingbuffer->pucFree) {
+        return pdFALSE;     //Byte buffers do not allow multiple retrievals before return
+    }
+    return (pxRingbuffer->pucRead != rbLOAD_ACQUIRE(pxRingbuffer->pucWrite)) ? pdTRUE : pdFALSE;
+}
+
+static void *prvGetItemNoSplitSPSC(Ringbuffer_t *pxRingbuffer,
+                                   BaseType_t *pxIsSplit,
+                                   size_t xUnusedParam,
+                                   size_t *pxItemSize)
+{
+    ItemHeader_t *pxHeader = (ItemHeader_t *)pxRingbuffer->pucRead;
+    //Wrap around if dummy data (dummy data indicates wrap around in no-split buffers)
+    if (pxHeader->uxItemFlags & rbITEM_DUMMY_DATA_FLAG) {
+        pxRingbuffer->pucRead = pxRingbuffer->pucHead;
+        pxHeader = (ItemHeader_t *)pxRingbuffer->pucRead;
+    }
+    configASSERT(pxHeader->xItemLen <= pxRingbuffer->xMaxItemSize);
+    uint8_t *pcReturn = pxRingbuffer->pucRead + rbHEADER_SIZE;
+    *pxItemSize = pxHeader->xItemLen;
+    *pxIsSplit = pdFALSE;
+
+    pxRingbuffer->pucRead += rbHEADER_SIZE + rbALIGN_SIZE(pxHeader->xItemLen);
+    if ((pxRingbuffer->pucTail - pxRingbuffer->pucRead) < rbHEADER_SIZE) {
+        pxRingbuffer->pucRead = pxRingbuffer->pucHead;
+    }
+    return (void *)pcReturn;
+}
+
+static void *prvGetItemByteBufSPSC(Ringbuffer_t *pxRingbuffer,
+                                   BaseType_t *pxUnusedParam,
+                                   size_t xMaxSize,
+                                   size_t *pxItemSize)
+{
+    uint8_t *pucWrite = rbLOAD_ACQUIRE(pxRingbuffer->pucWrite);
+    uint8_t *ret = pxRingbuffer->pucRead;
+    //Return contiguous piece from read pointer until write pointer or buffer tail, up to xMaxSize
+    size_t xSize = (pucWrite > pxRingbuffer->pucRead) ? pucWrite - pxRingbuffer->pucRead : pxRingbuffer->pucTail - pxRingbuffer->pucRead;
+    if (xMaxSize != 0 && xSize > xMaxSize) {
+        xSize = xMaxSize;
+    }
+    *pxItemSize = xSize;
+    pxRingbuffer->pucRead += xSize;
+    if (pxRingbuffer->pucRead == pxRingbuffer->pucTail) {
+        pxRingbuffer->pucRead = pxRingbuffer->pucHead;
+    }
+    return (void *)ret;
+}
+
+static void prvReturnItemNoSplitSPSC(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem)
+{
+    configASSERT(rbCHECK_ALIGNED(pucItem));
+    configASSERT(pucItem >= pxRingbuffer->pucHead && pucItem <= pxRingbuffer->pucTail);
+
+    ItemHeader_t *pxCurHeader = (ItemHeader_t *)(pucItem - rbHEADER_SIZE);
+    configASSERT((pxCurHeader->uxItemFlags & (rbITEM_DUMMY_DATA_FLAG | rbITEM_FREE_FLAG)) == 0);
+    pxCurHeader->uxItemFlags |= rbITEM_FREE_FLAG;
+
+    //Move the free pointer up to the next item that has not been returned yet, see prvReturnItemDefault()
+    uint8_t *pucFree = pxRingbuffer->pucFree;
+    pxCurHeader = (ItemHeader_t *)pucFree;
+    while ((pxCurHeader->uxItemFlags & (rbITEM_FREE_FLAG | rbITEM_DUMMY_DATA_FLAG)) && pucFree != pxRingbuffer->pucRead) {
+        if (pxCurHeader->uxItemFlags & rbITEM_DUMMY_DATA_FLAG) {
+            pucFree = pxRingbuffer->pucHead;
+        } else {
+            pucFree += rbALIGN_SIZE(pxCurHeader->xItemLen) + rbHEADER_SIZE;
+        }
+        if ((pxRingbuffer->pucTail - pucFree) < rbHEADER_SIZE) {
+            pucFree = pxRingbuffer->pucHead;
+        }
+        pxCurHeader = (ItemHeader_t *)pucFree;
+    }
+    //Publish the free space to the producer after all accesses to the returned items
+    rbSTORE_RELEASE(pxRingbuffer->pucFree, pucFree);
+}
+
+static void prvReturnItemByteBufSPSC(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem)
+{
+    configASSERT(pucItem >= pxRingbuffer->pucHead && pucItem < pxRingbuffer->pucTail);
+    rbSTORE_RELEASE(pxRingbuffer->pucFree, pxRingbuffer->pucRead);
+}
+
+static size_t prvGetCurMaxSizeNoSplitSPSC(Ringbuffer_t *pxRingbuffer)
+{
+    uint8_t *pucFree = rbLOAD_ACQUIRE(pxRingbuffer->pucFree);
+    uint8_t *pucAcquire = pxRingbuffer->pucAcquire;
+    BaseType_t xFreeSize;
+
+    if (pucFree > pucAcquire) {
+        xFreeSize = pucFree - pucAcquire - (rbALIGN_MASK + 1);
+    } else {
+        BaseType_t xSize1 = pxRingbuffer->pucTail - pucAcquire;
+        BaseType_t xSize2 = pucFree - pxRingbuffer->pucHead - (rbALIGN_MASK + 1);
+        if (pucFree == pxRingbuffer->pucHead) {
+            xSize1 -= rbHEADER_SIZE;    //The next write position must not wrap around onto pucFree
+        }
+        xFreeSize = (xSize1 > xSize2) ? xSize1 : xSize2;
+    }
+    xFreeSize -= rbHEADER_SIZE;
+    if (xFreeSize < 0) {
+        xFreeSize = 0;
+    } else if (xFreeSize > pxRingbuffer->xMaxItemSize) {
+        xFreeSize = pxRingbuffer->xMaxItemSize;
+    }
+    return xFreeSize;
+}
+
+static size_t prvGetCurMaxSizeByteBufSPSC(Ringbuffer_t *pxRingbuffer)
+{
+    uint8_t *pucFree = rbLOAD_ACQUIRE(pxRingbuffer->pucFree);
+    return (pucFree > pxRingbuffer->pucAcquire) ?
+           pucFree - pxRingbuffer->pucAcquire - 1 :
+           pxRingbuffer->xSize - (pxRingbuffer->pucAcquire - pucFree) - 1;
+}
+
+static UBaseType_t prvCopyItemsSPSC(Ringbuffer_t *pxRingbuffer,
+                                    const void *const *ppvItems,
+                                    const size_t *pxItemSizes,
+                                    UBaseType_t uxItemCount,
+                                    UBaseType_t *puxItemsCopied)
+{
+    UBaseType_t uxReturn = 0;
+    *puxItemsCopied = 0;
+    while (uxReturn < uxItemCount && pxRingbuffer->xCheckItemFits(pxRingbuffer, pxItemSizes[uxReturn]) == pdTRUE) {
+        //Sending 0 bytes to byte buffer has no effect
+        if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) == 0 || pxItemSizes[uxReturn] > 0) {
+            pxRingbuffer->vCopyItem(pxRingbuffer, ppvItems[uxReturn], pxItemSizes[uxReturn]);
+            (*puxItemsCopied)++;
+        }
+        uxReturn++;
+    }
+    if (*puxItemsCopied > 0) {
+        //Publish the items to the consumer after they have been completely written
+        rbSTORE_RELEASE(pxRingbuffer->pucWrite, pxRingbuffer->pucAcquire);
+    }
+    return uxReturn;
+}
+
+static UBaseType_t prvGetItemsSPSC(Ringbuffer_t *pxRingbuffer,
+                                   void **ppvItems,
+                                   size_t *pxItemSizes,
+                                   size_t xMaxSize,
+                                   UBaseType_t uxMaxItems)
+{
+    UBaseType_t uxReturn = 0;
+    BaseType_t xIsSplit;
+    while (uxReturn < uxMaxItems && prvCheckItemAvailSPSC(pxRingbuffer) == pdTRUE) {
+        ppvItems[uxReturn] = pxRingbuffer->pvGetItem(pxRingbuffer, &xIsSplit, xMaxSize, &pxItemSizes[uxReturn]);
+        uxReturn++;
+    }
+    return uxReturn;
+}
+
+static void prvReturnItemsSPSC(Ringbuffer_t *pxRingbuffer, void *const *ppvItems, UBaseType_t uxItemCount)
+{
+    for (UBaseType_t i = 0; i < uxItemCount; i++) {
+        configASSERT(ppvItems[i] != NULL);
+        pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)ppvItems[i]);
+    }
+}
+
+/*
+Wake up the other side of an SPSC ring buffer if it announced that it is waiting by
+setting uxWaitingFlag. The announcement is made in a critical section before checking
+the buffer state once more, so either the waiting side sees the new state or we see
+the flag. Returns pdTRUE if the woken task has a higher priority.
+*/
+static BaseType_t prvWakeWaitingSPSC(Ringbuffer_t *pxRingbuffer, UBaseType_t uxWaitingFlag, List_t *pxWaitingList, BaseType_t xFromISR)
 {
     BaseType_t xReturn = pdFALSE;
+
+    rbFULL_BARRIER();
+    if ((__atomic_load_n(&pxRingbuffer->uxRingbufferFlags, __ATOMIC_RELAXED) & uxWaitingFlag) == 0) {
+        return pdFALSE;
+    }
+    if (xFromISR) {
+        portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
+    } else {
+        portENTER_CRITICAL(&pxRingbuffer->mux);
+    }
+    pxRingbuffer->uxRingbufferFlags &= ~uxWaitingFlag;
+    if (listLIST_IS_EMPTY(pxWaitingList) == pdFALSE) {
+        xReturn = xTaskRemoveFromEventList(pxWaitingList);
+    }
+    if (xFromISR) {
+        portEXIT_CRITICAL_ISR(&pxRingbuffer->mux);
+    } else {
+        portEXIT_CRITICAL(&pxRingbuffer->mux);
+    }
+    return xReturn;
+}
+
+//Notify the consumer (or queue set) of an SPSC ring buffer about new items
+static void prvNotifyItemsSentSPSC(Ringbuffer_t *pxRingbuffer, UBaseType_t uxItemsCopied, BaseType_t xFromISR, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if (uxItemsCopied == 0) {
+        return;
+    }
+    if (pxRingbuffer->xQueueSet) {
+        //If ring buffer was added to a queue set, notify the queue set once per item
+        for (UBaseType_t i = 0; i < uxItemsCopied; i++) {
+            if (xFromISR) {
+                xQueueSendFromISR((QueueHandle_t)pxRingbuffer->xQueueSet, (QueueSetMemberHandle_t *)&pxRingbuffer, pxHigherPriorityTaskWoken);
+            } else {
+                xQueueSend((QueueHandle_t)pxRingbuffer->xQueueSet, (QueueSetMemberHandle_t *)&pxRingbuffer, 0);
+            }
+        }
+    } else if (prvWakeWaitingSPSC(pxRingbuffer, rbSPSC_RECEIVER_WAITING, &pxRingbuffer->xTasksWaitingToReceive, xFromISR) == pdTRUE) {
+        if (!xFromISR) {
+            portYIELD_WITHIN_API();
+        } else if (pxHigherPriorityTaskWoken != NULL) {
+            *pxHigherPriorityTaskWoken = pdTRUE;
+        }
+    }
+}
+
+//Notify the producer of an SPSC ring buffer about freed space
+static void prvNotifyItemsReturnedSPSC(Ringbuffer_t *pxRingbuffer, BaseType_t xFromISR, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if (prvWakeWaitingSPSC(pxRingbuffer, rbSPSC_SENDER_WAITING, &pxRingbuffer->xTasksWaitingToSend, xFromISR) == pdTRUE) {
+        if (!xFromISR) {
+            portYIELD_WITHIN_API();
+        } else if (pxHigherPriorityTaskWoken != NULL) {
+            *pxHigherPriorityTaskWoken = pdTRUE;
+        }
+    }
+}
+
+static UBaseType_t prvSendSPSC(Ringbuffer_t *pxRingbuffer,
+                               const void *const *ppvItems,
+                               const size_t *pxItemSizes,
+                               UBaseType_t uxItemCount,
+                               TickType_t xTicksToWait)
+{
+    UBaseType_t uxReturn;
+    UBaseType_t uxItemsCopied;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    BaseType_t xTimedOut = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    while ((uxReturn = prvCopyItemsSPSC(pxRingbuffer, ppvItems, pxItemSizes, uxItemCount, &uxItemsCopied)) == 0
+            && xTicksToWait != (TickType_t) 0 && xTimedOut == pdFALSE) {
+        portENTER_CRITICAL(&pxRingbuffer->mux);
+        if (xEntryTimeSet == pdFALSE) {
+            //This is our first block. Set entry time
+            vTaskInternalSetTimeOutState(&xTimeOut);
+            xEntryTimeSet = pdTRUE;
+        }
+        if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) == pdFALSE) {
+            //Announce that we are waiting, then check once more whether space was freed in the meantime
+            pxRingbuffer->uxRingbufferFlags |= rbSPSC_SENDER_WAITING;
+            rbFULL_BARRIER();
+            if (pxRingbuffer->xCheckItemFits(pxRingbuffer, pxItemSizes[0]) == pdFALSE) {
+                //Not timed out yet. Block the current task
+                vTaskPlaceOnEventList(&pxRingbuffer->xTasksWaitingToSend, xTicksToWait);
+                portYIELD_WITHIN_API();
+            } else {
+                pxRingbuffer->uxRingbufferFlags &= ~rbSPSC_SENDER_WAITING;
+            }
+        } else {
+            //We have timed out
+            pxRingbuffer->uxRingbufferFlags &= ~rbSPSC_SENDER_WAITING;
+            xTimedOut = pdTRUE;
+        }
+        portEXIT_CRITICAL(&pxRingbuffer->mux);
+    }
+    prvNotifyItemsSentSPSC(pxRingbuffer, uxItemsCopied, pdFALSE, NULL);
+    return uxReturn;
+}
+
+static UBaseType_t prvReceiveSPSC(Ringbuffer_t *pxRingbuffer,
+                                  void **ppvItems,
+                                  size_t *pxItemSizes,
+                                  size_t xMaxSize,
+                                  UBaseType_t uxMaxItems,
+                                  TickType_t xTicksToWait)
+{
+    UBaseType_t uxReturn;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    BaseType_t xTimedOut = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    while ((uxReturn = prvGetItemsSPSC(pxRingbuffer, ppvItems, pxItemSizes, xMaxSize, uxMaxItems)) == 0
+            && xTicksToWait != (TickType_t) 0 && xTimedOut == pdFALSE) {
+        portENTER_CRITICAL(&pxRingbuffer->mux);
+        if (xEntryTimeSet == pdFALSE) {
+            //This is our first block. Set entry time
+            vTaskInternalSetTimeOutState(&xTimeOut);
+            xEntryTimeSet = pdTRUE;
+        }
+        if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) == pdFALSE) {
+            //Announce that we are waiting, then check once more whether data arrived in the meantime
+            pxRingbuffer->uxRingbufferFlags |= rbSPSC_RECEIVER_WAITING;
+            rbFULL_BARRIER();
+            if (prvCheckItemAvailSPSC(pxRingbuffer) == pdFALSE) {
+                //Not timed out yet. Block the current task
+                vTaskPlaceOnEventList(&pxRingbuffer->xTasksWaitingToReceive, xTicksToWait);
+                portYIELD_WITHIN_API();
+            } else {
+                pxRingbuffer->uxRingbufferFlags &= ~rbSPSC_RECEIVER_WAITING;
+            }
+        } else {
+            //We have timed out
+            pxRingbuffer->uxRingbufferFlags &= ~rbSPSC_RECEIVER_WAITING;
+            xTimedOut = pdTRUE;
+        }
+        portEXIT_CRITICAL(&pxRingbuffer->mux);
+    }
+    return uxReturn;
+}
+
+//Count the items waiting in an SPSC ring buffer. Only accurate if neither side accesses the buffer concurrently.
+static UBaseType_t prvGetItemsWaitingSPSC(Ringbuffer_t *pxRingbuffer)
+{
+    uint8_t *pucWrite = rbLOAD_ACQUIRE(pxRingbuffer->pucWrite);
+    uint8_t *pucRead = pxRingbuffer->pucRead;
+    if (pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) {
+        return (pucWrite >= pucRead) ? pucWrite - pucRead : pxRingbuffer->xSize - (pucRead - pucWrite);
+    }
+    UBaseType_t uxItems = 0;
+    while (pucRead != pucWrite) {
+        ItemHeader_t *pxHeader = (ItemHeader_t *)pucRead;
+        if (pxHeader->uxItemFlags & rbITEM_DUMMY_DATA_FLAG) {
+            pucRead = pxRingbuffer->pucHead;
+            continue;
+        }
+        uxItems++;
+        pucRead += rbHEADER_SIZE + rbALIGN_SIZE(pxHeader->xItemLen);
+        if ((pxRingbuffer->pucTail - pucRead) < rbHEADER_SIZE) {
+            pucRead = pxRingbuffer->pucHead;
+        }
+    }
+    return uxItems;
+}
+
+static UBaseType_t prvSendAcquireGeneric(Ringbuffer_t *pxRingbuffer,
+                                         const void *const *ppvItems,
+                                         const size_t *pxItemSizes,
+                                         UBaseType_t uxItemCount,
+                                         void **ppvItem,
+                                         TickType_t xTicksToWait)
+{
+    UBaseType_t uxReturn = 0;
+    UBaseType_t uxItemsCopied = 0;
     BaseType_t xExitLoop = pdFALSE;
     BaseType_t xEntryTimeSet = pdFALSE;
     BaseType_t xNotifyQueueSet = pdFALSE;
     TimeOut_t xTimeOut;
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        configASSERT(ppvItem == NULL);   //Send acquire is not supported by SPSC ring buffers
+        return prvSendSPSC(pxRingbuffer, ppvItems, pxItemSizes, uxItemCount, xTicksToWait);
+    }
+
     while (xExitLoop == pdFALSE) {
         portENTER_CRITICAL(&pxRingbuffer->mux);
-        if (pxRingbuffer->xCheckItemFits(pxRingbuffer, xItemSize) == pdTRUE) {
-            //xItemSize will fit. Copy or acquire the buffer immediately
+        if (pxRingbuffer->xCheckItemFits(pxRingbuffer, pxItemSizes[0]) == pdTRUE) {
+            //The first item will fit. Copy or acquire the buffer immediately
             if (ppvItem) {
                 //Acquire the buffer
-                *ppvItem = prvAcquireItemNoSplit(pxRingbuffer, xItemSize);
+                *ppvItem = prvAcquireItemNoSplit(pxRingbuffer, pxItemSizes[0]);
+                uxReturn = 1;
             } else {
-                //Copy item into buffer
-                pxRingbuffer->vCopyItem(pxRingbuffer, pvItem, xItemSize);
+                //Copy items into buffer until one does not fit anymore
+                while (uxReturn < uxItemCount) {
+                    if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) && pxItemSizes[uxReturn] == 0) {
+                        uxReturn++;     //Sending 0 bytes to byte buffer has no effect
+                        continue;
+                    }
+                    if (uxReturn > 0 && pxRingbuffer->xCheckItemFits(pxRingbuffer, pxItemSizes[uxReturn]) == pdFALSE) {
+                        break;
+                    }
+                    pxRingbuffer->vCopyItem(pxRingbuffer, ppvItems[uxReturn], pxItemSizes[uxReturn]);
+                    uxReturn++;
+                    uxItemsCopied++;
+                }
                 if (pxRingbuffer->xQueueSet) {
                     //If ring buffer was added to a queue set, notify the queue set
                     xNotifyQueueSet = pdTRUE;
                 } else {
-                    //If a task was waiting for data to arrive on the ring buffer, unblock it immediately.
-                    if (listLIST_IS_EMPTY(&pxRingbuffer->xTasksWaitingToReceive) == pdFALSE) {
+                    //If tasks were waiting for data to arrive on the ring buffer, unblock one per item immediately.
+                    BaseType_t xYieldRequired = pdFALSE;
+                    for (UBaseType_t i = 0; i < uxItemsCopied && listLIST_IS_EMPTY(&pxRingbuffer->xTasksWaitingToReceive) == pdFALSE; i++) {
                         if (xTaskRemoveFromEventList(&pxRingbuffer->xTasksWaitingToReceive) == pdTRUE) {
-                            //The unblocked task will preempt us. Trigger a yield here.
-                            portYIELD_WITHIN_API();
+                            xYieldRequired = pdTRUE;
                         }
                     }
+                    if (xYieldRequired == pdTRUE) {
+                        //An unblocked task will preempt us. Trigger a yield here.
+                        portYIELD_WITHIN_API();
+                    }
                 }
             }
-            xReturn = pdTRUE;
             xExitLoop = pdTRUE;
             goto loop_end;
         } else if (xTicksToWait == (TickType_t) 0) {
@@ -814,29 +1305,36 @@ static BaseType_t prvSendAcquireGeneric(Ringbuffer_t *pxRingbuffer,
 loop_end:
         portEXIT_CRITICAL(&pxRingbuffer->mux);
     }
-    //Defer notifying the queue set until we are outside the loop and critical section.
+    //Defer notifying the queue set until we are outside the loop and critical section. The queue set is notified once per item.
     if (xNotifyQueueSet == pdTRUE) {
-        xQueueSend((QueueHandle_t)pxRingbuffer->xQueueSet, (QueueSetMemberHandle_t *)&pxRingbuffer, 0);
+        for (UBaseType_t i = 0; i < uxItemsCopied; i++) {
+            xQueueSend((QueueHandle_t)pxRingbuffer->xQueueSet, (QueueSetMemberHandle_t *)&pxRingbuffer, 0);
+        }
     }
 
-    return xReturn;
+    return uxReturn;
 }
 
-static BaseType_t prvReceiveGeneric(Ringbuffer_t *pxRingbuffer,
-                                    void **pvItem1,
-                                    void **pvItem2,
-                                    size_t *xItemSize1,
-                                    size_t *xItemSize2,
-                                    size_t xMaxSize,
-                                    TickType_t xTicksToWait)
+static UBaseType_t prvReceiveGeneric(Ringbuffer_t *pxRingbuffer,
+                                     void **pvItem1,
+                                     void **pvItem2,
+                                     size_t *xItemSize1,
+                                     size_t *xItemSize2,
+                                     size_t xMaxSize,
+                                     UBaseType_t uxMaxItems,
+                                     TickType_t xTicksToWait)
 {
-    BaseType_t xReturn = pdFALSE;
+    UBaseType_t uxReturn = 0;
     BaseType_t xExitLoop = pdFALSE;
     BaseType_t xEntryTimeSet = pdFALSE;
     TimeOut_t xTimeOut;
 
     ESP_STATIC_ANALYZER_CHECK(!pvItem1 || !xItemSize1, pdFALSE);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return prvReceiveSPSC(pxRingbuffer, pvItem1, xItemSize1, xMaxSize, uxMaxItems, xTicksToWait);
+    }
+
     while (xExitLoop == pdFALSE) {
         portENTER_CRITICAL(&pxRingbuffer->mux);
         if (prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
@@ -860,7 +1358,12 @@ static BaseType_t prvReceiveGeneric(Ringbuffer_t *pxRingbuffer,
                     *pvItem2 = NULL;
                 }
             }
-            xReturn = pdTRUE;
+            uxReturn = 1;
+            //Get further items from no-split buffers that are available without blocking
+            while (uxReturn < uxMaxItems && prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
+                pvItem1[uxReturn] = pxRingbuffer->pvGetItem(pxRingbuffer, &xIsSplit, 0, &xItemSize1[uxReturn]);
+                uxReturn++;
+            }
             xExitLoop = pdTRUE;
             goto loop_end;
         } else if (xTicksToWait == (TickType_t) 0) {
@@ -885,7 +1388,7 @@ loop_end:
         portEXIT_CRITICAL(&pxRingbuffer->mux);
     }
 
-    return xReturn;
+    return uxReturn;
 }
 
 static BaseType_t prvReceiveGenericFromISR(Ringbuffer_t *pxRingbuffer,
@@ -899,6 +1402,10 @@ static BaseType_t prvReceiveGenericFromISR(Ringbuffer_t *pxRingbuffer,
 
     ESP_STATIC_ANALYZER_CHECK(!pvItem1 || !xItemSize1, pdFALSE);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return (prvGetItemsSPSC(pxRingbuffer, pvItem1, xItemSize1, xMaxSize, 1) == 1) ? pdTRUE : pdFALSE;
+    }
+
     portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
     if (prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
         BaseType_t xIsSplit = pdFALSE;
@@ -961,6 +1468,46 @@ RingbufHandle_t xRingbufferCreateNoSplit(size_t xItemSize, size_t xItemNum)
     return xRingbufferCreate((rbALIGN_SIZE(xItemSize) + rbHEADER_SIZE) * xItemNum, RINGBUF_TYPE_NOSPLIT);
 }
 
+RingbufHandle_t xRingbufferCreateSPSC(size_t xBufferSize, RingbufferType_t xBufferType)
+{
+    configASSERT(xBufferSize > 0);
+    configASSERT(xBufferType == RINGBUF_TYPE_NOSPLIT || xBufferType == RINGBUF_TYPE_BYTEBUF);
+
+    //The buffer is never completely filled. Byte buffers get one extra byte so that xBufferSize bytes fit.
+    size_t xStorageSize = (xBufferType == RINGBUF_TYPE_BYTEBUF) ? xBufferSize + 1 : rbALIGN_SIZE(xBufferSize);
+    Ringbuffer_t *pxNewRingbuffer = calloc(1, sizeof(Ringbuffer_t));
+    uint8_t *pucRingbufferStorage = malloc(xStorageSize);
+    if (pxNewRingbuffer == NULL || pucRingbufferStorage == NULL) {
+        goto err;
+    }
+
+    prvInitializeNewRingbuffer(xStorageSize, xBufferType, pxNewRingbuffer, pucRingbufferStorage);
+    pxNewRingbuffer->uxRingbufferFlags |= rbSPSC_FLAG;
+    if (xBufferType == RINGBUF_TYPE_NOSPLIT) {
+        pxNewRingbuffer->xCheckItemFits = prvCheckItemFitsNoSplitSPSC;
+        pxNewRingbuffer->vCopyItem = prvCopyItemNoSplitSPSC;
+        pxNewRingbuffer->pvGetItem = prvGetItemNoSplitSPSC;
+        pxNewRingbuffer->vReturnItem = prvReturnItemNoSplitSPSC;
+        //The write position must stay behind the free pointer, so an item may not always start at the halfway point
+        pxNewRingbuffer->xMaxItemSize = ((xStorageSize / 2) & ~rbALIGN_MASK) - rbHEADER_SIZE;
+        pxNewRingbuffer->xGetCurMaxSize = prvGetCurMaxSizeNoSplitSPSC;
+    } else {
+        pxNewRingbuffer->xCheckItemFits = prvCheckItemFitsByteBufSPSC;
+        pxNewRingbuffer->vCopyItem = prvCopyItemByteBufSPSC;
+        pxNewRingbuffer->pvGetItem = prvGetItemByteBufSPSC;
+        pxNewRingbuffer->vReturnItem = prvReturnItemByteBufSPSC;
+        pxNewRingbuffer->xMaxItemSize = xBufferSize;
+        pxNewRingbuffer->xGetCurMaxSize = prvGetCurMaxSizeByteBufSPSC;
+    }
+    return (RingbufHandle_t)pxNewRingbuffer;
+
+err:
+    //An error has occurred, Free memory and return NULL
+    free(pxNewRingbuffer);
+    free(pucRingbufferStorage);
+    return NULL;
+}
+
 RingbufHandle_t xRingbufferCreateStatic(size_t xBufferSize,
                                         RingbufferType_t xBufferType,
                                         uint8_t *pucRingbufferStorage,
@@ -989,13 +1536,14 @@ BaseType_t xRingbufferSendAcquire(RingbufHandle_t xRingbuffer, void **ppvItem, s
     configASSERT(pxRingbuffer);
     configASSERT(ppvItem != NULL);
     configASSERT((pxRingbuffer->uxRingbufferFlags & (rbBYTE_BUFFER_FLAG | rbALLOW_SPLIT_FLAG)) == 0); //Send acquire currently only supported in NoSplit buffers
+    configASSERT((pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) == 0);   //Send acquire is not supported by SPSC ring buffers
 
     *ppvItem = NULL;
     if (xItemSize > pxRingbuffer->xMaxItemSize) {
         return pdFALSE;     //Data will never ever fit in the queue.
     }
 
-    return prvSendAcquireGeneric(pxRingbuffer, NULL, ppvItem, xItemSize, xTicksToWait);
+    return (prvSendAcquireGeneric(pxRingbuffer, NULL, &xItemSize, 1, ppvItem, xTicksToWait) == 1) ? pdTRUE : pdFALSE;
 }
 
 BaseType_t xRingbufferSendComplete(RingbufHandle_t xRingbuffer, void *pvItem)
@@ -1047,7 +1595,41 @@ BaseType_t xRingbufferSend(RingbufHandle_t xRingbuffer,
         return pdTRUE;      //Sending 0 bytes to byte buffer has no effect
     }
 
-    return prvSendAcquireGeneric(pxRingbuffer, pvItem, NULL, xItemSize, xTicksToWait);
+    return (prvSendAcquireGeneric(pxRingbuffer, &pvItem, &xItemSize, 1, NULL, xTicksToWait) == 1) ? pdTRUE : pdFALSE;
+}
+
+UBaseType_t xRingbufferSendMultiple(RingbufHandle_t xRingbuffer,
+                                    const void *const *ppvItems,
+                                    const size_t *pxItemSizes,
+                                    UBaseType_t uxItemCount,
+                                    TickType_t xTicksToWait)
+{
+    Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
+    UBaseType_t uxSkipped = 0;
+
+    //Check arguments
+    configASSERT(pxRingbuffer);
+    configASSERT(ppvItems != NULL && pxItemSizes != NULL);
+    //Only send up to the first item that will never fit
+    for (UBaseType_t i = 0; i < uxItemCount; i++) {
+        configASSERT(ppvItems[i] != NULL || pxItemSizes[i] == 0);
+        if (pxItemSizes[i] > pxRingbuffer->xMaxItemSize) {
+            uxItemCount = i;
+            break;
+        }
+    }
+    if (pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) {
+        //Sending 0 bytes to byte buffer has no effect, don't block for leading empty items
+        while (uxSkipped < uxItemCount && pxItemSizes[uxSkipped] == 0) {
+            uxSkipped++;
+        }
+    }
+    if (uxSkipped == uxItemCount) {
+        return uxSkipped;
+    }
+
+    return uxSkipped + prvSendAcquireGeneric(pxRingbuffer, &ppvItems[uxSkipped], &pxItemSizes[uxSkipped],
+                                             uxItemCount - uxSkipped, NULL, xTicksToWait);
 }
 
 BaseType_t xRingbufferSendFromISR(RingbufHandle_t xRingbuffer,
@@ -1068,6 +1650,12 @@ BaseType_t xRingbufferSendFromISR(RingbufHandle_t xRingbuffer,
     if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) && xItemSize == 0) {
         return pdTRUE;      //Sending 0 bytes to byte buffer has no effect
     }
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        UBaseType_t uxItemsCopied;
+        xReturn = (prvCopyItemsSPSC(pxRingbuffer, &pvItem, &xItemSize, 1, &uxItemsCopied) == 1) ? pdTRUE : pdFALSE;
+        prvNotifyItemsSentSPSC(pxRingbuffer, uxItemsCopied, pdTRUE, pxHigherPriorityTaskWoken);
+        return xReturn;
+    }
 
     portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
     if (pxRingbuffer->xCheckItemFits(xRingbuffer, xItemSize) == pdTRUE) {
@@ -1108,13 +1696,31 @@ void *xRingbufferReceive(RingbufHandle_t xRingbuffer, size_t *pxItemSize, TickTy
 
     //Attempt to retrieve an item
     void *pvTempItem;
-    if (prvReceiveGeneric(pxRingbuffer, &pvTempItem, NULL, pxItemSize, NULL, 0, xTicksToWait) == pdTRUE) {
+    if (prvReceiveGeneric(pxRingbuffer, &pvTempItem, NULL, pxItemSize, NULL, 0, 1, xTicksToWait) == 1) {
         return pvTempItem;
     } else {
         return NULL;
     }
 }
 
+UBaseType_t xRingbufferReceiveMultiple(RingbufHandle_t xRingbuffer,
+                                       void **ppvItems,
+                                       size_t *pxItemSizes,
+                                       UBaseType_t uxMaxItems,
+                                       TickType_t xTicksToWait)
+{
+    Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
+
+    //Check arguments
+    configASSERT(pxRingbuffer && ppvItems && pxItemSizes);
+    configASSERT((pxRingbuffer->uxRingbufferFlags & (rbBYTE_BUFFER_FLAG | rbALLOW_SPLIT_FLAG)) == 0);    //This function should only be called for no-split buffers
+
+    if (uxMaxItems == 0) {
+        return 0;
+    }
+    return prvReceiveGeneric(pxRingbuffer, ppvItems, NULL, pxItemSizes, NULL, 0, uxMaxItems, xTicksToWait);
+}
+
 void *xRingbufferReceiveFromISR(RingbufHandle_t xRingbuffer, size_t *pxItemSize)
 {
     Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
@@ -1145,7 +1751,7 @@ BaseType_t xRingbufferReceiveSplit(RingbufHandle_t xRingbuffer,
     configASSERT(pxRingbuffer && ppvHeadItem && ppvTailItem && pxHeadItemSize && pxTailItemSize);
     configASSERT(pxRingbuffer->uxRingbufferFlags & rbALLOW_SPLIT_FLAG);
 
-    return prvReceiveGeneric(pxRingbuffer, ppvHeadItem, ppvTailItem, pxHeadItemSize, pxTailItemSize, 0, xTicksToWait);
+    return (prvReceiveGeneric(pxRingbuffer, ppvHeadItem, ppvTailItem, pxHeadItemSize, pxTailItemSize, 0, 1, xTicksToWait) == 1) ? pdTRUE : pdFALSE;
 }
 
 BaseType_t xRingbufferReceiveSplitFromISR(RingbufHandle_t xRingbuffer,
@@ -1179,7 +1785,7 @@ void *xRingbufferReceiveUpTo(RingbufHandle_t xRingbuffer,
     }
     //Attempt to retrieve up to xMaxSize bytes
     void *pvTempItem;
-    if (prvReceiveGeneric(pxRingbuffer, &pvTempItem, NULL, pxItemSize, NULL, xMaxSize, xTicksToWait) == pdTRUE) {
+    if (prvReceiveGeneric(pxRingbuffer, &pvTempItem, NULL, pxItemSize, NULL, xMaxSize, 1, xTicksToWait) == 1) {
         return pvTempItem;
     } else {
         return NULL;
@@ -1212,6 +1818,12 @@ void vRingbufferReturnItem(RingbufHandle_t xRingbuffer, void *pvItem)
     configASSERT(pxRingbuffer);
     configASSERT(pvItem != NULL);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        prvReturnItemsSPSC(pxRingbuffer, &pvItem, 1);
+        prvNotifyItemsReturnedSPSC(pxRingbuffer, pdFALSE, NULL);
+        return;
+    }
+
     portENTER_CRITICAL(&pxRingbuffer->mux);
     pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)pvItem);
     //If a task was waiting for space to send, unblock it immediately.
@@ -1224,12 +1836,49 @@ void vRingbufferReturnItem(RingbufHandle_t xRingbuffer, void *pvItem)
     portEXIT_CRITICAL(&pxRingbuffer->mux);
 }
 
+void vRingbufferReturnMultiple(RingbufHandle_t xRingbuffer, void *const *ppvItems, UBaseType_t uxItemCount)
+{
+    Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
+    BaseType_t xYieldRequired = pdFALSE;
+    configASSERT(pxRingbuffer);
+    configASSERT(ppvItems != NULL || uxItemCount == 0);
+
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        prvReturnItemsSPSC(pxRingbuffer, ppvItems, uxItemCount);
+        prvNotifyItemsReturnedSPSC(pxRingbuffer, pdFALSE, NULL);
+        return;
+    }
+
+    portENTER_CRITICAL(&pxRingbuffer->mux);
+    for (UBaseType_t i = 0; i < uxItemCount; i++) {
+        configASSERT(ppvItems[i] != NULL);
+        pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)ppvItems[i]);
+    }
+    //If tasks were waiting for space to send, unblock one per returned item immediately.
+    for (UBaseType_t i = 0; i < uxItemCount && listLIST_IS_EMPTY(&pxRingbuffer->xTasksWaitingToSend) == pdFALSE; i++) {
+        if (xTaskRemoveFromEventList(&pxRingbuffer->xTasksWaitingToSend) == pdTRUE) {
+            xYieldRequired = pdTRUE;
+        }
+    }
+    if (xYieldRequired == pdTRUE) {
+        //An unblocked task will preempt us. Trigger a yield here.
+        portYIELD_WITHIN_API();
+    }
+    portEXIT_CRITICAL(&pxRingbuffer->mux);
+}
+
 void vRingbufferReturnItemFromISR(RingbufHandle_t xRingbuffer, void *pvItem, BaseType_t *pxHigherPriorityTaskWoken)
 {
     Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
     configASSERT(pxRingbuffer);
     configASSERT(pvItem != NULL);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        prvReturnItemsSPSC(pxRingbuffer, &pvItem, 1);
+        prvNotifyItemsReturnedSPSC(pxRingbuffer, pdTRUE, pxHigherPriorityTaskWoken);
+        return;
+    }
+
     portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
     pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)pvItem);
     //If a task was waiting for space to send, unblock it immediately.
@@ -1347,7 +1996,11 @@ void vRingbufferGetInfo(RingbufHandle_t xRingbuffer,
         *uxAcquire = (UBaseType_t)(pxRingbuffer->pucAcquire - pxRingbuffer->pucHead);
     }
     if (uxItemsWaiting != NULL) {
-        *uxItemsWaiting = (UBaseType_t)(pxRingbuffer->xItemsWaiting);
+        if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+            *uxItemsWaiting = prvGetItemsWaitingSPSC(pxRingbuffer);
+        } else {
+            *uxItemsWaiting = (UBaseType_t)(pxRingbuffer->xItemsWaiting);
+        }
     }
     portEXIT_CRITICAL(&pxRingbuffer->mux);
 }
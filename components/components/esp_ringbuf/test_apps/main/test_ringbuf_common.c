@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2024-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -12,6 +12,7 @@
 #include "sdkconfig.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
@@ -1124,3 +1125,237 @@ TEST_CASE("Test no-split buffers can receive items if the acquire pointer wraps
     // Cleanup
     vRingbufferDelete(buffer_handle);
 }
+
+/* ------------------------ Test ring buffer multiple items ---------------------------
+ * The following test case tests sending, receiving and returning multiple items at once.
+ *
+ * The test case will do the following...
+ * 1) Send more items to a no-split buffer than it can hold. Only the items that fit are sent.
+ * 2) Receive all items at once and verify their order and content.
+ * 3) Return all items at once and verify that the buffer is empty.
+ * 4) Verify that sending stops at an item that is too large for the buffer.
+ * 5) Verify that multiple items sent to a byte buffer are appended.
+ */
+#define MULTIPLE_ITEMS_NUM      ( BUFFER_SIZE / ( SMALL_ITEM_SIZE + ITEM_HDR_SIZE ) )
+
+TEST_CASE("Test ring buffer send and receive multiple items", "[esp_ringbuf][linux]")
+{
+    RingbufHandle_t no_split_rb = xRingbufferCreate(BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT);
+    RingbufHandle_t byte_rb = xRingbufferCreate(BUFFER_SIZE, RINGBUF_TYPE_BYTEBUF);
+    TEST_ASSERT_MESSAGE(no_split_rb && byte_rb, "Failed to create ring buffers");
+
+    uint8_t data[MULTIPLE_ITEMS_NUM + 2][SMALL_ITEM_SIZE];
+    const void *items[MULTIPLE_ITEMS_NUM + 2];
+    size_t item_sizes[MULTIPLE_ITEMS_NUM + 2];
+    for (int i = 0; i < MULTIPLE_ITEMS_NUM + 2; i++) {
+        memset(data[i], i, SMALL_ITEM_SIZE);
+        items[i] = data[i];
+        item_sizes[i] = SMALL_ITEM_SIZE;
+    }
+
+    //Only the items which fit are sent
+    TEST_ASSERT_EQUAL(MULTIPLE_ITEMS_NUM, xRingbufferSendMultiple(no_split_rb, items, item_sizes, MULTIPLE_ITEMS_NUM + 2, 0));
+    TEST_ASSERT_EQUAL(0, xRingbufferSendMultiple(no_split_rb, items, item_sizes, 1, 0));
+
+    //Receive all items at once, in order
+    void *received[MULTIPLE_ITEMS_NUM + 2];
+    size_t received_sizes[MULTIPLE_ITEMS_NUM + 2];
+    TEST_ASSERT_EQUAL(MULTIPLE_ITEMS_NUM, xRingbufferReceiveMultiple(no_split_rb, received, received_sizes, MULTIPLE_ITEMS_NUM + 2, 0));
+    for (int i = 0; i < MULTIPLE_ITEMS_NUM; i++) {
+        TEST_ASSERT_EQUAL(SMALL_ITEM_SIZE, received_sizes[i]);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(data[i], received[i], SMALL_ITEM_SIZE);
+    }
+    TEST_ASSERT_EQUAL(0, xRingbufferReceiveMultiple(no_split_rb, received, received_sizes, MULTIPLE_ITEMS_NUM + 2, 0));
+    vRingbufferReturnMultiple(no_split_rb, received, MULTIPLE_ITEMS_NUM);
+    UBaseType_t items_waiting;
+    vRingbufferGetInfo(no_split_rb, NULL, NULL, NULL, NULL, &items_waiting);
+    TEST_ASSERT_EQUAL(0, items_waiting);
+    TEST_ASSERT_EQUAL(xRingbufferGetMaxItemSize(no_split_rb), xRingbufferGetCurFreeSize(no_split_rb));
+
+    //Receiving is limited to uxMaxItems, the remaining items stay in the buffer
+    TEST_ASSERT_EQUAL(2, xRingbufferSendMultiple(no_split_rb, &items[1], &item_sizes[1], 2, 0));
+    TEST_ASSERT_EQUAL(1, xRingbufferReceiveMultiple(no_split_rb, received, received_sizes, 1, 0));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data[1], received[0], SMALL_ITEM_SIZE);
+    vRingbufferReturnMultiple(no_split_rb, received, 1);
+    receive_check_and_return_item_no_split(no_split_rb, data[2], SMALL_ITEM_SIZE, 0, false);
+
+    //Sending stops at an item which is too large for the buffer
+    item_sizes[1] = xRingbufferGetMaxItemSize(no_split_rb) + 1;
+    TEST_ASSERT_EQUAL(1, xRingbufferSendMultiple(no_split_rb, items, item_sizes, 3, 0));
+    receive_check_and_return_item_no_split(no_split_rb, data[0], SMALL_ITEM_SIZE, 0, false);
+    item_sizes[1] = SMALL_ITEM_SIZE;
+
+    //Items sent to a byte buffer are appended
+    item_sizes[1] = 0;
+    TEST_ASSERT_EQUAL(3, xRingbufferSendMultiple(byte_rb, items, item_sizes, 3, 0));
+    size_t received_size;
+    uint8_t *received_data = xRingbufferReceiveUpTo(byte_rb, &received_size, 0, BUFFER_SIZE);
+    TEST_ASSERT_NOT_NULL(received_data);
+    TEST_ASSERT_EQUAL(2 * SMALL_ITEM_SIZE, received_size);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data[0], received_data, SMALL_ITEM_SIZE);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data[2], received_data + SMALL_ITEM_SIZE, SMALL_ITEM_SIZE);
+    vRingbufferReturnItem(byte_rb, received_data);
+
+    //Cleanup
+    vRingbufferDelete(no_split_rb);
+    vRingbufferDelete(byte_rb);
+}
+
+/* ------------------------- Test SPSC ring buffers ----------------------------
+ * The following test case tests single-producer/single-consumer ring buffers
+ * from a single task.
+ * 1) A byte buffer holds exactly the requested number of bytes.
+ * 2) A no-split buffer accepts an item of the maximum size at every position
+ *    of the write pointer.
+ * 3) Items of different sizes which wrap around the buffer are received in
+ *    order and the number of waiting items is reported correctly.
+ */
+#define SPSC_ITERATIONS         100
+
+TEST_CASE("Test SPSC ring buffers", "[esp_ringbuf][linux]")
+{
+    RingbufHandle_t no_split_rb = xRingbufferCreateSPSC(BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT);
+    RingbufHandle_t byte_rb = xRingbufferCreateSPSC(BUFFER_SIZE, RINGBUF_TYPE_BYTEBUF);
+    TEST_ASSERT_MESSAGE(no_split_rb && byte_rb, "Failed to create ring buffers");
+    uint8_t data[BUFFER_SIZE];
+    for (int i = 0; i < BUFFER_SIZE; i++) {
+        data[i] = i;
+    }
+
+    //A byte buffer holds exactly BUFFER_SIZE bytes
+    TEST_ASSERT_EQUAL(BUFFER_SIZE, xRingbufferGetCurFreeSize(byte_rb));
+    TEST_ASSERT_EQUAL(pdFALSE, xRingbufferSend(byte_rb, data, BUFFER_SIZE + 1, 0));
+    TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSend(byte_rb, data, BUFFER_SIZE, 0));
+    TEST_ASSERT_EQUAL(0, xRingbufferGetCurFreeSize(byte_rb));
+    TEST_ASSERT_EQUAL(pdFALSE, xRingbufferSend(byte_rb, data, 1, 0));
+    receive_check_and_return_item_byte_buffer(byte_rb, data, BUFFER_SIZE, 0, false);
+    //Received data wraps around the end of the buffer
+    for (int i = 0; i < SPSC_ITERATIONS; i++) {
+        size_t size = 1 + i % BUFFER_SIZE;
+        TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSend(byte_rb, data, size, 0));
+        UBaseType_t bytes_waiting;
+        vRingbufferGetInfo(byte_rb, NULL, NULL, NULL, NULL, &bytes_waiting);
+        TEST_ASSERT_EQUAL(size, bytes_waiting);
+        receive_check_and_return_item_byte_buffer(byte_rb, data, size, 0, false);
+    }
+
+    //An item of the maximum size fits into the empty buffer, wherever the write pointer is
+    size_t max_item_size = xRingbufferGetMaxItemSize(no_split_rb);
+    for (int i = 0; i < BUFFER_SIZE / (SMALL_ITEM_SIZE + ITEM_HDR_SIZE); i++) {
+        TEST_ASSERT_EQUAL(max_item_size, xRingbufferGetCurFreeSize(no_split_rb));
+        send_item_and_check(no_split_rb, data, max_item_size, 0, false);
+        receive_check_and_return_item_no_split(no_split_rb, data, max_item_size, 0, false);
+        send_item_and_check(no_split_rb, data, SMALL_ITEM_SIZE, 0, false);
+        receive_check_and_return_item_no_split(no_split_rb, data, SMALL_ITEM_SIZE, 0, false);
+    }
+
+    //Items of different sizes are received in order, also when they wrap around
+    size_t next_send = 0;
+    size_t next_receive = 0;
+    for (int i = 0; i < SPSC_ITERATIONS; i++) {
+        UBaseType_t items_sent = 0;
+        while (xRingbufferSend(no_split_rb, &data[next_send % SMALL_ITEM_SIZE], next_send % (MEDIUM_ITEM_SIZE + 1), 0) == pdTRUE) {
+            next_send++;
+            items_sent++;
+        }
+        TEST_ASSERT_MESSAGE(items_sent > 0, "Failed to send any item");
+        UBaseType_t items_waiting;
+        vRingbufferGetInfo(no_split_rb, NULL, NULL, NULL, NULL, &items_waiting);
+        TEST_ASSERT_EQUAL(next_send - next_receive, items_waiting);
+        //Receive all but the last item, which stays in the buffer for the next iteration
+        while (next_receive < next_send - (i % 2)) {
+            receive_check_and_return_item_no_split(no_split_rb, &data[next_receive % SMALL_ITEM_SIZE], next_receive % (MEDIUM_ITEM_SIZE + 1), 0, false);
+            next_receive++;
+        }
+    }
+
+    //Cleanup
+    vRingbufferDelete(no_split_rb);
+    vRingbufferDelete(byte_rb);
+}
+
+/* ---------------- Test SPSC ring buffers between two tasks -------------------
+ * The following test case sends a continuous piece of data split into items of
+ * random length from one task to another through SPSC ring buffers, with the
+ * receiving task having a lower, equal and higher priority. Both tasks block
+ * on the ring buffer when it is full or empty.
+ */
+static const char spsc_data[] = {"A_piece_of_data_which_is_sent_in_items_of_random_length_"
+                                 "through_a_single_producer_single_consumer_ring_buffer."
+                                };
+#define SPSC_DATA_LEN           (sizeof(spsc_data))
+#define SPSC_TASK_ITERATIONS    200
+
+static void spsc_send_task(void *args)
+{
+    task_args_t *task_args = (task_args_t *)args;
+    size_t max_item_size = xRingbufferGetMaxItemSize(task_args->buffer);
+    for (int iter = 0; iter < SPSC_TASK_ITERATIONS; iter++) {
+        size_t bytes_sent = 0;
+        while (bytes_sent < SPSC_DATA_LEN) {
+            size_t item_size = rand() % (max_item_size + 1);
+            if (item_size > SPSC_DATA_LEN - bytes_sent) {
+                item_size = SPSC_DATA_LEN - bytes_sent;
+            }
+            TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSend(task_args->buffer, &spsc_data[bytes_sent], item_size, portMAX_DELAY));
+            bytes_sent += item_size;
+        }
+    }
+    xSemaphoreGive(tx_done);
+    vTaskDelete(NULL);
+}
+
+static void spsc_receive_task(void *args)
+{
+    task_args_t *task_args = (task_args_t *)args;
+    for (int iter = 0; iter < SPSC_TASK_ITERATIONS; iter++) {
+        size_t bytes_received = 0;
+        while (bytes_received < SPSC_DATA_LEN) {
+            size_t item_size;
+            char *item;
+            if (task_args->type == RINGBUF_TYPE_NOSPLIT) {
+                item = xRingbufferReceive(task_args->buffer, &item_size, portMAX_DELAY);
+            } else {
+                //Do not receive data of the next iteration
+                item = xRingbufferReceiveUpTo(task_args->buffer, &item_size, portMAX_DELAY, SPSC_DATA_LEN - bytes_received);
+            }
+            TEST_ASSERT_NOT_NULL(item);
+            if (item_size > 0) {
+                TEST_ASSERT_EQUAL_HEX8_ARRAY(&spsc_data[bytes_received], item, item_size);
+            }
+            bytes_received += item_size;
+            vRingbufferReturnItem(task_args->buffer, item);
+        }
+    }
+    xSemaphoreGive(rx_done);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("Test SPSC ring buffers between two tasks", "[esp_ringbuf][linux]")
+{
+    tx_done = xSemaphoreCreateBinary();
+    rx_done = xSemaphoreCreateBinary();
+    TEST_ASSERT(tx_done && rx_done);
+    srand(SRAND_SEED);
+
+    RingbufferType_t buf_types[] = { RINGBUF_TYPE_NOSPLIT, RINGBUF_TYPE_BYTEBUF };
+    for (int type = 0; type < sizeof(buf_types) / sizeof(buf_types[0]); type++) {
+        task_args_t task_args = {
+            .buffer = xRingbufferCreateSPSC(BUFFER_SIZE, buf_types[type]),
+            .type = buf_types[type],
+        };
+        TEST_ASSERT_MESSAGE(task_args.buffer != NULL, "Failed to create ring buffer");
+        for (int prior_mod = -1; prior_mod < 2; prior_mod++) {
+            //The receiving task runs on the last core, so both tasks run concurrently on multi-core targets
+            xTaskCreatePinnedToCore(spsc_send_task, "spsc send", 4096, &task_args, 10, NULL, 0);
+            xTaskCreatePinnedToCore(spsc_receive_task, "spsc rec", 4096, &task_args, 10 + prior_mod, NULL, CONFIG_FREERTOS_NUMBER_OF_CORES - 1);
+            TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(tx_done, portMAX_DELAY));
+            TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(rx_done, portMAX_DELAY));
+            vTaskDelay(5);  //Allow idle to clean up
+        }
+        vRingbufferDelete(task_args.buffer);
+    }
+
+    vSemaphoreDelete(tx_done);
+    vSemaphoreDelete(rx_done);
+}
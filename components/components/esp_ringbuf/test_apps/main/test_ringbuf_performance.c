@@ -0,0 +1,250 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Throughput of small items through a no-split ring buffer, sent and received
+ * one by one compared to batches, and throughput and latency of SPSC ring buffers
+ * compared to ring buffers protected by a spinlock. Runs on both the chip target
+ * and the Linux target.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/ringbuf.h"
+#include "unity.h"
+
+#include "test_functions.h"
+
+#define IDF_LOG_PERFORMANCE(item, value_fmt, value, ...) \
+    printf("[Performance][%s]: " value_fmt "\n", item, value, ##__VA_ARGS__)
+
+#define PERF_ITEM_SIZE          16
+#define PERF_BATCH_SIZE         16
+#define PERF_NUM_ITEMS          (PERF_BATCH_SIZE * 1000)
+#define PERF_BUFFER_SIZE        (4 * PERF_BATCH_SIZE * (PERF_ITEM_SIZE + ITEM_HDR_SIZE))
+
+typedef struct {
+    RingbufHandle_t buffer;
+    bool batched;
+    SemaphoreHandle_t done;
+} perf_args_t;
+
+static int64_t get_time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void perf_receive_task(void *args)
+{
+    perf_args_t *perf_args = (perf_args_t *)args;
+    void *items[PERF_BATCH_SIZE];
+    size_t item_sizes[PERF_BATCH_SIZE];
+    int received = 0;
+
+    while (received < PERF_NUM_ITEMS) {
+        if (perf_args->batched) {
+            UBaseType_t count = xRingbufferReceiveMultiple(perf_args->buffer, items, item_sizes, PERF_BATCH_SIZE, portMAX_DELAY);
+            vRingbufferReturnMultiple(perf_args->buffer, items, count);
+            received += count;
+        } else {
+            items[0] = xRingbufferReceive(perf_args->buffer, &item_sizes[0], portMAX_DELAY);
+            TEST_ASSERT_NOT_NULL(items[0]);
+            vRingbufferReturnItem(perf_args->buffer, items[0]);
+            received++;
+        }
+    }
+    xSemaphoreGive(perf_args->done);
+    vTaskDelete(NULL);
+}
+
+/*
+ * The receiving task has a higher priority than the sending task, so it is woken up
+ * as soon as items are available, as it would be when processing data from a driver.
+ */
+static uint32_t measure_items_per_sec(bool batched)
+{
+    static const uint8_t item[PERF_ITEM_SIZE];
+    const void *items[PERF_BATCH_SIZE];
+    size_t item_sizes[PERF_BATCH_SIZE];
+    for (int i = 0; i < PERF_BATCH_SIZE; i++) {
+        items[i] = item;
+        item_sizes[i] = PERF_ITEM_SIZE;
+    }
+
+    perf_args_t perf_args = {
+        .buffer = xRingbufferCreate(PERF_BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT),
+        .batched = batched,
+        .done = xSemaphoreCreateBinary(),
+    };
+    TEST_ASSERT_NOT_NULL(perf_args.buffer);
+    TEST_ASSERT_NOT_NULL(perf_args.done);
+    TEST_ASSERT_EQUAL(pdTRUE, xTaskCreatePinnedToCore(perf_receive_task, "perf_rec", 4096, &perf_args,
+                                                      uxTaskPriorityGet(NULL) + 1, NULL, 0));
+
+    int64_t start = get_time_us();
+    int sent = 0;
+    while (sent < PERF_NUM_ITEMS) {
+        if (batched) {
+            sent += xRingbufferSendMultiple(perf_args.buffer, items, item_sizes, PERF_BATCH_SIZE, portMAX_DELAY);
+        } else {
+            TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSend(perf_args.buffer, item, PERF_ITEM_SIZE, portMAX_DELAY));
+            sent++;
+        }
+    }
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(perf_args.done, portMAX_DELAY));
+    int64_t elapsed_us = get_time_us() - start;
+
+    vRingbufferDelete(perf_args.buffer);
+    vSemaphoreDelete(perf_args.done);
+    return (uint32_t)((int64_t)PERF_NUM_ITEMS * 1000000 / (elapsed_us > 0 ? elapsed_us : 1));
+}
+
+TEST_CASE("Test ring buffer throughput of single and multiple items", "[esp_ringbuf][linux]")
+{
+    uint32_t single = measure_items_per_sec(false);
+    uint32_t batched = measure_items_per_sec(true);
+    IDF_LOG_PERFORMANCE("ringbuf_no_split_single_items", "%" PRIu32 " items/s", single);
+    IDF_LOG_PERFORMANCE("ringbuf_no_split_batched", "%" PRIu32 " items/s (batches of %d)", batched, PERF_BATCH_SIZE);
+}
+
+/*
+ * The sending and the receiving task have the same priority, so they only switch when
+ * the ring buffer is full or empty and most items are sent without waking up a task.
+ */
+#define PERF_STREAM_BUFFER_SIZE 1024
+#define PERF_LATENCY_SAMPLES    1000
+
+static void perf_stream_receive_task(void *args)
+{
+    perf_args_t *perf_args = (perf_args_t *)args;
+    size_t bytes_received = 0;
+
+    while (bytes_received < PERF_NUM_ITEMS * PERF_ITEM_SIZE) {
+        size_t item_size;
+        void *item = xRingbufferReceive(perf_args->buffer, &item_size, portMAX_DELAY);
+        TEST_ASSERT_NOT_NULL(item);
+        vRingbufferReturnItem(perf_args->buffer, item);
+        bytes_received += item_size;
+    }
+    xSemaphoreGive(perf_args->done);
+    vTaskDelete(NULL);
+}
+
+static uint32_t measure_stream_items_per_sec(RingbufHandle_t buffer)
+{
+    static const uint8_t item[PERF_ITEM_SIZE];
+    perf_args_t perf_args = {
+        .buffer = buffer,
+        .done = xSemaphoreCreateBinary(),
+    };
+    TEST_ASSERT_NOT_NULL(perf_args.buffer);
+    TEST_ASSERT_NOT_NULL(perf_args.done);
+    TEST_ASSERT_EQUAL(pdTRUE, xTaskCreatePinnedToCore(perf_stream_receive_task, "perf_rec", 4096, &perf_args,
+                                                      uxTaskPriorityGet(NULL), NULL, CONFIG_FREERTOS_NUMBER_OF_CORES - 1));
+
+    int64_t start = get_time_us();
+    for (int i = 0; i < PERF_NUM_ITEMS; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSend(perf_args.buffer, item, PERF_ITEM_SIZE, portMAX_DELAY));
+    }
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(perf_args.done, portMAX_DELAY));
+    int64_t elapsed_us = get_time_us() - start;
+
+    vRingbufferDelete(perf_args.buffer);
+    vSemaphoreDelete(perf_args.done);
+    return (uint32_t)((int64_t)PERF_NUM_ITEMS * 1000000 / (elapsed_us > 0 ? elapsed_us : 1));
+}
+
+typedef struct {
+    RingbufHandle_t buffer;
+    RingbufferType_t type;
+    SemaphoreHandle_t done;
+    int64_t total_us;
+    int64_t max_us;
+} latency_args_t;
+
+static void perf_latency_receive_task(void *args)
+{
+    latency_args_t *latency_args = (latency_args_t *)args;
+
+    for (int i = 0; i < PERF_LATENCY_SAMPLES; i++) {
+        int64_t sent_us;
+        size_t received = 0;
+        //Data sent to a byte buffer may be received in two parts when it wraps around
+        while (received < sizeof(sent_us)) {
+            size_t item_size;
+            void *item;
+            if (latency_args->type == RINGBUF_TYPE_BYTEBUF) {
+                item = xRingbufferReceiveUpTo(latency_args->buffer, &item_size, portMAX_DELAY, sizeof(sent_us) - received);
+            } else {
+                item = xRingbufferReceive(latency_args->buffer, &item_size, portMAX_DELAY);
+                TEST_ASSERT_EQUAL(sizeof(sent_us), item_size);
+            }
+            TEST_ASSERT_NOT_NULL(item);
+            memcpy((uint8_t *)&sent_us + received, item, item_size);
+            vRingbufferReturnItem(latency_args->buffer, item);
+            received += item_size;
+        }
+        int64_t latency_us = get_time_us() - sent_us;
+        latency_args->total_us += latency_us;
+        if (latency_us > latency_args->max_us) {
+            latency_args->max_us = latency_us;
+        }
+    }
+    xSemaphoreGive(latency_args->done);
+    vTaskDelete(NULL);
+}
+
+/*
+ * Time from sending a timestamp until a higher priority task blocked on the ring buffer
+ * has received it, which includes waking up the task and switching to it.
+ */
+static void measure_latency(RingbufHandle_t buffer, RingbufferType_t type, const char *name)
+{
+    latency_args_t latency_args = {
+        .buffer = buffer,
+        .type = type,
+        .done = xSemaphoreCreateBinary(),
+    };
+    TEST_ASSERT_NOT_NULL(latency_args.buffer);
+    TEST_ASSERT_NOT_NULL(latency_args.done);
+    TEST_ASSERT_EQUAL(pdTRUE, xTaskCreatePinnedToCore(perf_latency_receive_task, "perf_rec", 4096, &latency_args,
+                                                      uxTaskPriorityGet(NULL) + 1, NULL, 0));
+
+    for (int i = 0; i < PERF_LATENCY_SAMPLES; i++) {
+        int64_t now_us = get_time_us();
+        TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSend(latency_args.buffer, &now_us, sizeof(now_us), portMAX_DELAY));
+    }
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(latency_args.done, portMAX_DELAY));
+
+    IDF_LOG_PERFORMANCE(name, "%" PRId64 " us average, %" PRId64 " us max",
+                        latency_args.total_us / PERF_LATENCY_SAMPLES, latency_args.max_us);
+    vRingbufferDelete(latency_args.buffer);
+    vSemaphoreDelete(latency_args.done);
+}
+
+TEST_CASE("Test SPSC ring buffer throughput and latency", "[esp_ringbuf][linux]")
+{
+    uint32_t no_split = measure_stream_items_per_sec(xRingbufferCreate(PERF_STREAM_BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT));
+    uint32_t no_split_spsc = measure_stream_items_per_sec(xRingbufferCreateSPSC(PERF_STREAM_BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT));
+    uint32_t byte_buf = measure_stream_items_per_sec(xRingbufferCreate(PERF_STREAM_BUFFER_SIZE, RINGBUF_TYPE_BYTEBUF));
+    uint32_t byte_buf_spsc = measure_stream_items_per_sec(xRingbufferCreateSPSC(PERF_STREAM_BUFFER_SIZE, RINGBUF_TYPE_BYTEBUF));
+    IDF_LOG_PERFORMANCE("ringbuf_no_split_locked", "%" PRIu32 " items/s", no_split);
+    IDF_LOG_PERFORMANCE("ringbuf_no_split_spsc", "%" PRIu32 " items/s", no_split_spsc);
+    IDF_LOG_PERFORMANCE("ringbuf_byte_buf_locked", "%" PRIu32 " items/s", byte_buf);
+    IDF_LOG_PERFORMANCE("ringbuf_byte_buf_spsc", "%" PRIu32 " items/s", byte_buf_spsc);
+
+    measure_latency(xRingbufferCreate(PERF_STREAM_BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT), RINGBUF_TYPE_NOSPLIT, "ringbuf_no_split_locked_latency");
+    measure_latency(xRingbufferCreateSPSC(PERF_STREAM_BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT), RINGBUF_TYPE_NOSPLIT, "ringbuf_no_split_spsc_latency");
+    measure_latency(xRingbufferCreate(PERF_STREAM_BUFFER_SIZE, RINGBUF_TYPE_BYTEBUF), RINGBUF_TYPE_BYTEBUF, "ringbuf_byte_buf_locked_latency");
+    measure_latency(xRingbufferCreateSPSC(PERF_STREAM_BUFFER_SIZE, RINGBUF_TYPE_BYTEBUF), RINGBUF_TYPE_BYTEBUF, "ringbuf_byte_buf_spsc_latency");
+}
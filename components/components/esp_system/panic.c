@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -28,6 +28,11 @@
 
 #include "sdkconfig.h"
 
+#if CONFIG_LOG_ASYNC
+#include "esp_private/log_async.h"
+#include "esp_private/cache_utils.h"
+#endif
+
 #if !CONFIG_ESP_SYSTEM_PANIC_SILENT_REBOOT
 #if __has_include("esp_app_desc.h")
 #define WITH_ELF_SHA256
@@ -418,6 +423,15 @@ void esp_panic_handler(panic_info_t *info)
     }
 #endif /* CONFIG_ESP_COREDUMP_ENABLE */
 
+#if CONFIG_LOG_ASYNC
+    // Output the log messages logged before the panic, which are still waiting for the log task. This comes
+    // after the panic information, which doesn't depend on the state of the log buffer.
+    if (spi_flash_cache_enabled()) {
+        esp_panic_handler_feed_wdts();
+        esp_log_async_panic_flush();
+    }
+#endif
+
 #if CONFIG_ESP_SYSTEM_PANIC_GDBSTUB
     panic_print_str("Entering gdb stub now.\r\n");
     disable_all_wdts();
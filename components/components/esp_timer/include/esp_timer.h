@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2017-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2017-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -76,6 +76,9 @@ typedef struct {
     //                                !< `CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD`
     const char* name;               //!< Timer name, used in esp_timer_dump() function
     bool skip_unhandled_events;     //!< Setting to skip unhandled events in light sleep for periodic timers
+    uint32_t slack_us;              //!< Time in microseconds the callback may be delayed by, so that it can be
+    //                                !< dispatched together with other timers instead of waking up on its own;
+    //                                !< 0 to call it as soon as the timer expires
 } esp_timer_create_args_t;
 
 /**
@@ -224,6 +227,10 @@ int64_t esp_timer_get_time(void);
 
 /**
  * @brief Get the timestamp of the next expected timeout
+ *
+ * For the timers with ::esp_timer_create_args_t::slack_us set, this is the latest time the timer
+ * may be dispatched at, all the timers which have expired by then are dispatched together.
+ *
  * @return Timestamp of the nearest timer event, in microseconds.
  *         The timebase is the same as for the values returned by esp_timer_get_time().
  */
@@ -292,6 +299,19 @@ esp_err_t esp_timer_get_expiry_time(esp_timer_handle_t timer, uint64_t *expiry);
  * - Times_skipped - number of times the callback was skipped
  * - Callback_exec_time - total time taken by callback to execute, across all calls
  *
+ * Armed timers are listed in the order of their alarms. Timers armed while the list is being collected may
+ * not fit into it, their number is then printed as "(N more)".
+ *
+ * The list is followed by the statistics of each dispatch method:
+ *
+ * | Dispatch | Batches | Callbacks | Coalesced |
+ *
+ * - Dispatch — TASK or ISR
+ * - Batches — number of times expired timers were dispatched
+ * - Callbacks — number of callbacks called
+ * - Coalesced — number of callbacks called before their slack ran out, in the same batch as
+ *   another timer, i.e. without a separate wake-up
+ *
  * @param stream stream (such as stdout) to which to dump the information
  * @return
  *      - ESP_OK on success
@@ -1,10 +1,12 @@
 /*
- * SPDX-FileCopyrightText: 2017-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2017-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
 
 #include <sys/param.h>
+#include <inttypes.h>
+#include <stdlib.h>
 #include <string.h>
 #include "soc/soc.h"
 #include "esp_types.h"
@@ -35,6 +37,9 @@
 
 #define EVENT_ID_DELETE_TIMER   0xF0DE1E1E
 
+// Initial number of timers which fit into a timer heap, the heap grows by doubling
+#define TIMER_HEAP_MIN_CAPACITY 8
+
 typedef enum {
     FL_ISR_DISPATCH_METHOD   = (1 << 0),  //!< 0=Callback is called from timer task, 1=Callback is called from timer ISR
     FL_SKIP_UNHANDLED_EVENTS = (1 << 1),  //!< 0=NOT skip unhandled events for periodic timers, 1=Skip unhandled events for periodic timers
@@ -49,22 +54,40 @@ struct esp_timer {
         uint32_t event_id;
     };
     void* arg;
+    uint32_t slack;
 #if WITH_PROFILING
     const char* name;
     size_t times_triggered;
     size_t times_armed;
     size_t times_skipped;
     uint64_t total_callback_run_time;
-#endif // WITH_PROFILING
     LIST_ENTRY(esp_timer) list_entry;
+#endif // WITH_PROFILING
+    size_t heap_index;
 };
 
+// Binary min-heap of armed timers, ordered by alarm. Its array is only reallocated
+// in esp_timer_create, so arming a timer never allocates memory.
+typedef struct {
+    esp_timer_handle_t* timers;
+    size_t count;
+    size_t capacity;
+} timer_heap_t;
+
 static inline bool is_initialized(void);
-static esp_err_t timer_insert(esp_timer_handle_t timer, bool without_update_alarm);
+static esp_err_t timer_insert(esp_timer_handle_t timer);
 static esp_err_t timer_remove(esp_timer_handle_t timer);
 static bool timer_armed(esp_timer_handle_t timer);
 static void timer_list_lock(esp_timer_dispatch_t timer_type);
 static void timer_list_unlock(esp_timer_dispatch_t timer_type);
+static esp_err_t timer_heap_reserve(esp_timer_dispatch_t dispatch_method, size_t capacity);
+static esp_err_t timer_heap_push(timer_heap_t* heap, esp_timer_handle_t timer);
+static void timer_heap_erase(timer_heap_t* heap, esp_timer_handle_t timer);
+static void timer_heap_sift_down(timer_heap_t* heap, size_t index);
+static esp_timer_handle_t timer_heap_first(const timer_heap_t* heap);
+static inline uint64_t timer_deadline(esp_timer_handle_t timer);
+static uint64_t timer_heap_find_deadline(const timer_heap_t* heap, size_t index, uint64_t deadline, bool for_wake_up);
+static void timer_set_alarm(esp_timer_dispatch_t dispatch_method, uint64_t deadline);
 
 #if WITH_PROFILING
 static void timer_insert_inactive(esp_timer_handle_t timer);
@@ -73,10 +96,11 @@ static void timer_remove_inactive(esp_timer_handle_t timer);
 
 __attribute__((unused)) static const char* TAG = "esp_timer";
 
-// lists of currently armed timers for two dispatch methods: ISR and TASK
-static LIST_HEAD(esp_timer_list, esp_timer) s_timers[ESP_TIMER_MAX] = {
-    [0 ...(ESP_TIMER_MAX - 1)] = LIST_HEAD_INITIALIZER(s_timers)
-};
+// heaps of currently armed timers for two dispatch methods: ISR and TASK
+static timer_heap_t s_timers[ESP_TIMER_MAX];
+// number of existing timers. Any of them may be put into the TASK heap to be deleted,
+// so the TASK heap (and the ISR heap, for ISR timers) can hold this many timers.
+static size_t s_timer_count;
 #if WITH_PROFILING
 // lists of unarmed timers for two dispatch methods: ISR and TASK,
 // used only to be able to dump statistics about all the timers
@@ -87,7 +111,22 @@ static LIST_HEAD(esp_inactive_timer_list, esp_timer) s_inactive_timers[ESP_TIMER
 // task used to dispatch timer callbacks
 static TaskHandle_t s_timer_task;
 
-// lock protecting s_timers, s_inactive_timers
+// deadlines the alarms of the two dispatch methods are currently set to.
+// The deadline of a heap is the earliest alarm + slack of its timers.
+static uint64_t s_next_deadline[ESP_TIMER_MAX] = {
+    [0 ...(ESP_TIMER_MAX - 1)] = UINT64_MAX
+};
+
+// statistics of timer_process_alarm for two dispatch methods, printed by esp_timer_dump
+typedef struct {
+    uint32_t batches;   // number of times the expired timers were processed
+    uint32_t callbacks; // number of callbacks called
+    uint32_t coalesced; // number of callbacks called before their deadline, together with an earlier timer
+} timer_dispatch_stats_t;
+static timer_dispatch_stats_t s_dispatch_stats[ESP_TIMER_MAX];
+
+// lock protecting s_timers, s_inactive_timers, s_next_deadline and s_dispatch_stats.
+// s_timer_count is protected by the TASK lock.
 static portMUX_TYPE s_timer_lock[ESP_TIMER_MAX] = {
     [0 ...(ESP_TIMER_MAX - 1)] = portMUX_INITIALIZER_UNLOCKED
 };
@@ -111,8 +150,23 @@ esp_err_t esp_timer_create(const esp_timer_create_args_t* args,
     if (result == NULL) {
         return ESP_ERR_NO_MEM;
     }
+    timer_list_lock(ESP_TIMER_TASK);
+    size_t timer_count = ++s_timer_count;
+    timer_list_unlock(ESP_TIMER_TASK);
+    esp_err_t err = timer_heap_reserve(ESP_TIMER_TASK, timer_count);
+    if (err == ESP_OK && args->dispatch_method == ESP_TIMER_ISR) {
+        err = timer_heap_reserve(ESP_TIMER_ISR, timer_count);
+    }
+    if (err != ESP_OK) {
+        timer_list_lock(ESP_TIMER_TASK);
+        --s_timer_count;
+        timer_list_unlock(ESP_TIMER_TASK);
+        free(result);
+        return err;
+    }
     result->callback = args->callback;
     result->arg = args->arg;
+    result->slack = args->slack_us;
     result->flags = (args->dispatch_method ? FL_ISR_DISPATCH_METHOD : 0) |
                     (args->skip_unhandled_events ? FL_SKIP_UNHANDLED_EVENTS : 0);
 #if WITH_PROFILING
@@ -169,7 +223,7 @@ esp_err_t ESP_TIMER_IRAM_ATTR esp_timer_restart(esp_timer_handle_t timer, uint64
             timer->alarm = now + timeout_us;
             timer->period = 0;
         }
-        ret = timer_insert(timer, false);
+        ret = timer_insert(timer);
     }
 
     timer_list_unlock(dispatch_method);
@@ -204,7 +258,7 @@ esp_err_t ESP_TIMER_IRAM_ATTR esp_timer_start_once(esp_timer_handle_t timer, uin
 #if WITH_PROFILING
         timer->times_armed++;
 #endif
-        err = timer_insert(timer, false);
+        err = timer_insert(timer);
     }
     timer_list_unlock(dispatch_method);
     return err;
@@ -234,7 +288,7 @@ esp_err_t ESP_TIMER_IRAM_ATTR esp_timer_start_periodic(esp_timer_handle_t timer,
         timer->times_armed++;
         timer->times_skipped = 0;
 #endif
-        err = timer_insert(timer, false);
+        err = timer_insert(timer);
     }
     timer_list_unlock(dispatch_method);
     return err;
@@ -278,43 +332,36 @@ esp_err_t esp_timer_delete(esp_timer_handle_t timer)
         err = ESP_ERR_INVALID_STATE;
     } else {
         // A case for the timer with ESP_TIMER_ISR:
-        // This ISR timer was removed from the ISR list in esp_timer_stop() or in timer_process_alarm() -> LIST_REMOVE(it, list_entry)
-        // and here this timer will be added to another the TASK list, see below.
+        // This ISR timer was removed from the ISR heap in esp_timer_stop() or in timer_process_alarm()
+        // and here this timer will be added to the TASK heap, see below.
         // We do this because we want to free memory of the timer in a task context instead of an isr context.
         timer->flags &= ~FL_ISR_DISPATCH_METHOD;
         timer->event_id = EVENT_ID_DELETE_TIMER;
         timer->alarm = alarm;
         timer->period = 0;
-        err = timer_insert(timer, false);
+        err = timer_insert(timer);
     }
     timer_list_unlock(ESP_TIMER_TASK);
     return err;
 }
 
-static ESP_TIMER_IRAM_ATTR esp_err_t timer_insert(esp_timer_handle_t timer, bool without_update_alarm)
+static ESP_TIMER_IRAM_ATTR esp_err_t timer_insert(esp_timer_handle_t timer)
 {
+    esp_timer_dispatch_t dispatch_method = timer->flags & FL_ISR_DISPATCH_METHOD;
+    esp_err_t err = timer_heap_push(&s_timers[dispatch_method], timer);
+    if (err != ESP_OK) {
+        timer->alarm = 0;
+        timer->period = 0;
+        return err;
+    }
 #if WITH_PROFILING
     timer_remove_inactive(timer);
 #endif
-    esp_timer_handle_t it, last = NULL;
-    esp_timer_dispatch_t dispatch_method = timer->flags & FL_ISR_DISPATCH_METHOD;
-    if (LIST_FIRST(&s_timers[dispatch_method]) == NULL) {
-        LIST_INSERT_HEAD(&s_timers[dispatch_method], timer, list_entry);
-    } else {
-        LIST_FOREACH(it, &s_timers[dispatch_method], list_entry) {
-            if (timer->alarm < it->alarm) {
-                LIST_INSERT_BEFORE(it, timer, list_entry);
-                break;
-            }
-            last = it;
-        }
-        if (it == NULL) {
-            assert(last);
-            LIST_INSERT_AFTER(last, timer, list_entry);
-        }
-    }
-    if (without_update_alarm == false && timer == LIST_FIRST(&s_timers[dispatch_method])) {
-        esp_timer_impl_set_alarm_id(timer->alarm, dispatch_method);
+    // The alarm only has to move if this timer has to run before the current deadline.
+    // Otherwise it runs together with the timers at the deadline (or earlier).
+    uint64_t deadline = timer_deadline(timer);
+    if (deadline < s_next_deadline[dispatch_method]) {
+        timer_set_alarm(dispatch_method, deadline);
     }
     return ESP_OK;
 }
@@ -323,17 +370,13 @@ static ESP_TIMER_IRAM_ATTR esp_err_t timer_remove(esp_timer_handle_t timer)
 {
     esp_timer_dispatch_t dispatch_method = timer->flags & FL_ISR_DISPATCH_METHOD;
     timer_list_lock(dispatch_method);
-    esp_timer_handle_t first_timer = LIST_FIRST(&s_timers[dispatch_method]);
-    LIST_REMOVE(timer, list_entry);
+    // only the timers with an alarm before the deadline may have determined it
+    bool update_deadline = timer->alarm <= s_next_deadline[dispatch_method];
+    timer_heap_erase(&s_timers[dispatch_method], timer);
     timer->alarm = 0;
     timer->period = 0;
-    if (timer == first_timer) { // if this timer was the first in the list.
-        uint64_t next_timestamp = UINT64_MAX;
-        first_timer = LIST_FIRST(&s_timers[dispatch_method]);
-        if (first_timer) { // if after removing the timer from the list, this list is not empty.
-            next_timestamp = first_timer->alarm;
-        }
-        esp_timer_impl_set_alarm_id(next_timestamp, dispatch_method);
+    if (update_deadline) {
+        timer_set_alarm(dispatch_method, timer_heap_find_deadline(&s_timers[dispatch_method], 0, UINT64_MAX, false));
     }
 #if WITH_PROFILING
     timer_insert_inactive(timer);
@@ -342,6 +385,142 @@ static ESP_TIMER_IRAM_ATTR esp_err_t timer_remove(esp_timer_handle_t timer)
     return ESP_OK;
 }
 
+/* Returns the latest time the callback of the timer may be called at */
+static ESP_TIMER_IRAM_ATTR inline uint64_t timer_deadline(esp_timer_handle_t timer)
+{
+    return (timer->alarm > UINT64_MAX - timer->slack) ? UINT64_MAX : timer->alarm + timer->slack;
+}
+
+static ESP_TIMER_IRAM_ATTR void timer_set_alarm(esp_timer_dispatch_t dispatch_method, uint64_t deadline)
+{
+    s_next_deadline[dispatch_method] = deadline;
+    esp_timer_impl_set_alarm_id(deadline, dispatch_method);
+}
+
+static ESP_TIMER_IRAM_ATTR void timer_heap_set(timer_heap_t* heap, size_t index, esp_timer_handle_t timer)
+{
+    heap->timers[index] = timer;
+    timer->heap_index = index;
+}
+
+static ESP_TIMER_IRAM_ATTR void timer_heap_sift_up(timer_heap_t* heap, size_t index)
+{
+    esp_timer_handle_t timer = heap->timers[index];
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (heap->timers[parent]->alarm <= timer->alarm) {
+            break;
+        }
+        timer_heap_set(heap, index, heap->timers[parent]);
+        index = parent;
+    }
+    timer_heap_set(heap, index, timer);
+}
+
+static ESP_TIMER_IRAM_ATTR void timer_heap_sift_down(timer_heap_t* heap, size_t index)
+{
+    esp_timer_handle_t timer = heap->timers[index];
+    while (true) {
+        size_t child = 2 * index + 1;
+        if (child >= heap->count) {
+            break;
+        }
+        if (child + 1 < heap->count && heap->timers[child + 1]->alarm < heap->timers[child]->alarm) {
+            ++child;
+        }
+        if (timer->alarm <= heap->timers[child]->alarm) {
+            break;
+        }
+        timer_heap_set(heap, index, heap->timers[child]);
+        index = child;
+    }
+    timer_heap_set(heap, index, timer);
+}
+
+static ESP_TIMER_IRAM_ATTR esp_err_t timer_heap_push(timer_heap_t* heap, esp_timer_handle_t timer)
+{
+    if (heap->count == heap->capacity) {
+        // Should not happen, the capacity is reserved when creating the timer
+        return ESP_ERR_NO_MEM;
+    }
+    heap->timers[heap->count] = timer;
+    timer_heap_sift_up(heap, heap->count++);
+    return ESP_OK;
+}
+
+static ESP_TIMER_IRAM_ATTR void timer_heap_erase(timer_heap_t* heap, esp_timer_handle_t timer)
+{
+    size_t index = timer->heap_index;
+    assert(index < heap->count && heap->timers[index] == timer);
+    esp_timer_handle_t last = heap->timers[--heap->count];
+    if (index < heap->count) {
+        // Move the last timer into the hole and restore the heap order around it
+        heap->timers[index] = last;
+        if (index > 0 && last->alarm < heap->timers[(index - 1) / 2]->alarm) {
+            timer_heap_sift_up(heap, index);
+        } else {
+            timer_heap_sift_down(heap, index);
+        }
+    }
+}
+
+static ESP_TIMER_IRAM_ATTR esp_timer_handle_t timer_heap_first(const timer_heap_t* heap)
+{
+    return (heap->count > 0) ? heap->timers[0] : NULL;
+}
+
+/* Returns the earliest deadline (alarm + slack) before the given one of the timers in the
+ * subtree at index. With for_wake_up, the timers with the SKIP_UNHANDLED_EVENTS flag are ignored.
+ * Subtrees which only contain alarms after the deadline are not visited, so only the timers
+ * expiring within the coalescing window of the first one are visited.
+ */
+static ESP_TIMER_IRAM_ATTR uint64_t timer_heap_find_deadline(const timer_heap_t* heap, size_t index, uint64_t deadline, bool for_wake_up)
+{
+    if (index >= heap->count || heap->timers[index]->alarm >= deadline) {
+        return deadline;
+    }
+    esp_timer_handle_t it = heap->timers[index];
+    // timers with the SKIP_UNHANDLED_EVENTS flag do not want to wake up CPU from a sleep mode.
+    if (!for_wake_up || (it->flags & FL_SKIP_UNHANDLED_EVENTS) == 0) {
+        deadline = MIN(deadline, timer_deadline(it));
+    }
+    deadline = timer_heap_find_deadline(heap, 2 * index + 1, deadline, for_wake_up);
+    return timer_heap_find_deadline(heap, 2 * index + 2, deadline, for_wake_up);
+}
+
+static esp_err_t timer_heap_reserve(esp_timer_dispatch_t dispatch_method, size_t capacity)
+{
+    timer_heap_t* heap = &s_timers[dispatch_method];
+    timer_list_lock(dispatch_method);
+    size_t old_capacity = heap->capacity;
+    timer_list_unlock(dispatch_method);
+    if (old_capacity >= capacity) {
+        return ESP_OK;
+    }
+
+    /* Memory can't be allocated while holding the lock, so allocate first and
+     * swap the arrays unless another task has grown the heap in the meantime.
+     */
+    size_t new_capacity = MAX(MAX(capacity, 2 * old_capacity), TIMER_HEAP_MIN_CAPACITY);
+    esp_timer_handle_t* timers = heap_caps_malloc(new_capacity * sizeof(esp_timer_handle_t), MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
+    if (timers == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    timer_list_lock(dispatch_method);
+    if (heap->capacity < new_capacity) {
+        esp_timer_handle_t* old_timers = heap->timers;
+        if (heap->count > 0) {
+            memcpy(timers, old_timers, heap->count * sizeof(esp_timer_handle_t));
+        }
+        heap->timers = timers;
+        heap->capacity = new_capacity;
+        timers = old_timers;
+    }
+    timer_list_unlock(dispatch_method);
+    free(timers);
+    return ESP_OK;
+}
+
 #if WITH_PROFILING
 
 static ESP_TIMER_IRAM_ATTR void timer_insert_inactive(esp_timer_handle_t timer)
@@ -392,8 +571,11 @@ static bool timer_process_alarm(esp_timer_dispatch_t dispatch_method)
     timer_list_lock(dispatch_method);
     bool processed = false;
     esp_timer_handle_t it;
+    timer_dispatch_stats_t* stats = &s_dispatch_stats[dispatch_method];
+    // All the timers which have expired are processed in one pass, including the ones
+    // which could wait longer because of their slack. The alarm is set once at the end.
     while (1) {
-        it = LIST_FIRST(&s_timers[dispatch_method]);
+        it = timer_heap_first(&s_timers[dispatch_method]);
         int64_t now = esp_timer_impl_get_time();
         ESP_COMPILER_DIAGNOSTIC_PUSH_IGNORE("-Wanalyzer-use-after-free") // False-positive detection. TODO GCC-366
         if (it == NULL || it->alarm > now) {
@@ -401,14 +583,19 @@ static bool timer_process_alarm(esp_timer_dispatch_t dispatch_method)
         }
         ESP_COMPILER_DIAGNOSTIC_POP("-Wanalyzer-use-after-free")
         processed = true;
-        LIST_REMOVE(it, list_entry);
         if (it->event_id == EVENT_ID_DELETE_TIMER) {
             // It is handled only by ESP_TIMER_TASK (see esp_timer_delete()).
-            // All the ESP_TIMER_ISR timers which should be deleted are moved by esp_timer_delete() to the ESP_TIMER_TASK list.
+            // All the ESP_TIMER_ISR timers which should be deleted are moved by esp_timer_delete() to the ESP_TIMER_TASK heap.
             // We want to free memory of the timer in a task context instead of an isr context.
+            timer_heap_erase(&s_timers[dispatch_method], it);
             free(it);
             it = NULL;
+            --s_timer_count;
         } else {
+            ++stats->callbacks;
+            if (now < timer_deadline(it)) {
+                ++stats->coalesced;
+            }
             if (it->period > 0) {
                 int skipped = (now - it->alarm) / it->period;
                 if ((it->flags & FL_SKIP_UNHANDLED_EVENTS) && (skipped > 1)) {
@@ -419,8 +606,10 @@ static bool timer_process_alarm(esp_timer_dispatch_t dispatch_method)
                 } else {
                     it->alarm += it->period;
                 }
-                timer_insert(it, true);
+                // the timer stays armed, move it from the top of the heap to its new position
+                timer_heap_sift_down(&s_timers[dispatch_method], 0);
             } else {
+                timer_heap_erase(&s_timers[dispatch_method], it);
                 it->alarm = 0;
 #if WITH_PROFILING
                 timer_insert_inactive(it);
@@ -440,13 +629,16 @@ static bool timer_process_alarm(esp_timer_dispatch_t dispatch_method)
 #endif
         }
     } // while(1)
+    if (processed) {
+        ++stats->batches;
+    }
     if (it) {
         if (dispatch_method == ESP_TIMER_TASK || (dispatch_method != ESP_TIMER_TASK && processed == true)) {
-            esp_timer_impl_set_alarm_id(it->alarm, dispatch_method);
+            timer_set_alarm(dispatch_method, timer_heap_find_deadline(&s_timers[dispatch_method], 0, UINT64_MAX, false));
         }
     } else {
         if (processed) {
-            esp_timer_impl_set_alarm_id(UINT64_MAX, dispatch_method);
+            timer_set_alarm(dispatch_method, UINT64_MAX);
         }
     }
     timer_list_unlock(dispatch_method);
@@ -575,7 +767,7 @@ esp_err_t esp_timer_deinit(void)
 
     /* Check if there are any active timers */
     for (esp_timer_dispatch_t dispatch_method = ESP_TIMER_TASK; dispatch_method < ESP_TIMER_MAX; ++dispatch_method) {
-        if (!LIST_EMPTY(&s_timers[dispatch_method])) {
+        if (s_timers[dispatch_method].count > 0) {
             return ESP_ERR_INVALID_STATE;
         }
     }
@@ -593,6 +785,12 @@ esp_err_t esp_timer_deinit(void)
 
     esp_timer_impl_deinit();
     deinit_timer_task();
+    if (s_timer_count == 0) {
+        for (esp_timer_dispatch_t dispatch_method = ESP_TIMER_TASK; dispatch_method < ESP_TIMER_MAX; ++dispatch_method) {
+            free(s_timers[dispatch_method].timers);
+            s_timers[dispatch_method] = (timer_heap_t) { 0 };
+        }
+    }
     return ESP_OK;
 }
 
@@ -619,6 +817,13 @@ static void print_timer_info(esp_timer_handle_t t, char** dst, size_t* dst_size)
     *dst_size -= cb;
 }
 
+static int timer_compare_alarm(const void* a, const void* b)
+{
+    uint64_t alarm_a = (*(const esp_timer_handle_t*) a)->alarm;
+    uint64_t alarm_b = (*(const esp_timer_handle_t*) b)->alarm;
+    return (alarm_a > alarm_b) - (alarm_a < alarm_b);
+}
+
 esp_err_t esp_timer_dump(FILE* stream)
 {
     /* Since timer lock is a critical section, we don't want to print directly
@@ -627,15 +832,17 @@ esp_err_t esp_timer_dump(FILE* stream)
      * print to it, then dump this memory to stdout.
      */
 
+#if WITH_PROFILING
     esp_timer_handle_t it;
+#endif
 
     /* First count the number of timers */
     size_t timer_count = 0;
+    size_t armed_count = 0;
     for (esp_timer_dispatch_t dispatch_method = ESP_TIMER_TASK; dispatch_method < ESP_TIMER_MAX; ++dispatch_method) {
         timer_list_lock(dispatch_method);
-        LIST_FOREACH(it, &s_timers[dispatch_method], list_entry) {
-            ++timer_count;
-        }
+        timer_count += s_timers[dispatch_method].count;
+        armed_count = MAX(armed_count, s_timers[dispatch_method].count);
 #if WITH_PROFILING
         LIST_FOREACH(it, &s_inactive_timers[dispatch_method], list_entry) {
             ++timer_count;
@@ -651,16 +858,30 @@ esp_err_t esp_timer_dump(FILE* stream)
      */
     size_t buf_size = TIMER_INFO_LINE_LEN * (timer_count + 3);
     char* print_buf = calloc(1, buf_size + 1);
-    if (print_buf == NULL) {
+    /* Armed timers are printed in the order of their alarms, sorted in a copy of the heap */
+    size_t sorted_size = armed_count + 3;
+    esp_timer_handle_t* sorted = calloc(sorted_size, sizeof(esp_timer_handle_t));
+    if (print_buf == NULL || sorted == NULL) {
+        free(print_buf);
+        free(sorted);
         return ESP_ERR_NO_MEM;
     }
 
     /* Print to the buffer */
     char* pos = print_buf;
+    timer_dispatch_stats_t stats[ESP_TIMER_MAX];
+    size_t omitted_count = 0; // timers armed since they were counted, which don't fit into the copy
     for (esp_timer_dispatch_t dispatch_method = ESP_TIMER_TASK; dispatch_method < ESP_TIMER_MAX; ++dispatch_method) {
         timer_list_lock(dispatch_method);
-        LIST_FOREACH(it, &s_timers[dispatch_method], list_entry) {
-            print_timer_info(it, &pos, &buf_size);
+        stats[dispatch_method] = s_dispatch_stats[dispatch_method];
+        size_t sorted_count = MIN(s_timers[dispatch_method].count, sorted_size);
+        omitted_count += s_timers[dispatch_method].count - sorted_count;
+        if (sorted_count > 0) { // the array of an empty heap may not be allocated yet
+            memcpy(sorted, s_timers[dispatch_method].timers, sorted_count * sizeof(esp_timer_handle_t));
+        }
+        qsort(sorted, sorted_count, sizeof(esp_timer_handle_t), timer_compare_alarm);
+        for (size_t i = 0; i < sorted_count; ++i) {
+            print_timer_info(sorted[i], &pos, &buf_size);
         }
 #if WITH_PROFILING
         LIST_FOREACH(it, &s_inactive_timers[dispatch_method], list_entry) {
@@ -681,9 +902,23 @@ esp_err_t esp_timer_dump(FILE* stream)
 
         /* Print the buffer */
         fputs(print_buf, stream);
+        if (omitted_count > 0) {
+            fprintf(stream, "(%zu more)\n", omitted_count);
+        }
+
+        /* Print how the expired timers were dispatched. Coalesced callbacks were called
+         * before their deadline, in the same batch as an earlier timer, without an alarm of their own.
+         */
+        fprintf(stream, "%-8s  %-12s  %-12s  %-12s\n", "Dispatch", "Batches", "Callbacks", "Coalesced");
+        for (esp_timer_dispatch_t dispatch_method = ESP_TIMER_TASK; dispatch_method < ESP_TIMER_MAX; ++dispatch_method) {
+            fprintf(stream, "%-8s  %-12"PRIu32"  %-12"PRIu32"  %-12"PRIu32"\n",
+                    (dispatch_method == ESP_TIMER_TASK) ? "TASK" : "ISR",
+                    stats[dispatch_method].batches, stats[dispatch_method].callbacks, stats[dispatch_method].coalesced);
+        }
     }
 
     free(print_buf);
+    free(sorted);
     return ESP_OK;
 }
 
@@ -692,12 +927,7 @@ int64_t ESP_TIMER_IRAM_ATTR esp_timer_get_next_alarm(void)
     int64_t next_alarm = INT64_MAX;
     for (esp_timer_dispatch_t dispatch_method = ESP_TIMER_TASK; dispatch_method < ESP_TIMER_MAX; ++dispatch_method) {
         timer_list_lock(dispatch_method);
-        esp_timer_handle_t it = LIST_FIRST(&s_timers[dispatch_method]);
-        if (it) {
-            if (next_alarm > it->alarm) {
-                next_alarm = it->alarm;
-            }
-        }
+        next_alarm = timer_heap_find_deadline(&s_timers[dispatch_method], 0, next_alarm, false);
         timer_list_unlock(dispatch_method);
     }
     return next_alarm;
@@ -708,16 +938,7 @@ int64_t ESP_TIMER_IRAM_ATTR esp_timer_get_next_alarm_for_wake_up(void)
     int64_t next_alarm = INT64_MAX;
     for (esp_timer_dispatch_t dispatch_method = ESP_TIMER_TASK; dispatch_method < ESP_TIMER_MAX; ++dispatch_method) {
         timer_list_lock(dispatch_method);
-        esp_timer_handle_t it = NULL;
-        LIST_FOREACH(it, &s_timers[dispatch_method], list_entry) {
-            // timers with the SKIP_UNHANDLED_EVENTS flag do not want to wake up CPU from a sleep mode.
-            if ((it->flags & FL_SKIP_UNHANDLED_EVENTS) == 0) {
-                if (next_alarm > it->alarm) {
-                    next_alarm = it->alarm;
-                }
-                break;
-            }
-        }
+        next_alarm = timer_heap_find_deadline(&s_timers[dispatch_method], 0, next_alarm, true);
         timer_list_unlock(dispatch_method);
     }
     return next_alarm;
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2022-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -405,6 +405,82 @@ TEST_CASE("esp_timer_get_time call takes less than 1us", "[esp_timer]")
     test_esp_timer_get_time_performance();
 }
 
+#define PERF_TIMERS_NUM         150
+#define PERF_ARM_ITERATIONS     1000
+
+typedef struct {
+    SemaphoreHandle_t done;
+    volatile int fired;
+    int64_t first_fired;
+    int64_t last_fired;
+} perf_fire_state_t;
+
+static void perf_fire_cb(void* arg)
+{
+    perf_fire_state_t* state = (perf_fire_state_t*) arg;
+    int64_t now = esp_timer_get_time();
+    if (state->fired++ == 0) {
+        state->first_fired = now;
+    }
+    state->last_fired = now;
+    if (state->fired == PERF_TIMERS_NUM) {
+        xSemaphoreGive(state->done);
+    }
+}
+
+TEST_CASE("esp_timer arm, cancel and fire performance with many timers", "[esp_timer]")
+{
+    perf_fire_state_t state = {
+        .done = xSemaphoreCreateBinary(),
+    };
+    TEST_ASSERT_NOT_NULL(state.done);
+    esp_timer_handle_t* timers = calloc(PERF_TIMERS_NUM, sizeof(esp_timer_handle_t));
+    TEST_ASSERT_NOT_NULL(timers);
+    esp_timer_create_args_t args = {
+        .callback = &perf_fire_cb,
+        .arg = &state,
+    };
+    for (int i = 0; i < PERF_TIMERS_NUM; ++i) {
+        TEST_ESP_OK(esp_timer_create(&args, &timers[i]));
+    }
+
+    /* Arm and cancel one timer at a time while all the other timers are armed,
+     * with alarms spread far enough in the future not to fire during the test.
+     */
+    srand(1);
+    for (int i = 0; i < PERF_TIMERS_NUM; ++i) {
+        TEST_ESP_OK(esp_timer_start_periodic(timers[i], 10 * SEC + rand() % SEC));
+    }
+    int64_t begin = esp_timer_get_time();
+    for (int i = 0; i < PERF_ARM_ITERATIONS; ++i) {
+        esp_timer_handle_t timer = timers[rand() % PERF_TIMERS_NUM];
+        TEST_ESP_OK(esp_timer_stop(timer));
+        TEST_ESP_OK(esp_timer_start_once(timer, 10 * SEC + rand() % SEC));
+    }
+    int64_t end = esp_timer_get_time();
+    for (int i = 0; i < PERF_TIMERS_NUM; ++i) {
+        TEST_ESP_OK(esp_timer_stop(timers[i]));
+    }
+    int ns_per_arm_cancel = (int)((end - begin) * 1000 / PERF_ARM_ITERATIONS);
+
+    /* Fire all timers within a short interval, the callbacks are dispatched back to back */
+    for (int i = 0; i < PERF_TIMERS_NUM; ++i) {
+        TEST_ESP_OK(esp_timer_start_once(timers[i], 20000 + rand() % 1000));
+    }
+    TEST_ASSERT_TRUE(xSemaphoreTake(state.done, pdMS_TO_TICKS(1000)));
+    int ns_per_fire = (int)((state.last_fired - state.first_fired) * 1000 / (PERF_TIMERS_NUM - 1));
+
+    for (int i = 0; i < PERF_TIMERS_NUM; ++i) {
+        TEST_ESP_OK(esp_timer_delete(timers[i]));
+    }
+    free(timers);
+    vSemaphoreDelete(state.done);
+    vTaskDelay(3); // wait for the esp_timer task to delete all timers
+
+    IDF_LOG_PERFORMANCE("esp_timer_stop_and_start_once_150_timers", "%dns", ns_per_arm_cancel);
+    IDF_LOG_PERFORMANCE("esp_timer_fire_150_timers", "%dns per timer", ns_per_fire);
+}
+
 static int64_t IRAM_ATTR __attribute__((noinline)) get_clock_diff(void)
 {
     uint64_t hs_time = esp_timer_get_time();
@@ -956,6 +1032,48 @@ TEST_CASE("one-shot esp_timer can be restarted", "[esp_timer]")
     vTaskDelay(3); // wait for the esp_timer task to delete all timers
 }
 
+static void test_slack_timer_cb(void* arg)
+{
+    *(int64_t*) arg = esp_timer_get_time();
+}
+
+TEST_CASE("esp_timer with slack is dispatched together with a later timer", "[esp_timer]")
+{
+    const int64_t slack_us = 20000;
+    int64_t t_fired[2] = { 0 };
+    esp_timer_handle_t timers[2];
+    const esp_timer_create_args_t create_args[2] = {
+        { .callback = &test_slack_timer_cb, .arg = &t_fired[0], .name = "slack", .slack_us = slack_us },
+        { .callback = &test_slack_timer_cb, .arg = &t_fired[1], .name = "no_slack" },
+    };
+    for (int i = 0; i < 2; ++i) {
+        TEST_ESP_OK(esp_timer_create(&create_args[i], &timers[i]));
+    }
+
+    /* The first timer expires earlier, but may wait for the second one */
+    int64_t t_start = esp_timer_get_time();
+    TEST_ESP_OK(esp_timer_start_once(timers[0], 10000));
+    TEST_ESP_OK(esp_timer_start_once(timers[1], 15000));
+    vTaskDelay(50 / portTICK_PERIOD_MS);
+    TEST_ASSERT_TRUE(t_fired[1] >= t_start + 15000);
+    TEST_ASSERT_TRUE(t_fired[0] >= t_start + 10000);
+    TEST_ASSERT_INT64_WITHIN(1000, t_fired[1], t_fired[0]);
+
+    /* Alone, the timer is dispatched within its slack */
+    t_fired[0] = 0;
+    t_start = esp_timer_get_time();
+    TEST_ESP_OK(esp_timer_start_once(timers[0], 10000));
+    vTaskDelay(50 / portTICK_PERIOD_MS);
+    TEST_ASSERT_TRUE(t_fired[0] >= t_start + 10000);
+    TEST_ASSERT_TRUE(t_fired[0] <= t_start + 10000 + slack_us + 1000);
+
+    TEST_ESP_OK(esp_timer_dump(stdout));
+    for (int i = 0; i < 2; ++i) {
+        TEST_ESP_OK(esp_timer_delete(timers[i]));
+    }
+    vTaskDelay(3); // wait for the esp_timer task to delete all timers
+}
+
 #ifdef CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
 static int64_t old_time[2];
 
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -402,6 +402,7 @@ void heap_caps_print_heap_info( uint32_t caps )
             printf("    largest_free_block %d alloc_blocks %d free_blocks %d total_blocks %d\n",
                    info.largest_free_block, info.allocated_blocks,
                    info.free_blocks, info.total_blocks);
+            heap_caps_pool_print_region(heap->start, heap->end);
         }
     }
     printf("  Totals:\n");
@@ -420,6 +421,7 @@ bool heap_caps_check_integrity(uint32_t caps, bool print_errors)
         if (heap->heap != NULL
             && (all_heaps || (get_all_caps(heap) & caps) == caps)) {
             valid = multi_heap_check(heap->heap, print_errors) && valid;
+            valid = heap_caps_pool_check_region(heap->start, heap->end, print_errors) && valid;
         }
     }
 
@@ -437,7 +439,8 @@ bool heap_caps_check_integrity_addr(intptr_t addr, bool print_errors)
     if (heap == NULL) {
         return false;
     }
-    return multi_heap_check(heap->heap, print_errors);
+    bool valid = multi_heap_check(heap->heap, print_errors);
+    return heap_caps_pool_check_region(heap->start, heap->end, print_errors) && valid;
 }
 
 void heap_caps_dump(uint32_t caps)
@@ -612,3 +615,10 @@ void heap_caps_walk_all(heap_caps_walker_cb_t walker_func, void *user_data)
 {
     heap_caps_walk(MALLOC_CAP_INVALID, walker_func, user_data);
 }
+
+void heap_caps_small_alloc_cache_flush(void)
+{
+#if HEAP_SMALL_CACHE_EN
+    heap_caps_small_cache_flush_all();
+#endif
+}
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -61,6 +61,54 @@ HEAP_IRAM_ATTR static void *dram_alloc_to_iram_addr(void *addr, size_t len)
     return iptr + 1;
 }
 
+#if HEAP_SMALL_CACHE_EN
+void heap_caps_small_cache_init(heap_t *heap)
+{
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        MULTI_HEAP_LOCK_INIT(&heap->small_cache[core].lock);
+        multi_heap_cache_init(&heap->small_cache[core].cache);
+    }
+}
+
+/* The cache of the current core is used. Should the task migrate to the other core meanwhile,
+   the lock keeps the cache of the first core consistent. */
+HEAP_IRAM_ATTR static void *small_cache_malloc(heap_t *heap, size_t size)
+{
+    heap_small_cache_t *small_cache = &heap->small_cache[xPortGetCoreID()];
+    MULTI_HEAP_LOCK(&small_cache->lock);
+    void *ret = multi_heap_cache_malloc(heap->heap, &small_cache->cache, size);
+    MULTI_HEAP_UNLOCK(&small_cache->lock);
+    return ret;
+}
+
+HEAP_IRAM_ATTR static bool small_cache_free(heap_t *heap, void *ptr)
+{
+    heap_small_cache_t *small_cache = &heap->small_cache[xPortGetCoreID()];
+    MULTI_HEAP_LOCK(&small_cache->lock);
+    bool cached = multi_heap_cache_free(heap->heap, &small_cache->cache, ptr);
+    MULTI_HEAP_UNLOCK(&small_cache->lock);
+    return cached;
+}
+
+HEAP_IRAM_ATTR size_t heap_caps_small_cache_flush_all(void)
+{
+    size_t freed = 0;
+    heap_t *heap;
+    SLIST_FOREACH(heap, &registered_heaps, next) {
+        if (heap->heap == NULL) {
+            continue;
+        }
+        for (int core = 0; core < portNUM_PROCESSORS; core++) {
+            heap_small_cache_t *small_cache = &heap->small_cache[core];
+            MULTI_HEAP_LOCK(&small_cache->lock);
+            freed += multi_heap_cache_flush(heap->heap, &small_cache->cache);
+            MULTI_HEAP_UNLOCK(&small_cache->lock);
+        }
+    }
+    return freed;
+}
+#endif // HEAP_SMALL_CACHE_EN
+
 HEAP_IRAM_ATTR void heap_caps_free( void *ptr)
 {
     if (ptr == NULL) {
@@ -83,7 +131,13 @@ HEAP_IRAM_ATTR void heap_caps_free( void *ptr)
     heap_caps_update_per_task_info_free(heap, ptr);
 #endif
 
+#if HEAP_SMALL_CACHE_EN
+    if (!small_cache_free(heap, block_owner_ptr)) {
+        multi_heap_free(heap->heap, block_owner_ptr);
+    }
+#else
     multi_heap_free(heap->heap, block_owner_ptr);
+#endif
 
     CALL_HOOK(esp_heap_trace_free_hook, ptr);
 }
@@ -134,6 +188,10 @@ HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_aligned_alloc_base(size_t alignment
         size = (size + 3) & (~3); // int overflow checked above
     }
 
+#if HEAP_SMALL_CACHE_EN
+    bool small_caches_flushed = false;
+retry:
+#endif
     for (int prio = 0; prio < SOC_MEMORY_TYPE_NO_PRIOS; prio++) {
         //Iterate over heaps and check capabilities at this priority
         heap_t *heap;
@@ -171,6 +229,17 @@ HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_aligned_alloc_base(size_t alignment
                             return iptr;
                         }
                     } else {
+#if HEAP_SMALL_CACHE_EN
+                        //Small allocations are served by the cache of the first heap that can satisfy them.
+                        //The cache is refilled from this heap, falling back to a regular allocation if that fails.
+                        if (alignment <= UNALIGNED_MEM_ALIGNMENT_BYTES && size <= MULTI_HEAP_CACHE_MAX_SIZE) {
+                            ret = small_cache_malloc(heap, size);
+                            if (ret != NULL) {
+                                CALL_HOOK(esp_heap_trace_alloc_hook, ret, size, caps);
+                                return ret;
+                            }
+                        }
+#endif
                         //Just try to alloc, nothing special.
                         ret = aligned_or_unaligned_alloc(heap->heap, MULTI_HEAP_ADD_BLOCK_OWNER_SIZE(size),
                                                         alignment, MULTI_HEAP_BLOCK_OWNER_SIZE());
@@ -193,6 +262,14 @@ HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_aligned_alloc_base(size_t alignment
         }
     }
 
+#if HEAP_SMALL_CACHE_EN
+    //The memory missing may be held by the small allocation caches, give it back to the heaps and try again.
+    if (!small_caches_flushed && heap_caps_small_cache_flush_all() != 0) {
+        small_caches_flushed = true;
+        goto retry;
+    }
+#endif
+
     //Nothing usable found.
     return NULL;
 }
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2022 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -204,6 +204,10 @@ size_t heap_caps_get_containing_block_size(void *ptr) {
     return 0;
 }
 
+void heap_caps_small_alloc_cache_flush(void)
+{
+}
+
 void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps)
 {
     void *ptr = aligned_alloc(alignment, size);
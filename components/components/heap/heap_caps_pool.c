@@ -0,0 +1,383 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "sdkconfig.h"
+#include "esp_heap_caps.h"
+#include "esp_heap_caps_pool.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <pthread.h>
+#else
+#include "sys/queue.h"
+#include "heap_private.h"
+#endif
+
+/* Pools can be used from interrupt handlers: on the chips the lock is a spinlock, like the heap lock.
+   On Linux, the pools are used from threads only. */
+#if CONFIG_IDF_TARGET_LINUX
+typedef pthread_mutex_t pool_lock_t;
+#define POOL_LOCK_INIT(PLOCK)       pthread_mutex_init((PLOCK), NULL)
+#define POOL_LOCK_DELETE(PLOCK)     pthread_mutex_destroy(PLOCK)
+#define POOL_LOCK(PLOCK)            pthread_mutex_lock(PLOCK)
+#define POOL_UNLOCK(PLOCK)          pthread_mutex_unlock(PLOCK)
+#define POOL_STDERR_PRINTF(MSG, ...) fprintf(stderr, MSG, __VA_ARGS__)
+#else
+typedef multi_heap_lock_t pool_lock_t;
+#define POOL_LOCK_INIT(PLOCK)       MULTI_HEAP_LOCK_INIT(PLOCK)
+#define POOL_LOCK_DELETE(PLOCK)     (void)(PLOCK)
+#define POOL_LOCK(PLOCK)            MULTI_HEAP_LOCK(PLOCK)
+#define POOL_UNLOCK(PLOCK)          MULTI_HEAP_UNLOCK(PLOCK)
+#define POOL_STDERR_PRINTF(MSG, ...) MULTI_HEAP_STDERR_PRINTF(MSG, __VA_ARGS__)
+#endif
+
+/* The head of the list of free objects holds the index of the first free object in its lower half.
+   In lock-free pools, its upper half counts the changes of the list, so that an allocation racing with
+   the allocation and the free of the same object does not take the head it read before (ABA problem). */
+#define POOL_INDEX_MASK             0xFFFF
+#define POOL_INDEX_NONE             0xFFFF
+#define POOL_TAG_INC                0x10000
+
+/* Objects are aligned on the size of a pointer, as heap allocations are */
+#define POOL_ALIGN                  sizeof(void *)
+#define POOL_ALIGN_UP(SIZE)         (((SIZE) + POOL_ALIGN - 1) & ~(POOL_ALIGN - 1))
+
+/* Same patterns as the comprehensive heap poisoning */
+#define POOL_MALLOC_FILL_PATTERN    0xce
+#define POOL_FREE_FILL_PATTERN      0xfe
+
+/* Number of times the free objects of a lock-free pool are walked to get a stable result */
+#define POOL_CHECK_ATTEMPTS         4
+
+_Static_assert(HEAP_CAPS_POOL_MAX_OBJECTS == POOL_INDEX_NONE, "The last index marks the end of the free list");
+
+/* The pool is followed by the objects, in the same heap block */
+struct heap_caps_pool {
+#if !CONFIG_IDF_TARGET_LINUX
+    SLIST_ENTRY(heap_caps_pool) next;   ///< Next registered pool
+#endif
+    uint32_t head;                      ///< Head of the list of free objects
+    size_t used;                        ///< Number of allocated objects
+    size_t max_used;                    ///< Highest number of allocated objects
+    uint8_t *storage;                   ///< First object
+    size_t obj_size;                    ///< Object size given by the user
+    size_t slot_size;                   ///< Object size in the storage, aligned
+    uint32_t count;                     ///< Number of objects
+    uint32_t flags;                     ///< HEAP_CAPS_POOL_FLAG_* flags
+    pool_lock_t lock;                   ///< Protects the other fields, unless the pool is lock-free
+};
+
+#if !CONFIG_IDF_TARGET_LINUX
+/* All the pools, to include them in the heap diagnostics */
+static SLIST_HEAD(registered_pool_ll, heap_caps_pool) registered_pools = SLIST_HEAD_INITIALIZER(registered_pools);
+static multi_heap_lock_t registered_pools_lock = MULTI_HEAP_LOCK_STATIC_INITIALIZER;
+#endif
+
+HEAP_IRAM_ATTR static inline uint8_t *pool_object(heap_caps_pool_handle_t pool, uint32_t index)
+{
+    return pool->storage + index * pool->slot_size;
+}
+
+/* A free object starts with the index of the next free object. It is read and written with atomic
+   operations as a lock-free allocation may read it while another task allocates the object. */
+HEAP_IRAM_ATTR static inline uint32_t get_next(heap_caps_pool_handle_t pool, uint32_t index)
+{
+    return __atomic_load_n((uint32_t *)pool_object(pool, index), __ATOMIC_RELAXED);
+}
+
+HEAP_IRAM_ATTR static inline void set_next(heap_caps_pool_handle_t pool, uint32_t index, uint32_t next)
+{
+    __atomic_store_n((uint32_t *)pool_object(pool, index), next, __ATOMIC_RELAXED);
+}
+
+#if CONFIG_HEAP_POISONING_COMPREHENSIVE
+/* Check that a free object, after its link, still holds the free pattern */
+HEAP_IRAM_ATTR static bool verify_free_fill(heap_caps_pool_handle_t pool, uint32_t index)
+{
+    const uint8_t *obj = pool_object(pool, index);
+    for (size_t i = sizeof(uint32_t); i < pool->slot_size; i++) {
+        if (obj[i] != POOL_FREE_FILL_PATTERN) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+heap_caps_pool_handle_t heap_caps_pool_create(size_t obj_size, size_t count, uint32_t caps)
+{
+    return heap_caps_pool_create_with_flags(obj_size, count, caps, 0);
+}
+
+heap_caps_pool_handle_t heap_caps_pool_create_with_flags(size_t obj_size, size_t count, uint32_t caps, uint32_t flags)
+{
+    // Executable memory only supports 32-bit accesses, which objects can't be restricted to
+    if (obj_size == 0 || count == 0 || count > HEAP_CAPS_POOL_MAX_OBJECTS
+            || (flags & ~HEAP_CAPS_POOL_FLAG_LOCK_FREE) != 0 || (caps & MALLOC_CAP_EXEC) != 0) {
+        return NULL;
+    }
+
+    const size_t slot_size = POOL_ALIGN_UP(obj_size < sizeof(uint32_t) ? sizeof(uint32_t) : obj_size);
+    if (slot_size < obj_size || slot_size > (SIZE_MAX - sizeof(struct heap_caps_pool)) / count) {
+        return NULL;
+    }
+    const size_t header_size = POOL_ALIGN_UP(sizeof(struct heap_caps_pool));
+    heap_caps_pool_handle_t pool = heap_caps_malloc(header_size + slot_size * count, caps);
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    *pool = (struct heap_caps_pool) {
+        .storage = (uint8_t *)pool + header_size,
+        .obj_size = obj_size,
+        .slot_size = slot_size,
+        .count = count,
+        .flags = flags,
+        .head = 0,
+    };
+    POOL_LOCK_INIT(&pool->lock);
+    for (uint32_t index = 0; index < count; index++) {
+#if CONFIG_HEAP_POISONING_COMPREHENSIVE
+        memset(pool_object(pool, index), POOL_FREE_FILL_PATTERN, slot_size);
+#endif
+        set_next(pool, index, index + 1 < count ? index + 1 : POOL_INDEX_NONE);
+    }
+
+#if !CONFIG_IDF_TARGET_LINUX
+    MULTI_HEAP_LOCK(&registered_pools_lock);
+    SLIST_INSERT_HEAD(&registered_pools, pool, next);
+    MULTI_HEAP_UNLOCK(&registered_pools_lock);
+#endif
+    return pool;
+}
+
+void heap_caps_pool_delete(heap_caps_pool_handle_t pool)
+{
+    if (pool == NULL) {
+        return;
+    }
+
+#if !CONFIG_IDF_TARGET_LINUX
+    MULTI_HEAP_LOCK(&registered_pools_lock);
+    SLIST_REMOVE(&registered_pools, pool, heap_caps_pool, next);
+    MULTI_HEAP_UNLOCK(&registered_pools_lock);
+#endif
+    POOL_LOCK_DELETE(&pool->lock);
+    heap_caps_free(pool);
+}
+
+HEAP_IRAM_ATTR void *heap_caps_pool_alloc(heap_caps_pool_handle_t pool)
+{
+    assert(pool != NULL);
+
+    uint32_t index;
+    if (pool->flags & HEAP_CAPS_POOL_FLAG_LOCK_FREE) {
+        uint32_t head = __atomic_load_n(&pool->head, __ATOMIC_ACQUIRE);
+        uint32_t new_head;
+        do {
+            index = head & POOL_INDEX_MASK;
+            if (index == POOL_INDEX_NONE) {
+                return NULL;
+            }
+            // If another task allocates the object meanwhile, the link read is garbage but the exchange fails
+            new_head = ((head + POOL_TAG_INC) & ~POOL_INDEX_MASK) | get_next(pool, index);
+        } while (!__atomic_compare_exchange_n(&pool->head, &head, new_head, true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+        size_t used = __atomic_add_fetch(&pool->used, 1, __ATOMIC_RELAXED);
+        size_t max_used = __atomic_load_n(&pool->max_used, __ATOMIC_RELAXED);
+        while (used > max_used
+                && !__atomic_compare_exchange_n(&pool->max_used, &max_used, used, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        }
+    } else {
+        POOL_LOCK(&pool->lock);
+        index = pool->head;
+        if (index != POOL_INDEX_NONE) {
+            pool->head = get_next(pool, index);
+            pool->used++;
+            if (pool->used > pool->max_used) {
+                pool->max_used = pool->used;
+            }
+        }
+        POOL_UNLOCK(&pool->lock);
+        if (index == POOL_INDEX_NONE) {
+            return NULL;
+        }
+    }
+
+#if CONFIG_HEAP_POISONING_COMPREHENSIVE
+    assert(verify_free_fill(pool, index) && "Pool object was written to after it was freed");
+    memset(pool_object(pool, index), POOL_MALLOC_FILL_PATTERN, pool->slot_size);
+#endif
+    return pool_object(pool, index);
+}
+
+HEAP_IRAM_ATTR void heap_caps_pool_free(heap_caps_pool_handle_t pool, void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+    assert(pool != NULL);
+
+    const size_t offset = (uintptr_t)ptr - (uintptr_t)pool->storage;
+    assert((uintptr_t)ptr >= (uintptr_t)pool->storage && offset < pool->count * pool->slot_size
+           && offset % pool->slot_size == 0 && "heap_caps_pool_free() pointer is not an object of the pool");
+    const uint32_t index = offset / pool->slot_size;
+#if CONFIG_HEAP_POISONING_COMPREHENSIVE
+    memset(ptr, POOL_FREE_FILL_PATTERN, pool->slot_size);
+#endif
+
+    if (pool->flags & HEAP_CAPS_POOL_FLAG_LOCK_FREE) {
+        uint32_t head = __atomic_load_n(&pool->head, __ATOMIC_RELAXED);
+        uint32_t new_head;
+        do {
+            set_next(pool, index, head & POOL_INDEX_MASK);
+            new_head = ((head + POOL_TAG_INC) & ~POOL_INDEX_MASK) | index;
+        } while (!__atomic_compare_exchange_n(&pool->head, &head, new_head, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+        __atomic_sub_fetch(&pool->used, 1, __ATOMIC_RELAXED);
+    } else {
+        POOL_LOCK(&pool->lock);
+        set_next(pool, index, pool->head);
+        pool->head = index;
+        pool->used--;
+        POOL_UNLOCK(&pool->lock);
+    }
+}
+
+HEAP_IRAM_ATTR size_t heap_caps_pool_get_obj_size(heap_caps_pool_handle_t pool)
+{
+    assert(pool != NULL);
+    return pool->obj_size;
+}
+
+void heap_caps_pool_get_info(heap_caps_pool_handle_t pool, multi_heap_info_t *info)
+{
+    assert(pool != NULL && info != NULL);
+
+    const size_t used = __atomic_load_n(&pool->used, __ATOMIC_RELAXED);
+    const size_t max_used = __atomic_load_n(&pool->max_used, __ATOMIC_RELAXED);
+
+    memset(info, 0, sizeof(multi_heap_info_t));
+    info->total_free_bytes = (pool->count - used) * pool->obj_size;
+    info->total_allocated_bytes = used * pool->obj_size;
+    info->largest_free_block = used < pool->count ? pool->obj_size : 0;
+    info->minimum_free_bytes = (pool->count - max_used) * pool->obj_size;
+    info->allocated_blocks = used;
+    info->free_blocks = pool->count - used;
+    info->total_blocks = pool->count;
+}
+
+/* Walk the list of free objects starting at head. Return NULL if it is valid, otherwise a description of the
+   error and in *address the location of the error. */
+static const char *check_free_list(heap_caps_pool_handle_t pool, uint32_t head, size_t *free_count, const void **address)
+{
+    const void *link = &pool->head;
+    size_t free_objects = 0;
+
+    for (uint32_t index = head & POOL_INDEX_MASK; index != POOL_INDEX_NONE; index = get_next(pool, index)) {
+        if (index >= pool->count) {
+            *address = link;
+            return "invalid free object index";
+        }
+        if (++free_objects > pool->count) {
+            *address = link;
+            return "loop in the free object list";
+        }
+#if CONFIG_HEAP_POISONING_COMPREHENSIVE
+        if (!verify_free_fill(pool, index)) {
+            *address = pool_object(pool, index);
+            return "free object was written to";
+        }
+#endif
+        link = pool_object(pool, index);
+    }
+    *free_count = free_objects;
+    return NULL;
+}
+
+bool heap_caps_pool_check_integrity(heap_caps_pool_handle_t pool, bool print_errors)
+{
+    assert(pool != NULL);
+
+    const char *error = NULL;
+    const void *address = NULL;
+    size_t free_count;
+
+    if (pool->flags & HEAP_CAPS_POOL_FLAG_LOCK_FREE) {
+        // The free objects may be allocated and written while they are walked, the result is only
+        // meaningful if the list did not change meanwhile
+        for (int attempt = 0; attempt < POOL_CHECK_ATTEMPTS; attempt++) {
+            uint32_t head = __atomic_load_n(&pool->head, __ATOMIC_ACQUIRE);
+            error = check_free_list(pool, head, &free_count, &address);
+            if (__atomic_load_n(&pool->head, __ATOMIC_ACQUIRE) == head) {
+                break;
+            }
+            error = NULL;
+        }
+    } else {
+        POOL_LOCK(&pool->lock);
+        error = check_free_list(pool, pool->head, &free_count, &address);
+        if (error == NULL && free_count != pool->count - pool->used) {
+            error = "wrong number of free objects";
+            address = pool;
+        }
+        POOL_UNLOCK(&pool->lock);
+    }
+
+    if (error != NULL && print_errors) {
+        POOL_STDERR_PRINTF("CORRUPT POOL %p: %s at %p\n", pool, error, address);
+    }
+    return error == NULL;
+}
+
+#if !CONFIG_IDF_TARGET_LINUX
+
+bool heap_caps_pool_check_region(intptr_t start, intptr_t end, bool print_errors)
+{
+    bool valid = true;
+
+    MULTI_HEAP_LOCK(&registered_pools_lock);
+    heap_caps_pool_handle_t pool;
+    SLIST_FOREACH(pool, &registered_pools, next) {
+        if ((intptr_t)pool >= start && (intptr_t)pool < end) {
+            valid = heap_caps_pool_check_integrity(pool, print_errors) && valid;
+        }
+    }
+    MULTI_HEAP_UNLOCK(&registered_pools_lock);
+
+    return valid;
+}
+
+void heap_caps_pool_print_region(intptr_t start, intptr_t end)
+{
+    // printf can't be called with the lock taken: the pools are looked up one at a time
+    for (size_t n = 0;; n++) {
+        heap_caps_pool_handle_t found = NULL;
+        struct heap_caps_pool copy;
+
+        MULTI_HEAP_LOCK(&registered_pools_lock);
+        size_t i = 0;
+        heap_caps_pool_handle_t pool;
+        SLIST_FOREACH(pool, &registered_pools, next) {
+            if ((intptr_t)pool >= start && (intptr_t)pool < end && i++ == n) {
+                found = pool;
+                copy = *pool;
+                break;
+            }
+        }
+        MULTI_HEAP_UNLOCK(&registered_pools_lock);
+
+        if (found == NULL) {
+            return;
+        }
+        printf("    Pool at %p obj_size %d count %d used %d max_used %d%s\n", found, copy.obj_size, (int)copy.count,
+               copy.used, copy.max_used, (copy.flags & HEAP_CAPS_POOL_FLAG_LOCK_FREE) ? " lock-free" : "");
+    }
+}
+
+#endif // !CONFIG_IDF_TARGET_LINUX
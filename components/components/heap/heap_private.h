@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -12,6 +12,9 @@
 #include "multi_heap_platform.h"
 #include "sys/queue.h"
 #include "esp_attr.h"
+#if CONFIG_HEAP_SMALL_ALLOC_CACHE
+#include "multi_heap_cache.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,6 +26,22 @@ extern "C" {
 
 #define HEAP_SIZE_MAX (SOC_MAX_CONTIGUOUS_RAM_SIZE)
 
+/* The small allocation caches are per core, they need the OS to know the current core */
+#if CONFIG_HEAP_SMALL_ALLOC_CACHE && defined(MULTI_HEAP_FREERTOS)
+#define HEAP_SMALL_CACHE_EN 1
+#else
+#define HEAP_SMALL_CACHE_EN 0
+#endif
+
+#if HEAP_SMALL_CACHE_EN
+/* Small allocation cache of a heap used by one core. The lock is only contended when a task
+   migrates to the other core while using the cache, or while the caches are flushed. */
+typedef struct {
+    multi_heap_lock_t lock;
+    multi_heap_cache_t cache;
+} heap_small_cache_t;
+#endif
+
 /* Type for describing each registered heap */
 typedef struct heap_t_ {
 #if CONFIG_HEAP_TASK_TRACKING
@@ -33,6 +52,9 @@ typedef struct heap_t_ {
     intptr_t end;
     multi_heap_lock_t heap_mux;
     multi_heap_handle_t heap;
+#if HEAP_SMALL_CACHE_EN
+    heap_small_cache_t small_cache[portNUM_PROCESSORS];
+#endif
     SLIST_ENTRY(heap_t_) next;
 } heap_t;
 
@@ -46,6 +68,20 @@ extern SLIST_HEAD(registered_heap_ll, heap_t_) registered_heaps;
 
 bool heap_caps_match(const heap_t *heap, uint32_t caps);
 
+#if HEAP_SMALL_CACHE_EN
+/* Initialise the small allocation caches of a heap */
+void heap_caps_small_cache_init(heap_t *heap);
+
+/* Free the blocks of all the small allocation caches to their heaps, return the number of blocks freed */
+size_t heap_caps_small_cache_flush_all(void);
+#endif
+
+/* Check the integrity of the object pools allocated in [start, end) */
+bool heap_caps_pool_check_region(intptr_t start, intptr_t end, bool print_errors);
+
+/* Print a summary of the object pools allocated in [start, end) */
+void heap_caps_pool_print_region(intptr_t start, intptr_t end);
+
 FORCE_INLINE_ATTR uint32_t get_ored_caps(const uint32_t caps[SOC_MEMORY_TYPE_NO_PRIOS])
 {
     uint32_t all_caps = 0;
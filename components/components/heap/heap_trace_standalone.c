@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -14,6 +14,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_memory_utils.h"
+#include "esp_cpu.h"
 #include "sys/queue.h"
 
 static __attribute__((unused)) const char* TAG = "heaptrace";
@@ -62,6 +63,33 @@ typedef struct {
     bool has_overflowed;
 } records_t;
 
+/* Sampling profiler: hash table of call sites */
+typedef struct {
+
+    /* Buffer used for the call sites, as a hash table with linear probing */
+    heap_trace_site_t *buffer;
+
+    /* capacity of 'buffer' */
+    size_t capacity;
+
+    /* Count of used entries in 'buffer' */
+    size_t count;
+
+    /* Samples recorded, and lost because 'buffer' was full */
+    size_t samples;
+    size_t lost_samples;
+
+    /* Average number of bytes between two samples */
+    size_t interval;
+    bool running;
+
+    /* Number of bytes to allocate before the next sample, on each core */
+    size_t bytes_left[portNUM_PROCESSORS];
+
+    /* State of the pseudo-random generator of the intervals */
+    uint32_t seed;
+} sampling_t;
+
 // Forward Defines
 static void heap_trace_dump_base(bool internal_ram, bool psram);
 static void record_deep_copy(heap_trace_record_t *r_dest, const heap_trace_record_t *r_src);
@@ -70,11 +98,14 @@ static void list_remove(heap_trace_record_t *r_remove);
 static heap_trace_record_t* list_add(const heap_trace_record_t *r_append);
 static heap_trace_record_t* list_pop_unused(void);
 static heap_trace_record_t* list_find(void *p);
+static size_t next_sample_interval(size_t interval);
 static void list_find_and_remove(void* p);
 
 /* The actual records. */
 static records_t records;
 
+static sampling_t sampling;
+
 /* Actual number of allocations logged */
 static size_t total_allocations;
 
@@ -330,6 +361,172 @@ esp_err_t heap_trace_summary(heap_trace_summary_t *summary)
     return ESP_OK;
 }
 
+esp_err_t heap_trace_sampling_init(heap_trace_site_t *site_buffer, size_t num_sites)
+{
+    if (sampling.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (site_buffer == NULL || num_sites == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&trace_mux);
+    sampling.buffer = site_buffer;
+    sampling.capacity = num_sites;
+    sampling.count = 0;
+    memset(sampling.buffer, 0, sizeof(heap_trace_site_t) * sampling.capacity);
+    portEXIT_CRITICAL(&trace_mux);
+
+    return ESP_OK;
+}
+
+esp_err_t heap_trace_sampling_start(size_t sample_interval)
+{
+    if (sampling.buffer == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (sample_interval == 0 || sample_interval > SIZE_MAX / 2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&trace_mux);
+
+    // clear the call sites
+    memset(sampling.buffer, 0, sizeof(heap_trace_site_t) * sampling.capacity);
+    sampling.count = 0;
+    sampling.samples = 0;
+    sampling.lost_samples = 0;
+
+    sampling.interval = sample_interval;
+    sampling.seed = esp_cpu_get_cycle_count() | 1;
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        sampling.bytes_left[i] = next_sample_interval(sample_interval);
+    }
+    sampling.running = true;
+
+    portEXIT_CRITICAL(&trace_mux);
+    return ESP_OK;
+}
+
+esp_err_t heap_trace_sampling_stop(void)
+{
+    esp_err_t ret_val = ESP_ERR_INVALID_STATE;
+
+    portENTER_CRITICAL(&trace_mux);
+    if (sampling.running) {
+        sampling.running = false;
+        ret_val = ESP_OK;
+    }
+    portEXIT_CRITICAL(&trace_mux);
+
+    return ret_val;
+}
+
+esp_err_t heap_trace_sampling_get(size_t index, heap_trace_site_t *site)
+{
+    if (site == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t result = ESP_ERR_INVALID_ARG;
+
+    portENTER_CRITICAL(&trace_mux);
+    for (size_t i = 0; i < sampling.capacity; i++) {
+        if (sampling.buffer[i].samples != 0 && index-- == 0) {
+            memcpy(site, &sampling.buffer[i], sizeof(heap_trace_site_t));
+            result = ESP_OK;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&trace_mux);
+
+    return result;
+}
+
+esp_err_t heap_trace_sampling_summary(heap_trace_sampling_summary_t *summary)
+{
+    if (summary == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&trace_mux);
+    summary->running = sampling.running;
+    summary->sample_interval = sampling.interval;
+    summary->sites = sampling.count;
+    summary->capacity = sampling.capacity;
+    summary->samples = sampling.samples;
+    summary->lost_samples = sampling.lost_samples;
+    portEXIT_CRITICAL(&trace_mux);
+
+    return ESP_OK;
+}
+
+/* Copy the call site at index i of the buffer, return false if the entry is empty */
+static bool sampling_copy_site(size_t i, heap_trace_site_t *site)
+{
+    portENTER_CRITICAL(&trace_mux);
+    memcpy(site, &sampling.buffer[i], sizeof(heap_trace_site_t));
+    portEXIT_CRITICAL(&trace_mux);
+    return site->samples != 0;
+}
+
+esp_err_t heap_trace_sampling_dump(heap_trace_profile_format_t format)
+{
+    if (sampling.buffer == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (format != HEAP_TRACE_PROFILE_FOLDED && format != HEAP_TRACE_PROFILE_PPROF) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // The call sites are copied one at a time so that the allocations are not blocked while printing
+    heap_trace_site_t site;
+
+    if (format == HEAP_TRACE_PROFILE_PPROF) {
+        uint32_t allocs = 0;
+        uint64_t bytes = 0;
+        for (size_t i = 0; i < sampling.capacity; i++) {
+            if (sampling_copy_site(i, &site)) {
+                allocs += site.allocs;
+                bytes += site.bytes;
+            }
+        }
+        // pprof scales the sampled allocations up itself, using the sampling interval
+        esp_rom_printf("heap profile: 0: 0 [%"PRIu32": %"PRIu64"] @ heap_v2/%"PRIu32"\n",
+            allocs, bytes, (uint32_t)sampling.interval);
+    }
+
+    for (size_t i = 0; i < sampling.capacity; i++) {
+        if (!sampling_copy_site(i, &site)) {
+            continue;
+        }
+
+        if (format == HEAP_TRACE_PROFILE_PPROF) {
+            // Callers from the innermost
+            esp_rom_printf("0: 0 [%"PRIu32": %"PRIu64"] @", site.allocs, site.bytes);
+            for (int j = 0; j < STACK_DEPTH && site.callers[j] != NULL; j++) {
+                esp_rom_printf(" %p", site.callers[j]);
+            }
+            esp_rom_printf("\n");
+        } else {
+            // Callers from the outermost, and the estimated number of bytes allocated
+            bool first = true;
+            for (int j = STACK_DEPTH - 1; j >= 0; j--) {
+                if (site.callers[j] != NULL) {
+                    esp_rom_printf("%s%p", first ? "" : ";", site.callers[j]);
+                    first = false;
+                }
+            }
+            esp_rom_printf("%s %"PRIu64"\n", first ? "[unknown]" : "", (uint64_t)site.samples * sampling.interval);
+        }
+    }
+
+    return ESP_OK;
+}
+
 void heap_trace_dump(void) {
     heap_trace_dump_caps(MALLOC_CAP_INTERNAL | MALLOC_CAP_SPIRAM);
 }
@@ -516,6 +713,106 @@ static HEAP_IRAM_ATTR void record_free(void *p, void **callers)
     portEXIT_CRITICAL(&trace_mux);
 }
 
+/* Tell the wrappers if they must read the call stack for record_allocation() and record_free() */
+static HEAP_IRAM_ATTR bool recording_allocations(void)
+{
+    return tracing == TRACING_STARTED;
+}
+
+static HEAP_IRAM_ATTR bool recording_frees(void)
+{
+    return tracing == TRACING_STARTED || tracing == TRACING_ALLOC_PAUSED;
+}
+
+/* Random number of bytes between two samples, uniform in [1, 2 * interval] so that the average is the interval.
+   The intervals are random so that periodic allocation patterns do not bias the samples. */
+static HEAP_IRAM_ATTR size_t next_sample_interval(size_t interval)
+{
+    // xorshift32: concurrent updates from both cores only make it a bit less random
+    uint32_t x = sampling.seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sampling.seed = x;
+    return 1 + x % (2 * interval);
+}
+
+/* Return the number of samples falling in a new allocation, usually 0. This is the only work done for
+   the allocations which are not sampled. */
+static HEAP_IRAM_ATTR size_t sample_allocation(const void *p, size_t size)
+{
+    const size_t interval = sampling.interval;
+    if (!sampling.running || p == NULL) {
+        return 0;
+    }
+
+    // Only the current core updates its counter: an interrupt allocating meanwhile can only make it
+    // slightly inaccurate
+    size_t *bytes_left = &sampling.bytes_left[xPortGetCoreID()];
+    if (size < *bytes_left) {
+        *bytes_left -= size;
+        return 0;
+    }
+
+    size -= *bytes_left;
+    size_t samples = 1;
+    size_t next = next_sample_interval(interval);
+    while (size >= next) {
+        size -= next;
+        samples++;
+        next = next_sample_interval(interval);
+    }
+    *bytes_left = next - size;
+    return samples;
+}
+
+/* Find the call site of a call stack, or the empty entry where to add it. Return NULL if the buffer is full. */
+static HEAP_IRAM_ATTR heap_trace_site_t *find_site(void **callers)
+{
+    // FNV-1a hash of the return addresses
+    uint32_t hash = 2166136261;
+    for (int i = 0; i < STACK_DEPTH; i++) {
+        hash = (hash ^ (uint32_t)(uintptr_t)callers[i]) * 16777619;
+    }
+
+    size_t idx = hash % sampling.capacity;
+    for (size_t n = 0; n < sampling.capacity; n++) {
+        heap_trace_site_t *site = &sampling.buffer[idx];
+        if (site->samples == 0 || memcmp(site->callers, callers, sizeof(void *) * STACK_DEPTH) == 0) {
+            return site;
+        }
+        idx = (idx + 1 == sampling.capacity) ? 0 : idx + 1;
+    }
+    return NULL;
+}
+
+/* Add the samples of an allocation to the call site of its call stack */
+static HEAP_IRAM_ATTR void record_sample(size_t size, size_t samples, void **callers)
+{
+    if (samples == 0) {
+        return;
+    }
+    portENTER_CRITICAL(&trace_mux);
+
+    if (sampling.running) {
+        heap_trace_site_t *site = find_site(callers);
+        if (site == NULL) {
+            sampling.lost_samples += samples;
+        } else {
+            if (site->samples == 0) {
+                memcpy(site->callers, callers, sizeof(void *) * STACK_DEPTH);
+                sampling.count++;
+            }
+            site->samples += samples;
+            site->allocs++;
+            site->bytes += size;
+            sampling.samples += samples;
+        }
+    }
+
+    portEXIT_CRITICAL(&trace_mux);
+}
+
 // connect all records into a linked list of 'unused' records
 static void list_setup(void)
 {
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2019-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2019-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -274,6 +274,9 @@ esp_err_t heap_caps_monitor_local_minimum_free_size_stop(void);
  * across all matching heaps. The meanings of fields are the same as defined for multi_heap_info_t, except that
  * ``minimum_free_bytes`` has the same caveats described in heap_caps_get_minimum_free_size().
  *
+ * The memory of an object pool (see esp_heap_caps_pool.h) counts as one allocated block, use
+ * heap_caps_pool_get_info() to get the statistics of its objects.
+ *
  * @param info        Pointer to a structure which will be filled with relevant
  *                    heap metadata.
  * @param caps        Bitwise OR of MALLOC_CAP_* flags indicating the type
@@ -287,7 +290,8 @@ void heap_caps_get_info( multi_heap_info_t *info, uint32_t caps );
  * @brief Print a summary of all memory with the given capabilities.
  *
  * Calls multi_heap_info on all heaps which share the given capabilities, and
- * prints a two-line summary for each, then a total summary.
+ * prints a two-line summary for each followed by a line for each object pool
+ * allocated in it, then a total summary.
  *
  * @param caps        Bitwise OR of MALLOC_CAP_* flags indicating the type
  *                    of memory
@@ -511,6 +515,20 @@ void heap_caps_walk(uint32_t caps, heap_caps_walker_cb_t walker_func, void *user
  */
 void heap_caps_walk_all(heap_caps_walker_cb_t walker_func, void *user_data);
 
+/**
+ * @brief Free the blocks held by the small allocation caches back to their heaps
+ *
+ * With CONFIG_HEAP_SMALL_ALLOC_CACHE enabled, freed blocks of up to 128 bytes are kept in per-core caches
+ * to serve the next small allocations, and count as allocated in the heap statistics and in the heap walks.
+ * Call this function before reading the free size of the heaps, e.g. with heap_caps_get_free_size() or
+ * heap_caps_get_info(), to get the same results as without the caches.
+ *
+ * Allocations that fail flush the caches and retry by themselves.
+ *
+ * @note Does nothing if CONFIG_HEAP_SMALL_ALLOC_CACHE is disabled.
+ */
+void heap_caps_small_alloc_cache_flush(void);
+
 #ifdef __cplusplus
 }
 #endif
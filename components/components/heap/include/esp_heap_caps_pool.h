@@ -0,0 +1,147 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "multi_heap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file esp_heap_caps_pool.h
+ * @brief Pools of fixed-size objects allocated from the heap.
+ *
+ * A pool allocates the memory of all its objects from the heap at once, with the requested capabilities.
+ * Objects are then allocated from and freed to the pool in constant time, without taking the heap lock
+ * and without fragmenting the heap.
+ *
+ * Pools are part of the heap diagnostics: heap_caps_check_integrity() and friends check the pools whose
+ * memory is in the checked heaps, heap_caps_print_heap_info() lists them, and heap tracing records the
+ * allocations and frees of the objects besides the allocation of the memory of the pool. In heap_caps_get_info(),
+ * the memory of a pool counts as one allocated block, heap_caps_pool_get_info() gives the statistics of the objects.
+ */
+
+/**
+ * @brief Handle of a pool of fixed-size objects
+ */
+typedef struct heap_caps_pool *heap_caps_pool_handle_t;
+
+/**
+ * @brief Maximum number of objects of a pool
+ */
+#define HEAP_CAPS_POOL_MAX_OBJECTS          0xFFFF
+
+/**
+ * @brief Flag of heap_caps_pool_create_with_flags(): the objects are allocated and freed with atomic
+ *        operations instead of in a critical section.
+ *
+ * Allocations and frees never disable the interrupts nor wait for the other core, but they may retry when
+ * they race with each other. On chips without atomic instructions, the atomic operations are emulated by
+ * disabling the interrupts briefly.
+ */
+#define HEAP_CAPS_POOL_FLAG_LOCK_FREE       (1 << 0)
+
+/**
+ * @brief Create a pool of fixed-size objects
+ *
+ * Equivalent to heap_caps_pool_create_with_flags(obj_size, count, caps, 0).
+ *
+ * @param obj_size Size of each object, in bytes
+ * @param count    Number of objects of the pool, up to HEAP_CAPS_POOL_MAX_OBJECTS
+ * @param caps     Bitwise OR of MALLOC_CAP_* flags indicating the type of memory of the objects
+ *
+ * @return Handle of the pool, or NULL if the arguments are invalid or the memory could not be allocated
+ */
+heap_caps_pool_handle_t heap_caps_pool_create(size_t obj_size, size_t count, uint32_t caps);
+
+/**
+ * @brief Create a pool of fixed-size objects, with options
+ *
+ * The memory of all the objects is allocated from the heap at once, with heap_caps_malloc(). The objects are
+ * aligned on the size of a pointer. Executable memory (MALLOC_CAP_EXEC) is not supported.
+ *
+ * @param obj_size Size of each object, in bytes
+ * @param count    Number of objects of the pool, up to HEAP_CAPS_POOL_MAX_OBJECTS
+ * @param caps     Bitwise OR of MALLOC_CAP_* flags indicating the type of memory of the objects
+ * @param flags    Bitwise OR of HEAP_CAPS_POOL_FLAG_* flags, or 0
+ *
+ * @return Handle of the pool, or NULL if the arguments are invalid or the memory could not be allocated
+ */
+heap_caps_pool_handle_t heap_caps_pool_create_with_flags(size_t obj_size, size_t count, uint32_t caps, uint32_t flags);
+
+/**
+ * @brief Delete a pool and free its memory to the heap
+ *
+ * The objects still allocated from the pool must not be used anymore.
+ *
+ * @param pool Handle of the pool, may be NULL
+ */
+void heap_caps_pool_delete(heap_caps_pool_handle_t pool);
+
+/**
+ * @brief Allocate an object from a pool
+ *
+ * Runs in constant time, and can be called from an interrupt handler. The content of the object is not
+ * initialized.
+ *
+ * @param pool Handle of the pool
+ *
+ * @return Pointer to the object, or NULL if all the objects of the pool are allocated
+ */
+void *heap_caps_pool_alloc(heap_caps_pool_handle_t pool);
+
+/**
+ * @brief Free an object to the pool it was allocated from
+ *
+ * Runs in constant time, and can be called from an interrupt handler.
+ *
+ * @param pool Handle of the pool
+ * @param ptr  Pointer to the object, returned by heap_caps_pool_alloc() for the same pool. May be NULL.
+ */
+void heap_caps_pool_free(heap_caps_pool_handle_t pool, void *ptr);
+
+/**
+ * @brief Return the size of the objects of a pool
+ *
+ * @param pool Handle of the pool
+ *
+ * @return Size of the objects, as given when creating the pool
+ */
+size_t heap_caps_pool_get_obj_size(heap_caps_pool_handle_t pool);
+
+/**
+ * @brief Get the statistics of the objects of a pool
+ *
+ * Fills the structure like heap_caps_get_info() does for the heaps, counting an object as a block:
+ * the free and allocated bytes are multiples of the object size, minimum_free_bytes is the lowest number
+ * of free objects since the pool was created times the object size, and largest_free_block is the object size
+ * while an object is free.
+ *
+ * @param pool Handle of the pool
+ * @param info Pointer to a structure which will be filled with the statistics
+ */
+void heap_caps_pool_get_info(heap_caps_pool_handle_t pool, multi_heap_info_t *info);
+
+/**
+ * @brief Check the integrity of a pool
+ *
+ * Checks that the list of free objects is valid, and with comprehensive heap poisoning, that the free objects
+ * were not written to. heap_caps_check_integrity() also checks the pools whose memory is in the checked heaps.
+ *
+ * @param pool         Handle of the pool
+ * @param print_errors Print specific errors if the pool is corrupt
+ *
+ * @return True if the pool is valid, false otherwise
+ */
+bool heap_caps_pool_check_integrity(heap_caps_pool_handle_t pool, bool print_errors);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -195,6 +195,129 @@ void heap_trace_dump_caps(const uint32_t caps);
  */
 esp_err_t heap_trace_summary(heap_trace_summary_t *summary);
 
+/**
+ * @brief Allocation call site of the sampling profiler.
+ *
+ * The samples taken at the same call stack are aggregated in one call site.
+ */
+typedef struct {
+    void *callers[CONFIG_HEAP_TRACING_STACK_DEPTH]; ///< Call stack of the sampled allocations. If the depth is 0, all allocations share one call site.
+    uint32_t samples;  ///< Number of samples taken, each one stands for sample_interval bytes allocated. 0 if the entry is empty.
+    uint32_t allocs;   ///< Number of sampled allocations
+    uint64_t bytes;    ///< Total size of the sampled allocations
+} heap_trace_site_t;
+
+/**
+ * @brief Summary of the sampling profiler.
+ */
+typedef struct {
+    bool running;               ///< True if the sampling profiler is running
+    size_t sample_interval;     ///< Average number of bytes allocated between two samples, as given to the last heap_trace_sampling_start()
+    size_t sites;               ///< Number of call sites recorded
+    size_t capacity;            ///< Capacity of the call site buffer
+    size_t samples;             ///< Number of samples recorded
+    size_t lost_samples;        ///< Number of samples lost because the call site buffer was full
+} heap_trace_sampling_summary_t;
+
+/**
+ * @brief Formats of the profile dumped by heap_trace_sampling_dump().
+ */
+typedef enum {
+    HEAP_TRACE_PROFILE_FOLDED,  ///< Folded stacks: one line per call site with the callers from the outermost, separated by ';', and the estimated allocated bytes. Read by flamegraph.pl or speedscope.
+    HEAP_TRACE_PROFILE_PPROF,   ///< Legacy text heap profile of gperftools, read by pprof. Only the alloc_objects and alloc_space sample types are filled.
+} heap_trace_profile_format_t;
+
+/**
+ * @brief Initialise the sampling profiler of standalone heap tracing.
+ *
+ * The sampling profiler records about one allocation every sample_interval bytes allocated, and aggregates
+ * the samples by call stack in the call site buffer. Unlike heap_trace_start(), it has a low overhead and does
+ * not overflow, so it can stay enabled to find the allocation hot spots of a running application. It runs
+ * independently of the trace records.
+ *
+ * The call stacks have CONFIG_HEAP_TRACING_STACK_DEPTH frames.
+ *
+ * @param site_buffer Provide a buffer for the call sites, used as a hash table. It should be about twice as big
+ * as the expected number of call sites.
+ * Note: External RAM is allowed, but it prevents sampling allocations made from ISR's.
+ * @param num_sites Size of the call site buffer, as number of call site structures.
+ * @return
+ *  - ESP_ERR_NOT_SUPPORTED Project was compiled without standalone heap tracing enabled in menuconfig.
+ *  - ESP_ERR_INVALID_STATE The sampling profiler is running.
+ *  - ESP_ERR_INVALID_ARG The buffer is NULL or empty.
+ *  - ESP_OK The sampling profiler was initialised successfully.
+ */
+esp_err_t heap_trace_sampling_init(heap_trace_site_t *site_buffer, size_t num_sites);
+
+/**
+ * @brief Start the sampling profiler. The call site buffer is cleared.
+ *
+ * The interval between two samples is random, sample_interval bytes on average, so that allocation patterns
+ * do not bias the samples. An allocation bigger than the interval may be sampled several times.
+ *
+ * @param sample_interval Average number of bytes allocated between two samples.
+ * @return
+ *  - ESP_ERR_NOT_SUPPORTED Project was compiled without standalone heap tracing enabled in menuconfig.
+ *  - ESP_ERR_INVALID_STATE No call site buffer has been set via heap_trace_sampling_init().
+ *  - ESP_ERR_INVALID_ARG sample_interval is 0.
+ *  - ESP_OK The sampling profiler is started.
+ */
+esp_err_t heap_trace_sampling_start(size_t sample_interval);
+
+/**
+ * @brief Stop the sampling profiler. The call sites are kept until it is started again.
+ *
+ * @return
+ *  - ESP_ERR_NOT_SUPPORTED Project was compiled without standalone heap tracing enabled in menuconfig.
+ *  - ESP_ERR_INVALID_STATE The sampling profiler was not running.
+ *  - ESP_OK The sampling profiler is stopped.
+ */
+esp_err_t heap_trace_sampling_stop(void);
+
+/**
+ * @brief Return a call site of the sampling profiler.
+ *
+ * @note It is safe to call this function while the sampling profiler is running.
+ *
+ * @param index Index (zero-based) of the call site, less than the number of sites given by heap_trace_sampling_summary().
+ * @param[out] site Where the call site will be copied.
+ * @return
+ *  - ESP_ERR_NOT_SUPPORTED Project was compiled without standalone heap tracing enabled in menuconfig.
+ *  - ESP_ERR_INVALID_ARG site is NULL or index is out of bounds.
+ *  - ESP_OK Call site returned successfully.
+ */
+esp_err_t heap_trace_sampling_get(size_t index, heap_trace_site_t *site);
+
+/**
+ * @brief Get summary information about the sampling profiler.
+ *
+ * @note It is safe to call this function while the sampling profiler is running.
+ *
+ * @param[out] summary Where the summary will be copied.
+ * @return
+ *  - ESP_ERR_NOT_SUPPORTED Project was compiled without standalone heap tracing enabled in menuconfig.
+ *  - ESP_ERR_INVALID_ARG summary is NULL.
+ *  - ESP_OK Summary returned successfully.
+ */
+esp_err_t heap_trace_sampling_summary(heap_trace_sampling_summary_t *summary);
+
+/**
+ * @brief Dump the profile of the sampling profiler to stdout.
+ *
+ * The callers are printed as return addresses, to be resolved with the ELF file of the application, e.g.
+ * ``go tool pprof -sample_index=alloc_space build/app.elf profile.txt``.
+ *
+ * @note It is safe to call this function while the sampling profiler is running.
+ *
+ * @param format Format of the profile.
+ * @return
+ *  - ESP_ERR_NOT_SUPPORTED Project was compiled without standalone heap tracing enabled in menuconfig.
+ *  - ESP_ERR_INVALID_STATE No call site buffer has been set via heap_trace_sampling_init().
+ *  - ESP_ERR_INVALID_ARG The format is unknown.
+ *  - ESP_OK The profile was dumped.
+ */
+esp_err_t heap_trace_sampling_dump(heap_trace_profile_format_t format);
+
 #ifdef __cplusplus
 }
 #endif
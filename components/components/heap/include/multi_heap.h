@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -253,6 +253,30 @@ size_t multi_heap_get_full_block_size(multi_heap_handle_t heap, void *p);
  */
 void *multi_heap_find_containing_block(multi_heap_handle_t heap, void *ptr);
 
+/**
+ * @brief Allocate several buffers of the same size in a given heap, taking the heap lock only once
+ *
+ * Each buffer is allocated as with multi_heap_malloc() and must be freed with multi_heap_free() or
+ * multi_heap_free_bulk().
+ *
+ * @param heap Handle to a registered heap.
+ * @param size Size of each buffer.
+ * @param[out] ptrs Array receiving the pointers to the allocated buffers.
+ * @param count Number of buffers to allocate.
+ * @return Number of buffers allocated, less than count if the heap runs out of memory.
+ */
+size_t multi_heap_malloc_bulk(multi_heap_handle_t heap, size_t size, void **ptrs, size_t count);
+
+/**
+ * @brief Free several buffers of a given heap, taking the heap lock only once
+ *
+ * @param heap Handle to a registered heap.
+ * @param ptrs Array of pointers previously returned from multi_heap_malloc(), multi_heap_realloc() or
+ *             multi_heap_malloc_bulk() for the same heap. NULL entries are ignored.
+ * @param count Number of pointers in the array.
+ */
+void multi_heap_free_bulk(multi_heap_handle_t heap, void **ptrs, size_t count);
+
 #ifdef __cplusplus
 }
 #endif
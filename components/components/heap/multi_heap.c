@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -482,3 +482,36 @@ void multi_heap_restore_minimum_free_bytes(multi_heap_handle_t heap, const size_
     heap->minimum_free_bytes = MIN(heap->minimum_free_bytes, new_minimum_free_bytes_value);
     multi_heap_internal_unlock(heap);
 }
+
+size_t multi_heap_malloc_bulk(multi_heap_handle_t heap, size_t size, void **ptrs, size_t count)
+{
+    size_t allocated = 0;
+
+    if (heap == NULL) {
+        return 0;
+    }
+
+    /* The heap lock is recursive, multi_heap_malloc() taking it again is cheap */
+    multi_heap_internal_lock(heap);
+    for (; allocated < count; allocated++) {
+        ptrs[allocated] = multi_heap_malloc(heap, size);
+        if (ptrs[allocated] == NULL) {
+            break;
+        }
+    }
+    multi_heap_internal_unlock(heap);
+    return allocated;
+}
+
+void multi_heap_free_bulk(multi_heap_handle_t heap, void **ptrs, size_t count)
+{
+    if (heap == NULL) {
+        return;
+    }
+
+    multi_heap_internal_lock(heap);
+    for (size_t i = 0; i < count; i++) {
+        multi_heap_free(heap, ptrs[i]);
+    }
+    multi_heap_internal_unlock(heap);
+}
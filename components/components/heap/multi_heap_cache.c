@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/param.h>
+#include "multi_heap.h"
+#include "multi_heap_cache.h"
+
+/* Note: Keep this source file dependent on libc only, like multi_heap.c,
+   the locking is done by the caller and by the heap */
+
+/* Defines compile-time configuration macros */
+#include "multi_heap_config.h"
+
+/* Number of blocks moved between a size class and the heap at once */
+#define CACHE_BATCH ((MULTI_HEAP_CACHE_DEPTH + 1) / 2)
+
+_Static_assert(MULTI_HEAP_CACHE_DEPTH >= 2 && MULTI_HEAP_CACHE_DEPTH <= UINT8_MAX, "Invalid small allocation cache depth");
+
+static inline void cache_push(multi_heap_cache_t *cache, size_t class_idx, void *p)
+{
+    *(void **)p = cache->head[class_idx];
+    cache->head[class_idx] = p;
+    cache->count[class_idx]++;
+}
+
+static inline void *cache_pop(multi_heap_cache_t *cache, size_t class_idx)
+{
+    void *p = cache->head[class_idx];
+    cache->head[class_idx] = *(void **)p;
+    cache->count[class_idx]--;
+    return p;
+}
+
+void multi_heap_cache_init(multi_heap_cache_t *cache)
+{
+    memset(cache, 0, sizeof(*cache));
+}
+
+void *multi_heap_cache_malloc(multi_heap_handle_t heap, multi_heap_cache_t *cache, size_t size)
+{
+    if (size == 0 || size > MULTI_HEAP_CACHE_MAX_SIZE) {
+        return NULL;
+    }
+
+    const size_t class_idx = (size - 1) / MULTI_HEAP_CACHE_GRANULE;
+    if (cache->head[class_idx] != NULL) {
+        cache->hits++;
+        return cache_pop(cache, class_idx);
+    }
+
+    void *batch[CACHE_BATCH];
+    size_t count = multi_heap_malloc_bulk(heap, (class_idx + 1) * MULTI_HEAP_CACHE_GRANULE, batch, CACHE_BATCH);
+    if (count == 0) {
+        return NULL;
+    }
+    cache->refills++;
+    for (size_t i = 1; i < count; i++) {
+        cache_push(cache, class_idx, batch[i]);
+    }
+    return batch[0];
+}
+
+bool multi_heap_cache_free(multi_heap_handle_t heap, multi_heap_cache_t *cache, void *p)
+{
+    /* The block goes to the biggest class it can serve. Blocks slightly bigger than the biggest class
+       (TLSF does not split off remainders too small to be a block) still go to the biggest class. */
+    size_t size = multi_heap_get_allocated_size(heap, p);
+    if (size < MULTI_HEAP_CACHE_GRANULE || size >= MULTI_HEAP_CACHE_MAX_SIZE + MULTI_HEAP_CACHE_GRANULE) {
+        return false;
+    }
+
+    const size_t class_idx = MIN(size / MULTI_HEAP_CACHE_GRANULE, MULTI_HEAP_CACHE_CLASSES) - 1;
+    if (cache->count[class_idx] >= MULTI_HEAP_CACHE_DEPTH) {
+        void *batch[CACHE_BATCH];
+        for (size_t i = 0; i < CACHE_BATCH; i++) {
+            batch[i] = cache_pop(cache, class_idx);
+        }
+        multi_heap_free_bulk(heap, batch, CACHE_BATCH);
+        cache->trims++;
+    }
+    cache_push(cache, class_idx, p);
+    return true;
+}
+
+size_t multi_heap_cache_flush(multi_heap_handle_t heap, multi_heap_cache_t *cache)
+{
+    void *batch[CACHE_BATCH];
+    size_t count = 0;
+    size_t freed = 0;
+
+    for (size_t class_idx = 0; class_idx < MULTI_HEAP_CACHE_CLASSES; class_idx++) {
+        while (cache->head[class_idx] != NULL) {
+            batch[count++] = cache_pop(cache, class_idx);
+            if (count == CACHE_BATCH) {
+                multi_heap_free_bulk(heap, batch, count);
+                freed += count;
+                count = 0;
+            }
+        }
+    }
+    multi_heap_free_bulk(heap, batch, count);
+    return freed + count;
+}
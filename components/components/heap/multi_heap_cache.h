@@ -0,0 +1,65 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "multi_heap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Small allocation cache in front of a multi_heap.
+
+   Blocks of up to MULTI_HEAP_CACHE_MAX_SIZE bytes are kept in one singly linked list per size class (the
+   link is stored in the block itself) and handed out again without going through TLSF or taking the heap
+   lock. An empty size class is refilled by allocating half of MULTI_HEAP_CACHE_DEPTH blocks under a single
+   heap lock, a full one is trimmed by freeing half of its blocks under a single heap lock.
+
+   Cached blocks stay allocated from the point of view of the heap. A cache is not thread-safe: the caller
+   uses one cache per core or per task, or protects it with its own lock.
+*/
+
+/* Size classes are multiples of the granule, class N holding blocks of at least (N + 1) * granule bytes */
+#define MULTI_HEAP_CACHE_GRANULE    16
+#define MULTI_HEAP_CACHE_CLASSES    8
+#define MULTI_HEAP_CACHE_MAX_SIZE   (MULTI_HEAP_CACHE_GRANULE * MULTI_HEAP_CACHE_CLASSES)
+
+typedef struct {
+    void *head[MULTI_HEAP_CACHE_CLASSES];       ///< First cached block of each size class
+    uint8_t count[MULTI_HEAP_CACHE_CLASSES];    ///< Number of cached blocks of each size class
+    uint32_t hits;                              ///< Allocations served from the cache
+    uint32_t refills;                           ///< Bulk allocations from the heap, one heap lock each
+    uint32_t trims;                             ///< Bulk frees to the heap, one heap lock each
+} multi_heap_cache_t;
+
+/* Initialise an empty cache */
+void multi_heap_cache_init(multi_heap_cache_t *cache);
+
+/* Allocate a block of at least size bytes from the cache, refilling it from the heap if needed.
+
+   Returns NULL if size is 0 or above MULTI_HEAP_CACHE_MAX_SIZE, or if the heap is out of memory.
+*/
+void *multi_heap_cache_malloc(multi_heap_handle_t heap, multi_heap_cache_t *cache, size_t size);
+
+/* Give a block allocated from the heap back to the cache instead of freeing it.
+
+   Any block of the heap can be given, not only the ones returned by multi_heap_cache_malloc().
+   Returns false if the block is too big or too small to be cached, in which case the caller frees it.
+*/
+bool multi_heap_cache_free(multi_heap_handle_t heap, multi_heap_cache_t *cache, void *p);
+
+/* Free all the cached blocks to the heap.
+
+   Returns the number of blocks freed.
+*/
+size_t multi_heap_cache_flush(multi_heap_handle_t heap, multi_heap_cache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2022 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -21,3 +21,10 @@
 #define MULTI_HEAP_POISONING
 #define MULTI_HEAP_POISONING_SLOW
 #endif
+
+/* Maximum number of blocks kept per size class by a small allocation cache, see multi_heap_cache.h */
+#ifdef CONFIG_HEAP_SMALL_ALLOC_CACHE_DEPTH
+#define MULTI_HEAP_CACHE_DEPTH CONFIG_HEAP_SMALL_ALLOC_CACHE_DEPTH
+#else
+#define MULTI_HEAP_CACHE_DEPTH 8
+#endif
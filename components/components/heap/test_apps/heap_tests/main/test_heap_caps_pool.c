@@ -0,0 +1,226 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "unity.h"
+#include "esp_heap_caps.h"
+#include "esp_heap_caps_pool.h"
+#include "esp_cpu.h"
+#include "esp_memory_utils.h"
+#include "sdkconfig.h"
+
+#define POOL_COUNT          32
+
+static const uint32_t pool_flags[] = { 0, HEAP_CAPS_POOL_FLAG_LOCK_FREE };
+
+TEST_CASE("object pool allocates and frees all its objects", "[heap][pool]")
+{
+    void *objs[POOL_COUNT];
+
+    TEST_ASSERT_NULL(heap_caps_pool_create(0, POOL_COUNT, MALLOC_CAP_DEFAULT));
+    TEST_ASSERT_NULL(heap_caps_pool_create(20, HEAP_CAPS_POOL_MAX_OBJECTS + 1, MALLOC_CAP_DEFAULT));
+    TEST_ASSERT_NULL(heap_caps_pool_create(20, POOL_COUNT, MALLOC_CAP_EXEC));
+    TEST_ASSERT_NULL(heap_caps_pool_create_with_flags(20, POOL_COUNT, MALLOC_CAP_DEFAULT, 0x80));
+
+    for (size_t i = 0; i < sizeof(pool_flags) / sizeof(pool_flags[0]); i++) {
+        size_t free_size = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+        heap_caps_pool_handle_t pool = heap_caps_pool_create_with_flags(22, POOL_COUNT, MALLOC_CAP_INTERNAL, pool_flags[i]);
+        TEST_ASSERT_NOT_NULL(pool);
+        TEST_ASSERT_EQUAL(22, heap_caps_pool_get_obj_size(pool));
+
+        for (int n = 0; n < POOL_COUNT; n++) {
+            objs[n] = heap_caps_pool_alloc(pool);
+            TEST_ASSERT_NOT_NULL(objs[n]);
+            TEST_ASSERT(esp_ptr_internal(objs[n]));
+            TEST_ASSERT_EQUAL(0, (intptr_t)objs[n] & 3);
+            memset(objs[n], n, 22);
+        }
+        TEST_ASSERT_NULL(heap_caps_pool_alloc(pool));
+        for (int n = 0; n < POOL_COUNT; n++) {
+            TEST_ASSERT_EACH_EQUAL_HEX8(n, objs[n], 22);
+        }
+
+        multi_heap_info_t info;
+        heap_caps_pool_get_info(pool, &info);
+        TEST_ASSERT_EQUAL(POOL_COUNT, info.allocated_blocks);
+        TEST_ASSERT_EQUAL(POOL_COUNT * 22, info.total_allocated_bytes);
+        TEST_ASSERT_EQUAL(0, info.largest_free_block);
+
+        // The object freed last is allocated first
+        heap_caps_pool_free(pool, objs[5]);
+        TEST_ASSERT_EQUAL_PTR(objs[5], heap_caps_pool_alloc(pool));
+        for (int n = 0; n < POOL_COUNT; n++) {
+            heap_caps_pool_free(pool, objs[n]);
+        }
+
+        heap_caps_pool_get_info(pool, &info);
+        TEST_ASSERT_EQUAL(0, info.allocated_blocks);
+        TEST_ASSERT_EQUAL(POOL_COUNT, info.free_blocks);
+        TEST_ASSERT_EQUAL(POOL_COUNT * 22, info.total_free_bytes);
+        TEST_ASSERT_EQUAL(0, info.minimum_free_bytes);
+        TEST_ASSERT_TRUE(heap_caps_pool_check_integrity(pool, true));
+
+        heap_caps_pool_delete(pool);
+        TEST_ASSERT_EQUAL(free_size, heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+    }
+}
+
+TEST_CASE("object pool corruption is detected by the heap integrity checks", "[heap][pool]")
+{
+    heap_caps_pool_handle_t pool = heap_caps_pool_create(16, 4, MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(pool);
+    heap_caps_print_heap_info(MALLOC_CAP_DEFAULT);
+
+    // A free object starts with the index of the next free object
+    uint32_t *obj = heap_caps_pool_alloc(pool);
+    TEST_ASSERT_NOT_NULL(obj);
+    heap_caps_pool_free(pool, obj);
+    TEST_ASSERT_TRUE(heap_caps_check_integrity_all(true));
+
+    uint32_t next = obj[0];
+    obj[0] = 1000;
+    TEST_ASSERT_FALSE(heap_caps_pool_check_integrity(pool, true));
+    TEST_ASSERT_FALSE(heap_caps_check_integrity_all(true));
+    TEST_ASSERT_FALSE(heap_caps_check_integrity_addr((intptr_t)obj, true));
+    obj[0] = next;
+    TEST_ASSERT_TRUE(heap_caps_check_integrity_all(true));
+
+#if CONFIG_HEAP_POISONING_COMPREHENSIVE
+    // Use after free
+    uint8_t saved = ((uint8_t *)obj)[8];
+    ((uint8_t *)obj)[8] = 0;
+    TEST_ASSERT_FALSE(heap_caps_check_integrity_all(true));
+    ((uint8_t *)obj)[8] = saved;
+    TEST_ASSERT_TRUE(heap_caps_check_integrity_all(true));
+#endif
+
+    heap_caps_pool_delete(pool);
+}
+
+#define STRESS_SLOTS        8
+#define STRESS_ITERATIONS   20000
+
+typedef struct {
+    heap_caps_pool_handle_t pool;
+    SemaphoreHandle_t done;
+    uint8_t mark;
+    bool failed;
+} stress_args_t;
+
+static void pool_stress_task(void *arg)
+{
+    stress_args_t *args = (stress_args_t *)arg;
+    uint8_t *p[STRESS_SLOTS] = { 0 };
+    uint32_t seed = args->mark;
+
+    for (int i = 0; i < STRESS_ITERATIONS; i++) {
+        seed = seed * 1103515245 + 12345;
+        uint8_t **slot = &p[(seed >> 16) % STRESS_SLOTS];
+        if (*slot != NULL) {
+            // An object handed out to two tasks would be overwritten by the other one
+            args->failed |= ((*slot)[0] != args->mark || (*slot)[31] != args->mark);
+            heap_caps_pool_free(args->pool, *slot);
+            *slot = NULL;
+        } else {
+            *slot = heap_caps_pool_alloc(args->pool);
+            args->failed |= (*slot == NULL);
+            if (*slot != NULL) {
+                (*slot)[0] = (*slot)[31] = args->mark;
+            }
+        }
+    }
+
+    for (int i = 0; i < STRESS_SLOTS; i++) {
+        heap_caps_pool_free(args->pool, p[i]);
+    }
+    xSemaphoreGive(args->done);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("object pool allocations from tasks on all cores", "[heap][pool]")
+{
+    const int tasks = 2 * CONFIG_FREERTOS_NUMBER_OF_CORES;
+    stress_args_t args[2 * CONFIG_FREERTOS_NUMBER_OF_CORES];
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(tasks, 0);
+    TEST_ASSERT_NOT_NULL(done);
+
+    for (size_t i = 0; i < sizeof(pool_flags) / sizeof(pool_flags[0]); i++) {
+        heap_caps_pool_handle_t pool = heap_caps_pool_create_with_flags(32, tasks * STRESS_SLOTS, MALLOC_CAP_DEFAULT, pool_flags[i]);
+        TEST_ASSERT_NOT_NULL(pool);
+
+        for (int n = 0; n < tasks; n++) {
+            args[n] = (stress_args_t) { .pool = pool, .done = done, .mark = n + 1 };
+            TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(pool_stress_task, "pool_stress", 4096, &args[n],
+                                                              uxTaskPriorityGet(NULL) + 1, NULL, n % CONFIG_FREERTOS_NUMBER_OF_CORES));
+        }
+        for (int n = 0; n < tasks; n++) {
+            xSemaphoreTake(done, portMAX_DELAY);
+        }
+        for (int n = 0; n < tasks; n++) {
+            TEST_ASSERT_FALSE(args[n].failed);
+        }
+
+        multi_heap_info_t info;
+        heap_caps_pool_get_info(pool, &info);
+        TEST_ASSERT_EQUAL(0, info.allocated_blocks);
+        TEST_ASSERT_TRUE(heap_caps_pool_check_integrity(pool, true));
+        heap_caps_pool_delete(pool);
+    }
+    vTaskDelay(2); // let the idle task clean up the workers
+    vSemaphoreDelete(done);
+}
+
+#define BENCH_COUNT         64
+#define BENCH_ROUNDS        50
+
+/* Runs in every configuration, to compare the timings with and without heap poisoning */
+TEST_CASE("object pool timings compared to heap_caps_malloc", "[heap][pool]")
+{
+    static const size_t sizes[] = { 16, 48, 128, 512 };
+    void *p[BENCH_COUNT];
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint32_t malloc_cycles = 0;
+        uint32_t pool_cycles[2] = { 0 };
+
+        for (int round = 0; round < BENCH_ROUNDS; round++) {
+            uint32_t start = esp_cpu_get_cycle_count();
+            for (int n = 0; n < BENCH_COUNT; n++) {
+                p[n] = heap_caps_malloc(sizes[s], MALLOC_CAP_DEFAULT);
+            }
+            for (int n = 0; n < BENCH_COUNT; n++) {
+                heap_caps_free(p[n]);
+            }
+            malloc_cycles += esp_cpu_get_cycle_count() - start;
+            TEST_ASSERT_NOT_NULL(p[BENCH_COUNT - 1]);
+        }
+
+        for (size_t i = 0; i < sizeof(pool_flags) / sizeof(pool_flags[0]); i++) {
+            heap_caps_pool_handle_t pool = heap_caps_pool_create_with_flags(sizes[s], BENCH_COUNT, MALLOC_CAP_DEFAULT, pool_flags[i]);
+            TEST_ASSERT_NOT_NULL(pool);
+            for (int round = 0; round < BENCH_ROUNDS; round++) {
+                uint32_t start = esp_cpu_get_cycle_count();
+                for (int n = 0; n < BENCH_COUNT; n++) {
+                    p[n] = heap_caps_pool_alloc(pool);
+                }
+                for (int n = 0; n < BENCH_COUNT; n++) {
+                    heap_caps_pool_free(pool, p[n]);
+                }
+                pool_cycles[i] += esp_cpu_get_cycle_count() - start;
+                TEST_ASSERT_NOT_NULL(p[BENCH_COUNT - 1]);
+            }
+            heap_caps_pool_delete(pool);
+        }
+
+        printf("%d bytes, cycles per allocation and free: heap_caps_malloc %"PRIu32", pool %"PRIu32", lock-free pool %"PRIu32"\n",
+               sizes[s], malloc_cycles / (BENCH_ROUNDS * BENCH_COUNT),
+               pool_cycles[0] / (BENCH_ROUNDS * BENCH_COUNT), pool_cycles[1] / (BENCH_ROUNDS * BENCH_COUNT));
+    }
+}
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2022-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Unlicense OR CC0-1.0
  */
@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/param.h>
 #include "sdkconfig.h"
 #include "unity.h"
 
@@ -20,6 +21,7 @@
 #include "freertos/task.h"
 
 #include "esp_heap_caps.h"
+#include "esp_heap_caps_pool.h"
 
 #ifdef CONFIG_HEAP_TRACING
 // only compile in heap tracing tests if tracing is enabled
@@ -71,6 +73,37 @@ TEST_CASE("heap trace leak check", "[heap-trace]")
     heap_trace_stop();
 }
 
+TEST_CASE("heap trace records the objects of pools", "[heap-trace]")
+{
+    heap_trace_record_t recs[8];
+    heap_trace_init_standalone(recs, 8);
+
+    heap_caps_pool_handle_t pool = heap_caps_pool_create(40, 4, MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(pool);
+
+    heap_trace_start(HEAP_TRACE_LEAKS);
+
+    void *a = heap_caps_pool_alloc(pool);
+    void *b = heap_caps_pool_alloc(pool);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+
+    heap_trace_dump();
+    TEST_ASSERT_EQUAL(2, heap_trace_get_count());
+
+    heap_trace_record_t trace_a;
+    heap_trace_get(0, &trace_a);
+    TEST_ASSERT_EQUAL_PTR(a, trace_a.address);
+    TEST_ASSERT_EQUAL(40, trace_a.size);
+
+    heap_caps_pool_free(pool, a);
+    heap_caps_pool_free(pool, b);
+    TEST_ASSERT_EQUAL(0, heap_trace_get_count());
+
+    heap_trace_stop();
+    heap_caps_pool_delete(pool);
+}
+
 TEST_CASE("heap trace wrapped buffer check", "[heap-trace]")
 {
     const size_t N = 8;
@@ -264,6 +297,98 @@ TEST_CASE("check for summary value validity", "[heap-trace]") {
     heap_trace_stop();
 }
 
+#ifdef CONFIG_HEAP_TRACING_STANDALONE
+#define SAMPLING_INTERVAL   512
+#define SAMPLING_BLOCKS     4096
+
+static void __attribute__((noinline)) sampling_alloc_free(size_t size)
+{
+    void *p = heap_caps_malloc(size, MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(p);
+    heap_caps_free(p);
+}
+
+/* Not identical to sampling_alloc_free(), so that the compiler does not merge them */
+static void __attribute__((noinline)) sampling_alloc_free_other_site(size_t size)
+{
+    void *p = heap_caps_malloc(size, MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(p);
+    memset(p, 0, size);
+    heap_caps_free(p);
+}
+
+TEST_CASE("heap trace sampling profiler aggregates allocations by call site", "[heap-trace]")
+{
+    static heap_trace_site_t sites[16];
+    heap_trace_sampling_summary_t summary;
+    heap_trace_site_t site;
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, heap_trace_sampling_init(NULL, 16));
+    TEST_ASSERT_EQUAL(ESP_OK, heap_trace_sampling_init(sites, 16));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, heap_trace_sampling_start(0));
+    TEST_ASSERT_EQUAL(ESP_OK, heap_trace_sampling_start(SAMPLING_INTERVAL));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, heap_trace_sampling_init(sites, 16));
+
+    // 3/4 of the bytes are allocated by one call site, 1/4 by the other
+    for (int i = 0; i < SAMPLING_BLOCKS; i++) {
+        sampling_alloc_free(48);
+        sampling_alloc_free_other_site(16);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, heap_trace_sampling_stop());
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, heap_trace_sampling_stop());
+
+    heap_trace_sampling_summary(&summary);
+    TEST_ASSERT_FALSE(summary.running);
+    TEST_ASSERT_EQUAL(SAMPLING_INTERVAL, summary.sample_interval);
+    TEST_ASSERT_EQUAL(16, summary.capacity);
+    TEST_ASSERT_EQUAL(0, summary.lost_samples);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, summary.sites);
+
+    // The samples estimate the allocated bytes. Other tasks may have allocated a bit meanwhile.
+    size_t samples = 0;
+    size_t count = 0;
+    uint32_t largest = 0;
+    while (heap_trace_sampling_get(count, &site) == ESP_OK) {
+        TEST_ASSERT_NOT_EQUAL(0, site.samples);
+        TEST_ASSERT_GREATER_OR_EQUAL(1, site.allocs);
+        samples += site.samples;
+        largest = MAX(largest, site.samples);
+        count++;
+    }
+    TEST_ASSERT_EQUAL(summary.sites, count);
+    TEST_ASSERT_EQUAL(summary.samples, samples);
+
+    const uint64_t allocated = SAMPLING_BLOCKS * (48 + 16);
+    printf("%u bytes allocated, %llu estimated from %u samples\n", (unsigned)allocated,
+           (unsigned long long)samples * SAMPLING_INTERVAL, (unsigned)samples);
+    TEST_ASSERT((uint64_t)samples * SAMPLING_INTERVAL > allocated * 8 / 10);
+    TEST_ASSERT((uint64_t)samples * SAMPLING_INTERVAL < allocated * 13 / 10);
+#if CONFIG_HEAP_TRACING_STACK_DEPTH > 0
+    TEST_ASSERT_GREATER_OR_EQUAL(2, summary.sites);
+    TEST_ASSERT((uint64_t)largest * SAMPLING_INTERVAL > SAMPLING_BLOCKS * 48 * 8 / 10);
+    TEST_ASSERT((uint64_t)largest * SAMPLING_INTERVAL < SAMPLING_BLOCKS * 48 * 12 / 10);
+#endif
+
+    TEST_ASSERT_EQUAL(ESP_OK, heap_trace_sampling_dump(HEAP_TRACE_PROFILE_FOLDED));
+    TEST_ASSERT_EQUAL(ESP_OK, heap_trace_sampling_dump(HEAP_TRACE_PROFILE_PPROF));
+
+#if CONFIG_HEAP_TRACING_STACK_DEPTH > 0
+    // The samples of the call sites which do not fit in the buffer are counted as lost
+    TEST_ASSERT_EQUAL(ESP_OK, heap_trace_sampling_init(sites, 1));
+    TEST_ASSERT_EQUAL(ESP_OK, heap_trace_sampling_start(SAMPLING_INTERVAL));
+    for (int i = 0; i < SAMPLING_BLOCKS / 8; i++) {
+        sampling_alloc_free(48);
+        sampling_alloc_free_other_site(48);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, heap_trace_sampling_stop());
+    heap_trace_sampling_summary(&summary);
+    TEST_ASSERT_EQUAL(1, summary.sites);
+    TEST_ASSERT_NOT_EQUAL(0, summary.samples);
+    TEST_ASSERT_NOT_EQUAL(0, summary.lost_samples);
+#endif
+}
+#endif // CONFIG_HEAP_TRACING_STANDALONE
+
 #ifdef CONFIG_SPIRAM
 void* allocate_pointer(uint32_t caps)
 {
@@ -0,0 +1,167 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "unity.h"
+#include "esp_heap_caps.h"
+#include "esp_cpu.h"
+#include "esp_memory_utils.h"
+#include "sdkconfig.h"
+
+#define SMALL_ALLOC_MAX     128
+#define SLOTS               32
+#define ITERATIONS          20000
+
+typedef struct {
+    SemaphoreHandle_t done;
+    uint32_t cycles;
+    bool failed;
+} worker_args_t;
+
+/* Random mix of small allocations and frees, as done by network stacks or JSON parsers */
+static void small_alloc_worker(void *arg)
+{
+    worker_args_t *args = (worker_args_t *)arg;
+    void *p[SLOTS] = { 0 };
+    uint32_t seed = (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle();
+
+    uint32_t start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < ITERATIONS; i++) {
+        seed = seed * 1103515245 + 12345;
+        void **slot = &p[(seed >> 16) % SLOTS];
+        if (*slot != NULL) {
+            heap_caps_free(*slot);
+            *slot = NULL;
+        } else {
+            *slot = heap_caps_malloc(1 + (seed >> 8) % SMALL_ALLOC_MAX, MALLOC_CAP_DEFAULT);
+            args->failed |= (*slot == NULL);
+        }
+    }
+    args->cycles = esp_cpu_get_cycle_count() - start;
+
+    for (int i = 0; i < SLOTS; i++) {
+        heap_caps_free(p[i]);
+    }
+    xSemaphoreGive(args->done);
+    vTaskDelete(NULL);
+}
+
+/* Runs in every configuration, to compare the timings with and without CONFIG_HEAP_SMALL_ALLOC_CACHE */
+TEST_CASE("small allocations latency and contention between cores", "[heap][small-alloc-cache]")
+{
+    worker_args_t args[CONFIG_FREERTOS_NUMBER_OF_CORES];
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(CONFIG_FREERTOS_NUMBER_OF_CORES, 0);
+    TEST_ASSERT_NOT_NULL(done);
+
+    // One task alone, then one task per core allocating at the same time
+    for (int tasks = 1; tasks <= CONFIG_FREERTOS_NUMBER_OF_CORES; tasks++) {
+        for (int core = 0; core < tasks; core++) {
+            args[core] = (worker_args_t) { .done = done };
+            TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(small_alloc_worker, "small_alloc", 4096, &args[core],
+                                                              uxTaskPriorityGet(NULL) + 1, NULL, core));
+        }
+        for (int core = 0; core < tasks; core++) {
+            xSemaphoreTake(done, portMAX_DELAY);
+        }
+        for (int core = 0; core < tasks; core++) {
+            TEST_ASSERT_FALSE(args[core].failed);
+            printf("%d task(s), core %d: %"PRIu32" cycles per operation\n", tasks, core, args[core].cycles / ITERATIONS);
+        }
+    }
+    vTaskDelay(2); // let the idle task clean up the workers
+    vSemaphoreDelete(done);
+    heap_caps_small_alloc_cache_flush();
+    TEST_ASSERT(heap_caps_check_integrity_all(true));
+}
+
+#if CONFIG_HEAP_SMALL_ALLOC_CACHE
+
+TEST_CASE("small allocation cache reuses the freed blocks", "[heap][small-alloc-cache]")
+{
+    heap_caps_small_alloc_cache_flush();
+    size_t free_size = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+
+    // Several blocks of the size class are allocated at once, the next ones are served from the cache
+    uint8_t *first = heap_caps_malloc(40, MALLOC_CAP_DEFAULT);
+    uint8_t *second = heap_caps_malloc(48, MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT(heap_caps_get_allocated_size(first) >= 48);
+    memset(first, 0xA5, 48);
+    memset(second, 0x5A, 48);
+    heap_caps_free(second);
+
+    // The block freed last is handed out first
+    TEST_ASSERT_EQUAL_PTR(second, heap_caps_malloc(33, MALLOC_CAP_DEFAULT));
+    TEST_ASSERT_EACH_EQUAL_HEX8(0xA5, first, 48);
+    heap_caps_free(second);
+    heap_caps_free(first);
+
+    // Cached blocks count as allocated until the caches are flushed
+    TEST_ASSERT_LESS_THAN(free_size, heap_caps_get_free_size(MALLOC_CAP_DEFAULT));
+    heap_caps_small_alloc_cache_flush();
+    TEST_ASSERT_EQUAL(free_size, heap_caps_get_free_size(MALLOC_CAP_DEFAULT));
+    TEST_ASSERT(heap_caps_check_integrity_all(true));
+}
+
+TEST_CASE("small allocation cache is not used for other capabilities or alignments", "[heap][small-alloc-cache]")
+{
+    // Blocks cached for an internal heap are not handed out for external memory
+    uint8_t *internal = heap_caps_malloc(64, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    TEST_ASSERT_NOT_NULL(internal);
+    heap_caps_free(internal);
+#if CONFIG_SPIRAM
+    uint8_t *external = heap_caps_malloc(64, MALLOC_CAP_SPIRAM);
+    TEST_ASSERT_NOT_NULL(external);
+    TEST_ASSERT(esp_ptr_external_ram(external));
+    heap_caps_free(external);
+#endif
+
+    uint8_t *aligned = heap_caps_aligned_alloc(64, 64, MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(aligned);
+    TEST_ASSERT_EQUAL(0, (intptr_t)aligned & 63);
+    heap_caps_free(aligned);
+    heap_caps_small_alloc_cache_flush();
+    TEST_ASSERT(heap_caps_check_integrity_all(true));
+}
+
+TEST_CASE("small allocation cache is flushed when memory runs out", "[heap][small-alloc-cache]")
+{
+    // Leave blocks of 64 bytes in the cache
+    void *small[8];
+    for (int i = 0; i < 8; i++) {
+        small[i] = heap_caps_malloc(64, MALLOC_CAP_DEFAULT);
+        TEST_ASSERT_NOT_NULL(small[i]);
+    }
+    for (int i = 0; i < 8; i++) {
+        heap_caps_free(small[i]);
+    }
+
+    // Allocate all the rest of the memory
+    void *big[32] = { 0 };
+    size_t largest;
+    for (int i = 0; i < 32 && (largest = heap_caps_get_largest_free_block(MALLOC_CAP_DEFAULT)) >= SMALL_ALLOC_MAX; i++) {
+        big[i] = heap_caps_malloc(largest, MALLOC_CAP_DEFAULT);
+        TEST_ASSERT_NOT_NULL(big[i]);
+    }
+
+    // Only the cached blocks are left: the allocation succeeds once the caches are flushed
+    void *last = heap_caps_malloc(SMALL_ALLOC_MAX - 16, MALLOC_CAP_DEFAULT);
+    heap_caps_free(last);
+    for (int i = 0; i < 32; i++) {
+        heap_caps_free(big[i]);
+    }
+    TEST_ASSERT_NOT_NULL(last);
+    heap_caps_small_alloc_cache_flush();
+    TEST_ASSERT(heap_caps_check_integrity_all(true));
+}
+
+#endif // CONFIG_HEAP_SMALL_ALLOC_CACHE
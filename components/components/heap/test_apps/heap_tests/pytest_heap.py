@@ -1,4 +1,4 @@
-# SPDX-FileCopyrightText: 2022-2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-FileCopyrightText: 2022-2026 Espressif Systems (Shanghai) CO LTD
 # SPDX-License-Identifier: CC0-1.0
 import pytest
 from pytest_embedded import Dut
@@ -40,6 +40,13 @@ def test_heap_in_flash(dut: Dut) -> None:
     dut.run_all_single_board_cases()
 
 
+@pytest.mark.generic
+@pytest.mark.parametrize('config', ['no_poisoning', 'small_alloc_cache'])
+@idf_parametrize('target', ['esp32', 'esp32s3', 'esp32c3'], indirect=['target'])
+def test_heap_small_alloc_cache(dut: Dut) -> None:
+    dut.run_all_single_board_cases(group='small-alloc-cache')
+
+
 @pytest.mark.generic
 @pytest.mark.parametrize(
     'target',
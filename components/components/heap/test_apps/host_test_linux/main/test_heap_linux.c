@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2022-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -7,8 +7,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
+#include <time.h>
+#include <pthread.h>
 #include "sdkconfig.h"
 #include "esp_heap_caps.h"
+#include "esp_heap_caps_pool.h"
 #include "unity.h"
 
 #define MALLOC_LEN 1000
@@ -106,6 +109,200 @@ TEST_CASE("Misc APIs", "[heap]")
     TEST_ASSERT_TRUE(alloc_failed);
 }
 
+#define SMALL_ALLOC_MAX 128
+#define SMALL_ALLOC_SLOTS 32
+#define SMALL_ALLOC_ITERATIONS 200000
+#define SMALL_ALLOC_MAX_THREADS 4
+
+typedef struct {
+    unsigned seed;
+    uint64_t ns;
+    bool failed;
+} small_alloc_args_t;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* Same workload as the "small allocations latency and contention between cores" target test */
+static void *small_alloc_thread(void *arg)
+{
+    small_alloc_args_t *args = (small_alloc_args_t *)arg;
+    void *p[SMALL_ALLOC_SLOTS] = { 0 };
+
+    uint64_t start = now_ns();
+    for (int i = 0; i < SMALL_ALLOC_ITERATIONS; i++) {
+        void **slot = &p[rand_r(&args->seed) % SMALL_ALLOC_SLOTS];
+        if (*slot != NULL) {
+            heap_caps_free(*slot);
+            *slot = NULL;
+        } else {
+            *slot = heap_caps_malloc(1 + rand_r(&args->seed) % SMALL_ALLOC_MAX, MALLOC_CAP_DEFAULT);
+            args->failed |= (*slot == NULL);
+        }
+    }
+    args->ns = now_ns() - start;
+
+    for (int i = 0; i < SMALL_ALLOC_SLOTS; i++) {
+        heap_caps_free(p[i]);
+    }
+    return NULL;
+}
+
+TEST_CASE("Small allocations latency and contention", "[heap]")
+{
+    pthread_t threads[SMALL_ALLOC_MAX_THREADS];
+    small_alloc_args_t args[SMALL_ALLOC_MAX_THREADS];
+
+    for (int count = 1; count <= SMALL_ALLOC_MAX_THREADS; count *= 2) {
+        for (int i = 0; i < count; i++) {
+            args[i] = (small_alloc_args_t) { .seed = i + 1 };
+            TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, small_alloc_thread, &args[i]));
+        }
+        uint64_t ns = 0;
+        for (int i = 0; i < count; i++) {
+            TEST_ASSERT_EQUAL(0, pthread_join(threads[i], NULL));
+            TEST_ASSERT_FALSE(args[i].failed);
+            ns += args[i].ns;
+        }
+        printf("%d thread(s): %.1f ns per operation\n", count, (double)ns / count / SMALL_ALLOC_ITERATIONS);
+    }
+    heap_caps_small_alloc_cache_flush();
+}
+
+TEST_CASE("Object pool APIs", "[heap]")
+{
+    void *objs[4];
+
+    TEST_ASSERT_NULL(heap_caps_pool_create(0, 4, MALLOC_CAP_DEFAULT));
+    TEST_ASSERT_NULL(heap_caps_pool_create(24, 0, MALLOC_CAP_DEFAULT));
+    TEST_ASSERT_NULL(heap_caps_pool_create(24, HEAP_CAPS_POOL_MAX_OBJECTS + 1, MALLOC_CAP_DEFAULT));
+
+    heap_caps_pool_handle_t pool = heap_caps_pool_create(24, 4, MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(pool);
+    TEST_ASSERT_EQUAL(24, heap_caps_pool_get_obj_size(pool));
+    for (int i = 0; i < 4; i++) {
+        objs[i] = heap_caps_pool_alloc(pool);
+        TEST_ASSERT_NOT_NULL(objs[i]);
+        TEST_ASSERT_EQUAL(0, (uintptr_t)objs[i] % sizeof(void *));
+        memset(objs[i], TEST_VAL, 24);
+    }
+    TEST_ASSERT_NULL(heap_caps_pool_alloc(pool));
+
+    multi_heap_info_t info;
+    heap_caps_pool_get_info(pool, &info);
+    TEST_ASSERT_EQUAL(4, info.allocated_blocks);
+    TEST_ASSERT_EQUAL(0, info.free_blocks);
+    TEST_ASSERT_EQUAL(4 * 24, info.total_allocated_bytes);
+    TEST_ASSERT_EQUAL(0, info.largest_free_block);
+
+    heap_caps_pool_free(pool, objs[2]);
+    heap_caps_pool_free(pool, NULL);
+    TEST_ASSERT_EQUAL_PTR(objs[2], heap_caps_pool_alloc(pool));
+    for (int i = 0; i < 4; i++) {
+        heap_caps_pool_free(pool, objs[i]);
+    }
+    heap_caps_pool_get_info(pool, &info);
+    TEST_ASSERT_EQUAL(4 * 24, info.total_free_bytes);
+    TEST_ASSERT_EQUAL(0, info.minimum_free_bytes);
+    TEST_ASSERT_EQUAL(24, info.largest_free_block);
+    TEST_ASSERT_TRUE(heap_caps_pool_check_integrity(pool, true));
+    heap_caps_pool_delete(pool);
+}
+
+#define POOL_THREADS        4
+#define POOL_SLOTS          16
+#define POOL_ITERATIONS     100000
+
+typedef struct {
+    heap_caps_pool_handle_t pool;
+    unsigned int seed;
+    uint64_t ns;
+    bool failed;
+} pool_args_t;
+
+static uint8_t *obj_alloc(heap_caps_pool_handle_t pool)
+{
+    return pool != NULL ? heap_caps_pool_alloc(pool) : heap_caps_malloc(48, MALLOC_CAP_DEFAULT);
+}
+
+static void obj_free(heap_caps_pool_handle_t pool, uint8_t *obj)
+{
+    if (pool != NULL) {
+        heap_caps_pool_free(pool, obj);
+    } else {
+        heap_caps_free(obj);
+    }
+}
+
+/* Random mix of allocations and frees of 48 bytes objects, from a pool or from the heap if there is no pool */
+static void *pool_thread(void *arg)
+{
+    pool_args_t *args = (pool_args_t *)arg;
+    uint8_t *p[POOL_SLOTS] = { 0 };
+    const uint8_t mark = args->seed;
+
+    uint64_t start = now_ns();
+    for (int i = 0; i < POOL_ITERATIONS; i++) {
+        uint8_t **slot = &p[rand_r(&args->seed) % POOL_SLOTS];
+        if (*slot != NULL) {
+            // An object handed out twice would be overwritten by another thread
+            args->failed |= ((*slot)[0] != mark || (*slot)[47] != mark);
+            obj_free(args->pool, *slot);
+            *slot = NULL;
+        } else {
+            *slot = obj_alloc(args->pool);
+            args->failed |= (*slot == NULL);
+            if (*slot != NULL) {
+                (*slot)[0] = (*slot)[47] = mark;
+            }
+        }
+    }
+    args->ns = now_ns() - start;
+
+    for (int i = 0; i < POOL_SLOTS; i++) {
+        obj_free(args->pool, p[i]);
+    }
+    return NULL;
+}
+
+TEST_CASE("Object pool concurrent allocations, compared to the heap", "[heap]")
+{
+    const char *names[] = { "heap", "pool", "lock-free pool" };
+    pthread_t threads[POOL_THREADS];
+    pool_args_t args[POOL_THREADS];
+
+    for (int kind = 0; kind < 3; kind++) {
+        heap_caps_pool_handle_t pool = NULL;
+        if (kind > 0) {
+            pool = heap_caps_pool_create_with_flags(48, POOL_THREADS * POOL_SLOTS, MALLOC_CAP_DEFAULT,
+                                                    kind == 2 ? HEAP_CAPS_POOL_FLAG_LOCK_FREE : 0);
+            TEST_ASSERT_NOT_NULL(pool);
+        }
+        for (int i = 0; i < POOL_THREADS; i++) {
+            args[i] = (pool_args_t) { .pool = pool, .seed = i + 1 };
+            TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, pool_thread, &args[i]));
+        }
+        uint64_t ns = 0;
+        for (int i = 0; i < POOL_THREADS; i++) {
+            TEST_ASSERT_EQUAL(0, pthread_join(threads[i], NULL));
+            TEST_ASSERT_FALSE(args[i].failed);
+            ns += args[i].ns;
+        }
+        printf("%s, %d threads: %.1f ns per operation\n", names[kind], POOL_THREADS, (double)ns / POOL_THREADS / POOL_ITERATIONS);
+        if (pool != NULL) {
+            multi_heap_info_t info;
+            heap_caps_pool_get_info(pool, &info);
+            TEST_ASSERT_EQUAL(0, info.allocated_blocks);
+            TEST_ASSERT_TRUE(heap_caps_pool_check_integrity(pool, true));
+            heap_caps_pool_delete(pool);
+        }
+    }
+}
+
 void app_main(void)
 {
     printf("Running heap linux API host test app");
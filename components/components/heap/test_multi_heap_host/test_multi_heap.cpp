@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2024-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -8,12 +8,14 @@
 #include "multi_heap.h"
 
 #include "../multi_heap_config.h"
+#include "../multi_heap_cache.h"
 #include "../tlsf/include/tlsf.h"
 #include "../tlsf/tlsf_block_functions.h"
 #include "../tlsf/tlsf_control_functions.h"
 
 #include <string.h>
 #include <assert.h>
+#include <chrono>
 
 /* The functions __malloc__ and __free__ are used to call the libc
  * malloc and free and allocate memory from the host heap. Since the test
@@ -621,3 +623,177 @@ TEST_CASE("multi_heap poisoning detection", "[multi_heap]")
         REQUIRE(is_heap_ok == true);
     }
 }
+
+TEST_CASE("multi_heap bulk allocations", "[multi_heap]")
+{
+    const size_t COUNT = 16;
+    uint8_t heapdata[4 * 1024];
+    multi_heap_handle_t heap = multi_heap_register(heapdata, sizeof(heapdata));
+    size_t free_bytes = multi_heap_free_size(heap);
+
+    void *p[COUNT];
+    REQUIRE( multi_heap_malloc_bulk(heap, 32, p, COUNT) == COUNT );
+    for (size_t i = 0; i < COUNT; i++) {
+        REQUIRE( p[i] != NULL );
+        REQUIRE( multi_heap_get_allocated_size(heap, p[i]) >= 32 );
+        memset(p[i], i, 32);
+    }
+    REQUIRE( multi_heap_check(heap, true) );
+    multi_heap_free_bulk(heap, p, COUNT);
+    REQUIRE( multi_heap_free_size(heap) == free_bytes );
+
+    /* Running out of memory stops the bulk allocation, the buffers allocated so far are returned */
+    void *big[COUNT];
+    size_t count = multi_heap_malloc_bulk(heap, 1000, big, COUNT);
+    REQUIRE( count > 0 );
+    REQUIRE( count < COUNT );
+    REQUIRE( big[count] == NULL );
+    multi_heap_free_bulk(heap, big, count);
+    REQUIRE( multi_heap_free_size(heap) == free_bytes );
+}
+
+/* The cache hands out blocks allocated for another size class, which heap poisoning would report as corrupt */
+#ifndef MULTI_HEAP_POISONING
+
+TEST_CASE("multi_heap small allocation cache", "[multi_heap]")
+{
+    uint8_t heapdata[16 * 1024];
+    multi_heap_handle_t heap = multi_heap_register(heapdata, sizeof(heapdata));
+    size_t free_bytes = multi_heap_free_size(heap);
+    multi_heap_cache_t cache;
+    multi_heap_cache_init(&cache);
+
+    REQUIRE( multi_heap_cache_malloc(heap, &cache, 0) == NULL );
+    REQUIRE( multi_heap_cache_malloc(heap, &cache, MULTI_HEAP_CACHE_MAX_SIZE + 1) == NULL );
+
+    /* Allocate every small size, the cache is refilled once per size class */
+    void *p[MULTI_HEAP_CACHE_MAX_SIZE + 1];
+    for (size_t size = 1; size <= MULTI_HEAP_CACHE_MAX_SIZE; size++) {
+        p[size] = multi_heap_cache_malloc(heap, &cache, size);
+        REQUIRE( p[size] != NULL );
+        REQUIRE( multi_heap_get_allocated_size(heap, p[size]) >= size );
+        memset(p[size], size, size);
+    }
+    REQUIRE( multi_heap_check(heap, true) );
+    REQUIRE( cache.refills >= MULTI_HEAP_CACHE_CLASSES );
+    REQUIRE( cache.refills + cache.hits == MULTI_HEAP_CACHE_MAX_SIZE );
+
+    for (size_t size = 1; size <= MULTI_HEAP_CACHE_MAX_SIZE; size++) {
+        for (size_t i = 0; i < size; i++) {
+            REQUIRE( ((uint8_t *)p[size])[i] == (uint8_t)size );
+        }
+        REQUIRE( multi_heap_cache_free(heap, &cache, p[size]) );
+    }
+    for (size_t class_idx = 0; class_idx < MULTI_HEAP_CACHE_CLASSES; class_idx++) {
+        REQUIRE( cache.count[class_idx] <= MULTI_HEAP_CACHE_DEPTH );
+    }
+    REQUIRE( cache.trims > 0 );
+
+    /* A freed block is handed out again by its size class */
+    void *x = multi_heap_cache_malloc(heap, &cache, 40);
+    REQUIRE( multi_heap_cache_free(heap, &cache, x) );
+    REQUIRE( multi_heap_cache_malloc(heap, &cache, 33) == x );
+    REQUIRE( multi_heap_cache_free(heap, &cache, x) );
+
+    /* Blocks allocated outside of the cache are accepted if their size fits a class */
+    void *small = multi_heap_malloc(heap, 24);
+    void *large = multi_heap_malloc(heap, 512);
+    REQUIRE( multi_heap_cache_free(heap, &cache, small) );
+    REQUIRE_FALSE( multi_heap_cache_free(heap, &cache, large) );
+    multi_heap_free(heap, large);
+
+    REQUIRE( multi_heap_free_size(heap) < free_bytes );
+    REQUIRE( multi_heap_cache_flush(heap, &cache) > 0 );
+    REQUIRE( multi_heap_cache_flush(heap, &cache) == 0 );
+    REQUIRE( multi_heap_check(heap, true) );
+    REQUIRE( multi_heap_free_size(heap) == free_bytes );
+}
+
+TEST_CASE("multi_heap small allocation cache out of memory", "[multi_heap]")
+{
+    uint8_t heapdata[2 * 1024];
+    multi_heap_handle_t heap = multi_heap_register(heapdata, sizeof(heapdata));
+    size_t free_bytes = multi_heap_free_size(heap);
+    multi_heap_cache_t cache;
+    multi_heap_cache_init(&cache);
+
+    /* The last refills are partial, then the allocations fail */
+    void *p[256];
+    size_t count = 0;
+    while (count < 256 && (p[count] = multi_heap_cache_malloc(heap, &cache, 64)) != NULL) {
+        count++;
+    }
+    REQUIRE( count > 0 );
+    REQUIRE( count < 256 );
+    REQUIRE( cache.head[3] == NULL );
+
+    for (size_t i = 0; i < count; i++) {
+        REQUIRE( multi_heap_cache_free(heap, &cache, p[i]) );
+    }
+    multi_heap_cache_flush(heap, &cache);
+    REQUIRE( multi_heap_free_size(heap) == free_bytes );
+}
+
+/* Replay a mix of small allocations and frees, with and without the cache. Reports the time per operation
+ * and the number of times the heap lock is taken, i.e. the number of chances of contention between cores. */
+TEST_CASE("multi_heap small allocation cache timings", "[multi_heap]")
+{
+    const size_t SLOTS = 64;
+    const size_t ITERATIONS = 200000;
+    const size_t HEAP_SIZE = 32 * 1024;
+    uint8_t *heapdata = (uint8_t *) __malloc__(HEAP_SIZE);
+    static size_t sizes[ITERATIONS];
+    static size_t slots[ITERATIONS];
+
+    srand(0x5eed);
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        sizes[i] = 1 + rand() % MULTI_HEAP_CACHE_MAX_SIZE;
+        slots[i] = rand() % SLOTS;
+    }
+
+    for (int cached = 0; cached <= 1; cached++) {
+        multi_heap_handle_t heap = multi_heap_register(heapdata, HEAP_SIZE);
+        multi_heap_cache_t cache;
+        multi_heap_cache_init(&cache);
+        void *p[SLOTS] = { 0 };
+        size_t heap_locks = 0;
+        size_t failed = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < ITERATIONS; i++) {
+            void **slot = &p[slots[i]];
+            if (*slot != NULL) {
+                if (!cached || !multi_heap_cache_free(heap, &cache, *slot)) {
+                    multi_heap_free(heap, *slot);
+                    heap_locks++;
+                }
+                *slot = NULL;
+            } else {
+                *slot = cached ? multi_heap_cache_malloc(heap, &cache, sizes[i]) : multi_heap_malloc(heap, sizes[i]);
+                heap_locks += cached ? 0 : 1;
+                failed += (*slot == NULL);
+            }
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        heap_locks += cache.refills + cache.trims;
+        REQUIRE( failed == 0 );
+
+        printf("%s: %.1f ns per operation, heap lock taken %zu times for %zu operations\n",
+               cached ? "small allocation cache" : "multi_heap", (double)elapsed.count() / ITERATIONS,
+               heap_locks, ITERATIONS);
+
+        if (cached) {
+            /* Most operations are served by the cache */
+            REQUIRE( heap_locks < ITERATIONS / 4 );
+            multi_heap_cache_flush(heap, &cache);
+        }
+        for (size_t i = 0; i < SLOTS; i++) {
+            multi_heap_free(heap, p[i]);
+        }
+        REQUIRE( multi_heap_check(heap, true) );
+    }
+
+    __free__(heapdata);
+}
+
+#endif // MULTI_HEAP_POISONING
@@ -0,0 +1,316 @@
+/* Binary LOG unit tests
+
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+#include <cstdio>
+#include <cstring>
+#include <regex>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include "esp_log.h"
+#include "esp_log_binary.h"
+#include "esp_log_binary_decode.h"
+#include "esp_private/log_format.h"
+#include "esp_private/log_message.h"
+#include "esp_private/log_timestamp.h"
+#include "sdkconfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace std;
+
+static const char *TEST_TAG = "test";
+
+static const esp_log_binary_decoder_config_t s_decoder_config = {
+    .pointer_size = sizeof(void *),
+    .lookup = NULL,
+    .lookup_arg = NULL,
+};
+
+/**
+ * Decodes all the packages of a byte stream, checking that each of them is valid.
+ */
+static string decode_all(const uint8_t *data, size_t len, const esp_log_binary_decoder_config_t *config = &s_decoder_config)
+{
+    string result;
+    size_t pos = 0;
+    while (pos < len) {
+        char text[2048];
+        size_t consumed;
+        esp_err_t err = esp_log_binary_decode(config, &data[pos], len - pos, &consumed, text, sizeof(text));
+        CHECK(err == ESP_OK);
+        if (consumed == 0) {
+            break;
+        }
+        pos += consumed;
+        result += text;
+    }
+    CHECK(pos == len);
+    return result;
+}
+
+class RingSinkFixture {
+public:
+    RingSinkFixture(size_t size = 4096) : storage(size), output(size)
+    {
+        esp_log_binary_ring_init(&ring, storage.data(), storage.size());
+        esp_log_binary_set_sink(esp_log_binary_ring_sink, &ring);
+        esp_log_level_set("*", ESP_LOG_VERBOSE);
+    }
+
+    ~RingSinkFixture()
+    {
+        esp_log_binary_set_sink(NULL, NULL);
+        esp_log_level_set("*", ESP_LOG_INFO);
+    }
+
+    string read_text()
+    {
+        size_t len = esp_log_binary_ring_read(&ring, output.data(), output.size());
+        return decode_all(output.data(), len);
+    }
+
+    esp_log_binary_ring_t ring;
+
+private:
+    vector<uint8_t> storage;
+    vector<uint8_t> output;
+};
+
+TEST_CASE("binary log decodes back to the text log")
+{
+    RingSinkFixture fix;
+    ESP_LOGI(TEST_TAG, "int %d uint %u hex 0x%08x", -5, 42u, 0xbeefu);
+    ESP_LOGW(TEST_TAG, "long long %lld %llu", -1234567890123LL, 9876543210ULL);
+    ESP_LOGE(TEST_TAG, "str '%s' char %c padded [%5d] [%-3s]", "binary", 'x', 12, "a");
+    ESP_LOGD(TEST_TAG, "empty '%s' no args %%", "");
+    ESP_LOGV(TEST_TAG, "verbose");
+
+    const regex expected("I \\([0-9]+\\) test: int -5 uint 42 hex 0x0000beef\n"
+                         "W \\([0-9]+\\) test: long long -1234567890123 9876543210\n"
+                         "E \\([0-9]+\\) test: str 'binary' char x padded \\[   12\\] \\[a  \\]\n"
+                         "D \\([0-9]+\\) test: empty '' no args %\n"
+                         "V \\([0-9]+\\) test: verbose\n");
+    string text = fix.read_text();
+    CHECK(regex_match(text, expected) == true);
+    CHECK(fix.ring.overwritten == 0);
+}
+
+TEST_CASE("binary buffer logs decode back to the text log")
+{
+    RingSinkFixture fix;
+    const char buffer[] = "The way to get started is to quit talking";
+    ESP_LOG_BUFFER_HEX(TEST_TAG, buffer, 18);
+    ESP_LOG_BUFFER_CHAR(TEST_TAG, buffer, 18);
+    ESP_LOG_BUFFER_HEXDUMP(TEST_TAG, buffer, 18, ESP_LOG_INFO);
+
+    const regex expected("I \\([0-9]+\\) test: 54 68 65 20 77 61 79 20 74 6f 20 67 65 74 20 73\n"
+                         "I \\([0-9]+\\) test: 74 61\n"
+                         "I \\([0-9]+\\) test: The way to get s\n"
+                         "I \\([0-9]+\\) test: ta\n"
+                         "I \\([0-9]+\\) test: 0x[0-9a-f]{8}   54 68 65 20 77 61 79 20  74 6f 20 67 65 74 20 73  \\|The way to get s\\|\n"
+                         "I \\([0-9]+\\) test: 0x[0-9a-f]{8}   74 61                                             \\|ta\\|\n");
+    string text = fix.read_text();
+    CHECK(regex_match(text, expected) == true);
+}
+
+TEST_CASE("binary ring keeps the latest packages")
+{
+    RingSinkFixture fix(ESP_LOG_BINARY_PKG_MAX_LEN);
+    const int count = 100;
+    for (int i = 0; i < count; i++) {
+        ESP_LOGI(TEST_TAG, "message %d", i);
+    }
+    CHECK(fix.ring.overwritten > 0);
+
+    string text = fix.read_text();
+    int expected = count - (int) count_if(text.begin(), text.end(), [](char c) {
+        return c == '\n';
+    });
+    CHECK(expected == (int) fix.ring.overwritten);
+    const regex line("I \\([0-9]+\\) test: message ([0-9]+)\n");
+    for (auto it = sregex_iterator(text.begin(), text.end(), line); it != sregex_iterator(); ++it) {
+        CHECK(stoi((*it)[1]) == expected++);
+    }
+    CHECK(expected == count);
+    CHECK(fix.read_text().empty());
+}
+
+TEST_CASE("binary log streams to a file")
+{
+    FILE *file = tmpfile();
+    REQUIRE(file != NULL);
+    esp_log_binary_set_sink(esp_log_binary_file_sink, file);
+    for (int i = 0; i < 10; i++) {
+        ESP_LOGI(TEST_TAG, "file message %d of %s", i, "10");
+    }
+    esp_log_binary_set_sink(NULL, NULL);
+
+    long size = ftell(file);
+    vector<uint8_t> data(size);
+    rewind(file);
+    REQUIRE(fread(data.data(), 1, data.size(), file) == data.size());
+    fclose(file);
+
+    string text = decode_all(data.data(), data.size());
+    string expected;
+    for (int i = 0; i < 10; i++) {
+        expected += "I \\([0-9]+\\) test: file message " + to_string(i) + " of 10\n";
+    }
+    CHECK(regex_match(text, regex(expected)) == true);
+}
+
+static uint8_t crc8(const uint8_t *data, size_t len)
+{
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static const char *lookup_elf(uint64_t addr, void *arg)
+{
+    (void) arg;
+    switch (addr) {
+    case 0x3c020010: return "connected to %s, channel %d";
+    case 0x3c020100: return "wifi";
+    case 0x3c020200: return "home-ap";
+    default: return NULL;
+    }
+}
+
+TEST_CASE("binary decoder resolves the strings from the ELF file")
+{
+    // Package as output by a chip: 32 bits addresses of the format string, tag and "%s" argument
+    vector<uint8_t> pkg = {
+        0x02, 0x00, 0x00,           // application, control filled below
+        0x3c, 0x02, 0x00, 0x10,     // format
+        0x3c, 0x02, 0x01, 0x00,     // tag
+        0x00, 0x00, 0x04, 0xd2,     // timestamp 1234
+        0x3c, 0x02, 0x02, 0x00,     // "%s"
+        0x00, 0x00, 0x00, 0x06,     // "%d"
+    };
+    uint16_t control = (pkg.size() + 1) | (ESP_LOG_WARN << 10);
+    pkg[1] = control >> 8;
+    pkg[2] = control & 0xFF;
+    pkg.push_back(crc8(pkg.data(), pkg.size()));
+
+    esp_log_binary_decoder_config_t config = {
+        .pointer_size = 4,
+        .lookup = lookup_elf,
+        .lookup_arg = NULL,
+    };
+    char text[128];
+    size_t consumed;
+    CHECK(esp_log_binary_decode(&config, pkg.data(), pkg.size(), &consumed, text, sizeof(text)) == ESP_OK);
+    CHECK(consumed == pkg.size());
+    CHECK(string(text) == "W (1234) wifi: connected to home-ap, channel 6\n");
+
+    // Unknown address of an argument
+    config.lookup = [](uint64_t addr, void *arg) -> const char * {
+        return (addr == 0x3c020200) ? NULL : lookup_elf(addr, arg);
+    };
+    CHECK(esp_log_binary_decode(&config, pkg.data(), pkg.size(), &consumed, text, sizeof(text)) == ESP_ERR_NOT_SUPPORTED);
+    CHECK(string(text) == "W (1234) wifi: connected to 0x3c020200, channel 6\n");
+}
+
+TEST_CASE("binary decoder resynchronizes on corrupted data")
+{
+    RingSinkFixture fix;
+    ESP_LOGI(TEST_TAG, "first %d", 1);
+    ESP_LOGI(TEST_TAG, "second %d", 2);
+    vector<uint8_t> data(1024);
+    data.resize(esp_log_binary_ring_read(&fix.ring, data.data(), data.size()));
+    size_t first_len = ((data[1] & 0x03) << 8) | data[2];
+
+    char text[128];
+    size_t consumed;
+    // Not enough bytes
+    CHECK(esp_log_binary_decode(&s_decoder_config, data.data(), 2, &consumed, text, sizeof(text)) == ESP_ERR_INVALID_SIZE);
+    CHECK(consumed == 0);
+    CHECK(esp_log_binary_decode(&s_decoder_config, data.data(), first_len - 1, &consumed, text, sizeof(text)) == ESP_ERR_INVALID_SIZE);
+    CHECK(consumed == 0);
+
+    // Corrupted first package, the decoder skips bytes until the second package
+    data[5] ^= 0x40;
+    size_t pos = 0;
+    esp_err_t err;
+    while ((err = esp_log_binary_decode(&s_decoder_config, &data[pos], data.size() - pos, &consumed, text, sizeof(text))) != ESP_OK) {
+        CHECK((err == ESP_ERR_INVALID_CRC || err == ESP_ERR_INVALID_VERSION || err == ESP_ERR_INVALID_SIZE || err == ESP_ERR_NOT_SUPPORTED));
+        // All the data is there, so a false header longer than the rest of the data is skipped as well
+        pos += (consumed != 0) ? consumed : 1;
+    }
+    CHECK(pos == first_len);
+    CHECK(regex_match(string(text), regex("I \\([0-9]+\\) test: second 2\n")) == true);
+    CHECK(pos + consumed == data.size());
+}
+
+static char s_text[512];
+static size_t s_text_len;
+
+static int text_to_buffer(const char *format, va_list args)
+{
+    int len = vsnprintf(&s_text[s_text_len], sizeof(s_text) - s_text_len, format, args);
+    s_text_len += len;
+    return len;
+}
+
+static void text_log(const char *tag, const char *format, ...)
+{
+    esp_log_msg_t message = {
+        .config = ESP_LOG_CONFIG_INIT(ESP_LOG_INFO | ESP_LOG_CONFIG_REQUIRE_FORMATTING | ESP_LOG_CONFIG_DIS_COLOR),
+        .tag = tag,
+        .format = format,
+        .timestamp = esp_log_timestamp64(false),
+        .arg_types = NULL,
+    };
+    va_start(message.args, format);
+    esp_log_format(&message);
+    va_end(message.args);
+}
+
+TEST_CASE("binary log is smaller and faster than the text log")
+{
+    // The binary log goes through the whole ESP_LOGI() path (level check, lock), while the text log is only
+    // formatted, which favours the text log.
+    const int count = 10000;
+    const char *format = "sensor %d value %u status %s";
+    RingSinkFixture fix(64 * 1024);
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        ESP_LOGI(TEST_TAG, "sensor %d value %u status %s", i, i * 3u, "ok");
+    }
+    auto binary_ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count() / count;
+    uint8_t pkg[ESP_LOG_BINARY_PKG_MAX_LEN];
+    REQUIRE(esp_log_binary_ring_read(&fix.ring, pkg, sizeof(pkg)) != 0);
+    size_t binary_bytes = ((pkg[1] & 0x03) << 8) | pkg[2];
+    // On the chips, the format string and the tag are sent as 32 bits addresses instead of being embedded
+    size_t chip_binary_bytes = binary_bytes - (2 + strlen(format)) - (2 + strlen(TEST_TAG)) + 2 * 4;
+
+    vprintf_like_t original = esp_log_set_vprintf(text_to_buffer);
+    size_t text_bytes = 0;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        s_text_len = 0;
+        text_log(TEST_TAG, format, i, i * 3u, "ok");
+        text_bytes += s_text_len;
+    }
+    auto text_ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count() / count;
+    esp_log_set_vprintf(original);
+    text_bytes /= count;
+
+    cout << "text: " << text_bytes << " bytes, " << text_ns << " ns per message" << endl;
+    cout << "binary: " << binary_bytes << " bytes (" << chip_binary_bytes << " on chips), " << binary_ns << " ns per message" << endl;
+    CHECK(chip_binary_bytes < text_bytes);
+}
@@ -9,9 +9,16 @@
 #include <cstdio>
 #include <regex>
 #include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <cstring>
 #include "esp_rom_sys.h"
 #include "esp_log.h"
 #include "esp_private/log_util.h"
+#include "esp_private/log_lock.h"
+#include "esp_private/log_level.h"
 #include "esp_private/log_timestamp.h"
 #include "sdkconfig.h"
 
@@ -60,6 +67,9 @@ public:
 
     string get_print_buffer_string() const
     {
+#if CONFIG_LOG_ASYNC
+        esp_log_async_flush();
+#endif
         return string(print_buffer);
     }
 
@@ -86,11 +96,17 @@ struct PrintFixture : BasicLogFixture {
 
         instance = this;
 
+#if CONFIG_LOG_ASYNC
+        esp_log_async_flush();
+#endif
         old_vprintf = esp_log_set_vprintf(print_callback);
     }
 
     virtual ~PrintFixture()
     {
+#if CONFIG_LOG_ASYNC
+        esp_log_async_flush();
+#endif
         esp_log_set_vprintf(old_vprintf);
         instance = nullptr;
     }
@@ -224,6 +240,56 @@ TEST_CASE("changing log level")
 }
 #endif // CONFIG_LOG_DYNAMIC_LEVEL_CONTROL
 
+#if ESP_LOG_TAG_TABLE_EN
+ESP_LOG_TAG_DEFINE(DECLARED_TAG, "declared");
+
+TEST_CASE("declared tag level")
+{
+    PrintFixture fix(ESP_LOG_INFO);
+    const std::regex test_print("I " TIMESTAMP_FORMAT "declared: must indeed be printed", std::regex::ECMAScript);
+
+    ESP_LOGI(DECLARED_TAG, "must indeed be printed");
+    CHECK(regex_search(fix.get_print_buffer_string(), test_print) == true);
+
+    fix.reset_buffer();
+    ESP_LOGD(DECLARED_TAG, "must not be printed");
+    CHECK(fix.get_print_buffer_string().size() == 0);
+
+    // Set by name, only in the slot: a tag with the same name which is not declared keeps the default level
+    char undeclared_tag[] = "declared";
+    esp_log_level_set("declared", ESP_LOG_DEBUG);
+    CHECK(esp_log_level_get(DECLARED_TAG) == ESP_LOG_DEBUG);
+    CHECK(esp_log_level_get(undeclared_tag) == ESP_LOG_INFO);
+    ESP_LOGD(DECLARED_TAG, "debug printed");
+    CHECK(fix.get_print_buffer_string().find("declared: debug printed") != string::npos);
+
+    fix.reset_buffer();
+    esp_log_level_set(DECLARED_TAG, ESP_LOG_NONE);
+    ESP_LOGE(DECLARED_TAG, "must not be printed");
+    CHECK(fix.get_print_buffer_string().size() == 0);
+    CHECK(esp_log_level_get(undeclared_tag) == ESP_LOG_INFO);
+
+    // The wildcard makes the declared tags follow the default level again
+    esp_log_level_set("*", ESP_LOG_WARN);
+    CHECK(esp_log_level_get(DECLARED_TAG) == ESP_LOG_WARN);
+    esp_log_set_default_level(ESP_LOG_ERROR);
+    CHECK(esp_log_level_get(DECLARED_TAG) == ESP_LOG_ERROR);
+}
+
+TEST_CASE("declared tag level is read without the log lock")
+{
+    BasicLogFixture fix(ESP_LOG_INFO);
+    esp_log_level_set(DECLARED_TAG, ESP_LOG_WARN);
+
+    // The lock is not recursive, looking up an undeclared tag here would block
+    esp_log_impl_lock();
+    CHECK(esp_log_level_get(DECLARED_TAG) == ESP_LOG_WARN);
+    CHECK(esp_log_is_tag_loggable(ESP_LOG_WARN, DECLARED_TAG) == true);
+    CHECK(esp_log_is_tag_loggable(ESP_LOG_INFO, DECLARED_TAG) == false);
+    esp_log_impl_unlock();
+}
+#endif // ESP_LOG_TAG_TABLE_EN
+
 TEST_CASE("log buffer")
 {
     PrintFixture fix(ESP_LOG_INFO);
@@ -521,3 +587,137 @@ TEST_CASE("esp_log TAG can be NULL")
     fix.reset_buffer();
 }
 #endif // ESP_LOG_VERSION == 2
+
+#if CONFIG_LOG_ASYNC
+TEST_CASE("deferred log copies the arguments")
+{
+    PrintFixture fix(ESP_LOG_INFO);
+    char name[16] = "first";
+    const char *null_str = NULL;
+
+    ESP_LOGI(TEST_TAG, "%s %lld %.2f [%*d] [%-6s] %s 100%%", name, -1234567890123LL, 3.14159, 5, 42, "ab", null_str);
+    strcpy(name, "second");
+
+    const std::regex test_print("I " TIMESTAMP_FORMAT "test: first -1234567890123 3.14 \\[   42\\] \\[ab    \\] \\(null\\) 100%", std::regex::ECMAScript);
+    CHECK(regex_search(fix.get_print_buffer_string(), test_print) == true);
+}
+
+TEST_CASE("deferred log reads strings only up to their precision")
+{
+    PrintFixture fix(ESP_LOG_INFO);
+    // Not NUL terminated, reading past the precision is caught by the address sanitizer
+    std::unique_ptr<char[]> data(new char[4]);
+    memcpy(data.get(), "abcd", 4);
+    esp_log_async_stats_t start_stats;
+    esp_log_async_get_stats(&start_stats);
+
+    ESP_LOGI(TEST_TAG, "[%.*s] [%.3s] [%*.*s] [%.10s]", 4, data.get(), data.get(), 6, 2, data.get(), "short");
+
+    const std::regex test_print("I " TIMESTAMP_FORMAT "test: \\[abcd\\] \\[abc\\] \\[    ab\\] \\[short\\]", std::regex::ECMAScript);
+    CHECK(regex_search(fix.get_print_buffer_string(), test_print) == true);
+    esp_log_async_stats_t stats;
+    esp_log_async_get_stats(&stats);
+    CHECK(stats.truncated == start_stats.truncated);
+}
+
+struct AsyncSinkFixture {
+    AsyncSinkFixture()
+    {
+        esp_log_async_flush();
+        blocked = false;
+        entered = false;
+        delay_us = 0;
+        dropped_lines = 0;
+        old_vprintf = esp_log_set_vprintf(sink);
+        esp_log_async_get_stats(&start_stats);
+    }
+
+    ~AsyncSinkFixture()
+    {
+        blocked = false;
+        esp_log_async_flush();
+        esp_log_set_vprintf(old_vprintf);
+    }
+
+    static int sink(const char *format, va_list args)
+    {
+        entered = true;
+        while (blocked) {
+            std::this_thread::yield();
+        }
+        if (delay_us != 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(delay_us));
+        }
+        char line[128];
+        int len = vsnprintf(line, sizeof(line), format, args);
+        if (strstr(line, "messages dropped, log buffer full") != nullptr) {
+            dropped_lines++;
+        }
+        return len;
+    }
+
+    static std::atomic<bool> blocked;
+    static std::atomic<bool> entered;
+    static std::atomic<int> delay_us;
+    static std::atomic<int> dropped_lines;
+    esp_log_async_stats_t start_stats;
+    vprintf_like_t old_vprintf;
+};
+
+std::atomic<bool> AsyncSinkFixture::blocked;
+std::atomic<bool> AsyncSinkFixture::entered;
+std::atomic<int> AsyncSinkFixture::delay_us;
+std::atomic<int> AsyncSinkFixture::dropped_lines;
+
+TEST_CASE("deferred log counts the messages dropped when the buffer is full")
+{
+    AsyncSinkFixture fix;
+    const int messages = 200;
+
+    // Keep the log task busy with the first message, so that the buffer fills up
+    AsyncSinkFixture::blocked = true;
+    ESP_LOGI(TEST_TAG, "blocking the log task");
+    while (!AsyncSinkFixture::entered) {
+        std::this_thread::yield();
+    }
+    for (int i = 0; i < messages; i++) {
+        ESP_LOGI(TEST_TAG, "message %d", i);
+    }
+    AsyncSinkFixture::blocked = false;
+    esp_log_async_flush();
+
+    esp_log_async_stats_t stats;
+    esp_log_async_get_stats(&stats);
+    uint32_t stored = stats.messages - fix.start_stats.messages;
+    uint32_t dropped = stats.dropped - fix.start_stats.dropped;
+    CHECK(dropped > 0);
+    CHECK(stored + dropped == messages + 1);
+    CHECK(stats.buffer_peak <= CONFIG_LOG_ASYNC_BUFFER_SIZE);
+    CHECK(AsyncSinkFixture::dropped_lines == 1);
+}
+
+TEST_CASE("deferred log latency")
+{
+    AsyncSinkFixture fix;
+    const int messages = 40;
+
+    // Each output call of the sink takes 50 us, as a slow console would
+    AsyncSinkFixture::delay_us = 50;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < messages; i++) {
+        ESP_LOGI(TEST_TAG, "latency %d of %d: %s", i, messages, "measured");
+    }
+    auto logged = std::chrono::steady_clock::now();
+    esp_log_async_flush();
+    auto flushed = std::chrono::steady_clock::now();
+
+    double call_us = std::chrono::duration<double, std::micro>(logged - start).count() / messages;
+    double output_us = std::chrono::duration<double, std::micro>(flushed - start).count() / messages;
+    printf("deferred log: %.2f us per call, %.2f us per message output\n", call_us, output_us);
+    CHECK(call_us < output_us);
+
+    esp_log_async_stats_t stats;
+    esp_log_async_get_stats(&stats);
+    CHECK(stats.dropped == fix.start_stats.dropped);
+}
+#endif // CONFIG_LOG_ASYNC
@@ -1,4 +1,4 @@
-# SPDX-FileCopyrightText: 2023-2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-FileCopyrightText: 2023-2026 Espressif Systems (Shanghai) CO LTD
 # SPDX-License-Identifier: Unlicense OR CC0-1.0
 import pytest
 from pytest_embedded import Dut
@@ -18,6 +18,7 @@ from pytest_embedded_idf.utils import idf_parametrize
         'v2_rtos_timestamp',
         'v2_system_full_timestamp',
         'v2_system_timestamp',
+        'v2_async',
         'tag_level_linked_list',
         'tag_level_linked_list_and_array_cache',
         'tag_level_none',
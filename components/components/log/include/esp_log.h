@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -20,6 +20,8 @@
 #include "esp_log_format.h"
 #include "esp_log_args.h"
 #include "esp_log_attr.h"
+#include "esp_log_async.h"
+#include "esp_log_binary.h"
 
 #ifdef __cplusplus
 extern "C" {
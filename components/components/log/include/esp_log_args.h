@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2025-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -195,6 +195,17 @@ extern "C++" {
         constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_POINTER;
     };
 
+    // Arrays are passed by reference to ESP_LOG_DETECT_TYPE() and decay to pointers in the va_list
+    template <size_t N>
+    struct EspLogArgType<char[N]> {
+        constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_POINTER;
+    };
+
+    template <size_t N>
+    struct EspLogArgType<uint8_t[N]> {
+        constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_POINTER;
+    };
+
     template <>
     struct EspLogArgType<long long int> {
         constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_64BITS;
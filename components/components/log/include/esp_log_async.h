@@ -0,0 +1,51 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if CONFIG_LOG_ASYNC || __DOXYGEN__
+
+/**
+ * @brief Statistics of the deferred (asynchronous) logging.
+ */
+typedef struct {
+    uint32_t messages;      /*!< Number of messages deferred to the log task */
+    uint32_t dropped;       /*!< Number of messages dropped because the log buffer was full */
+    uint32_t truncated;     /*!< Number of messages with string arguments truncated to CONFIG_LOG_ASYNC_LINE_SIZE */
+    uint32_t buffer_peak;   /*!< Highest number of bytes used in the log buffer */
+} esp_log_async_stats_t;
+
+/**
+ * @brief Outputs the log messages waiting in the log buffer.
+ *
+ * With CONFIG_LOG_ASYNC, the messages logged by tasks are stored in a buffer and are formatted and output
+ * later by a low priority task. This function outputs the messages stored so far from the calling task
+ * and returns once they have been output. It is useful before a restart or a deep sleep, or when the output
+ * has to be checked right after logging.
+ *
+ * @note A message which is being stored by another task when this function is called may be left in the buffer.
+ */
+void esp_log_async_flush(void);
+
+/**
+ * @brief Gets the statistics of the deferred logging.
+ *
+ * @param[out] stats Pointer to the structure to fill.
+ */
+void esp_log_async_get_stats(esp_log_async_stats_t *stats);
+
+#endif // CONFIG_LOG_ASYNC || __DOXYGEN__
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,106 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if CONFIG_LOG_MODE_BINARY_EN || __DOXYGEN__
+
+/**
+ * @brief Maximum length of a binary log package, limited by its 10 bits length field.
+ */
+#define ESP_LOG_BINARY_PKG_MAX_LEN  (1023)
+
+/**
+ * @brief Function receiving the binary log packages.
+ *
+ * It is called with one complete package at a time, while the log lock is held, so the calls never overlap.
+ * It must not log itself.
+ *
+ * @param pkg   Package, starting with the application type byte and ending with the CRC8 byte.
+ * @param len   Length of the package in bytes.
+ * @param arg   Argument given to esp_log_binary_set_sink().
+ */
+typedef void (*esp_log_binary_sink_t)(const void *pkg, size_t len, void *arg);
+
+/**
+ * @brief Sets the function receiving the binary log packages.
+ *
+ * By default, binary log packages are output to the console UART byte by byte. With a sink, the package
+ * is first encoded into a buffer in a single pass and then handed over as a whole, for example to a RAM ring
+ * (see esp_log_binary_ring_sink()) or to a file (see esp_log_binary_file_sink()).
+ *
+ * Logs from constrained environments (ISR, early logs, disabled cache) are still output to the console UART.
+ * Packages longer than ESP_LOG_BINARY_PKG_MAX_LEN are dropped.
+ *
+ * @param sink  Function receiving the packages, NULL to output them to the console UART again.
+ * @param arg   Argument passed to the sink.
+ */
+void esp_log_binary_set_sink(esp_log_binary_sink_t sink, void *arg);
+
+/**
+ * @brief RAM ring buffer of binary log packages.
+ *
+ * When the ring is full, the oldest packages are overwritten, so it always holds the latest logs.
+ * The fields are private, use the esp_log_binary_ring_* functions.
+ */
+typedef struct {
+    uint8_t *buffer;        /*!< Storage of the packages */
+    size_t size;            /*!< Size of the storage in bytes */
+    size_t head;            /*!< Offset of the next package written */
+    size_t tail;            /*!< Offset of the oldest package */
+    size_t used;            /*!< Number of bytes used by the packages */
+    uint32_t overwritten;   /*!< Number of packages overwritten before being read */
+} esp_log_binary_ring_t;
+
+/**
+ * @brief Initializes a ring of binary log packages.
+ *
+ * @param ring      Ring to initialize.
+ * @param buffer    Storage of the packages, it must stay valid while the ring is used.
+ * @param size      Size of the storage in bytes, at least ESP_LOG_BINARY_PKG_MAX_LEN to hold any package.
+ */
+void esp_log_binary_ring_init(esp_log_binary_ring_t *ring, void *buffer, size_t size);
+
+/**
+ * @brief Sink storing the packages into a ring, to be passed to esp_log_binary_set_sink() with the ring as argument.
+ */
+void esp_log_binary_ring_sink(const void *pkg, size_t len, void *arg);
+
+/**
+ * @brief Reads the oldest packages from a ring.
+ *
+ * Only whole packages are read, as many as fit in the destination buffer. The bytes read can be given to the
+ * host decoder as they are.
+ *
+ * @param ring  Ring to read from.
+ * @param dst   Destination buffer.
+ * @param size  Size of the destination buffer in bytes.
+ *
+ * @return Number of bytes read, 0 if the ring is empty or the next package does not fit.
+ */
+size_t esp_log_binary_ring_read(esp_log_binary_ring_t *ring, void *dst, size_t size);
+
+/**
+ * @brief Sink writing the packages to a file, to be passed to esp_log_binary_set_sink() with a FILE* as argument.
+ *
+ * The file can be on any file system (e.g. FAT or LittleFS on a flash partition) and is decoded on the host
+ * with the ELF file of the application.
+ */
+void esp_log_binary_file_sink(const void *pkg, size_t len, void *arg);
+
+#endif // CONFIG_LOG_MODE_BINARY_EN || __DOXYGEN__
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,72 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file esp_log_binary_decode.h
+ * @brief Host-side decoder of binary log packages.
+ *
+ * Available on the Linux target only. It turns the packages output in binary log mode, by the UART or by
+ * a sink (see esp_log_binary_set_sink()), back into the text lines the text log mode would have output,
+ * without colors and with the timestamp in milliseconds.
+ */
+
+/**
+ * @brief Function returning the string at an address of the application, read from its ELF file.
+ *
+ * @param addr  Address of the format string, tag or string argument.
+ * @param arg   Argument given in the decoder configuration.
+ *
+ * @return The NUL terminated string, NULL if the address is unknown.
+ */
+typedef const char *(*esp_log_binary_lookup_t)(uint64_t addr, void *arg);
+
+/**
+ * @brief Decoder configuration.
+ */
+typedef struct {
+    size_t pointer_size;            /*!< Size of a pointer of the application which logged: 4 for the chips, sizeof(void *) for the Linux target */
+    esp_log_binary_lookup_t lookup; /*!< Resolves the strings sent as addresses, may be NULL if they are all embedded */
+    void *lookup_arg;               /*!< Argument passed to lookup */
+} esp_log_binary_decoder_config_t;
+
+/**
+ * @brief Decodes the binary log package at the start of a buffer into text.
+ *
+ * @param config    Decoder configuration.
+ * @param data      Received bytes, starting with a package.
+ * @param len       Number of received bytes.
+ * @param[out] consumed Number of bytes to skip to reach the next package: the package length if the package
+ *                      is complete and its CRC8 is right, 1 otherwise to resynchronize on the next byte,
+ *                      0 if more bytes are needed.
+ * @param[out] text Buffer receiving the NUL terminated text lines, each ended with a new line. It is truncated
+ *                  if it is too small.
+ * @param text_size Size of the text buffer.
+ *
+ * @return
+ *      - ESP_OK on success.
+ *      - ESP_ERR_INVALID_ARG if an argument is NULL.
+ *      - ESP_ERR_INVALID_SIZE if the package is not complete yet.
+ *      - ESP_ERR_INVALID_VERSION if the bytes do not start with a package of a known version.
+ *      - ESP_ERR_INVALID_CRC if the CRC8 of the package is wrong.
+ *      - ESP_ERR_NOT_SUPPORTED if the arguments in the package do not match its format string, or a string
+ *        address is unknown (e.g. wrong pointer_size or ELF file). The text is decoded as far as possible.
+ */
+esp_err_t esp_log_binary_decode(const esp_log_binary_decoder_config_t *config, const void *data, size_t len,
+                                size_t *consumed, char *text, size_t text_size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2023-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2023-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -179,6 +179,61 @@ void esp_log_level_set(const char* tag, esp_log_level_t level);
  */
 esp_log_level_t esp_log_level_get(const char* tag);
 
+/** @cond */
+#if !NON_OS_BUILD && !CONFIG_LOG_TAG_LEVEL_IMPL_NONE
+#define ESP_LOG_TAG_TABLE_EN (1)
+#else
+#define ESP_LOG_TAG_TABLE_EN (0)
+#endif
+
+#if CONFIG_IDF_TARGET_LINUX && defined(__APPLE__)
+// Mach-O section names are given with their segment, ld64 provides section$start and section$end symbols
+#define ESP_LOG_TAG_SECTION "__DATA,log_tag_level"
+#elif CONFIG_IDF_TARGET_LINUX
+// A section named as a C identifier gets __start_ and __stop_ symbols from the host linker
+#define ESP_LOG_TAG_SECTION "log_tag_level"
+#else
+// Placed into DRAM by the linker fragment of the log component
+#define ESP_LOG_TAG_SECTION ".log_tag_level"
+#endif
+
+#define ESP_LOG_TAG_ENTRY_MARK  (0x80) /*!< Set in the level byte of a declared tag, which is never 0 */
+#define ESP_LOG_TAG_LEVEL_UNSET (ESP_LOG_LEVEL_MASK) /*!< Declared tag following the default log level */
+/** @endcond */
+
+/**
+ * @brief Defines a log tag with a static slot in the tag level table.
+ *
+ * It defines `static const char *const var = name;`, where the string is stored in a linker section table,
+ * right after the log level byte of the tag. The log level of such a tag is read from its slot without
+ * any lock or search, instead of going through the cache and the linked list used for the other tags.
+ * esp_log_level_set() with the same name updates the slot only, a tag with the same name which is not
+ * defined this way keeps its level, so all files using the tag should define it with this macro.
+ *
+ * Example:
+ * @code{c}
+ * ESP_LOG_TAG_DEFINE(TAG, "wifi");
+ * ...
+ * ESP_LOGI(TAG, "connected");
+ * @endcode
+ *
+ * If the per-tag log level is disabled (CONFIG_LOG_TAG_LEVEL_IMPL_NONE) or in the bootloader,
+ * it defines a plain string.
+ *
+ * @param var   Name of the tag variable.
+ * @param name  Tag, a string literal.
+ */
+#if ESP_LOG_TAG_TABLE_EN || __DOXYGEN__
+#define ESP_LOG_TAG_DEFINE(var, name) \
+    static __attribute__((section(ESP_LOG_TAG_SECTION), used, aligned(4))) struct { \
+        uint8_t level; \
+        char str[sizeof(name)]; \
+    } var##_log_tag_entry = { ESP_LOG_TAG_ENTRY_MARK | ESP_LOG_TAG_LEVEL_UNSET, name }; \
+    static const char *const var = var##_log_tag_entry.str
+#else
+#define ESP_LOG_TAG_DEFINE(var, name) static const char *const var = name
+#endif
+
 #ifdef __cplusplus
 }
 #endif
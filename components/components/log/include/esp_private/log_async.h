@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_log_async.h"
+#include "log_message.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Stores a log message in the log buffer, to be formatted and output by the log task.
+ *
+ * The level, tag, format pointer, timestamp and arguments of the message are copied. String arguments
+ * and the tag are copied by value, the format string must remain valid (string literal).
+ *
+ * @param message Pointer to log message structure.
+ *
+ * @return true if the message was stored or dropped because the buffer was full,
+ *         false if it has to be output synchronously by the caller.
+ */
+bool esp_log_async_write(esp_log_msg_t *message);
+
+/**
+ * @brief Outputs the log messages waiting in the log buffer from the panic handler.
+ *
+ * The level, timestamp, tag and format string of the messages are output with esp_rom_printf(), the arguments
+ * are not formatted. No locks are taken and the buffer is not modified. The flash cache must be enabled,
+ * the format strings and tags may be stored in flash.
+ */
+void esp_log_async_panic_flush(void);
+
+/** @cond */
+/*
+ * Functions implemented for each system target, to run the log task.
+ */
+
+/**
+ * @brief Creates the log task, which calls task_func.
+ *
+ * @return true on success.
+ */
+bool esp_log_async_os_start(void (*task_func)(void));
+
+/**
+ * @brief Wakes up the log task waiting in esp_log_async_os_wait().
+ */
+void esp_log_async_os_wake(void);
+
+/**
+ * @brief Waits in the log task until esp_log_async_os_wake() is called or the timeout expires.
+ */
+void esp_log_async_os_wait(uint32_t timeout_ms);
+
+/**
+ * @brief Takes the lock which serializes the output of the log buffer by the log task and the flush.
+ */
+void esp_log_async_os_output_lock(void);
+
+/**
+ * @brief Releases the lock taken by esp_log_async_os_output_lock().
+ */
+void esp_log_async_os_output_unlock(void);
+/** @endcond */
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,82 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <time.h>
+#include <assert.h>
+#include "esp_private/log_async.h"
+
+static pthread_mutex_t s_wake_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_wake_cond;
+static bool s_wake;
+static pthread_mutex_t s_output_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void *log_task(void *arg)
+{
+    void (*task_func)(void) = (void (*)(void)) arg;
+    task_func();
+    return NULL;
+}
+
+bool esp_log_async_os_start(void (*task_func)(void))
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&s_wake_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, log_task, (void *) task_func) != 0) {
+        return false;
+    }
+    pthread_detach(thread);
+    return true;
+}
+
+void esp_log_async_os_wake(void)
+{
+    pthread_mutex_lock(&s_wake_mutex);
+    s_wake = true;
+    pthread_cond_signal(&s_wake_cond);
+    pthread_mutex_unlock(&s_wake_mutex);
+}
+
+void esp_log_async_os_wait(uint32_t timeout_ms)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&s_wake_mutex);
+    while (!s_wake) {
+        if (pthread_cond_timedwait(&s_wake_cond, &s_wake_mutex, &deadline) != 0) {
+            break;
+        }
+    }
+    s_wake = false;
+    pthread_mutex_unlock(&s_wake_mutex);
+}
+
+void esp_log_async_os_output_lock(void)
+{
+    int result = pthread_mutex_lock(&s_output_mutex);
+    assert(result == 0);
+    (void) result;
+}
+
+void esp_log_async_os_output_unlock(void)
+{
+    int result = pthread_mutex_unlock(&s_output_mutex);
+    assert(result == 0);
+    (void) result;
+}
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2024-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -18,6 +18,9 @@
 #include "esp_private/log_print.h"
 #include "esp_private/log_message.h"
 #include "esp_private/log_format.h"
+#if CONFIG_LOG_ASYNC
+#include "esp_private/log_async.h"
+#endif
 #include "esp_log_write.h"
 #include "esp_rom_sys.h"
 #include "sdkconfig.h"
@@ -69,7 +72,13 @@ void __attribute__((optimize("-O3"))) esp_log_va(esp_log_config_t config, const
         }
         esp_log_format_binary(&message);
 #else
-        esp_log_format(&message);
+#if CONFIG_LOG_ASYNC
+        // Messages from constrained environments are output right away, the others by the log task
+        if (config.opts.constrained_env || !esp_log_async_write(&message))
+#endif
+        {
+            esp_log_format(&message);
+        }
 #endif // ESP_LOG_MODE_BINARY_EN
         va_end(message.args);
     }
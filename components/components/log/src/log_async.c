@@ -0,0 +1,584 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include "esp_log_config.h"
+#include "esp_log_level.h"
+#include "esp_private/log_async.h"
+#include "esp_private/log_format.h"
+#include "esp_private/log_message.h"
+#include "esp_rom_sys.h"
+#include "sdkconfig.h"
+
+/*
+ * Log messages are stored in a ring buffer as records, which are written by any number of tasks and read by
+ * the log task. A writer reserves the space of its record by advancing the head with a compare-and-swap,
+ * fills the record and then marks it as ready. The log task outputs the records from the tail in the order
+ * of their reservation, waiting for a record which is not ready yet, and then releases their space by
+ * advancing the tail. A record never wraps around the end of the buffer, the space left at the end is
+ * reserved as padding instead.
+ *
+ * Head and tail are free-running counters of bytes, their difference is the number of bytes in use.
+ */
+
+#define BUFFER_SIZE         CONFIG_LOG_ASYNC_BUFFER_SIZE
+#define BUFFER_MASK         (BUFFER_SIZE - 1)
+#define RECORD_ALIGN        8
+#define LINE_SIZE           CONFIG_LOG_ASYNC_LINE_SIZE
+#define MAX_SPEC_LEN        32
+#define WAIT_TIMEOUT_MS     1000
+#define RETRY_TIMEOUT_MS    1
+
+_Static_assert((BUFFER_SIZE & BUFFER_MASK) == 0, "CONFIG_LOG_ASYNC_BUFFER_SIZE must be a power of two");
+
+enum {
+    RECORD_FREE = 0,    // reserved by a writer, being filled
+    RECORD_READY,       // filled, to be output
+    RECORD_PADDING,     // space skipped at the end of the buffer
+};
+
+typedef struct {
+    uint32_t state;             // RECORD_FREE, RECORD_READY or RECORD_PADDING
+    uint32_t size;              // size of the record including this header, multiple of RECORD_ALIGN
+    esp_log_config_t config;
+    const char *format;
+    uint64_t timestamp;
+    // followed by the tag, NUL terminated, and the arguments
+} log_record_t;
+
+_Static_assert(sizeof(log_record_t) % RECORD_ALIGN == 0, "log records must stay aligned");
+
+typedef enum {
+    ARG_END,        // end of the format string
+    ARG_PERCENT,    // "%%", no argument
+    ARG_INT,
+    ARG_LONG,
+    ARG_LLONG,
+    ARG_INTMAX,
+    ARG_SIZE,
+    ARG_PTRDIFF,
+    ARG_DOUBLE,
+    ARG_LDOUBLE,
+    ARG_POINTER,
+    ARG_STRING,
+    ARG_COUNT,      // "%n", the argument is skipped
+    ARG_INVALID,    // unknown conversion, the rest of the format string is output as is
+} arg_type_t;
+
+typedef struct {
+    const char *start;  // '%' of the conversion specification
+    const char *end;    // first character after it
+    arg_type_t type;
+    uint8_t stars;      // number of '*' for width and precision, each takes an int argument
+    int precision;      // precision given in the format string, -1 if none or given as argument
+    bool precision_arg; // the precision is given as argument, by the last '*'
+} conversion_t;
+
+static uint8_t s_buffer[BUFFER_SIZE] __attribute__((aligned(RECORD_ALIGN)));
+static uint32_t s_head;
+static uint32_t s_tail;
+static uint32_t s_task_waiting;
+static esp_log_async_stats_t s_stats;
+
+enum {
+    TASK_NOT_STARTED = 0,
+    TASK_STARTING,
+    TASK_RUNNING,
+    TASK_FAILED,
+};
+static uint32_t s_task_state;
+
+// Used by the log task and the flush one at a time
+static char s_line[LINE_SIZE];
+static uint32_t s_dropped_reported;
+
+static const char *next_conversion(const char *format, conversion_t *conv)
+{
+    while (*format && *format != '%') {
+        format++;
+    }
+    conv->start = format;
+    conv->stars = 0;
+    if (*format == '\0') {
+        conv->type = ARG_END;
+        conv->end = format;
+        return format;
+    }
+
+    format++;
+    if (*format == '%') {
+        conv->type = ARG_PERCENT;
+        conv->end = format + 1;
+        return conv->end;
+    }
+
+    // Flags and width
+    while (strchr("-+ #0123456789*'", *format) != NULL && *format != '\0') {
+        conv->stars += (*format == '*');
+        format++;
+    }
+
+    // Precision
+    conv->precision = -1;
+    conv->precision_arg = false;
+    if (*format == '.') {
+        format++;
+        if (*format == '*') {
+            conv->stars++;
+            conv->precision_arg = true;
+            format++;
+        } else {
+            conv->precision = 0;
+            while (*format >= '0' && *format <= '9') {
+                if (conv->precision < LINE_SIZE) {
+                    conv->precision = conv->precision * 10 + (*format - '0');
+                }
+                format++;
+            }
+        }
+    }
+
+    // Length modifier
+    int longs = 0;
+    char length = '\0';
+    while (strchr("hlLjzt", *format) != NULL && *format != '\0') {
+        if (*format == 'l') {
+            longs++;
+        } else if (*format != 'h') {
+            length = *format;
+        }
+        format++;
+    }
+
+    switch (*format) {
+    case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+        if (length == 'j') {
+            conv->type = ARG_INTMAX;
+        } else if (length == 'z') {
+            conv->type = ARG_SIZE;
+        } else if (length == 't') {
+            conv->type = ARG_PTRDIFF;
+        } else {
+            conv->type = (longs >= 2) ? ARG_LLONG : (longs == 1) ? ARG_LONG : ARG_INT;
+        }
+        break;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        conv->type = (length == 'L') ? ARG_LDOUBLE : ARG_DOUBLE;
+        break;
+    case 'p':
+        conv->type = ARG_POINTER;
+        break;
+    case 's':
+        conv->type = (longs == 0) ? ARG_STRING : ARG_INVALID;
+        break;
+    case 'n':
+        conv->type = ARG_COUNT;
+        break;
+    default:
+        conv->type = ARG_INVALID;
+        conv->end = format;
+        return format;
+    }
+    if (conv->stars > 2 || format + 1 - conv->start >= MAX_SPEC_LEN) {
+        conv->type = ARG_INVALID;
+    }
+    conv->end = format + 1;
+    return conv->end;
+}
+
+// Returns the number of characters of str to copy, which are the ones output with the given precision (-1 if none)
+// up to the line size. Characters beyond the precision are not read, the string may not be NUL terminated there.
+static inline size_t string_copy_len(const char *str, int precision, bool *truncated)
+{
+    if (str == NULL) {
+        return 0;
+    }
+    if (precision >= 0 && precision < LINE_SIZE) {
+        return strnlen(str, precision);
+    }
+    size_t len = strnlen(str, LINE_SIZE - 1);
+    if (len == LINE_SIZE - 1 && str[len] != '\0') {
+        *truncated = true;
+    }
+    return len;
+}
+
+// Walks the arguments of the message, computing their size in the record, and copying them to dst if it is not NULL
+static size_t args_copy(const char *format, va_list args, uint8_t *dst, bool *truncated)
+{
+    size_t size = 0;
+    conversion_t conv;
+
+#define COPY_ARG(type) do { \
+        type value = va_arg(args, type); \
+        if (dst) { \
+            memcpy(dst + size, &value, sizeof(value)); \
+        } \
+        size += sizeof(value); \
+    } while (0)
+
+    while (true) {
+        format = next_conversion(format, &conv);
+        if (conv.type == ARG_END || conv.type == ARG_INVALID) {
+            break;
+        }
+        int precision = conv.precision;
+        for (int i = 0; i < conv.stars; i++) {
+            int value = va_arg(args, int);
+            if (dst) {
+                memcpy(dst + size, &value, sizeof(value));
+            }
+            size += sizeof(value);
+            if (conv.precision_arg && i == conv.stars - 1) {
+                precision = value;  // a negative precision is taken as if it was omitted
+            }
+        }
+        switch (conv.type) {
+        case ARG_INT:       COPY_ARG(int); break;
+        case ARG_LONG:      COPY_ARG(long); break;
+        case ARG_LLONG:     COPY_ARG(long long); break;
+        case ARG_INTMAX:    COPY_ARG(intmax_t); break;
+        case ARG_SIZE:      COPY_ARG(size_t); break;
+        case ARG_PTRDIFF:   COPY_ARG(ptrdiff_t); break;
+        case ARG_DOUBLE:    COPY_ARG(double); break;
+        case ARG_LDOUBLE:   COPY_ARG(long double); break;
+        case ARG_POINTER:   COPY_ARG(void *); break;
+        case ARG_COUNT:     (void) va_arg(args, void *); break;
+        case ARG_STRING: {
+            // Stored as a flag telling whether the pointer was NULL, followed by the NUL terminated string
+            const char *str = va_arg(args, const char *);
+            size_t len = string_copy_len(str, precision, truncated);
+            if (dst) {
+                dst[size] = (str != NULL);
+                if (len != 0) {
+                    memcpy(dst + size + 1, str, len);
+                }
+                dst[size + 1 + len] = '\0';
+            }
+            size += len + 2;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+#undef COPY_ARG
+    return size;
+}
+
+static void stats_update_peak(uint32_t used)
+{
+    uint32_t peak = __atomic_load_n(&s_stats.buffer_peak, __ATOMIC_RELAXED);
+    while (used > peak &&
+            !__atomic_compare_exchange_n(&s_stats.buffer_peak, &peak, used, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+static log_record_t *buffer_reserve(uint32_t size)
+{
+    uint32_t head = __atomic_load_n(&s_head, __ATOMIC_RELAXED);
+    uint32_t padding, used;
+
+    do {
+        uint32_t tail = __atomic_load_n(&s_tail, __ATOMIC_ACQUIRE);
+        uint32_t offset = head & BUFFER_MASK;
+        padding = (BUFFER_SIZE - offset < size) ? BUFFER_SIZE - offset : 0;
+        used = head + padding + size - tail;
+        if (used > BUFFER_SIZE) {
+            return NULL;
+        }
+    } while (!__atomic_compare_exchange_n(&s_head, &head, head + padding + size, true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    stats_update_peak(used);
+
+    if (padding != 0) {
+        log_record_t *pad = (log_record_t *) &s_buffer[head & BUFFER_MASK];
+        pad->size = padding;
+        __atomic_store_n(&pad->state, RECORD_PADDING, __ATOMIC_RELEASE);
+    }
+
+    log_record_t *record = (log_record_t *) &s_buffer[(head + padding) & BUFFER_MASK];
+    record->size = size;
+    return record;
+}
+
+static void task_wake(void)
+{
+    // Pairs with the check of the buffer by the log task after it sets s_task_waiting
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&s_task_waiting, __ATOMIC_RELAXED) && __atomic_exchange_n(&s_task_waiting, 0, __ATOMIC_ACQ_REL)) {
+        esp_log_async_os_wake();
+    }
+}
+
+static void log_task(void);
+
+static bool task_start(void)
+{
+    uint32_t state = __atomic_load_n(&s_task_state, __ATOMIC_ACQUIRE);
+    if (state == TASK_NOT_STARTED &&
+            __atomic_compare_exchange_n(&s_task_state, &state, TASK_STARTING, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        state = esp_log_async_os_start(log_task) ? TASK_RUNNING : TASK_FAILED;
+        __atomic_store_n(&s_task_state, state, __ATOMIC_RELEASE);
+    }
+    // Messages logged while the task is being started are stored, and output once it runs
+    return state != TASK_FAILED;
+}
+
+bool esp_log_async_write(esp_log_msg_t *message)
+{
+    if (!task_start()) {
+        return false;
+    }
+
+    bool truncated = false;
+    size_t tag_len = string_copy_len(message->tag, -1, &truncated);
+    va_list args;
+
+    va_copy(args, message->args);
+    size_t args_size = args_copy(message->format, args, NULL, &truncated);
+    va_end(args);
+
+    size_t size = (sizeof(log_record_t) + tag_len + 2 + args_size + RECORD_ALIGN - 1) & ~(size_t)(RECORD_ALIGN - 1);
+    log_record_t *record = (size <= BUFFER_SIZE / 2) ? buffer_reserve(size) : NULL;
+    if (record == NULL) {
+        __atomic_fetch_add(&s_stats.dropped, 1, __ATOMIC_RELAXED);
+        return true;
+    }
+
+    record->config = message->config;
+    record->format = message->format;
+    record->timestamp = message->timestamp;
+    uint8_t *data = (uint8_t *)(record + 1);
+    data[0] = (message->tag != NULL);
+    if (tag_len != 0) {
+        memcpy(&data[1], message->tag, tag_len);
+    }
+    data[1 + tag_len] = '\0';
+    va_copy(args, message->args);
+    args_copy(message->format, args, &data[tag_len + 2], &truncated);
+    va_end(args);
+
+    __atomic_store_n(&record->state, RECORD_READY, __ATOMIC_RELEASE);
+
+    __atomic_fetch_add(&s_stats.messages, 1, __ATOMIC_RELAXED);
+    if (truncated) {
+        __atomic_fetch_add(&s_stats.truncated, 1, __ATOMIC_RELAXED);
+    }
+
+    task_wake();
+    return true;
+}
+
+static void output_message(esp_log_msg_t *message, const char *format, ...)
+{
+    message->format = format;
+    va_start(message->args, format);
+    esp_log_format(message);
+    va_end(message->args);
+}
+
+// Formats the arguments stored in the record with the format string, into s_line
+static void render_line(const char *format, const uint8_t *data)
+{
+    char *dst = s_line;
+    size_t remaining = sizeof(s_line);
+    conversion_t conv;
+
+#define APPEND(...) do { \
+        int len = snprintf(dst, remaining, __VA_ARGS__); \
+        len = (len < 0) ? 0 : ((size_t) len >= remaining) ? (int) remaining - 1 : len; \
+        dst += len; \
+        remaining -= len; \
+    } while (0)
+#define READ_ARG(type, var) type var; memcpy(&var, data, sizeof(var)); data += sizeof(var)
+
+    while (true) {
+        const char *literal = format;
+        format = next_conversion(format, &conv);
+        if (conv.type == ARG_INVALID) {
+            APPEND("%s", literal);
+            break;
+        }
+        APPEND("%.*s", (int)(conv.start - literal), literal);
+        if (conv.type == ARG_END) {
+            break;
+        }
+        if (conv.type == ARG_PERCENT) {
+            APPEND("%%");
+            continue;
+        }
+
+        // Rebuild the conversion specification with the width and precision given as arguments
+        char spec[MAX_SPEC_LEN + 2 * 12];
+        size_t spec_len = 0;
+        for (const char *c = conv.start; c < conv.end; c++) {
+            if (*c == '*') {
+                READ_ARG(int, value);
+                spec_len += snprintf(&spec[spec_len], sizeof(spec) - spec_len, "%d", value);
+            } else {
+                spec[spec_len++] = *c;
+            }
+        }
+        spec[spec_len] = '\0';
+
+        switch (conv.type) {
+        case ARG_INT:       { READ_ARG(int, value); APPEND(spec, value); break; }
+        case ARG_LONG:      { READ_ARG(long, value); APPEND(spec, value); break; }
+        case ARG_LLONG:     { READ_ARG(long long, value); APPEND(spec, value); break; }
+        case ARG_INTMAX:    { READ_ARG(intmax_t, value); APPEND(spec, value); break; }
+        case ARG_SIZE:      { READ_ARG(size_t, value); APPEND(spec, value); break; }
+        case ARG_PTRDIFF:   { READ_ARG(ptrdiff_t, value); APPEND(spec, value); break; }
+        case ARG_DOUBLE:    { READ_ARG(double, value); APPEND(spec, value); break; }
+        case ARG_LDOUBLE:   { READ_ARG(long double, value); APPEND(spec, value); break; }
+        case ARG_POINTER:   { READ_ARG(void *, value); APPEND(spec, value); break; }
+        case ARG_STRING: {
+            bool not_null = *data++;
+            const char *str = (const char *) data;
+            data += strlen(str) + 1;
+            APPEND(spec, not_null ? str : "(null)");
+            break;
+        }
+        default:
+            break;
+        }
+    }
+#undef READ_ARG
+#undef APPEND
+}
+
+static void output_record(const log_record_t *record)
+{
+    const uint8_t *data = (const uint8_t *)(record + 1);
+    bool has_tag = data[0];
+    const char *tag = (const char *) &data[1];
+
+    render_line(record->format, &data[strlen(tag) + 2]);
+
+    esp_log_msg_t message = {
+        .config = record->config,
+        .tag = has_tag ? tag : NULL,
+        .timestamp = record->timestamp,
+        .arg_types = NULL,
+    };
+    output_message(&message, "%s", s_line);
+}
+
+static void output_dropped(void)
+{
+    uint32_t dropped = __atomic_load_n(&s_stats.dropped, __ATOMIC_RELAXED);
+    if (dropped == s_dropped_reported) {
+        return;
+    }
+    esp_log_msg_t message = {
+        .config = ESP_LOG_CONFIG_INIT(ESP_LOG_WARN | ESP_LOG_CONFIGS_DEFAULT | ESP_LOG_CONFIG_DIS_TIMESTAMP),
+        .tag = "log",
+    };
+    output_message(&message, "%" PRIu32 " messages dropped, log buffer full", dropped - s_dropped_reported);
+    s_dropped_reported = dropped;
+}
+
+// Outputs the ready records from the tail, returns false if it stopped at a record which is not ready yet
+static bool buffer_output(void)
+{
+    uint32_t tail = __atomic_load_n(&s_tail, __ATOMIC_RELAXED);
+    bool done = true;
+
+    while (tail != __atomic_load_n(&s_head, __ATOMIC_ACQUIRE)) {
+        log_record_t *record = (log_record_t *) &s_buffer[tail & BUFFER_MASK];
+        uint32_t state = __atomic_load_n(&record->state, __ATOMIC_ACQUIRE);
+        if (state == RECORD_FREE) {
+            done = false;
+            break;
+        }
+        uint32_t size = record->size;
+        if (state == RECORD_READY) {
+            output_record(record);
+        }
+        // Records may start anywhere in the released space, clear it for the next writers
+        memset(record, 0, size);
+        tail += size;
+        __atomic_store_n(&s_tail, tail, __ATOMIC_RELEASE);
+    }
+    output_dropped();
+    return done;
+}
+
+static void log_task(void)
+{
+    while (true) {
+        esp_log_async_os_output_lock();
+        bool done = buffer_output();
+        esp_log_async_os_output_unlock();
+
+        if (!done) {
+            // A writer has not finished its record yet, let it run
+            esp_log_async_os_wait(RETRY_TIMEOUT_MS);
+            continue;
+        }
+
+        __atomic_store_n(&s_task_waiting, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&s_head, __ATOMIC_RELAXED) == __atomic_load_n(&s_tail, __ATOMIC_RELAXED)) {
+            esp_log_async_os_wait(WAIT_TIMEOUT_MS);
+        }
+        __atomic_store_n(&s_task_waiting, 0, __ATOMIC_RELAXED);
+    }
+}
+
+void esp_log_async_flush(void)
+{
+    // The output lock is created along with the log task, which outputs what is stored before it runs
+    if (__atomic_load_n(&s_task_state, __ATOMIC_ACQUIRE) != TASK_RUNNING) {
+        return;
+    }
+    esp_log_async_os_output_lock();
+    buffer_output();
+    esp_log_async_os_output_unlock();
+}
+
+void esp_log_async_panic_flush(void)
+{
+    // The log task may have been interrupted while formatting a record into s_line, and the state of the
+    // C library is unknown. The records are output as they are stored, with the format string and without
+    // the arguments, and are left in the buffer.
+    static const char lvl_name[ESP_LOG_MAX] = { '?', 'E', 'W', 'I', 'D', 'V' };
+    uint32_t tail = __atomic_load_n(&s_tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&s_head, __ATOMIC_ACQUIRE);
+
+    while (tail != head) {
+        const log_record_t *record = (const log_record_t *) &s_buffer[tail & BUFFER_MASK];
+        uint32_t state = __atomic_load_n(&record->state, __ATOMIC_ACQUIRE);
+        if (state == RECORD_FREE || record->size == 0 || record->size > head - tail) {
+            break;
+        }
+        if (state == RECORD_READY) {
+            const uint8_t *data = (const uint8_t *)(record + 1);
+            esp_log_level_t level = record->config.opts.log_level;
+            esp_rom_printf("%c (%u) %s: %s\n", lvl_name[level < ESP_LOG_MAX ? level : 0], (unsigned) record->timestamp,
+                           data[0] ? (const char *) &data[1] : "", record->format);
+        }
+        tail += record->size;
+    }
+    uint32_t dropped = __atomic_load_n(&s_stats.dropped, __ATOMIC_RELAXED) - s_dropped_reported;
+    if (dropped != 0) {
+        esp_rom_printf("W log: %u messages dropped, log buffer full\n", (unsigned) dropped);
+    }
+}
+
+void esp_log_async_get_stats(esp_log_async_stats_t *stats)
+{
+    stats->messages = __atomic_load_n(&s_stats.messages, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&s_stats.dropped, __ATOMIC_RELAXED);
+    stats->truncated = __atomic_load_n(&s_stats.truncated, __ATOMIC_RELAXED);
+    stats->buffer_peak = __atomic_load_n(&s_stats.buffer_peak, __ATOMIC_RELAXED);
+}
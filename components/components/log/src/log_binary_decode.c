@@ -0,0 +1,385 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "esp_log_binary_decode.h"
+
+/*
+ * Decodes the packages built by log_format_binary.c. All values are in big-endian order:
+ *
+ * [0]          application type: 1 - bootloader, 2 - application
+ * [1, 2]       control: length of the package (10 bits), log level (3 bits), 64 bits timestamp (1 bit), version (2 bits)
+ * string       format
+ * string       tag
+ * [4 or 8]     timestamp in milliseconds
+ * arguments    4 bytes for integers, 8 bytes for long long integers and floating point numbers, string for "%s"
+ * [1]          CRC8 of the previous bytes
+ *
+ * A string is either the address of the string in the ELF file (pointer_size bytes, 0 for NULL), or embedded
+ * as a 16 bits negative length (1 - len) followed by MAX(len, 2) bytes.
+ */
+
+#define MAX_SPEC_LEN        32
+#define MAX_STR_LEN         1023    // limited by the 10 bits length of the package
+#define BYTES_PER_LINE      16
+#define IS_CHAR_PRINTABLE(character) ((character) >= 32 && (character) <= 126)
+
+typedef struct {
+    const esp_log_binary_decoder_config_t *config;
+    const uint8_t *pos;
+    const uint8_t *end;
+    bool mismatch;          // the content does not match the format string, or an address is unknown
+} reader_t;
+
+typedef struct {
+    const char *str;        // NULL for a NULL pointer or an unknown address
+    size_t len;
+    uint64_t addr;
+} string_t;
+
+typedef struct {
+    char *pos;
+    size_t remaining;
+} writer_t;
+
+static uint8_t crc8(const uint8_t *data, size_t len)
+{
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static uint64_t read_value(reader_t *reader, size_t size)
+{
+    uint64_t value = 0;
+    if ((size_t)(reader->end - reader->pos) < size) {
+        reader->mismatch = true;
+        reader->pos = reader->end;
+        return 0;
+    }
+    for (size_t i = 0; i < size; i++) {
+        value = (value << 8) | *reader->pos++;
+    }
+    return value;
+}
+
+static string_t read_embedded_string(reader_t *reader)
+{
+    string_t string = { 0 };
+    int16_t neg_len = (int16_t)((reader->pos[0] << 8) | reader->pos[1]);
+    size_t len = 1 - neg_len;
+    size_t size = (len < 2) ? 2 : len;
+    reader->pos += 2;
+    if ((size_t)(reader->end - reader->pos) < size) {
+        reader->mismatch = true;
+        reader->pos = reader->end;
+        return string;
+    }
+    string.str = (const char *) reader->pos;
+    string.len = len;
+    reader->pos += size;
+    return string;
+}
+
+static string_t read_string(reader_t *reader)
+{
+    string_t string = { 0 };
+    if (reader->end - reader->pos < 2) {
+        reader->mismatch = true;
+        reader->pos = reader->end;
+        return string;
+    }
+    const uint8_t *start = reader->pos;
+    // The length of embedded strings longer than 1 byte starts with 0xFC-0xFF, addresses never do
+    if (start[0] >= 0xFC) {
+        return read_embedded_string(reader);
+    }
+    // Strings of 0 or 1 byte, 00 01 00 00 and 00 00 xx 00, look like small addresses of the no-load section.
+    // They are taken as addresses only if the ELF file has a string there.
+    bool maybe_embedded = reader->end - reader->pos >= 4 && start[0] == 0 &&
+                          ((start[1] == 1 && start[2] == 0 && start[3] == 0) || (start[1] == 0 && start[2] != 0 && start[3] == 0));
+    if (maybe_embedded && (size_t)(reader->end - reader->pos) < reader->config->pointer_size) {
+        return read_embedded_string(reader);
+    }
+    string.addr = read_value(reader, reader->config->pointer_size);
+    if (string.addr == 0) {
+        return string;
+    }
+    if (reader->config->lookup != NULL) {
+        string.str = reader->config->lookup(string.addr, reader->config->lookup_arg);
+        if (string.str != NULL) {
+            string.len = strlen(string.str);
+            return string;
+        }
+    }
+    if (maybe_embedded) {
+        reader->pos = start;
+        return read_embedded_string(reader);
+    }
+    return string;
+}
+
+static void append(writer_t *writer, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+static void append(writer_t *writer, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(writer->pos, writer->remaining, format, args);
+    va_end(args);
+    if (len < 0) {
+        return;
+    }
+    len = ((size_t) len < writer->remaining) ? len : (int) writer->remaining - 1;
+    writer->pos += len;
+    writer->remaining -= len;
+}
+
+static void append_header(writer_t *writer, char level, uint64_t timestamp, const string_t *tag)
+{
+    append(writer, "%c (%" PRIu64 ") ", level, timestamp);
+    if (tag->str != NULL) {
+        append(writer, "%.*s: ", (int) tag->len, tag->str);
+    } else if (tag->addr != 0) {
+        append(writer, "0x%" PRIx64 ": ", tag->addr);
+    }
+}
+
+// Formats one conversion specification, returns the first character after it
+static const char *render_conversion(reader_t *reader, writer_t *writer, const char *format)
+{
+    const char *start = format++;
+    char spec[MAX_SPEC_LEN + 16];
+    size_t spec_len = 0;
+    spec[spec_len++] = '%';
+
+    // Flags, width and precision, '*' takes a 32 bits argument
+    while (*format != '\0' && strchr("-+ #0123456789.*", *format) != NULL) {
+        if (*format == '*') {
+            int32_t value = (int32_t) read_value(reader, 4);
+            if (spec_len < MAX_SPEC_LEN) {
+                spec_len += snprintf(&spec[spec_len], MAX_SPEC_LEN - spec_len, "%" PRId32, value);
+                spec_len = (spec_len < MAX_SPEC_LEN) ? spec_len : MAX_SPEC_LEN - 1;
+            }
+        } else if (spec_len < MAX_SPEC_LEN - 1) {
+            spec[spec_len++] = *format;
+        }
+        format++;
+    }
+    // Length modifiers, only "ll" changes the size of the argument
+    int longs = 0;
+    while (*format != '\0' && strchr("hlLjzt", *format) != NULL) {
+        longs += (*format == 'l');
+        format++;
+    }
+
+    char conversion = *format;
+    if (conversion == '\0') {
+        append(writer, "%s", start);
+        return format;
+    }
+    format++;
+    switch (conversion) {
+    case '%':
+        append(writer, "%%");
+        break;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+        uint64_t bits = read_value(reader, 8);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        spec[spec_len++] = conversion;
+        spec[spec_len] = '\0';
+        append(writer, spec, value);
+        break;
+    }
+    case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c': case 'p':
+        if (conversion == 'p') {
+            append(writer, "0x");
+            conversion = 'x';
+        }
+        if (longs >= 2) {
+            uint64_t value = read_value(reader, 8);
+            spec[spec_len++] = 'l';
+            spec[spec_len++] = 'l';
+            spec[spec_len++] = conversion;
+            spec[spec_len] = '\0';
+            append(writer, spec, (conversion == 'd' || conversion == 'i') ? (long long)(int64_t) value : (long long) value);
+        } else {
+            uint32_t value = (uint32_t) read_value(reader, 4);
+            spec[spec_len++] = conversion;
+            spec[spec_len] = '\0';
+            append(writer, spec, (conversion == 'd' || conversion == 'i') ? (int)(int32_t) value : (int) value);
+        }
+        break;
+    case 's': case 'S': {
+        string_t string = read_string(reader);
+        char str[MAX_STR_LEN + 1];
+        if (string.str != NULL) {
+            snprintf(str, sizeof(str), "%.*s", (int) string.len, string.str);
+        } else if (string.addr != 0) {
+            snprintf(str, sizeof(str), "0x%" PRIx64, string.addr);
+            reader->mismatch = true;
+        } else {
+            snprintf(str, sizeof(str), "(null)");
+        }
+        spec[spec_len++] = 's';
+        spec[spec_len] = '\0';
+        append(writer, spec, str);
+        break;
+    }
+    default:
+        // Unknown conversion, takes a 32 bits argument
+        read_value(reader, 4);
+        append(writer, "%.*s", (int)(format - start), start);
+        break;
+    }
+    return format;
+}
+
+static void render_message(reader_t *reader, writer_t *writer, const char *format)
+{
+    while (*format != '\0') {
+        const char *percent = strchr(format, '%');
+        if (percent == NULL) {
+            append(writer, "%s", format);
+            break;
+        }
+        append(writer, "%.*s", (int)(percent - format), format);
+        format = render_conversion(reader, writer, percent);
+    }
+}
+
+typedef enum {
+    BUFFER_HEX,
+    BUFFER_CHAR,
+    BUFFER_HEXDUMP,
+} buffer_log_t;
+
+// ESP_LOG_BUFFER_HEX, ESP_LOG_BUFFER_CHAR and ESP_LOG_BUFFER_HEXDUMP, output as the text log mode does
+static void render_buffer(reader_t *reader, writer_t *writer, buffer_log_t type, char level, uint64_t timestamp, const string_t *tag)
+{
+    uint32_t len = (uint32_t) read_value(reader, 4);
+    string_t buffer = read_string(reader);
+    uint32_t address = (uint32_t) read_value(reader, 4);
+    if (buffer.str == NULL || buffer.len < len) {
+        reader->mismatch = true;
+        return;
+    }
+    const uint8_t *data = (const uint8_t *) buffer.str;
+    for (uint32_t offset = 0; offset < len; offset += BYTES_PER_LINE) {
+        uint32_t line_len = (len - offset < BYTES_PER_LINE) ? len - offset : BYTES_PER_LINE;
+        append_header(writer, level, timestamp, tag);
+        if (type == BUFFER_HEX) {
+            for (uint32_t i = 0; i < line_len; i++) {
+                append(writer, (i == 0) ? "%02x" : " %02x", data[offset + i]);
+            }
+        } else if (type == BUFFER_CHAR) {
+            append(writer, "%.*s", (int) line_len, (const char *) &data[offset]);
+        } else {
+            append(writer, "0x%08" PRIx32 " ", address + offset);
+            for (uint32_t i = 0; i < BYTES_PER_LINE; i++) {
+                append(writer, ((i & 7) == 0) ? "  " : " ");
+                if (i < line_len) {
+                    append(writer, "%02x", data[offset + i]);
+                } else {
+                    append(writer, "  ");
+                }
+            }
+            append(writer, "  |");
+            for (uint32_t i = 0; i < line_len; i++) {
+                append(writer, "%c", IS_CHAR_PRINTABLE(data[offset + i]) ? data[offset + i] : '.');
+            }
+            append(writer, "|");
+        }
+        append(writer, "\n");
+    }
+}
+
+static bool string_starts_with(const string_t *string, const char *prefix)
+{
+    size_t len = strlen(prefix);
+    return string->str != NULL && string->len >= len && memcmp(string->str, prefix, len) == 0;
+}
+
+esp_err_t esp_log_binary_decode(const esp_log_binary_decoder_config_t *config, const void *data, size_t len,
+                                size_t *consumed, char *text, size_t text_size)
+{
+    if (config == NULL || data == NULL || consumed == NULL || text == NULL || text_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const uint8_t *pkg = data;
+    *consumed = 0;
+    text[0] = '\0';
+    if (len < 3) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    uint16_t control = (pkg[1] << 8) | pkg[2];
+    size_t pkg_len = control & 0x3FF;
+    char level = "NEWIDV??"[(control >> 10) & 0x07];
+    size_t timestamp_size = ((control >> 13) & 0x01) ? sizeof(uint64_t) : sizeof(uint32_t);
+    unsigned version = control >> 14;
+    if ((pkg[0] != 1 && pkg[0] != 2) || version != 0 || pkg_len < 3 + 2 + 2 + timestamp_size + 1) {
+        *consumed = 1;
+        return ESP_ERR_INVALID_VERSION;
+    }
+    if (len < pkg_len) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (crc8(pkg, pkg_len - 1) != pkg[pkg_len - 1]) {
+        *consumed = 1;
+        return ESP_ERR_INVALID_CRC;
+    }
+    *consumed = pkg_len;
+
+    reader_t reader = {
+        .config = config,
+        .pos = pkg + 3,
+        .end = pkg + pkg_len - 1,
+        .mismatch = false,
+    };
+    writer_t writer = {
+        .pos = text,
+        .remaining = text_size,
+    };
+    string_t format = read_string(&reader);
+    string_t tag = read_string(&reader);
+    uint64_t timestamp = read_value(&reader, timestamp_size);
+
+    if (string_starts_with(&format, "__ESP_BUFFER_HEX_FORMAT__")) {
+        render_buffer(&reader, &writer, BUFFER_HEX, level, timestamp, &tag);
+    } else if (string_starts_with(&format, "__ESP_BUFFER_CHAR_FORMAT__")) {
+        render_buffer(&reader, &writer, BUFFER_CHAR, level, timestamp, &tag);
+    } else if (string_starts_with(&format, "__ESP_BUFFER_HEXDUMP_FORMAT__")) {
+        render_buffer(&reader, &writer, BUFFER_HEXDUMP, level, timestamp, &tag);
+    } else {
+        append_header(&writer, level, timestamp, &tag);
+        if (format.str != NULL) {
+            // Embedded strings are not NUL terminated
+            char format_str[MAX_STR_LEN + 1];
+            snprintf(format_str, sizeof(format_str), "%.*s", (int) format.len, format.str);
+            render_message(&reader, &writer, format_str);
+        } else {
+            reader.mismatch = true;
+        }
+        append(&writer, "\n");
+    }
+
+    if (reader.mismatch || reader.pos != reader.end || (tag.str == NULL && tag.addr != 0)) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "esp_log_binary.h"
+#include "esp_private/log_lock.h"
+
+/*
+ * The ring stores the packages back to back, as they are output to the UART, wrapping around the end of the
+ * buffer. A package starts with the application type byte followed by the 16 bits control field in big-endian
+ * order, whose lowest 10 bits are the length of the package.
+ */
+
+static inline size_t ring_offset(const esp_log_binary_ring_t *ring, size_t offset)
+{
+    return (offset >= ring->size) ? offset - ring->size : offset;
+}
+
+static size_t ring_pkg_len(const esp_log_binary_ring_t *ring)
+{
+    uint8_t high = ring->buffer[ring_offset(ring, ring->tail + 1)];
+    uint8_t low = ring->buffer[ring_offset(ring, ring->tail + 2)];
+    return ((high & 0x03) << 8) | low;
+}
+
+static void ring_drop(esp_log_binary_ring_t *ring, size_t len)
+{
+    ring->tail = ring_offset(ring, ring->tail + len);
+    ring->used -= len;
+}
+
+void esp_log_binary_ring_init(esp_log_binary_ring_t *ring, void *buffer, size_t size)
+{
+    assert(ring != NULL && buffer != NULL);
+    ring->buffer = buffer;
+    ring->size = size;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->used = 0;
+    ring->overwritten = 0;
+}
+
+void esp_log_binary_ring_sink(const void *pkg, size_t len, void *arg)
+{
+    esp_log_binary_ring_t *ring = arg;
+    if (len > ring->size) {
+        ring->overwritten++;
+        return;
+    }
+    // Make room by dropping the oldest packages
+    while (ring->size - ring->used < len) {
+        ring_drop(ring, ring_pkg_len(ring));
+        ring->overwritten++;
+    }
+    size_t first = (len < ring->size - ring->head) ? len : ring->size - ring->head;
+    memcpy(&ring->buffer[ring->head], pkg, first);
+    memcpy(ring->buffer, (const uint8_t *)pkg + first, len - first);
+    ring->head = ring_offset(ring, ring->head + len);
+    ring->used += len;
+}
+
+size_t esp_log_binary_ring_read(esp_log_binary_ring_t *ring, void *dst, size_t size)
+{
+    uint8_t *out = dst;
+    size_t read = 0;
+    esp_log_impl_lock();
+    while (ring->used != 0) {
+        size_t len = ring_pkg_len(ring);
+        if (read + len > size) {
+            break;
+        }
+        size_t first = (len < ring->size - ring->tail) ? len : ring->size - ring->tail;
+        memcpy(&out[read], &ring->buffer[ring->tail], first);
+        memcpy(&out[read + first], ring->buffer, len - first);
+        ring_drop(ring, len);
+        read += len;
+    }
+    esp_log_impl_unlock();
+    return read;
+}
+
+void esp_log_binary_file_sink(const void *pkg, size_t len, void *arg)
+{
+    fwrite(pkg, 1, len, (FILE *) arg);
+}
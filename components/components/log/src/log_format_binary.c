@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2025-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -10,6 +10,7 @@
 #include <assert.h>
 #include "esp_log_config.h"
 #include "esp_log_args.h"
+#include "esp_log_binary.h"
 #include "esp_private/log_lock.h"
 #include "esp_private/log_message.h"
 #include "esp_private/log_print.h"
@@ -59,6 +60,8 @@ typedef struct {
 
 _Static_assert(sizeof(control_t) == 3, "control_t must be exactly 24 bits (3 bytes)");
 
+#define PKG_MAX_LEN ((1 << 10) - 1) /**< Maximum package length, limited by control_t.opts.pkg_len. */
+
 typedef struct {
     uint8_t crc;
     bool buffer_hex_log;
@@ -66,12 +69,42 @@ typedef struct {
     bool buffer_hexdump_log;
     int buffer_len;
     bool len_calculation_stage;
+    uint8_t *pkg;           /**< Buffer the package is encoded into for the sink, NULL to output it to the UART. */
+    unsigned pkg_pos;       /**< Number of bytes encoded into pkg. */
 } pkg_info_t;
 
 extern const char __ESP_BUFFER_HEX_FORMAT__[];
 extern const char __ESP_BUFFER_CHAR_FORMAT__[];
 extern const char __ESP_BUFFER_HEXDUMP_FORMAT__[];
 
+#if !BOOTLOADER_BUILD
+static esp_log_binary_sink_t s_sink;
+static void *s_sink_arg;
+// Used with the log lock held
+static uint8_t s_pkg[PKG_MAX_LEN];
+// CRC8 (polynomial 0x07) of each byte value. Only used out of constrained environments, so it can stay in flash.
+static const uint8_t s_crc8_table[256] = {
+    0x00, 0x07, 0x0e, 0x09, 0x1c, 0x1b, 0x12, 0x15, 0x38, 0x3f, 0x36, 0x31, 0x24, 0x23, 0x2a, 0x2d,
+    0x70, 0x77, 0x7e, 0x79, 0x6c, 0x6b, 0x62, 0x65, 0x48, 0x4f, 0x46, 0x41, 0x54, 0x53, 0x5a, 0x5d,
+    0xe0, 0xe7, 0xee, 0xe9, 0xfc, 0xfb, 0xf2, 0xf5, 0xd8, 0xdf, 0xd6, 0xd1, 0xc4, 0xc3, 0xca, 0xcd,
+    0x90, 0x97, 0x9e, 0x99, 0x8c, 0x8b, 0x82, 0x85, 0xa8, 0xaf, 0xa6, 0xa1, 0xb4, 0xb3, 0xba, 0xbd,
+    0xc7, 0xc0, 0xc9, 0xce, 0xdb, 0xdc, 0xd5, 0xd2, 0xff, 0xf8, 0xf1, 0xf6, 0xe3, 0xe4, 0xed, 0xea,
+    0xb7, 0xb0, 0xb9, 0xbe, 0xab, 0xac, 0xa5, 0xa2, 0x8f, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9d, 0x9a,
+    0x27, 0x20, 0x29, 0x2e, 0x3b, 0x3c, 0x35, 0x32, 0x1f, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0d, 0x0a,
+    0x57, 0x50, 0x59, 0x5e, 0x4b, 0x4c, 0x45, 0x42, 0x6f, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7d, 0x7a,
+    0x89, 0x8e, 0x87, 0x80, 0x95, 0x92, 0x9b, 0x9c, 0xb1, 0xb6, 0xbf, 0xb8, 0xad, 0xaa, 0xa3, 0xa4,
+    0xf9, 0xfe, 0xf7, 0xf0, 0xe5, 0xe2, 0xeb, 0xec, 0xc1, 0xc6, 0xcf, 0xc8, 0xdd, 0xda, 0xd3, 0xd4,
+    0x69, 0x6e, 0x67, 0x60, 0x75, 0x72, 0x7b, 0x7c, 0x51, 0x56, 0x5f, 0x58, 0x4d, 0x4a, 0x43, 0x44,
+    0x19, 0x1e, 0x17, 0x10, 0x05, 0x02, 0x0b, 0x0c, 0x21, 0x26, 0x2f, 0x28, 0x3d, 0x3a, 0x33, 0x34,
+    0x4e, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5c, 0x5b, 0x76, 0x71, 0x78, 0x7f, 0x6a, 0x6d, 0x64, 0x63,
+    0x3e, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2c, 0x2b, 0x06, 0x01, 0x08, 0x0f, 0x1a, 0x1d, 0x14, 0x13,
+    0xae, 0xa9, 0xa0, 0xa7, 0xb2, 0xb5, 0xbc, 0xbb, 0x96, 0x91, 0x98, 0x9f, 0x8a, 0x8d, 0x84, 0x83,
+    0xde, 0xd9, 0xd0, 0xd7, 0xc2, 0xc5, 0xcc, 0xcb, 0xe6, 0xe1, 0xe8, 0xef, 0xfa, 0xfd, 0xf4, 0xf3,
+};
+
+_Static_assert(PKG_MAX_LEN == ESP_LOG_BINARY_PKG_MAX_LEN, "ESP_LOG_BINARY_PKG_MAX_LEN must match control_t");
+#endif
+
 void update_crc8(uint8_t data, pkg_info_t *pkg_info)
 {
     uint8_t crc = pkg_info->crc;
@@ -110,7 +143,13 @@ static unsigned output(const void *src, unsigned length, pkg_info_t *pkg_info)
 {
     for (unsigned i = 0; i < length; i++) {
         uint8_t data = ((uint8_t *)src)[length - 1 - i];
-        if (pkg_info->len_calculation_stage == false) {
+        if (pkg_info->pkg != NULL) {
+            // The CRC8 is computed once the package is complete
+            if (pkg_info->pkg_pos < PKG_MAX_LEN) {
+                pkg_info->pkg[pkg_info->pkg_pos] = data;
+            }
+            pkg_info->pkg_pos++;
+        } else if (pkg_info->len_calculation_stage == false) {
             esp_rom_output_tx_one_char(data);
             update_crc8(data, pkg_info);
         }
@@ -128,9 +167,19 @@ static unsigned output_pointer(const char *ptr, pkg_info_t *pkg_info)
         int len = (pkg_info->buffer_len) ? pkg_info->buffer_len : strlen(ptr);
         int16_t pkg_str_len = 1 - len;
         pkg_len = output(&pkg_str_len, sizeof(pkg_str_len), pkg_info);
-        for (unsigned i = 0; i < MAX(len, 2); i++) {
-            pkg_len += output(&ptr[i], sizeof(uint8_t), pkg_info);
+        unsigned i = 0;
+        if (pkg_info->pkg != NULL && pkg_info->pkg_pos + len <= PKG_MAX_LEN) {
+            // Strings are stored in order, copy them at once
+            memcpy(&pkg_info->pkg[pkg_info->pkg_pos], ptr, len);
+            pkg_info->pkg_pos += len;
+            i = len;
+        }
+        for (; i < MAX(len, 2); i++) {
+            // Strings shorter than 2 bytes are padded with zeros instead of reading past their end
+            uint8_t data = (i < len) ? ptr[i] : 0;
+            output(&data, sizeof(uint8_t), pkg_info);
         }
+        pkg_len += MAX(len, 2);
     }
     return pkg_len;
 }
@@ -240,9 +289,59 @@ static unsigned calc_pkg_len(esp_log_msg_t *message, pkg_info_t *pkg_info)
     va_end(args);
     pkg_len += sizeof(uint8_t); // crc8
     pkg_info->len_calculation_stage = false;
+    pkg_info->buffer_len = 0;
     return pkg_len;
 }
 
+#if !BOOTLOADER_BUILD
+void esp_log_binary_set_sink(esp_log_binary_sink_t sink, void *arg)
+{
+    esp_log_impl_lock();
+    s_sink = sink;
+    s_sink_arg = arg;
+    esp_log_impl_unlock();
+}
+
+/**
+ * @brief Encodes the package into s_pkg in a single pass and hands it over to the sink.
+ *
+ * Unlike the UART output, which needs the package length before the first byte is sent, the control bytes
+ * are filled in once the rest of the package is encoded, and the CRC8 is computed over the buffer with a table.
+ */
+static void format_to_sink(esp_log_msg_t *message, pkg_info_t *pkg_info)
+{
+    pkg_info->pkg = s_pkg;
+    pkg_info->pkg_pos = sizeof(control_t);
+    output_pointer(message->format, pkg_info);
+    output_pointer(message->tag, pkg_info);
+    bool time_64bits = (message->timestamp >> 32) != 0;
+    output(&message->timestamp, (time_64bits) ? sizeof(uint64_t) : sizeof(uint32_t), pkg_info);
+    output_arguments(message, message->args, pkg_info);
+
+    unsigned pkg_len = pkg_info->pkg_pos + sizeof(uint8_t); // crc8
+    if (pkg_len > PKG_MAX_LEN) {
+        return;
+    }
+    control_t control = {
+        .opts = {
+            .pkg_len = pkg_len,
+            .log_level = message->config.opts.log_level,
+            .time_64bits = time_64bits,
+            .version = 0,
+        },
+        .app_identifier = APP_TYPE,
+    };
+    pkg_info->pkg_pos = 0;
+    output(&control, sizeof(control), pkg_info);
+    uint8_t crc = 0;
+    for (unsigned i = 0; i < pkg_len - 1; i++) {
+        crc = s_crc8_table[crc ^ s_pkg[i]];
+    }
+    s_pkg[pkg_len - 1] = crc;
+    s_sink(s_pkg, pkg_len, s_sink_arg);
+}
+#endif // !BOOTLOADER_BUILD
+
 /*
 [0] - Type of message: 1 - bootloader, 2 - application, ...
 [1] - Control byte: log level, version.
@@ -271,8 +370,18 @@ void esp_log_format_binary(esp_log_msg_t *message)
         .buffer_hexdump_log = message->format == __ESP_BUFFER_HEXDUMP_FORMAT__,
         .buffer_len = 0,
         .len_calculation_stage = false,
+        .pkg = NULL,
+        .pkg_pos = 0,
     };
 
+#if !BOOTLOADER_BUILD
+    if (!message->config.opts.constrained_env && s_sink != NULL) {
+        format_to_sink(message, &pkg_info);
+        esp_log_impl_unlock();
+        return;
+    }
+#endif
+
     // Output control byte
     control_t control = {
         .opts = {
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -27,6 +27,62 @@
 
 #if !CONFIG_LOG_TAG_LEVEL_IMPL_NONE
 
+/*
+ * Tags defined with ESP_LOG_TAG_DEFINE() are stored in a linker section table, each one right after its level
+ * byte. A tag pointer within the table is therefore a declared tag whose level is the byte before it. Entries
+ * are 4-byte aligned, so the table may contain zero padding bytes, but level bytes always have
+ * ESP_LOG_TAG_ENTRY_MARK set.
+ */
+#if CONFIG_IDF_TARGET_LINUX && defined(__APPLE__)
+extern uint8_t log_tag_table_start[] __asm("section$start$__DATA$log_tag_level");
+extern uint8_t log_tag_table_end[] __asm("section$end$__DATA$log_tag_level");
+#define TAG_TABLE_START log_tag_table_start
+#define TAG_TABLE_END   log_tag_table_end
+#elif CONFIG_IDF_TARGET_LINUX
+// Weak, as the host linker defines them only if at least one tag is declared
+extern uint8_t __start_log_tag_level[] __attribute__((weak));
+extern uint8_t __stop_log_tag_level[] __attribute__((weak));
+#define TAG_TABLE_START __start_log_tag_level
+#define TAG_TABLE_END   __stop_log_tag_level
+#else
+extern uint8_t _log_tag_level_start[];
+extern uint8_t _log_tag_level_end[];
+#define TAG_TABLE_START _log_tag_level_start
+#define TAG_TABLE_END   _log_tag_level_end
+#endif
+
+static inline bool tag_table_get_level(const char *tag, esp_log_level_t *level)
+{
+    uint8_t *str = (uint8_t *)tag;
+    if (str <= TAG_TABLE_START || str >= TAG_TABLE_END) {
+        return false;
+    }
+    uint8_t entry_level = __atomic_load_n(&str[-1], __ATOMIC_RELAXED) & ESP_LOG_LEVEL_MASK;
+    *level = (entry_level == ESP_LOG_TAG_LEVEL_UNSET) ? esp_log_get_default_level() : (esp_log_level_t) entry_level;
+    return true;
+}
+
+// Sets the level of the declared tags named tag, or of all of them if tag is NULL. Called with the lock held.
+// Returns true if a declared tag was found.
+static bool tag_table_set_level(const char *tag, uint8_t level)
+{
+    bool found = false;
+    uint8_t *pos = TAG_TABLE_START;
+    while (pos < TAG_TABLE_END) {
+        if (*pos == 0) { // padding
+            pos++;
+            continue;
+        }
+        const char *str = (const char *)(pos + 1);
+        if (tag == NULL || strcmp(str, tag) == 0) {
+            __atomic_store_n(pos, ESP_LOG_TAG_ENTRY_MARK | level, __ATOMIC_RELAXED);
+            found = true;
+        }
+        pos += 1 + strlen(str) + 1;
+    }
+    return found;
+}
+
 static inline void log_level_set(const char *tag, esp_log_level_t level);
 static esp_log_level_t log_level_get(const char *tag, bool timeout);
 
@@ -44,7 +100,8 @@ static inline void log_level_set(const char *tag, esp_log_level_t level)
 #if CACHE_ENABLED
         esp_log_cache_clean();
 #endif
-    } else {
+        tag_table_set_level(NULL, ESP_LOG_TAG_LEVEL_UNSET);
+    } else if (!tag_table_set_level(tag, level)) {
         __attribute__((unused)) bool success = esp_log_linked_list_set_level(tag, level);
 #if CACHE_ENABLED
         if (success) {
@@ -58,7 +115,7 @@ static inline void log_level_set(const char *tag, esp_log_level_t level)
 static esp_log_level_t log_level_get(const char *tag, bool timeout)
 {
     esp_log_level_t level_for_tag = esp_log_get_default_level();
-    if (tag == NULL) {
+    if (tag == NULL || tag_table_get_level(tag, &level_for_tag)) {
         return level_for_tag;
     }
     if (timeout) {
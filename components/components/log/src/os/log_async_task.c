@@ -0,0 +1,52 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_private/log_async.h"
+#include "sdkconfig.h"
+
+static TaskHandle_t s_log_task = NULL;
+static SemaphoreHandle_t s_output_mutex = NULL;
+static StaticSemaphore_t s_output_mutex_buffer;
+
+static void log_task(void *arg)
+{
+    void (*task_func)(void) = (void (*)(void)) arg;
+    task_func();
+    vTaskDelete(NULL);
+}
+
+bool esp_log_async_os_start(void (*task_func)(void))
+{
+    s_output_mutex = xSemaphoreCreateMutexStatic(&s_output_mutex_buffer);
+    return xTaskCreatePinnedToCore(log_task, "log_async", CONFIG_LOG_ASYNC_TASK_STACK_SIZE, (void *) task_func,
+                                   CONFIG_LOG_ASYNC_TASK_PRIORITY, &s_log_task, tskNO_AFFINITY) == pdPASS;
+}
+
+void esp_log_async_os_wake(void)
+{
+    if (s_log_task != NULL) {
+        xTaskNotifyGive(s_log_task);
+    }
+}
+
+void esp_log_async_os_wait(uint32_t timeout_ms)
+{
+    TickType_t ticks = pdMS_TO_TICKS(timeout_ms);
+    ulTaskNotifyTake(pdTRUE, (ticks != 0) ? ticks : 1);
+}
+
+void esp_log_async_os_output_lock(void)
+{
+    xSemaphoreTake(s_output_mutex, portMAX_DELAY);
+}
+
+void esp_log_async_os_output_unlock(void)
+{
+    xSemaphoreGive(s_output_mutex);
+}
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2024-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -11,6 +11,7 @@
 #include <inttypes.h>
 #include "unity.h"
 #include "esp_rom_uart.h"
+#include "esp_timer.h"
 #include "sdkconfig.h"
 
 /*
@@ -23,6 +24,7 @@
 
 static const char * TAG1 = "ESP_LOG";
 static const char * TAG2 = "ESP_EARLY_LOG";
+ESP_LOG_TAG_DEFINE(TAG3, "ESP_LOG_DECLARED");
 
 #define BUFFER_SIZE (256)
 static unsigned s_counter = 0;
@@ -152,3 +154,42 @@ TEST_CASE("LOG_LOCAL_LEVEL can be re-defined", "[log]")
     esp_rom_install_uart_printf();
     esp_log_level_set("*", ESP_LOG_INFO);
 }
+
+TEST_CASE("declared tag level is read from the tag level table", "[log]")
+{
+#if CONFIG_LOG_MASTER_LEVEL
+    esp_log_set_level_master(ESP_LOG_VERBOSE);
+#endif
+    vprintf_like_t old_vprintf = esp_log_set_vprintf(print_to_buffer);
+    reset_buffer();
+    ESP_LOGD(TAG3, "No debug log");
+    TEST_ASSERT_EQUAL(0, get_counter());
+
+    esp_log_level_set("ESP_LOG_DECLARED", ESP_LOG_DEBUG);
+    TEST_ASSERT_EQUAL(ESP_LOG_DEBUG, esp_log_level_get(TAG3));
+    reset_buffer();
+    ESP_LOGD(TAG3, "There is a debug log");
+    TEST_ASSERT_NOT_NULL(strstr(get_buffer(), "There is a debug log"));
+    esp_log_set_vprintf(old_vprintf);
+
+    // Compare the lookup of a declared tag with the one of a string tag, which is cached after the first lookup
+    const int count = 1000;
+    esp_log_level_get(TAG1);
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < count; i++) {
+        esp_log_level_get(TAG3);
+    }
+    int64_t declared_us = esp_timer_get_time() - start;
+    start = esp_timer_get_time();
+    for (int i = 0; i < count; i++) {
+        esp_log_level_get(TAG1);
+    }
+    int64_t string_us = esp_timer_get_time() - start;
+    printf("%d lookups: declared tag %" PRId64 " us, string tag %" PRId64 " us\n", count, declared_us, string_us);
+#if ESP_LOG_TAG_TABLE_EN
+    TEST_ASSERT_LESS_THAN(string_us, declared_us);
+#endif
+
+    esp_log_level_set("*", ESP_LOG_INFO);
+    TEST_ASSERT_EQUAL(ESP_LOG_INFO, esp_log_level_get(TAG3));
+}
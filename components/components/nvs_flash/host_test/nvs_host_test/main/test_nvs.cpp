@@ -8,6 +8,8 @@
 #include "sdkconfig.h"
 #include "nvs_partition_manager.hpp"
 #include "nvs_partition.hpp"
+#include "nvs_handle.hpp"
+#include "nvs_value_cache.hpp"
 #include <sstream>
 #include <iostream>
 #include <fstream>
@@ -17,6 +19,9 @@
 #include <string.h>
 #include <string>
 #include <random>
+#include <vector>
+#include <algorithm>
+#include <chrono>
 #include "test_fixtures.hpp"
 #include "spi_flash_mmap.h"
 
@@ -264,9 +269,9 @@ TEST_CASE("Page validates blob size", "[nvs]")
 
 class HashListTestHelper : public nvs::HashList {
 public:
-    size_t getBlockCount()
+    size_t getGroupCount()
     {
-        return mBlockList.size();
+        return mGroupCount;
     }
 };
 
@@ -281,13 +286,13 @@ TEST_CASE("HashList is cleaned up as soon as items are erased", "[nvs]")
         nvs::Item item(1, nvs::ItemType::U32, 1, key);
         hashlist.insert(item, i);
     }
-    INFO("Added " << count << " items, " << hashlist.getBlockCount() << " blocks");
+    INFO("Added " << count << " items, " << hashlist.getGroupCount() << " groups");
     // Remove them in reverse order
     for (size_t i = count; i > 0; --i) {
         // Make sure that the element existed before it's erased
         CHECK(hashlist.erase(i - 1) == true);
     }
-    CHECK(hashlist.getBlockCount() == 0);
+    CHECK(hashlist.getGroupCount() == 0);
     // Add again
     for (size_t i = 0; i < count; ++i) {
         char key[16];
@@ -295,12 +300,12 @@ TEST_CASE("HashList is cleaned up as soon as items are erased", "[nvs]")
         nvs::Item item(1, nvs::ItemType::U32, 1, key);
         hashlist.insert(item, i);
     }
-    INFO("Added " << count << " items, " << hashlist.getBlockCount() << " blocks");
+    INFO("Added " << count << " items, " << hashlist.getGroupCount() << " groups");
     // Remove them in the same order
     for (size_t i = 0; i < count; ++i) {
         CHECK(hashlist.erase(i) == true);
     }
-    CHECK(hashlist.getBlockCount() == 0);
+    CHECK(hashlist.getGroupCount() == 0);
 }
 
 TEST_CASE("can init PageManager in empty flash", "[nvs]")
@@ -3973,6 +3978,657 @@ TEST_CASE("nvs find key tests", "[nvs]")
     nvs_close(handle_2);
     TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
 }
+
+TEST_CASE("key lookups stay consistent when pages are erased and reclaimed", "[nvs]")
+{
+    const size_t pageCount = 4;
+    PartitionEmulationFixture f(0, pageCount);
+    nvs::Storage storage(f.part());
+    TEST_ESP_OK(storage.init(0, pageCount));
+
+    // fill two pages with distinct keys, then erase every other one
+    const size_t keyCount = 2 * nvs::Page::ENTRY_COUNT;
+    char key[nvs::Item::MAX_KEY_LENGTH + 1];
+    for (size_t i = 0; i < keyCount; ++i) {
+        snprintf(key, sizeof(key), "key_%u", static_cast<unsigned>(i));
+        TEST_ESP_OK(storage.writeItem(1, key, static_cast<uint32_t>(i)));
+    }
+    for (size_t i = 0; i < keyCount; i += 2) {
+        snprintf(key, sizeof(key), "key_%u", static_cast<unsigned>(i));
+        TEST_ESP_OK(storage.eraseItem(1, key));
+    }
+
+    // keep rewriting one key, so that the pages holding the remaining keys are reclaimed,
+    // their items moved to new pages and the old pages erased and reused
+    esp_partition_clear_stats();
+    for (uint32_t i = 0; i < 8 * nvs::Page::ENTRY_COUNT; ++i) {
+        TEST_ESP_OK(storage.writeItem(1, "churn", i));
+    }
+    CHECK(esp_partition_get_erase_ops() >= 2);
+
+    for (size_t i = 0; i < keyCount; ++i) {
+        snprintf(key, sizeof(key), "key_%u", static_cast<unsigned>(i));
+        uint32_t value;
+        if (i % 2) {
+            TEST_ESP_OK(storage.readItem(1, key, value));
+            CHECK(value == i);
+        } else {
+            CHECK(storage.readItem(1, key, value) == ESP_ERR_NVS_NOT_FOUND);
+        }
+    }
+
+    // rewriting a moved key leaves a single copy of it
+    TEST_ESP_OK(storage.writeItem(1, "key_1", 1000U));
+    TEST_ESP_OK(storage.eraseItem(1, "key_1"));
+    uint32_t value;
+    CHECK(storage.readItem(1, "key_1", value) == ESP_ERR_NVS_NOT_FOUND);
+}
+
+TEST_CASE("key lookup time depends on number of pages", "[nvs][perf]")
+{
+    const size_t LOOKUP_COUNT = 1000;
+    const size_t pageCounts[] = {4, 16, 64};
+
+    for (size_t pageCount : pageCounts) {
+        PartitionEmulationFixture f(0, pageCount + 1);
+        nvs::Storage storage(f.part());
+        TEST_ESP_OK(storage.init(0, pageCount + 1));
+
+        // fill all pages with distinct keys
+        size_t itemCount = 0;
+        char key[nvs::Item::MAX_KEY_LENGTH + 1];
+        while (true) {
+            snprintf(key, sizeof(key), "key_%u", static_cast<unsigned>(itemCount));
+            if (storage.writeItem(1, key, static_cast<uint32_t>(itemCount)) != ESP_OK) {
+                break;
+            }
+            ++itemCount;
+        }
+        REQUIRE(itemCount > 0);
+
+        // the most recently written key lives on the last page, which is the worst case for a page by page search
+        char lastKey[nvs::Item::MAX_KEY_LENGTH + 1];
+        snprintf(lastKey, sizeof(lastKey), "key_%u", static_cast<unsigned>(itemCount - 1));
+
+        uint32_t value;
+        esp_partition_clear_stats();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < LOOKUP_COUNT; ++i) {
+            CHECK(storage.readItem(1, "missing", value) == ESP_ERR_NVS_NOT_FOUND);
+        }
+        auto missingTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        size_t missingReads = esp_partition_get_read_ops();
+
+        esp_partition_clear_stats();
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < LOOKUP_COUNT; ++i) {
+            TEST_ESP_OK(storage.readItem(1, lastKey, value));
+        }
+        auto presentTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        size_t presentReads = esp_partition_get_read_ops();
+        CHECK(value == itemCount - 1);
+
+        s_perf << "Key lookup with " << pageCount << " pages (" << itemCount << " items): missing key "
+               << missingTime / LOOKUP_COUNT << " ns (" << missingReads << "R), present key "
+               << presentTime / LOOKUP_COUNT << " ns (" << presentReads << "R)" << std::endl;
+    }
+}
+
+TEST_CASE("Recovery from power-off during commit of a transaction", "[nvs]")
+{
+    const size_t KEY_COUNT = 8;
+    // without filler items the old values are on the same page as the new ones, otherwise on the previous page
+    const size_t fillerCounts[] = {0, nvs::Page::ENTRY_COUNT - 1 - KEY_COUNT};
+    char key[nvs::Item::MAX_KEY_LENGTH + 1];
+
+    for (size_t fillerCount : fillerCounts) {
+        bool committed = false;
+        for (size_t failAfter = 1; !committed; ++failAfter) {
+            INFO(fillerCount << " " << failAfter);
+            PartitionEmulationFixture f(0, 4);
+            TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 4));
+
+            esp_err_t err;
+            std::unique_ptr<nvs::NVSHandle> handle = nvs::open_nvs_handle("test", NVS_READWRITE, &err);
+            TEST_ESP_OK(err);
+            for (size_t i = 0; i < KEY_COUNT; ++i) {
+                snprintf(key, sizeof(key), "key_%d", (int) i);
+                TEST_ESP_OK(handle->set_item(key, (uint32_t) 1));
+            }
+            for (size_t i = 0; i < fillerCount; ++i) {
+                snprintf(key, sizeof(key), "fill_%d", (int) i);
+                TEST_ESP_OK(handle->set_item(key, (uint8_t) 0));
+            }
+
+            TEST_ESP_OK(handle->begin_transaction());
+            for (size_t i = 0; i < KEY_COUNT; ++i) {
+                snprintf(key, sizeof(key), "key_%d", (int) i);
+                TEST_ESP_OK(handle->set_item(key, (uint32_t) 2));
+            }
+            esp_partition_fail_after(failAfter, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+            err = handle->commit();
+            esp_partition_fail_after(SIZE_MAX, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+            committed = (err == ESP_OK);
+            handle.reset();
+            TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
+
+            // every item has either its old or its new value, and there are no duplicates left
+            TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 4));
+            handle = nvs::open_nvs_handle("test", NVS_READONLY, &err);
+            TEST_ESP_OK(err);
+            for (size_t i = 0; i < KEY_COUNT; ++i) {
+                uint32_t value;
+                snprintf(key, sizeof(key), "key_%d", (int) i);
+                TEST_ESP_OK(handle->get_item(key, value));
+                CHECK((value == 2 || (!committed && value == 1)));
+            }
+            size_t usedEntries;
+            TEST_ESP_OK(handle->get_used_entry_count(usedEntries));
+            CHECK(usedEntries == KEY_COUNT + fillerCount);
+            handle.reset();
+            TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
+        }
+    }
+}
+
+TEST_CASE("value cache keeps recently read values per namespace", "[nvs]")
+{
+    nvs::ValueCache cache(1024);
+    nvs_cache_stats_t stats;
+    uint32_t value = 0;
+
+    CHECK(!cache.read(1, nvs::ItemType::U32, "key", &value, sizeof(value)));
+    value = 42;
+    cache.insert(1, nvs::ItemType::U32, "key", &value, sizeof(value));
+    value = 0;
+    CHECK(cache.read(1, nvs::ItemType::U32, "key", &value, sizeof(value)));
+    CHECK(value == 42);
+    // other data type, other namespace and wrong size are not served from the cache
+    CHECK(!cache.read(1, nvs::ItemType::I32, "key", &value, sizeof(value)));
+    CHECK(!cache.read(2, nvs::ItemType::U32, "key", &value, sizeof(value)));
+    CHECK(!cache.read(1, nvs::ItemType::U32, "key", &value, sizeof(uint16_t)));
+
+    const char str[] = "broker.example.com";
+    char readStr[32];
+    size_t size;
+    cache.insert(1, nvs::ItemType::SZ, "str", str, sizeof(str));
+    CHECK(cache.getSize(1, nvs::ItemType::SZ, "str", size));
+    CHECK(size == sizeof(str));
+    CHECK(!cache.read(1, nvs::ItemType::SZ, "str", readStr, sizeof(str) - 1));
+    CHECK(cache.read(1, nvs::ItemType::SZ, "str", readStr, sizeof(readStr)));
+    CHECK(strcmp(readStr, str) == 0);
+
+    cache.invalidate(1, "str");
+    CHECK(!cache.read(1, nvs::ItemType::SZ, "str", readStr, sizeof(readStr)));
+
+    cache.fillStats(stats);
+    CHECK(stats.size == 1024);
+    CHECK(stats.hits == 2);
+    CHECK(stats.misses == 6);
+    CHECK(stats.evictions == 0);
+
+    // reading many keys of namespace 2 evicts its own least recently used values, not the ones of namespace 1
+    char key[16];
+    for (uint32_t i = 0; i < 100; ++i) {
+        snprintf(key, sizeof(key), "key_%u", (unsigned) i);
+        cache.insert(2, nvs::ItemType::U32, key, &i, sizeof(i));
+    }
+    cache.fillStats(stats);
+    CHECK(stats.used_bytes <= stats.size);
+    CHECK(stats.evictions > 0);
+    CHECK(cache.read(1, nvs::ItemType::U32, "key", &value, sizeof(value)));
+    CHECK(cache.read(2, nvs::ItemType::U32, "key_99", &value, sizeof(value)));
+    CHECK(value == 99);
+    CHECK(!cache.read(2, nvs::ItemType::U32, "key_0", &value, sizeof(value)));
+
+    cache.invalidateNamespace(2);
+    CHECK(!cache.read(2, nvs::ItemType::U32, "key_99", &value, sizeof(value)));
+    CHECK(cache.read(1, nvs::ItemType::U32, "key", &value, sizeof(value)));
+
+    // too large values are not cached
+    uint8_t blob[512] = {};
+    cache.insert(1, nvs::ItemType::BLOB, "blob", blob, sizeof(blob));
+    CHECK(!cache.getSize(1, nvs::ItemType::BLOB, "blob", size));
+}
+
+#if CONFIG_NVS_VALUE_CACHE_SIZE > 0
+TEST_CASE("repeated reads of a key are served by the value cache", "[nvs]")
+{
+    const size_t READ_COUNT = 100;
+    PartitionEmulationFixture f(0, 4);
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 4));
+
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+    const char* url = "mqtts://broker.example.com:8883";
+    TEST_ESP_OK(nvs_set_str(handle, "url", url));
+    TEST_ESP_OK(nvs_set_u32(handle, "baud", 115200));
+
+    nvs_cache_stats_t stats;
+    TEST_ESP_OK(nvs_get_cache_stats(NULL, &stats));
+    const uint32_t hitsBefore = stats.hits;
+
+    char readUrl[64];
+    uint32_t baud;
+    esp_partition_clear_stats();
+    for (size_t i = 0; i < READ_COUNT; ++i) {
+        size_t len = sizeof(readUrl);
+        TEST_ESP_OK(nvs_get_str(handle, "url", readUrl, &len));
+        CHECK(strcmp(readUrl, url) == 0);
+        TEST_ESP_OK(nvs_get_u32(handle, "baud", &baud));
+        CHECK(baud == 115200);
+    }
+    const size_t readOps = esp_partition_get_read_ops();
+    TEST_ESP_OK(nvs_get_cache_stats(NULL, &stats));
+    CHECK(stats.hits - hitsBefore == 2 * (READ_COUNT - 1));
+    s_perf << "Value cache: " << 2 * READ_COUNT << " reads took " << readOps << " flash reads, "
+           << stats.hits << " hits, " << stats.misses << " misses" << std::endl;
+
+    // writing a key invalidates its cached value
+    TEST_ESP_OK(nvs_set_str(handle, "url", "mqtt://other"));
+    size_t len = sizeof(readUrl);
+    TEST_ESP_OK(nvs_get_str(handle, "url", readUrl, &len));
+    CHECK(strcmp(readUrl, "mqtt://other") == 0);
+    TEST_ESP_OK(nvs_erase_key(handle, "baud"));
+    TEST_ESP_ERR(nvs_get_u32(handle, "baud", &baud), ESP_ERR_NVS_NOT_FOUND);
+    TEST_ESP_OK(nvs_erase_all(handle));
+    len = sizeof(readUrl);
+    TEST_ESP_ERR(nvs_get_str(handle, "url", readUrl, &len), ESP_ERR_NVS_NOT_FOUND);
+
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
+}
+#endif
+
+TEST_CASE("init time depends on partition size", "[nvs][perf]")
+{
+    const size_t pageCounts[] = {4, 16, 64};
+
+    for (size_t pageCount : pageCounts) {
+        PartitionEmulationFixture f(0, pageCount + 1);
+        TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, pageCount + 1));
+
+        nvs_handle_t handle;
+        TEST_ESP_OK(nvs_open("bench", NVS_READWRITE, &handle));
+        // leave some room for the checkpoint
+        const size_t itemCount = (pageCount - 1) * nvs::Page::ENTRY_COUNT;
+        char key[nvs::Item::MAX_KEY_LENGTH + 1];
+        for (size_t i = 0; i < itemCount; ++i) {
+            snprintf(key, sizeof(key), "key_%u", static_cast<unsigned>(i));
+            TEST_ESP_OK(nvs_set_u32(handle, key, i));
+        }
+        nvs_close(handle);
+        TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
+
+        esp_partition_clear_stats();
+        auto start = std::chrono::steady_clock::now();
+        TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, pageCount + 1));
+        auto initTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        size_t initReads = esp_partition_get_read_ops();
+
+        uint32_t value;
+        TEST_ESP_OK(nvs_open("bench", NVS_READONLY, &handle));
+        TEST_ESP_OK(nvs_get_u32(handle, "key_0", &value));
+        CHECK(value == 0);
+        nvs_close(handle);
+        TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
+
+        s_perf << "Init with " << pageCount << " pages (" << itemCount << " items): "
+               << initTime << " us (" << initReads << "R)" << std::endl;
+    }
+}
+
+#ifdef CONFIG_NVS_FAST_BOOT
+TEST_CASE("checkpoint written on deinit lets init skip the partition checks", "[nvs]")
+{
+    const size_t PAGE_COUNT = 8;
+    PartitionEmulationFixture f(0, PAGE_COUNT);
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, PAGE_COUNT));
+
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open("first", NVS_READWRITE, &handle));
+    for (uint32_t i = 0; i < 300; ++i) {
+        char key[16];
+        snprintf(key, sizeof(key), "key_%u", static_cast<unsigned>(i));
+        TEST_ESP_OK(nvs_set_u32(handle, key, i));
+    }
+    nvs_close(handle);
+    uint8_t blob[3000];
+    for (size_t i = 0; i < sizeof(blob); ++i) {
+        blob[i] = static_cast<uint8_t>(i);
+    }
+    TEST_ESP_OK(nvs_open("second", NVS_READWRITE, &handle));
+    TEST_ESP_OK(nvs_set_blob(handle, "blob", blob, sizeof(blob)));
+    TEST_ESP_OK(nvs_set_str(handle, "str", "value"));
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
+
+    // the checkpoint doesn't show up as a namespace or an entry
+    esp_partition_clear_stats();
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, PAGE_COUNT));
+    const size_t fastReads = esp_partition_get_read_ops();
+    nvs_iterator_t it = nullptr;
+    size_t entryCount = 0;
+    for (esp_err_t res = nvs_entry_find(NVS_DEFAULT_PART_NAME, NULL, NVS_TYPE_ANY, &it);
+            res == ESP_OK; res = nvs_entry_next(&it)) {
+        ++entryCount;
+    }
+    nvs_release_iterator(it);
+    CHECK(entryCount == 302);
+    TEST_ESP_ERR(nvs_open("nvs.checkpoint", NVS_READONLY, &handle), ESP_ERR_NVS_NOT_FOUND);
+    TEST_ESP_ERR(nvs_open("nvs.checkpoint", NVS_READWRITE, &handle), ESP_ERR_NVS_INVALID_NAME);
+    TEST_ESP_OK(nvs_open("second", NVS_READONLY, &handle));
+    uint8_t readBlob[sizeof(blob)];
+    size_t size = sizeof(readBlob);
+    TEST_ESP_OK(nvs_get_blob(handle, "blob", readBlob, &size));
+    CHECK(memcmp(readBlob, blob, sizeof(blob)) == 0);
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
+
+    // without deinit (e.g. a reset), the first write invalidates the checkpoint and the full check is done
+    {
+        nvs::Storage storage(f.part());
+        TEST_ESP_OK(storage.init(0, PAGE_COUNT));
+        uint8_t nsIndex;
+        TEST_ESP_OK(storage.createOrOpenNamespace("first", false, nsIndex));
+        TEST_ESP_OK(storage.writeItem(nsIndex, "key_0", static_cast<uint32_t>(1000)));
+        TEST_ESP_OK(storage.createOrOpenNamespace("third", true, nsIndex));
+    }
+    esp_partition_clear_stats();
+    nvs::Storage storage(f.part());
+    TEST_ESP_OK(storage.init(0, PAGE_COUNT));
+    const size_t fullReads = esp_partition_get_read_ops();
+    CHECK(fastReads < fullReads / 2);
+
+    uint8_t nsIndex;
+    uint32_t value;
+    TEST_ESP_OK(storage.createOrOpenNamespace("first", false, nsIndex));
+    TEST_ESP_OK(storage.readItem(nsIndex, "key_0", value));
+    CHECK(value == 1000);
+    TEST_ESP_OK(storage.readItem(nsIndex, "key_299", value));
+    CHECK(value == 299);
+    TEST_ESP_OK(storage.createOrOpenNamespace("third", false, nsIndex));
+    s_perf << "Init of " << PAGE_COUNT << " pages after clean deinit: " << fastReads << "R, after reset: "
+           << fullReads << "R" << std::endl;
+}
+
+TEST_CASE("checkpoint is loaded as a namespace by versions without fast boot", "[nvs]")
+{
+    const size_t PAGE_COUNT = 4;
+    PartitionEmulationFixture f(0, PAGE_COUNT);
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, PAGE_COUNT));
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open("before", NVS_READWRITE, &handle));
+    TEST_ESP_OK(nvs_set_u8(handle, "key", 1));
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
+
+    // the namespace entries, read the way such versions read them
+    nvs::Page page;
+    TEST_ESP_OK(page.load(f.part(), 0));
+    size_t itemIndex = 0;
+    size_t namespaceCount = 0;
+    uint8_t checkpointNsIndex = 0;
+    nvs::Item item;
+    while (page.findItem(nvs::Page::NS_INDEX, nvs::ItemType::U8, nullptr, itemIndex, item) == ESP_OK) {
+        uint8_t nsIndex;
+        TEST_ESP_OK(item.getValue(nsIndex));
+        if (strcmp(item.key, nvs::PageManager::CHECKPOINT_NAMESPACE) == 0) {
+            checkpointNsIndex = nsIndex;
+        } else {
+            CHECK(strcmp(item.key, "before") == 0);
+            CHECK(nsIndex == 1);
+        }
+        ++namespaceCount;
+        itemIndex += item.span;
+    }
+    CHECK(namespaceCount == 2);
+    CHECK(checkpointNsIndex == 2);
+
+    // a namespace and its key written after the checkpoint by such a version
+    TEST_ESP_OK(page.writeItem(nvs::Page::NS_INDEX, "after", static_cast<uint8_t>(3)));
+    TEST_ESP_OK(page.writeItem(3, "key", static_cast<uint32_t>(42)));
+
+    nvs::Storage storage(f.part());
+    TEST_ESP_OK(storage.init(0, PAGE_COUNT));
+    uint8_t nsIndex;
+    TEST_ESP_OK(storage.createOrOpenNamespace("after", false, nsIndex));
+    CHECK(nsIndex == 3);
+    uint32_t value;
+    TEST_ESP_OK(storage.readItem(nsIndex, "key", value));
+    CHECK(value == 42);
+
+    // the index of the checkpoint namespace isn't handed out again
+    TEST_ESP_OK(storage.createOrOpenNamespace("new", true, nsIndex));
+    CHECK(nsIndex == 4);
+
+    // and the leftover checkpoint is removed
+    nvs::Page reloaded;
+    TEST_ESP_OK(reloaded.load(f.part(), 0));
+    CHECK(reloaded.findItem(checkpointNsIndex, nvs::ItemType::SZ, nvs::PageManager::CHECKPOINT_KEY) == ESP_ERR_NVS_NOT_FOUND);
+}
+#endif
+
+TEST_CASE("blob stream writes and reads a multi-page blob in pieces", "[nvs]")
+{
+    const size_t BLOB_SIZE = 12000;
+    PartitionEmulationFixture f(0, 8);
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 8));
+
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+    std::vector<uint8_t> oldBlob(5000, 0xaa);
+    TEST_ESP_OK(nvs_set_blob(handle, "blob", oldBlob.data(), oldBlob.size()));
+
+    std::vector<uint8_t> blob(BLOB_SIZE);
+    for (size_t i = 0; i < blob.size(); ++i) {
+        blob[i] = static_cast<uint8_t>(i * 7 + i / 256);
+    }
+
+    nvs_blob_stream_t stream;
+    TEST_ESP_OK(nvs_blob_stream_open_write(handle, "blob", blob.size(), &stream));
+    size_t offset = 0;
+    for (size_t piece = 1; offset < blob.size(); piece = piece * 3 % 1000 + 1) {
+        size_t len = std::min(piece, blob.size() - offset);
+        TEST_ESP_OK(nvs_blob_stream_write(stream, blob.data() + offset, len));
+        offset += len;
+        if (offset < blob.size() / 2) {
+            // the previous value stays readable until commit
+            size_t size = oldBlob.size();
+            std::vector<uint8_t> readBlob(size);
+            TEST_ESP_OK(nvs_get_blob(handle, "blob", readBlob.data(), &size));
+            CHECK(readBlob == oldBlob);
+        }
+    }
+    TEST_ESP_ERR(nvs_blob_stream_write(stream, blob.data(), 1), ESP_ERR_NVS_INVALID_LENGTH);
+    TEST_ESP_OK(nvs_blob_stream_commit(stream));
+    TEST_ESP_ERR(nvs_blob_stream_commit(stream), ESP_ERR_INVALID_STATE);
+    nvs_blob_stream_close(stream);
+
+    // the result is the same as writing the blob in one piece
+    size_t size = 0;
+    TEST_ESP_OK(nvs_get_blob(handle, "blob", NULL, &size));
+    CHECK(size == blob.size());
+    std::vector<uint8_t> readBlob(size);
+    TEST_ESP_OK(nvs_get_blob(handle, "blob", readBlob.data(), &size));
+    CHECK(readBlob == blob);
+    size_t usedEntries;
+    TEST_ESP_OK(nvs_get_used_entry_count(handle, &usedEntries));
+    const size_t streamEntries = usedEntries;
+
+    // read at offsets in random order, across chunk boundaries
+    std::mt19937 gen(42);
+    TEST_ESP_OK(nvs_blob_stream_open_read(handle, "blob", &size, &stream));
+    CHECK(size == blob.size());
+    uint8_t piece[1500];
+    for (int i = 0; i < 100; ++i) {
+        size_t readOffset = gen() % blob.size();
+        size_t len = std::min<size_t>(gen() % sizeof(piece), blob.size() - readOffset);
+        TEST_ESP_OK(nvs_blob_stream_read(stream, readOffset, piece, len));
+        CHECK(memcmp(piece, blob.data() + readOffset, len) == 0);
+    }
+    TEST_ESP_ERR(nvs_blob_stream_read(stream, blob.size() - 10, piece, 11), ESP_ERR_NVS_INVALID_LENGTH);
+    TEST_ESP_ERR(nvs_blob_stream_write(stream, piece, 1), ESP_ERR_INVALID_STATE);
+    nvs_blob_stream_close(stream);
+
+    // a stream closed without commit leaves nothing behind
+    TEST_ESP_OK(nvs_blob_stream_open_write(handle, "blob", 9000, &stream));
+    TEST_ESP_OK(nvs_blob_stream_write(stream, oldBlob.data(), oldBlob.size()));
+    TEST_ESP_ERR(nvs_blob_stream_commit(stream), ESP_ERR_NVS_INVALID_LENGTH);
+    nvs_blob_stream_close(stream);
+    TEST_ESP_OK(nvs_get_used_entry_count(handle, &usedEntries));
+    CHECK(usedEntries == streamEntries);
+    TEST_ESP_OK(nvs_get_blob(handle, "blob", readBlob.data(), &size));
+    CHECK(readBlob == blob);
+
+    TEST_ESP_OK(nvs_erase_key(handle, "blob"));
+    TEST_ESP_OK(nvs_blob_stream_open_write(handle, "empty", 0, &stream));
+    TEST_ESP_OK(nvs_blob_stream_commit(stream));
+    nvs_blob_stream_close(stream);
+    size = 1;
+    TEST_ESP_OK(nvs_get_blob(handle, "empty", NULL, &size));
+    CHECK(size == 0);
+    nvs_close(handle);
+
+    TEST_ESP_OK(nvs_open("test", NVS_READONLY, &handle));
+    TEST_ESP_ERR(nvs_blob_stream_open_write(handle, "blob", 10, &stream), ESP_ERR_NVS_READ_ONLY);
+    TEST_ESP_ERR(nvs_blob_stream_open_read(handle, "blob", &size, &stream), ESP_ERR_NVS_NOT_FOUND);
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
+}
+
+TEST_CASE("Recovery from power-off during a blob stream write", "[nvs]")
+{
+    std::vector<uint8_t> oldBlob(3000, 0x55);
+    std::vector<uint8_t> blob(9000);
+    for (size_t i = 0; i < blob.size(); ++i) {
+        blob[i] = static_cast<uint8_t>(i);
+    }
+
+    bool committed = false;
+    for (size_t failAfter = 1; !committed; failAfter += 3) {
+        INFO(failAfter);
+        PartitionEmulationFixture f(0, 6);
+        TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 6));
+        nvs_handle_t handle;
+        TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+        TEST_ESP_OK(nvs_set_blob(handle, "blob", oldBlob.data(), oldBlob.size()));
+
+        nvs_blob_stream_t stream;
+        TEST_ESP_OK(nvs_blob_stream_open_write(handle, "blob", blob.size(), &stream));
+        esp_partition_fail_after(failAfter, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+        esp_err_t err = ESP_OK;
+        for (size_t offset = 0; offset < blob.size() && err == ESP_OK; offset += 1000) {
+            err = nvs_blob_stream_write(stream, blob.data() + offset, 1000);
+        }
+        if (err == ESP_OK) {
+            err = nvs_blob_stream_commit(stream);
+        }
+        esp_partition_fail_after(SIZE_MAX, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+        committed = (err == ESP_OK);
+        // power-off: the stream isn't aborted, which closing the handle would do
+        TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
+        nvs_close(handle);
+        nvs_blob_stream_close(stream);
+
+        // either the old or the new blob is stored, without any leftover chunks.
+        // As with nvs_set_blob, a power-off while the first chunks are moved to a new page
+        // may also lose the old value.
+        TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 6));
+        TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+        size_t size = 0;
+        err = nvs_get_blob(handle, "blob", NULL, &size);
+        if (committed) {
+            TEST_ESP_OK(err);
+        }
+        if (err == ESP_OK) {
+            std::vector<uint8_t> readBlob(size);
+            TEST_ESP_OK(nvs_get_blob(handle, "blob", readBlob.data(), &size));
+            if (committed) {
+                CHECK(readBlob == blob);
+            } else {
+                CHECK((readBlob == oldBlob || readBlob == blob));
+            }
+            TEST_ESP_OK(nvs_erase_key(handle, "blob"));
+        } else {
+            CHECK(err == ESP_ERR_NVS_NOT_FOUND);
+        }
+        size_t usedEntries;
+        TEST_ESP_OK(nvs_get_used_entry_count(handle, &usedEntries));
+        CHECK(usedEntries == 0);
+        nvs_close(handle);
+        TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
+    }
+}
+
+TEST_CASE("chunks of a blob stream open at deinit don't collide with a later write", "[nvs]")
+{
+    PartitionEmulationFixture f(0, 8);
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 8));
+
+    // the stream writes a chunk of the new value, the blob index is only written on commit
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+    nvs_blob_stream_t stream;
+    std::vector<uint8_t> partial(6000, 0x11);
+    TEST_ESP_OK(nvs_blob_stream_open_write(handle, "blob", 9000, &stream));
+    TEST_ESP_OK(nvs_blob_stream_write(stream, partial.data(), partial.size()));
+    TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
+    nvs_close(handle);
+    nvs_blob_stream_close(stream);
+
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 8));
+    TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+    std::vector<uint8_t> blob(7000);
+    for (size_t i = 0; i < blob.size(); ++i) {
+        blob[i] = static_cast<uint8_t>(i);
+    }
+    TEST_ESP_OK(nvs_set_blob(handle, "blob", blob.data(), blob.size()));
+    size_t size = blob.size();
+    std::vector<uint8_t> readBlob(size);
+    TEST_ESP_OK(nvs_get_blob(handle, "blob", readBlob.data(), &size));
+    CHECK(readBlob == blob);
+
+    // nothing is left of the stream
+    TEST_ESP_OK(nvs_erase_key(handle, "blob"));
+    size_t usedEntries;
+    TEST_ESP_OK(nvs_get_used_entry_count(handle, &usedEntries));
+    CHECK(usedEntries == 0);
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
+}
+
+TEST_CASE("closing the handle aborts the blob streams opened with it", "[nvs]")
+{
+    PartitionEmulationFixture f(0, 8);
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 8));
+
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+    nvs_blob_stream_t stream;
+    std::vector<uint8_t> partial(6000, 0x11);
+    TEST_ESP_OK(nvs_blob_stream_open_write(handle, "blob", 9000, &stream));
+    TEST_ESP_OK(nvs_blob_stream_write(stream, partial.data(), partial.size()));
+    nvs_close(handle);
+    TEST_ESP_ERR(nvs_blob_stream_write(stream, partial.data(), 1), ESP_ERR_NVS_INVALID_HANDLE);
+    nvs_blob_stream_close(stream);
+
+    // the chunks written so far are erased
+    TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+    size_t usedEntries;
+    TEST_ESP_OK(nvs_get_used_entry_count(handle, &usedEntries));
+    CHECK(usedEntries == 0);
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
+
+#ifdef CONFIG_NVS_FAST_BOOT
+    // and the stream doesn't count as uncommitted any more, which would prevent the checkpoint
+    nvs::PageManager pm;
+    TEST_ESP_OK(pm.load(f.part(), 0, 8));
+    CHECK(pm.hasCheckpoint());
+#endif
+}
+
 /* Add new tests above */
 /* This test has to be the final one */
 
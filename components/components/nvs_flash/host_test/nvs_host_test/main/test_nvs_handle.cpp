@@ -9,6 +9,7 @@
 #include "nvs_handle_simple.hpp"
 #include "nvs_partition_manager.hpp"
 #include "test_fixtures.hpp"
+#include "esp_partition.h"
 #include <iostream>
 #include <string>
 
@@ -268,3 +269,83 @@ TEST_CASE("NVSHandleSimple correctly sets/gets char enum", "[partition_mgr]")
 
     REQUIRE(nvs::NVSPartitionManager::get_instance()->deinit_partition(NVS_DEFAULT_PART_NAME) == ESP_OK);
 }
+
+TEST_CASE("NVSHandleSimple transaction writes items with fewer flash writes", "[partition_mgr]")
+{
+    const uint32_t NVS_FLASH_SECTOR = 6;
+    const uint32_t NVS_FLASH_SECTOR_COUNT_MIN = 3;
+    const size_t ITEM_COUNT = 30;
+    PartitionEmulationFixture f(0, 10);
+
+    REQUIRE(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), NVS_FLASH_SECTOR, NVS_FLASH_SECTOR_COUNT_MIN)
+            == ESP_OK);
+
+    nvs::NVSHandleSimple *handle;
+    REQUIRE(nvs::NVSPartitionManager::get_instance()->open_handle(NVS_DEFAULT_PART_NAME, "ns_1", NVS_READWRITE, &handle) == ESP_OK);
+
+    char key[16];
+    esp_partition_clear_stats();
+    for (size_t i = 0; i < ITEM_COUNT; ++i) {
+        snprintf(key, sizeof(key), "single_%d", (int) i);
+        REQUIRE(handle->set_item(key, (uint32_t) i) == ESP_OK);
+    }
+    const size_t singleWrites = esp_partition_get_write_ops();
+
+    esp_partition_clear_stats();
+    REQUIRE(handle->begin_transaction() == ESP_OK);
+    for (size_t i = 0; i < ITEM_COUNT; ++i) {
+        snprintf(key, sizeof(key), "batch_%d", (int) i);
+        REQUIRE(handle->set_item(key, (uint32_t) i) == ESP_OK);
+    }
+    CHECK(esp_partition_get_write_ops() == 0);
+    REQUIRE(handle->commit() == ESP_OK);
+    const size_t batchWrites = esp_partition_get_write_ops();
+
+    INFO("new items, single writes: " << singleWrites << ", transaction writes: " << batchWrites);
+    CHECK(batchWrites * 10 < singleWrites);
+
+    // updating existing values also erases the old ones within the same entry table write
+    esp_partition_clear_stats();
+    REQUIRE(handle->begin_transaction() == ESP_OK);
+    for (size_t i = 0; i < ITEM_COUNT; ++i) {
+        snprintf(key, sizeof(key), "batch_%d", (int) i);
+        REQUIRE(handle->set_item(key, (uint32_t) (i + 100)) == ESP_OK);
+    }
+    REQUIRE(handle->set_string("batch_str", "value") == ESP_OK);
+    REQUIRE(handle->commit() == ESP_OK);
+    const size_t updateWrites = esp_partition_get_write_ops();
+    INFO("updated items, transaction writes: " << updateWrites);
+    CHECK(updateWrites * 10 < singleWrites);
+
+    for (size_t i = 0; i < ITEM_COUNT; ++i) {
+        uint32_t value;
+        snprintf(key, sizeof(key), "batch_%d", (int) i);
+        REQUIRE(handle->get_item(key, value) == ESP_OK);
+        CHECK(value == i + 100);
+    }
+    char str[8];
+    REQUIRE(handle->get_string("batch_str", str, sizeof(str)) == ESP_OK);
+    CHECK(strcmp(str, "value") == 0);
+
+    // staged values are discarded by abort and are not visible before commit
+    REQUIRE(handle->begin_transaction() == ESP_OK);
+    CHECK(handle->begin_transaction() == ESP_ERR_INVALID_STATE);
+    REQUIRE(handle->set_item("batch_0", (uint32_t) 42) == ESP_OK);
+    uint32_t value;
+    REQUIRE(handle->get_item("batch_0", value) == ESP_OK);
+    CHECK(value == 100);
+    CHECK(handle->set_blob("blob", str, sizeof(str)) == ESP_ERR_INVALID_STATE);
+    CHECK(handle->erase_item("batch_0") == ESP_ERR_INVALID_STATE);
+    REQUIRE(handle->abort_transaction() == ESP_OK);
+    CHECK(handle->abort_transaction() == ESP_ERR_INVALID_STATE);
+    REQUIRE(handle->get_item("batch_0", value) == ESP_OK);
+    CHECK(value == 100);
+
+    size_t usedEntries;
+    REQUIRE(handle->get_used_entry_count(usedEntries) == ESP_OK);
+    CHECK(usedEntries == 2 * ITEM_COUNT + 2);
+
+    delete handle;
+
+    REQUIRE(nvs::NVSPartitionManager::get_instance()->deinit_partition(NVS_DEFAULT_PART_NAME) == ESP_OK);
+}
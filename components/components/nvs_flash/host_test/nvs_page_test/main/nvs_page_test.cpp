@@ -6,10 +6,14 @@
 static const char* TAG = "nvs_page_host_test";
 
 #include <stdio.h>
+#include <chrono>
+#include <random>
 #include "unity.h"
 #include "test_fixtures.hpp"
 #include "esp_log.h"
 #include "spi_flash_mmap.h"
+#include "nvs_item_hash_list.hpp"
+#include "intrusive_list.h"
 
 #if defined(SEGGER_H) && defined(GLOBAL_H)
 NVS_GUARD_SYSVIEW_MACRO_EXPANSION_PUSH();
@@ -919,6 +923,215 @@ void test_Page_calcEntries__invalid()
     TEST_ASSERT_EQUAL(0, nvsStats.namespace_count);
 }
 
+/*
+ * Reference copy of the previous HashList implementation (linked list of fixed size blocks, searched linearly).
+ * Used to check the results of and to compare the performance with the current nvs::HashList.
+ */
+class BlockHashList
+{
+public:
+    ~BlockHashList()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        for (auto it = mBlockList.begin(); it != mBlockList.end();) {
+            auto tmp = it;
+            ++it;
+            mBlockList.erase(tmp);
+            delete static_cast<HashListBlock*>(tmp);
+        }
+    }
+
+    esp_err_t insert(const Item& item, size_t index)
+    {
+        const uint32_t hash_24 = item.calculateCrc32WithoutValue() & 0xffffff;
+        if (mBlockList.size()) {
+            auto& block = mBlockList.back();
+            if (block.mCount < HashListBlock::ENTRY_COUNT) {
+                block.mNodes[block.mCount].mIndex = index;
+                block.mNodes[block.mCount++].mHash = hash_24;
+                return ESP_OK;
+            }
+        }
+        HashListBlock* newBlock = new (std::nothrow) HashListBlock;
+        if (!newBlock) return ESP_ERR_NO_MEM;
+        mBlockList.push_back(newBlock);
+        newBlock->mNodes[0].mIndex = index;
+        newBlock->mNodes[0].mHash = hash_24;
+        newBlock->mCount++;
+        return ESP_OK;
+    }
+
+    bool erase(size_t index)
+    {
+        for (auto it = mBlockList.begin(); it != mBlockList.end();) {
+            bool haveEntries = false;
+            bool foundIndex = false;
+            for (size_t i = 0; i < it->mCount; ++i) {
+                if (it->mNodes[i].mIndex == index) {
+                    it->mNodes[i].mIndex = 0xff;
+                    foundIndex = true;
+                }
+                if (it->mNodes[i].mIndex != 0xff) {
+                    haveEntries = true;
+                }
+                if (haveEntries && foundIndex) {
+                    return true;
+                }
+            }
+            if (!haveEntries) {
+                auto tmp = it;
+                ++it;
+                mBlockList.erase(tmp);
+                delete static_cast<HashListBlock*>(tmp);
+            } else {
+                ++it;
+            }
+            if (foundIndex) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t find(size_t start, const Item& item)
+    {
+        const uint32_t hash_24 = item.calculateCrc32WithoutValue() & 0xffffff;
+        for (auto it = mBlockList.begin(); it != mBlockList.end(); ++it) {
+            for (size_t index = 0; index < it->mCount; ++index) {
+                const HashListNode& e = it->mNodes[index];
+                if (e.mIndex >= start && e.mHash == hash_24 && e.mIndex != 0xff) {
+                    return e.mIndex;
+                }
+            }
+        }
+        return SIZE_MAX;
+    }
+
+protected:
+    struct HashListNode {
+        uint32_t mIndex : 8;
+        uint32_t mHash  : 24;
+    };
+
+    struct HashListBlock : public intrusive_list_node<HashListBlock>, public ExceptionlessAllocatable {
+        static const size_t BYTE_SIZE = 128;
+        static const size_t ENTRY_COUNT = (BYTE_SIZE - sizeof(intrusive_list_node<HashListBlock>) - sizeof(size_t)) / 4;
+
+        size_t mCount = 0;
+        HashListNode mNodes[ENTRY_COUNT];
+    };
+
+    intrusive_list<HashListBlock> mBlockList;
+};
+
+static void make_hash_list_items(Item* items, size_t count, const char* prefix)
+{
+    for (size_t i = 0; i < count; ++i) {
+        char key[Item::MAX_KEY_LENGTH + 1];
+        snprintf(key, sizeof(key), "%s%u", prefix, (unsigned) i);
+        items[i] = Item(1, ItemType::U32, 1, key);
+    }
+}
+
+void test_HashList_find__same_result_as_block_list()
+{
+    HashList hashList;
+    BlockHashList blockList;
+    Item items[Page::ENTRY_COUNT];
+    // few distinct keys, so that the lists contain several entries with the same hash
+    make_hash_list_items(items, 16, "k");
+    for (size_t i = 16; i < Page::ENTRY_COUNT; ++i) {
+        items[i] = items[i % 16];
+    }
+    size_t nextIndex = 0;
+    std::mt19937 gen(42);
+
+    for (size_t round = 0; round < 5000; ++round) {
+        // like on a page, entries are only added after the last one and indices are not reused until cleared
+        for (size_t n = gen() % 8; n > 0 && nextIndex < Page::ENTRY_COUNT; --n, ++nextIndex) {
+            TEST_ASSERT_EQUAL(ESP_OK, hashList.insert(items[nextIndex], nextIndex));
+            TEST_ASSERT_EQUAL(ESP_OK, blockList.insert(items[nextIndex], nextIndex));
+        }
+        for (size_t n = gen() % 4; n > 0; --n) {
+            size_t index = gen() % Page::ENTRY_COUNT;
+            uint32_t hash = 0;
+            bool erased = hashList.erase(index, &hash);
+            TEST_ASSERT_EQUAL(blockList.erase(index), erased);
+            if (erased) {
+                TEST_ASSERT_EQUAL(items[index].calculateCrc32WithoutValue() & 0xffffff, hash);
+            }
+        }
+        for (size_t key = 0; key < 16; ++key) {
+            size_t start = gen() % Page::ENTRY_COUNT;
+            TEST_ASSERT_EQUAL(blockList.find(start, items[key]), hashList.find(start, items[key]));
+            TEST_ASSERT_EQUAL(blockList.find(0, items[key]), hashList.find(0, items[key]));
+        }
+        if (nextIndex == Page::ENTRY_COUNT && gen() % 4 == 0) {
+            nextIndex = 0;
+            hashList.clear();
+            blockList.clear();
+        }
+    }
+}
+
+template<typename TList>
+static void measure_hash_list(const char* name, const Item* items, const Item* missing, size_t count)
+{
+    const size_t ROUNDS = 2000;
+    std::chrono::steady_clock::duration insertTime{}, findTime{}, missTime{}, eraseTime{};
+    size_t found = 0;
+
+    for (size_t round = 0; round < ROUNDS; ++round) {
+        TList list;
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            list.insert(items[i], i);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            found += (list.find(0, items[i]) == i);
+        }
+        auto t2 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            found += (list.find(0, missing[i]) == SIZE_MAX);
+        }
+        auto t3 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            list.erase(i);
+        }
+        auto t4 = std::chrono::steady_clock::now();
+        insertTime += t1 - t0;
+        findTime += t2 - t1;
+        missTime += t3 - t2;
+        eraseTime += t4 - t3;
+    }
+    TEST_ASSERT_EQUAL(ROUNDS * count * 2, found);
+
+    auto perOp = [count, ROUNDS](std::chrono::steady_clock::duration d) {
+        return (long) (std::chrono::duration_cast<std::chrono::nanoseconds>(d).count() / (long) (ROUNDS * count));
+    };
+    printf("%s, %u entries: insert %ld ns, find %ld ns, find missing %ld ns, erase %ld ns\n", name, (unsigned) count,
+           perOp(insertTime), perOp(findTime), perOp(missTime), perOp(eraseTime));
+}
+
+void test_HashList_performance()
+{
+    Item items[Page::ENTRY_COUNT];
+    Item missing[Page::ENTRY_COUNT];
+    make_hash_list_items(items, Page::ENTRY_COUNT, "key");
+    make_hash_list_items(missing, Page::ENTRY_COUNT, "missing");
+
+    const size_t counts[] = {16, 64, Page::ENTRY_COUNT};
+    for (size_t count : counts) {
+        measure_hash_list<BlockHashList>("block list", items, missing, count);
+        measure_hash_list<HashList>("hash table", items, missing, count);
+    }
+}
+
 int main(int argc, char **argv)
 {
 #define TEMPORARILY_DISABLED(x)
@@ -978,6 +1191,8 @@ int main(int argc, char **argv)
     RUN_TEST(test_Page_calcEntries__active_wo_blob);
     RUN_TEST(test_Page_calcEntries__active_with_blob);
     RUN_TEST(test_Page_calcEntries__invalid);
+    RUN_TEST(test_HashList_find__same_result_as_block_list);
+    RUN_TEST(test_HashList_performance);
     int failures = UNITY_END();
     return failures;
 }
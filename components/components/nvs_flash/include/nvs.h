@@ -127,6 +127,11 @@ typedef struct {
  */
 typedef struct nvs_opaque_iterator_t *nvs_iterator_t;
 
+/**
+ * Opaque pointer type representing a blob which is written or read in pieces
+ */
+typedef struct nvs_opaque_blob_stream_t *nvs_blob_stream_t;
+
 /**
  * @brief      Open non-volatile storage with a given namespace from the default NVS partition
  *
@@ -501,6 +506,122 @@ esp_err_t nvs_get_str (nvs_handle_t handle, const char* key, char* out_value, si
 esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* out_value, size_t* length);
 /**@}*/
 
+/**
+ * @brief      Start writing a blob in pieces
+ *
+ * Blobs larger than a page are stored as a sequence of chunks. Instead of passing the whole blob
+ * in one buffer as nvs_set_blob requires, a blob stream takes the data in pieces of any size with
+ * nvs_blob_stream_write and writes a chunk as soon as enough data for it is collected,
+ * so at most one chunk (approximately 4000 bytes) of the blob is kept in RAM.
+ *
+ * The previous value of the key stays readable until nvs_blob_stream_commit replaces it.
+ * If the stream or its handle is closed without commit or the power is lost, the chunks written so far
+ * are erased (after power loss, during the next initialization). The key must not be written by other means
+ * while the stream is open.
+ *
+ * @param[in]  handle      Handle obtained from nvs_open function. Must be opened with NVS_READWRITE.
+ * @param[in]  key         Key name. Maximum length is (NVS_KEY_NAME_MAX_SIZE-1) characters. Shouldn't be empty.
+ * @param[in]  length      Total length of the blob in bytes.
+ * @param[out] out_stream  Stream to be passed to nvs_blob_stream_write and nvs_blob_stream_commit.
+ *                         Has to be released with nvs_blob_stream_close.
+ *
+ * @return
+ *             - ESP_OK if the stream was opened successfully
+ *             - ESP_ERR_NVS_INVALID_HANDLE if handle has been closed or is NULL
+ *             - ESP_ERR_NVS_READ_ONLY if storage handle was opened as read only
+ *             - ESP_ERR_NVS_KEY_TOO_LONG if the key name is too long
+ *             - ESP_ERR_NVS_VALUE_TOO_LONG if the blob is larger than the partition can hold
+ *             - ESP_ERR_INVALID_STATE if a transaction is open on the handle
+ *             - ESP_ERR_NO_MEM if memory for the stream couldn't be allocated
+ *             - ESP_ERR_INVALID_ARG if key or out_stream is NULL
+ */
+esp_err_t nvs_blob_stream_open_write(nvs_handle_t handle, const char* key, size_t length, nvs_blob_stream_t* out_stream);
+
+/**
+ * @brief      Append data to a blob opened with nvs_blob_stream_open_write
+ *
+ * @param[in]  stream   Stream obtained from nvs_blob_stream_open_write.
+ * @param[in]  data     Data to append.
+ * @param[in]  length   Length of the data in bytes. The total length of all pieces must not exceed
+ *                      the length given to nvs_blob_stream_open_write.
+ *
+ * @return
+ *             - ESP_OK if the data was written or buffered successfully
+ *             - ESP_ERR_NVS_INVALID_LENGTH if the data doesn't fit into the length of the blob
+ *             - ESP_ERR_NVS_NOT_ENOUGH_SPACE if there is not enough space in the partition
+ *             - ESP_ERR_NVS_INVALID_HANDLE if the handle of the stream has been closed
+ *             - ESP_ERR_INVALID_STATE if the stream is not open for writing or already committed
+ *             - ESP_ERR_INVALID_ARG if stream or data is NULL
+ *             - other error codes from the underlying storage driver
+ */
+esp_err_t nvs_blob_stream_write(nvs_blob_stream_t stream, const void* data, size_t length);
+
+/**
+ * @brief      Store the blob written in pieces, replacing the previous value of the key
+ *
+ * @param[in]  stream   Stream obtained from nvs_blob_stream_open_write. It still has to be closed
+ *                      with nvs_blob_stream_close.
+ *
+ * @return
+ *             - ESP_OK if the blob was stored successfully
+ *             - ESP_ERR_NVS_INVALID_LENGTH if less data than the length of the blob has been written
+ *             - ESP_ERR_NVS_NOT_ENOUGH_SPACE if there is not enough space in the partition
+ *             - ESP_ERR_NVS_REMOVE_FAILED if the previous value wasn't erased because flash write operation failed.
+ *               The blob was stored though, the previous value is erased during the next initialization.
+ *             - ESP_ERR_NVS_INVALID_HANDLE if the handle of the stream has been closed
+ *             - ESP_ERR_INVALID_STATE if the stream is not open for writing or already committed
+ *             - ESP_ERR_INVALID_ARG if stream is NULL
+ *             - other error codes from the underlying storage driver
+ */
+esp_err_t nvs_blob_stream_commit(nvs_blob_stream_t stream);
+
+/**
+ * @brief      Start reading a blob in pieces
+ *
+ * The blob is read with nvs_blob_stream_read at arbitrary offsets. The chunk containing the data is
+ * read from flash and kept in RAM, so sequential reads of small pieces read each chunk only once.
+ *
+ * @param[in]  handle      Handle obtained from nvs_open function.
+ * @param[in]  key         Key name. Maximum length is (NVS_KEY_NAME_MAX_SIZE-1) characters. Shouldn't be empty.
+ * @param[out] out_length  Total length of the blob in bytes. May be NULL.
+ * @param[out] out_stream  Stream to be passed to nvs_blob_stream_read. Has to be released with nvs_blob_stream_close.
+ *
+ * @return
+ *             - ESP_OK if the stream was opened successfully
+ *             - ESP_ERR_NVS_NOT_FOUND if the requested key doesn't exist as a blob
+ *             - ESP_ERR_NVS_INVALID_HANDLE if handle has been closed or is NULL
+ *             - ESP_ERR_NO_MEM if memory for the stream couldn't be allocated
+ *             - ESP_ERR_INVALID_ARG if key or out_stream is NULL
+ */
+esp_err_t nvs_blob_stream_open_read(nvs_handle_t handle, const char* key, size_t* out_length, nvs_blob_stream_t* out_stream);
+
+/**
+ * @brief      Read a piece of a blob opened with nvs_blob_stream_open_read
+ *
+ * @param[in]  stream    Stream obtained from nvs_blob_stream_open_read.
+ * @param[in]  offset    Offset of the piece within the blob.
+ * @param[out] out_data  Buffer for the piece.
+ * @param[in]  length    Length of the piece in bytes.
+ *
+ * @return
+ *             - ESP_OK if the piece was read successfully
+ *             - ESP_ERR_NVS_INVALID_LENGTH if the piece exceeds the end of the blob
+ *             - ESP_ERR_NVS_NOT_FOUND if a chunk of the blob is missing or corrupted, or the blob was replaced
+ *             - ESP_ERR_NVS_INVALID_HANDLE if the handle of the stream has been closed
+ *             - ESP_ERR_INVALID_STATE if the stream is not open for reading
+ *             - ESP_ERR_INVALID_ARG if stream or out_data is NULL
+ */
+esp_err_t nvs_blob_stream_read(nvs_blob_stream_t stream, size_t offset, void* out_data, size_t length);
+
+/**
+ * @brief      Release a blob stream
+ *
+ * A blob stream opened for writing and not committed is discarded, the previous value of the key is kept.
+ *
+ * @param[in]  stream   Stream to be released. If NULL, this function does nothing.
+ */
+void nvs_blob_stream_close(nvs_blob_stream_t stream);
+
 /**
  * @brief      Lookup key-value pair with given key name.
  *
@@ -635,6 +756,36 @@ typedef struct {
  */
 esp_err_t nvs_get_stats(const char *part_name, nvs_stats_t *nvs_stats);
 
+/**
+ * @note Statistics of the value cache of an NVS partition, see CONFIG_NVS_VALUE_CACHE_SIZE.
+ */
+typedef struct {
+    size_t size;              /**< Size of the cache in bytes, 0 if the cache is disabled. */
+    size_t used_bytes;        /**< Number of bytes currently used by cached values. */
+    uint32_t hits;            /**< Number of reads served from the cache. */
+    uint32_t misses;          /**< Number of reads which had to access flash. */
+    uint32_t evictions;       /**< Number of values removed from the cache to make room for others. */
+} nvs_cache_stats_t;
+
+/**
+ * @brief      Fill structure nvs_cache_stats_t. It provides info about the value cache of a partition.
+ *
+ * Values read by nvs_get_* functions are kept in a cache of CONFIG_NVS_VALUE_CACHE_SIZE bytes,
+ * so repeated reads of the same key don't access flash. Writing or erasing a key removes it from the cache.
+ * The hit and miss counters can be used to choose the cache size.
+ *
+ * @param[in]   part_name   Partition name NVS in the partition table.
+ *                          If pass a NULL than will use NVS_DEFAULT_PART_NAME ("nvs").
+ *
+ * @param[out]  cache_stats Returns filled structure nvs_cache_stats_t.
+ *
+ * @return
+ *             - ESP_OK if cache_stats has been filled.
+ *             - ESP_ERR_NVS_NOT_INITIALIZED if the storage driver is not initialized.
+ *             - ESP_ERR_INVALID_ARG if cache_stats is equal to NULL.
+ */
+esp_err_t nvs_get_cache_stats(const char *part_name, nvs_cache_stats_t *cache_stats);
+
 /**
  * @brief      Calculate all entries in a namespace.
  *
@@ -210,9 +210,49 @@ public:
      * Commits all changes done through this handle so far.
      * Currently, NVS writes to storage right after the set and get functions,
      * but this is not guaranteed.
+     *
+     * If a transaction has been started by begin_transaction(), the values set since then are written now.
+     * If they fit into one page, they are written together with a single data write and a single entry table
+     * write, and the old values are erased with one more entry table write per page. Otherwise they are written
+     * one after another. In case of a power-off during commit, each item keeps either its old or its new value.
+     * The transaction is closed in either case.
      */
     virtual esp_err_t commit() = 0;
 
+    /**
+     * @brief Starts a transaction.
+     *
+     * Until commit() or abort_transaction() is called, set_item() and set_string() only record the new values
+     * in RAM instead of writing them to flash. Get functions still return the values stored in flash.
+     * Blobs can't be part of a transaction, set_blob(), erase_item() and erase_all() return
+     * ESP_ERR_INVALID_STATE while a transaction is open.
+     *
+     * @return
+     *             - ESP_OK if the transaction has been started
+     *             - ESP_ERR_NVS_INVALID_HANDLE if the handle has been closed or is NULL
+     *             - ESP_ERR_NVS_READ_ONLY if the handle was opened as read only
+     *             - ESP_ERR_INVALID_STATE if a transaction is already open on this handle
+     *             - ESP_ERR_NOT_SUPPORTED if the handle implementation doesn't support transactions
+     */
+    virtual esp_err_t begin_transaction()
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    /**
+     * @brief Discards all values set since begin_transaction() and closes the transaction.
+     *
+     * @return
+     *             - ESP_OK if the transaction has been discarded
+     *             - ESP_ERR_NVS_INVALID_HANDLE if the handle has been closed or is NULL
+     *             - ESP_ERR_INVALID_STATE if no transaction is open on this handle
+     *             - ESP_ERR_NOT_SUPPORTED if the handle implementation doesn't support transactions
+     */
+    virtual esp_err_t abort_transaction()
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
     /**
      * @brief      Calculate all entries in the scope of the handle.
      *
@@ -538,6 +538,147 @@ extern "C" esp_err_t nvs_get_blob(nvs_handle_t c_handle, const char* key, void*
     return nvs_get_str_or_blob(c_handle, nvs::ItemType::BLOB, key, out_value, length);
 }
 
+struct nvs_opaque_blob_stream_t : public ExceptionlessAllocatable
+{
+    nvs_handle_t handle;
+    bool write;
+    nvs::Storage::BlobStream stream;
+};
+
+extern "C" esp_err_t nvs_blob_stream_open_write(nvs_handle_t c_handle, const char* key, size_t length, nvs_blob_stream_t* out_stream)
+{
+    if (key == nullptr || out_stream == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    Lock lock;
+    ESP_LOGD(TAG, "%s %s %d", __func__, key, static_cast<int>(length));
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    nvs_blob_stream_t stream = new (std::nothrow) nvs_opaque_blob_stream_t;
+    if (stream == nullptr) {
+        return ESP_ERR_NO_MEM;
+    }
+    stream->handle = c_handle;
+    stream->write = true;
+    err = handle->open_blob_stream_write(key, length, stream->stream);
+    if (err != ESP_OK) {
+        delete stream;
+        return err;
+    }
+
+    *out_stream = stream;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t nvs_blob_stream_write(nvs_blob_stream_t stream, const void* data, size_t length)
+{
+    if (stream == nullptr || (data == nullptr && length > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    Lock lock;
+    ESP_LOGD(TAG, "%s %s %d", __func__, stream->stream.mKey, static_cast<int>(length));
+    if (!stream->write) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(stream->handle, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return handle->write_blob_stream(stream->stream, data, length);
+}
+
+extern "C" esp_err_t nvs_blob_stream_commit(nvs_blob_stream_t stream)
+{
+    if (stream == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    Lock lock;
+    ESP_LOGD(TAG, "%s %s", __func__, stream->stream.mKey);
+    if (!stream->write) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(stream->handle, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return handle->commit_blob_stream(stream->stream);
+}
+
+extern "C" esp_err_t nvs_blob_stream_open_read(nvs_handle_t c_handle, const char* key, size_t* out_length, nvs_blob_stream_t* out_stream)
+{
+    if (key == nullptr || out_stream == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    Lock lock;
+    ESP_LOGD(TAG, "%s %s", __func__, key);
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    nvs_blob_stream_t stream = new (std::nothrow) nvs_opaque_blob_stream_t;
+    if (stream == nullptr) {
+        return ESP_ERR_NO_MEM;
+    }
+    stream->handle = c_handle;
+    stream->write = false;
+    err = handle->open_blob_stream_read(key, stream->stream);
+    if (err != ESP_OK) {
+        delete stream;
+        return err;
+    }
+
+    if (out_length != nullptr) {
+        *out_length = stream->stream.mDataSize;
+    }
+    *out_stream = stream;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t nvs_blob_stream_read(nvs_blob_stream_t stream, size_t offset, void* out_data, size_t length)
+{
+    if (stream == nullptr || (out_data == nullptr && length > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    Lock lock;
+    ESP_LOGD(TAG, "%s %s %d %d", __func__, stream->stream.mKey, static_cast<int>(offset), static_cast<int>(length));
+    if (stream->write) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(stream->handle, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return handle->read_blob_stream(stream->stream, offset, out_data, length);
+}
+
+extern "C" void nvs_blob_stream_close(nvs_blob_stream_t stream)
+{
+    if (stream == nullptr) {
+        return;
+    }
+
+    Lock lock;
+    NVSHandleSimple *handle;
+    if (stream->write && nvs_find_ns_handle(stream->handle, &handle) == ESP_OK) {
+        handle->abort_blob_stream(stream->stream);
+    }
+    delete stream;
+}
+
 extern "C" esp_err_t nvs_get_stats(const char* part_name, nvs_stats_t* nvs_stats)
 {
     Lock lock;
@@ -564,6 +705,25 @@ extern "C" esp_err_t nvs_get_stats(const char* part_name, nvs_stats_t* nvs_stats
     return pStorage->fillStats(*nvs_stats);
 }
 
+extern "C" esp_err_t nvs_get_cache_stats(const char* part_name, nvs_cache_stats_t* cache_stats)
+{
+    Lock lock;
+    nvs::Storage* pStorage;
+
+    if (cache_stats == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(cache_stats, 0, sizeof(*cache_stats));
+
+    pStorage = lookup_storage_from_name((part_name == nullptr) ? NVS_DEFAULT_PART_NAME : part_name);
+    if (pStorage == nullptr) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    pStorage->fillCacheStats(*cache_stats);
+    return ESP_OK;
+}
+
 extern "C" esp_err_t nvs_get_used_entry_count(nvs_handle_t c_handle, size_t* used_entries)
 {
     Lock lock;
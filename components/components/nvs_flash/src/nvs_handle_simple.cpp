@@ -1,15 +1,24 @@
 /*
- * SPDX-FileCopyrightText: 2015-2023 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <cstdlib>
+#include <cstring>
+#if __has_include(<bsd/string.h>)
+// for strlcpy
+#include <bsd/string.h>
+#endif
 #include "nvs_handle.hpp"
 #include "nvs_partition_manager.hpp"
 
 namespace nvs {
 
 NVSHandleSimple::~NVSHandleSimple() {
+    clearTransaction();
+    while (!mWriteStreams.empty()) {
+        abort_blob_stream(mWriteStreams.front());
+    }
     NVSPartitionManager::get_instance()->close_handle(this);
 }
 
@@ -17,6 +26,7 @@ esp_err_t NVSHandleSimple::set_typed_item(ItemType datatype, const char *key, co
 {
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
     if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
+    if (mInTransaction) return stageItem(datatype, key, data, dataSize);
 
     return mStoragePtr->writeItem(mNsIndex, datatype, key, data, dataSize);
 }
@@ -32,6 +42,7 @@ esp_err_t NVSHandleSimple::set_string(const char *key, const char* str)
 {
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
     if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
+    if (mInTransaction) return stageItem(nvs::ItemType::SZ, key, str, strlen(str) + 1);
 
     return mStoragePtr->writeItem(mNsIndex, nvs::ItemType::SZ, key, str, strlen(str) + 1);
 }
@@ -40,6 +51,7 @@ esp_err_t NVSHandleSimple::set_blob(const char *key, const void* blob, size_t le
 {
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
     if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
+    if (mInTransaction) return ESP_ERR_INVALID_STATE;
 
     return mStoragePtr->writeItem(mNsIndex, nvs::ItemType::BLOB, key, blob, len);
 }
@@ -86,6 +98,7 @@ esp_err_t NVSHandleSimple::erase_item(const char* key)
 {
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
     if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
+    if (mInTransaction) return ESP_ERR_INVALID_STATE;
 
     return mStoragePtr->eraseItem(mNsIndex, key);
 }
@@ -94,6 +107,7 @@ esp_err_t NVSHandleSimple::erase_all()
 {
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
     if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
+    if (mInTransaction) return ESP_ERR_INVALID_STATE;
 
     return mStoragePtr->eraseNamespace(mNsIndex);
 }
@@ -101,10 +115,86 @@ esp_err_t NVSHandleSimple::erase_all()
 esp_err_t NVSHandleSimple::commit()
 {
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (!mInTransaction) return ESP_OK;
+
+    esp_err_t err = mStoragePtr->writeItems(mNsIndex, mTransaction);
+    clearTransaction();
+    return err;
+}
+
+esp_err_t NVSHandleSimple::begin_transaction()
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
+    if (mInTransaction) return ESP_ERR_INVALID_STATE;
+
+    mInTransaction = true;
+    return ESP_OK;
+}
+
+esp_err_t NVSHandleSimple::abort_transaction()
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (!mInTransaction) return ESP_ERR_INVALID_STATE;
 
+    clearTransaction();
     return ESP_OK;
 }
 
+esp_err_t NVSHandleSimple::stageItem(ItemType datatype, const char *key, const void* data, size_t dataSize)
+{
+    if (strlen(key) > Item::MAX_KEY_LENGTH) return ESP_ERR_NVS_KEY_TOO_LONG;
+    if (dataSize > Page::CHUNK_MAX_SIZE) return ESP_ERR_NVS_VALUE_TOO_LONG;
+
+    Storage::BatchItem* item = nullptr;
+    for (auto it = mTransaction.begin(); it != mTransaction.end(); ++it) {
+        if (strcmp(it->mKey, key) == 0
+#ifdef CONFIG_NVS_LEGACY_DUP_KEYS_COMPATIBILITY
+                && it->mDatatype == datatype
+#endif
+           ) {
+            item = it;
+            break;
+        }
+    }
+
+    uint8_t* stringData = nullptr;
+    if (isVariableLengthType(datatype)) {
+        stringData = new (std::nothrow) uint8_t[dataSize];
+        if (!stringData) return ESP_ERR_NO_MEM;
+        memcpy(stringData, data, dataSize);
+    }
+
+    if (!item) {
+        item = new (std::nothrow) Storage::BatchItem;
+        if (!item) {
+            delete[] stringData;
+            return ESP_ERR_NO_MEM;
+        }
+        strlcpy(item->mKey, key, sizeof(item->mKey));
+        mTransaction.push_back(item);
+    }
+
+    item->mDatatype = datatype;
+    item->mDataSize = dataSize;
+    delete[] item->mData;
+    item->mData = stringData;
+    if (!stringData) {
+        memcpy(item->mValue, data, dataSize);
+    }
+    return ESP_OK;
+}
+
+void NVSHandleSimple::clearTransaction()
+{
+    while (!mTransaction.empty()) {
+        auto item = mTransaction.begin();
+        mTransaction.erase(item);
+        delete (Storage::BatchItem*)item;
+    }
+    mInTransaction = false;
+}
+
 esp_err_t NVSHandleSimple::get_used_entry_count(size_t& used_entries)
 {
     used_entries = 0;
@@ -143,6 +233,55 @@ bool NVSHandleSimple::nextEntry(nvs_opaque_iterator_t* it) {
     return mStoragePtr->nextEntry(it);
 }
 
+esp_err_t NVSHandleSimple::open_blob_stream_write(const char *key, size_t len, Storage::BlobStream &stream)
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
+    if (mInTransaction) return ESP_ERR_INVALID_STATE;
+
+    esp_err_t err = mStoragePtr->openBlobStreamWrite(mNsIndex, key, len, stream);
+    if (err == ESP_OK) {
+        mWriteStreams.push_back(&stream);
+    }
+    return err;
+}
+
+esp_err_t NVSHandleSimple::write_blob_stream(Storage::BlobStream &stream, const void *data, size_t len)
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+
+    return mStoragePtr->writeBlobStream(stream, data, len);
+}
+
+esp_err_t NVSHandleSimple::commit_blob_stream(Storage::BlobStream &stream)
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+
+    return mStoragePtr->commitBlobStream(stream);
+}
+
+void NVSHandleSimple::abort_blob_stream(Storage::BlobStream &stream)
+{
+    mWriteStreams.erase(&stream);
+    if (!valid) return;
+
+    mStoragePtr->abortBlobStream(stream);
+}
+
+esp_err_t NVSHandleSimple::open_blob_stream_read(const char *key, Storage::BlobStream &stream)
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+
+    return mStoragePtr->openBlobStreamRead(mNsIndex, key, stream);
+}
+
+esp_err_t NVSHandleSimple::read_blob_stream(Storage::BlobStream &stream, size_t offset, void *out_data, size_t len)
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+
+    return mStoragePtr->readBlobStream(stream, offset, out_data, len);
+}
+
 const char *NVSHandleSimple::get_partition_name() const {
     return mStoragePtr->getPartName();
 }
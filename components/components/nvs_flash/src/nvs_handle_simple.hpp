@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2022 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -59,6 +59,10 @@ public:
 
     esp_err_t commit() override;
 
+    esp_err_t begin_transaction() override;
+
+    esp_err_t abort_transaction() override;
+
     esp_err_t get_used_entry_count(size_t &usedEntries) override;
 
     esp_err_t getItemDataSize(ItemType datatype, const char *key, size_t &dataSize);
@@ -75,11 +79,33 @@ public:
 
     bool nextEntry(nvs_opaque_iterator_t *it);
 
+    /**
+     * Blob streams, see nvs_blob_stream_open_write() and nvs_blob_stream_open_read().
+     */
+    esp_err_t open_blob_stream_write(const char *key, size_t len, Storage::BlobStream &stream);
+
+    esp_err_t write_blob_stream(Storage::BlobStream &stream, const void *data, size_t len);
+
+    esp_err_t commit_blob_stream(Storage::BlobStream &stream);
+
+    void abort_blob_stream(Storage::BlobStream &stream);
+
+    esp_err_t open_blob_stream_read(const char *key, Storage::BlobStream &stream);
+
+    esp_err_t read_blob_stream(Storage::BlobStream &stream, size_t offset, void *out_data, size_t len);
+
     const char *get_partition_name() const;
 
     Storage *get_storage() const;
 
 private:
+    /**
+     * Records a value of an open transaction, replacing a value recorded earlier for the same key.
+     */
+    esp_err_t stageItem(ItemType datatype, const char *key, const void *data, size_t dataSize);
+
+    void clearTransaction();
+
     /**
      * The underlying storage's object.
      */
@@ -101,6 +127,21 @@ private:
      * Upon opening, a handle is valid. It becomes invalid if the underlying storage is de-initialized.
      */
     uint8_t valid;
+
+    /**
+     * Whether begin_transaction() has been called and the transaction is neither committed nor aborted yet.
+     */
+    bool mInTransaction = false;
+
+    /**
+     * Values set during the open transaction.
+     */
+    Storage::TBatch mTransaction;
+
+    /**
+     * Write streams opened with this handle and not closed yet, aborted when the handle is closed.
+     */
+    intrusive_list<Storage::BlobStream> mWriteStreams;
 };
 
 } // nvs
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include "nvs_item_hash_list.hpp"
+#include "nvs_constants.h"
+#include <algorithm>
 
 namespace nvs
 {
@@ -23,12 +25,11 @@ HashList::HashList()
 
 void HashList::clear()
 {
-    for (auto it = mBlockList.begin(); it != mBlockList.end();) {
-        auto tmp = it;
-        ++it;
-        mBlockList.erase(tmp);
-        delete static_cast<HashListBlock*>(tmp);
-    }
+    delete[] mGroups;
+    mGroups = nullptr;
+    mGroupCount = 0;
+    mCount = 0;
+    mDeletedCount = 0;
 }
 
 HashList::~HashList()
@@ -36,88 +37,122 @@ HashList::~HashList()
     clear();
 }
 
-HashList::HashListBlock::HashListBlock()
+esp_err_t HashList::resize(size_t groupCount)
 {
-    static_assert(sizeof(HashListBlock) == HashListBlock::BYTE_SIZE,
-                  "cache block size calculation incorrect");
+    HashListGroup* newGroups = new (std::nothrow) HashListGroup[groupCount];
+    if (!newGroups) return ESP_ERR_NO_MEM;
+
+    for (size_t i = 0; i < groupCount; ++i) {
+        for (size_t j = 0; j < GROUP_SIZE; ++j) {
+            newGroups[i].mIndices[j] = INDEX_EMPTY;
+        }
+    }
+
+    HashListGroup* oldGroups = mGroups;
+    size_t oldGroupCount = mGroupCount;
+    mGroups = newGroups;
+    mGroupCount = groupCount;
+    mDeletedCount = 0;
+    for (size_t i = 0; i < oldGroupCount; ++i) {
+        for (size_t j = 0; j < GROUP_SIZE; ++j) {
+            if (oldGroups[i].mIndices[j] < INDEX_DELETED) {
+                place(oldGroups[i].hashAt(j), oldGroups[i].mIndices[j]);
+            }
+        }
+    }
+    delete[] oldGroups;
+    return ESP_OK;
+}
+
+void HashList::place(uint32_t hash, uint8_t index)
+{
+    size_t group = homeGroup(hash);
+    uint32_t free;
+    while ((free = mGroups[group].matchFree()) == 0) {
+        group = (group + 1 == mGroupCount) ? 0 : group + 1;
+    }
+    HashListGroup& g = mGroups[group];
+    const size_t slot = __builtin_ctz(free);
+    if (g.mIndices[slot] == INDEX_DELETED) {
+        --mDeletedCount;
+    }
+    g.mHashLow[slot] = hash & 0xffff;
+    g.mHashHigh[slot] = hash >> 16;
+    g.mIndices[slot] = index;
 }
 
 esp_err_t HashList::insert(const Item& item, size_t index)
 {
     const uint32_t hash_24 = item.calculateCrc32WithoutValue() & 0xffffff;
-    // add entry to the end of last block if possible
-    if (mBlockList.size()) {
-        auto& block = mBlockList.back();
-        if (block.mCount < HashListBlock::ENTRY_COUNT) {
-            block.mNodes[block.mCount++] = HashListNode(hash_24, index);
-            return ESP_OK;
+    // grow (or just drop deleted slots) if the load would exceed 4/5; leave room for a few more items,
+    // but do not allocate more than needed for a full page
+    if ((mCount + mDeletedCount + 1) * 5 > capacity() * 4) {
+        const size_t items = std::max(std::min(mCount + 1 + GROWTH_ITEMS, (size_t) NVS_CONST_ENTRY_COUNT), mCount + 1);
+        esp_err_t err = resize((items * 5 / 4 + GROUP_SIZE - 1) / GROUP_SIZE);
+        if (err != ESP_OK) {
+            return err;
         }
     }
-    // if the above failed, create a new block and add entry to it
-    HashListBlock* newBlock = new (std::nothrow) HashListBlock;
-
-    if (!newBlock) return ESP_ERR_NO_MEM;
-
-    mBlockList.push_back(newBlock);
-    newBlock->mNodes[0] = HashListNode(hash_24, index);
-    newBlock->mCount++;
 
+    place(hash_24, (uint8_t) index);
+    ++mCount;
     return ESP_OK;
 }
 
-bool HashList::erase(size_t index)
+bool HashList::erase(size_t index, uint32_t* hash)
 {
-    for (auto it = mBlockList.begin(); it != mBlockList.end();) {
-        bool haveEntries = false;
-        bool foundIndex = false;
-        for (size_t i = 0; i < it->mCount; ++i) {
-            if (it->mNodes[i].mIndex == index) {
-                it->mNodes[i].mIndex = 0xff;
-                foundIndex = true;
-                /* found the item and removed it */
+    for (size_t group = 0; group < mGroupCount; ++group) {
+        HashListGroup& g = mGroups[group];
+        for (size_t slot = 0; slot < GROUP_SIZE; ++slot) {
+            if (g.mIndices[slot] != index) {
+                continue;
             }
-            if (it->mNodes[i].mIndex != 0xff) {
-                haveEntries = true;
+            if (hash) {
+                *hash = g.hashAt(slot);
             }
-            if (haveEntries && foundIndex) {
-                /* item was found, and HashListBlock still has some items */
+            if (--mCount == 0) {
+                clear();
                 return true;
             }
-        }
-        /* no items left in HashListBlock, can remove */
-        if (!haveEntries) {
-            auto tmp = it;
-            ++it;
-            mBlockList.erase(tmp);
-            delete static_cast<HashListBlock*>(tmp);
-        } else {
-            ++it;
-        }
-        if (foundIndex) {
-            /* item was found and empty HashListBlock was removed */
+            // Lookups only stop at a group with an empty slot. If this group has one, no item has been placed
+            // past it, so the slot can become empty as well. Otherwise it has to be skipped by lookups.
+            if (g.matchIndex(INDEX_EMPTY)) {
+                g.mIndices[slot] = INDEX_EMPTY;
+            } else {
+                g.mIndices[slot] = INDEX_DELETED;
+                ++mDeletedCount;
+            }
             return true;
         }
     }
 
-    // item hasn't been present in cache");
+    // item hasn't been present in cache
     return false;
 }
 
 size_t HashList::find(size_t start, const Item& item)
 {
+    if (mCount == 0) {
+        return SIZE_MAX;
+    }
+
     const uint32_t hash_24 = item.calculateCrc32WithoutValue() & 0xffffff;
-    for (auto it = mBlockList.begin(); it != mBlockList.end(); ++it) {
-        for (size_t index = 0; index < it->mCount; ++index) {
-            HashListNode& e = it->mNodes[index];
-            if (e.mIndex >= start &&
-                    e.mHash == hash_24 &&
-                    e.mIndex != 0xff) {
-                return e.mIndex;
+    size_t group = homeGroup(hash_24);
+    size_t result = SIZE_MAX;
+    for (size_t n = 0; n < mGroupCount; ++n) {
+        const HashListGroup& g = mGroups[group];
+        for (uint32_t matches = g.matchHash(hash_24); matches; matches &= matches - 1) {
+            const size_t index = g.mIndices[__builtin_ctz(matches)];
+            if (index >= start && index < result) {
+                result = index;
             }
         }
+        if (g.matchIndex(INDEX_EMPTY)) {
+            break;
+        }
+        group = (group + 1 == mGroupCount) ? 0 : group + 1;
     }
-    return SIZE_MAX;
+    return result;
 }
 
-
 } // namespace nvs
@@ -0,0 +1,158 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "nvs_item_index.hpp"
+#include "nvs_page.hpp"
+
+namespace nvs
+{
+
+ItemIndex::ItemIndex()
+{
+}
+
+ItemIndex::~ItemIndex()
+{
+    clear();
+}
+
+void ItemIndex::clear()
+{
+    delete[] mSlots;
+    mSlots = nullptr;
+    mCapacity = 0;
+    mCount = 0;
+    mPendingPages = 0;
+}
+
+esp_err_t ItemIndex::grow()
+{
+    size_t newCapacity = (mCapacity == 0) ? MIN_CAPACITY : mCapacity * 2;
+    Slot* newSlots = new (std::nothrow) Slot[newCapacity];
+    if (!newSlots) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (size_t i = 0; i < newCapacity; ++i) {
+        newSlots[i].mPage = nullptr;
+    }
+
+    Slot* oldSlots = mSlots;
+    size_t oldCapacity = mCapacity;
+    mSlots = newSlots;
+    mCapacity = newCapacity;
+    for (size_t i = 0; i < oldCapacity; ++i) {
+        if (oldSlots[i].mPage != nullptr) {
+            place(oldSlots[i]);
+        }
+    }
+    delete[] oldSlots;
+    return ESP_OK;
+}
+
+void ItemIndex::place(const Slot& slot)
+{
+    size_t pos = home(slot.mHash);
+    while (mSlots[pos].mPage != nullptr) {
+        pos = (pos + 1) & (mCapacity - 1);
+    }
+    mSlots[pos] = slot;
+}
+
+esp_err_t ItemIndex::insert(const Item& item, Page* page, size_t index)
+{
+    // keep the load factor below 3/4 so that probe sequences stay short
+    if ((mCount + 1) * 4 > mCapacity * 3) {
+        esp_err_t err = grow();
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    Slot slot;
+    slot.mPage = page;
+    slot.mIndex = (uint32_t) index;
+    slot.mHash = hash(item);
+    place(slot);
+    ++mCount;
+    return ESP_OK;
+}
+
+// Backward shift deletion: entries following the removed one are moved into the hole
+// unless their home position lies cyclically between the hole and their current position.
+void ItemIndex::eraseSlot(size_t pos)
+{
+    const size_t mask = mCapacity - 1;
+    size_t hole = pos;
+    mSlots[hole].mPage = nullptr;
+    for (size_t i = (hole + 1) & mask; mSlots[i].mPage != nullptr; i = (i + 1) & mask) {
+        size_t h = home(mSlots[i].mHash);
+        bool stays = (hole <= i) ? (hole < h && h <= i) : (hole < h || h <= i);
+        if (!stays) {
+            mSlots[hole] = mSlots[i];
+            mSlots[i].mPage = nullptr;
+            hole = i;
+        }
+    }
+    --mCount;
+}
+
+void ItemIndex::erase(uint32_t hash, const Page* page, size_t index)
+{
+    if (mCount == 0) {
+        return;
+    }
+    for (size_t pos = home(hash); mSlots[pos].mPage != nullptr; pos = (pos + 1) & (mCapacity - 1)) {
+        if (mSlots[pos].mPage == page && mSlots[pos].mIndex == index && mSlots[pos].mHash == hash) {
+            eraseSlot(pos);
+            return;
+        }
+    }
+}
+
+void ItemIndex::erasePage(const Page* page)
+{
+    // Entries only ever move towards the hole being filled, so re-checking the same
+    // position after a removal is enough to visit every entry once.
+    for (size_t pos = 0; mCount > 0 && pos < mCapacity;) {
+        if (mSlots[pos].mPage == page) {
+            eraseSlot(pos);
+        } else {
+            ++pos;
+        }
+    }
+}
+
+size_t ItemIndex::findPages(const Item& item, Page** pages, size_t maxCount) const
+{
+    if (mCount == 0) {
+        return 0;
+    }
+
+    const uint32_t itemHash = hash(item);
+    size_t found = 0;
+    for (size_t pos = home(itemHash); mSlots[pos].mPage != nullptr; pos = (pos + 1) & (mCapacity - 1)) {
+        const Slot& slot = mSlots[pos];
+        if (slot.mHash != itemHash) {
+            continue;
+        }
+        bool known = false;
+        for (size_t i = 0; i < found; ++i) {
+            if (pages[i] == slot.mPage) {
+                known = true;
+                break;
+            }
+        }
+        if (known) {
+            continue;
+        }
+        if (found == maxCount) {
+            return maxCount + 1;
+        }
+        pages[found++] = slot.mPage;
+    }
+    return found;
+}
+
+} // namespace nvs
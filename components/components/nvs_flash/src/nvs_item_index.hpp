@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef nvs_item_index_hpp
+#define nvs_item_index_hpp
+
+#include "nvs.h"
+#include "nvs_types.hpp"
+#include "nvs_memory_management.hpp"
+
+namespace nvs
+{
+
+class Page;
+
+/**
+ * Partition-wide index of the items stored in all pages of one PageManager.
+ *
+ * It mirrors the per-page HashList entries: every (hash, entry index) pair a page puts into its own HashList
+ * is also recorded here together with the page. This allows Storage to go directly to the page(s) which
+ * may contain an item instead of asking every page of the partition.
+ *
+ * The hash is the same 24-bit hash of namespace index, key and chunk index as used by HashList, so the index
+ * may return false positives. Callers have to confirm a match by Page::findItem.
+ *
+ * Implemented as an open-addressed table with linear probing, which grows by doubling its capacity.
+ */
+class ItemIndex
+{
+public:
+    ItemIndex();
+    ~ItemIndex();
+
+    esp_err_t insert(const Item& item, Page* page, size_t index);
+
+    void erase(uint32_t hash, const Page* page, size_t index);
+
+    void erasePage(const Page* page);
+
+    /**
+     * Collects distinct pages which contain an entry with the same hash as item.
+     *
+     * @return number of pages found. If it is greater than maxCount, only the first maxCount pages were stored.
+     */
+    size_t findPages(const Item& item, Page** pages, size_t maxCount) const;
+
+    void clear();
+
+    /**
+     * Pages which were loaded without reading their items (see Page::load) are not in the index yet.
+     * As long as there are such pages, the index can't tell that an item doesn't exist.
+     */
+    void addPendingPage()
+    {
+        ++mPendingPages;
+    }
+
+    void removePendingPage()
+    {
+        --mPendingPages;
+    }
+
+    bool hasPendingPages() const
+    {
+        return mPendingPages > 0;
+    }
+
+    size_t size() const
+    {
+        return mCount;
+    }
+
+    static uint32_t hash(const Item& item)
+    {
+        return item.calculateCrc32WithoutValue() & 0xffffff;
+    }
+
+private:
+    ItemIndex(const ItemIndex& other);
+    const ItemIndex& operator= (const ItemIndex& rhs);
+
+protected:
+    struct Slot : public ExceptionlessAllocatable {
+        Page* mPage;
+        uint32_t mIndex : 8;
+        uint32_t mHash  : 24;
+    };
+
+    static const size_t MIN_CAPACITY = 64;
+
+    size_t home(uint32_t hash) const
+    {
+        return hash & (mCapacity - 1);
+    }
+
+    esp_err_t grow();
+
+    void place(const Slot& slot);
+
+    void eraseSlot(size_t pos);
+
+    Slot* mSlots = nullptr;
+    size_t mCapacity = 0;
+    size_t mCount = 0;
+    size_t mPendingPages = 0;
+}; // class ItemIndex
+
+} // namespace nvs
+
+#endif /* nvs_item_index_hpp */
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -24,16 +24,18 @@ uint32_t Page::Header::calculateCrc32()
                             offsetof(Header, mCrc32) - offsetof(Header, mSeqNumber));
 }
 
-esp_err_t Page::load(Partition *partition, uint32_t sectorNumber)
+esp_err_t Page::load(Partition *partition, uint32_t sectorNumber, ItemIndex *itemIndex, bool deferItems)
 {
     if (partition == nullptr) {
         return ESP_ERR_INVALID_ARG;
     }
 
     mPartition = partition;
+    mItemIndex = itemIndex;
     mBaseAddress = sectorNumber * SEC_SIZE;
     mUsedEntryCount = 0;
     mErasedEntryCount = 0;
+    mItemsLoaded = true;
 
     Header header;
     auto rc = mPartition->read_raw(mBaseAddress, &header, sizeof(header));
@@ -85,7 +87,7 @@ esp_err_t Page::load(Partition *partition, uint32_t sectorNumber)
     case PageState::FULL:
     case PageState::ACTIVE:
     case PageState::FREEING:
-        return mLoadEntryTable();
+        return mLoadEntryTable(deferItems);
         break;
 
     default:
@@ -96,14 +98,27 @@ esp_err_t Page::load(Partition *partition, uint32_t sectorNumber)
     return ESP_OK;
 }
 
-esp_err_t Page::writeEntry(const Item &item)
+esp_err_t Page::writeEntries(size_t index, const void* data, size_t size)
 {
+    if (mBatch) {
+        NVS_ASSERT_OR_RETURN(index >= mBatch->mFirstEntry, ESP_FAIL);
+        const size_t offset = (index - mBatch->mFirstEntry) * ENTRY_SIZE;
+        NVS_ASSERT_OR_RETURN(offset + size <= mBatch->mEntryCount * ENTRY_SIZE, ESP_FAIL);
+        memcpy(mBatch->mData + offset, data, size);
+        return ESP_OK;
+    }
+
     uint32_t phyAddr;
-    esp_err_t err = getEntryAddress(mNextFreeEntry, &phyAddr);
+    esp_err_t err = getEntryAddress(index, &phyAddr);
     if (err != ESP_OK) {
         return err;
     }
-    err = mPartition->write(phyAddr, &item, sizeof(item));
+    return mPartition->write(phyAddr, data, size);
+}
+
+esp_err_t Page::writeEntry(const Item &item)
+{
+    esp_err_t err = writeEntries(mNextFreeEntry, &item, sizeof(item));
 
     if (err != ESP_OK) {
         mState = PageState::INVALID;
@@ -132,11 +147,7 @@ esp_err_t Page::writeEntryData(const uint8_t* data, size_t size)
     NVS_ASSERT_OR_RETURN(mFirstUsedEntry != INVALID_ENTRY, ESP_FAIL);
     const uint16_t count = size / ENTRY_SIZE;
 
-    uint32_t phyAddr;
-    esp_err_t rc = getEntryAddress(mNextFreeEntry, &phyAddr);
-    if (rc == ESP_OK) {
-        rc = mPartition->write(phyAddr, data, size);
-    }
+    esp_err_t rc = writeEntries(mNextFreeEntry, data, size);
     if (rc != ESP_OK) {
         mState = PageState::INVALID;
         return rc;
@@ -203,7 +214,7 @@ esp_err_t Page::writeItem(uint8_t nsIndex, ItemType datatype, const char* key, c
     // write first item
     size_t span = (totalSize + ENTRY_SIZE - 1) / ENTRY_SIZE;
     item = Item(nsIndex, datatype, span, key, chunkIdx);
-    err = mHashList.insert(item, mNextFreeEntry);
+    err = hashListInsert(item, mNextFreeEntry);
 
     if (err != ESP_OK) {
         return err;
@@ -413,8 +424,13 @@ esp_err_t Page::eraseEntryAndSpan(size_t index)
     uint32_t seq_num;
     getSeqNumber(seq_num);
 
+    esp_err_t err = ensureItemsLoaded();
+    if (err != ESP_OK) {
+        return err;
+    }
+
     EntryState state;
-    esp_err_t err = mEntryTable.get(index, &state);
+    err = mEntryTable.get(index, &state);
     if (err != ESP_OK) {
         return err;
     }
@@ -427,7 +443,7 @@ esp_err_t Page::eraseEntryAndSpan(size_t index)
             return rc;
         }
         if (!item.checkHeaderConsistency(index)) {
-            mHashList.erase(index);
+            hashListErase(index);
             rc = alterEntryState(index, EntryState::ERASED);
             --mUsedEntryCount;
             ++mErasedEntryCount;
@@ -435,7 +451,7 @@ esp_err_t Page::eraseEntryAndSpan(size_t index)
                 return rc;
             }
         } else {
-            mHashList.erase(index);
+            hashListErase(index);
             span = item.span;
             for (ptrdiff_t i = index + span - 1; i >= static_cast<ptrdiff_t>(index); --i) {
                 rc = mEntryTable.get(i, &state);
@@ -500,6 +516,35 @@ esp_err_t Page::updateFirstUsedEntry(size_t index, size_t span)
     return ESP_OK;
 }
 
+esp_err_t Page::hashListInsert(const Item& item, size_t index)
+{
+    esp_err_t err = mHashList.insert(item, index);
+    if (err != ESP_OK || mItemIndex == nullptr) {
+        return err;
+    }
+    err = mItemIndex->insert(item, this, index);
+    if (err != ESP_OK) {
+        mHashList.erase(index);
+    }
+    return err;
+}
+
+void Page::hashListErase(size_t index)
+{
+    uint32_t hash;
+    if (mHashList.erase(index, &hash) && mItemIndex != nullptr) {
+        mItemIndex->erase(hash, this, index);
+    }
+}
+
+void Page::hashListClear()
+{
+    mHashList.clear();
+    if (mItemIndex != nullptr) {
+        mItemIndex->erasePage(this);
+    }
+}
+
 esp_err_t Page::copyItems(Page &other)
 {
     if (mFirstUsedEntry == INVALID_ENTRY) {
@@ -513,6 +558,12 @@ esp_err_t Page::copyItems(Page &other)
         }
     }
 
+    // erases inconsistent items, which must not be copied
+    esp_err_t loadErr = ensureItemsLoaded();
+    if (loadErr != ESP_OK) {
+        return loadErr;
+    }
+
     Item entry;
     size_t readEntryIndex = mFirstUsedEntry;
     EntryState state;
@@ -533,7 +584,7 @@ esp_err_t Page::copyItems(Page &other)
             return err;
         }
 
-        err = other.mHashList.insert(entry, other.mNextFreeEntry);
+        err = other.hashListInsert(entry, other.mNextFreeEntry);
         if (err != ESP_OK) {
             return err;
         }
@@ -563,7 +614,7 @@ esp_err_t Page::copyItems(Page &other)
     return ESP_OK;
 }
 
-esp_err_t Page::mLoadEntryTable()
+esp_err_t Page::mLoadEntryTable(bool deferItems)
 {
     // for states where we actually care about data in the page, read entry state table
     if (mState == PageState::ACTIVE ||
@@ -693,7 +744,7 @@ esp_err_t Page::mLoadEntryTable()
                 continue;
             }
 
-            err = mHashList.insert(item, i);
+            err = hashListInsert(item, i);
             if (err != ESP_OK) {
                 mState = PageState::INVALID;
                 return err;
@@ -747,58 +798,98 @@ esp_err_t Page::mLoadEntryTable()
         }
     } else if (mState == PageState::FULL || mState == PageState::FREEING) {
         // We have already filled mHashList for page in active state.
-        // Do the same for the case when page is in full or freeing state.
-        Item item;
-        for (size_t i = mFirstUsedEntry; i < ENTRY_COUNT; ++i) {
-            auto err = mEntryTable.get(i, &state);
-            if (err != ESP_OK) {
-                return err;
-            }
-            if (state != EntryState::WRITTEN) {
-                continue;
+        // Do the same for the case when page is in full or freeing state, unless it is deferred.
+        if (deferItems) {
+            mItemsLoaded = false;
+            if (mItemIndex != nullptr) {
+                mItemIndex->addPendingPage();
             }
+            return ESP_OK;
+        }
+        return loadItems();
+    }
 
-            err = readEntry(i, item);
-            if (err != ESP_OK) {
-                mState = PageState::INVALID;
-                return err;
-            }
+    return ESP_OK;
+}
 
-            if (!item.checkHeaderConsistency(i)) {
-                err = eraseEntryAndSpan(i);
-                if (err != ESP_OK) {
-                    mState = PageState::INVALID;
-                    return err;
-                }
-                continue;
-            }
+bool Page::isEntryTableInSync() const
+{
+    TEntryTable table;
+    if (mPartition->read_raw(mBaseAddress + ENTRY_TABLE_OFFSET, table.data(), table.byteSize()) != ESP_OK) {
+        return false;
+    }
+    // the table in memory is only set up by initialize(), until then the one in flash is erased
+    TEntryTable expected = mEntryTable;
+    if (mState == PageState::UNINITIALIZED) {
+        std::fill_n(expected.data(), expected.byteSize() / sizeof(uint32_t), 0xffffffff);
+    }
+    return memcmp(table.data(), expected.data(), table.byteSize()) == 0;
+}
+
+void Page::setItemsLoaded()
+{
+    if (!mItemsLoaded) {
+        mItemsLoaded = true;
+        if (mItemIndex != nullptr) {
+            mItemIndex->removePendingPage();
+        }
+    }
+}
+
+esp_err_t Page::loadItems()
+{
+    setItemsLoaded();
+
+    EntryState state;
+    Item item;
+    for (size_t i = mFirstUsedEntry; i < ENTRY_COUNT; ++i) {
+        auto err = mEntryTable.get(i, &state);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (state != EntryState::WRITTEN) {
+            continue;
+        }
 
-            NVS_ASSERT_OR_RETURN(item.span > 0, ESP_FAIL);
+        err = readEntry(i, item);
+        if (err != ESP_OK) {
+            mState = PageState::INVALID;
+            return err;
+        }
 
-            err = mHashList.insert(item, i);
+        if (!item.checkHeaderConsistency(i)) {
+            err = eraseEntryAndSpan(i);
             if (err != ESP_OK) {
                 mState = PageState::INVALID;
                 return err;
             }
+            continue;
+        }
 
-            size_t span = item.span;
+        NVS_ASSERT_OR_RETURN(item.span > 0, ESP_FAIL);
 
-            if (isVariableLengthType(item.datatype)) {
-                for (size_t j = i + 1; j < i + span; ++j) {
-                    err = mEntryTable.get(j, &state);
-                    if (err != ESP_OK) {
-                        return err;
-                    }
-                    if (state != EntryState::WRITTEN) {
-                        eraseEntryAndSpan(i);
-                        break;
-                    }
+        err = hashListInsert(item, i);
+        if (err != ESP_OK) {
+            mState = PageState::INVALID;
+            return err;
+        }
+
+        size_t span = item.span;
+
+        if (isVariableLengthType(item.datatype)) {
+            for (size_t j = i + 1; j < i + span; ++j) {
+                err = mEntryTable.get(j, &state);
+                if (err != ESP_OK) {
+                    return err;
+                }
+                if (state != EntryState::WRITTEN) {
+                    eraseEntryAndSpan(i);
+                    break;
                 }
             }
-
-            i += span - 1;
         }
 
+        i += span - 1;
     }
 
     return ESP_OK;
@@ -825,6 +916,17 @@ esp_err_t Page::initialize()
     return ESP_OK;
 }
 
+esp_err_t Page::writeEntryTable(size_t beginWord, size_t endWord)
+{
+    if (mBatch) {
+        mBatch->mBeginWord = std::min(mBatch->mBeginWord, beginWord);
+        mBatch->mEndWord = std::max(mBatch->mEndWord, endWord);
+        return ESP_OK;
+    }
+    return mPartition->write_raw(mBaseAddress + ENTRY_TABLE_OFFSET + static_cast<uint32_t>(beginWord) * 4,
+                                 mEntryTable.data() + beginWord, (endWord - beginWord) * 4);
+}
+
 esp_err_t Page::alterEntryState(size_t index, EntryState state)
 {
     NVS_ASSERT_OR_RETURN(index < ENTRY_COUNT, ESP_FAIL);
@@ -833,9 +935,7 @@ esp_err_t Page::alterEntryState(size_t index, EntryState state)
         return err;
     }
     size_t wordToWrite = mEntryTable.getWordIndex(index);
-    uint32_t word = mEntryTable.data()[wordToWrite];
-    err = mPartition->write_raw(mBaseAddress + ENTRY_TABLE_OFFSET + static_cast<uint32_t>(wordToWrite) * 4,
-                                &word, sizeof(word));
+    err = writeEntryTable(wordToWrite, wordToWrite + 1);
     if (err != ESP_OK) {
         mState = PageState::INVALID;
         return err;
@@ -861,9 +961,7 @@ esp_err_t Page::alterEntryRangeState(size_t begin, size_t end, EntryState state)
             nextWordIndex = mEntryTable.getWordIndex(i - 1);
         }
         if (nextWordIndex != wordIndex) {
-            uint32_t word = mEntryTable.data()[wordIndex];
-            auto rc = mPartition->write_raw(mBaseAddress + ENTRY_TABLE_OFFSET + static_cast<uint32_t>(wordIndex) * 4,
-                                            &word, 4);
+            auto rc = writeEntryTable(wordIndex, wordIndex + 1);
             if (rc != ESP_OK) {
                 return rc;
             }
@@ -905,6 +1003,11 @@ esp_err_t Page::findItem(uint8_t nsIndex, ItemType datatype, const char* key, si
         return ESP_ERR_NVS_NOT_FOUND;
     }
 
+    esp_err_t err = ensureItemsLoaded();
+    if (err != ESP_OK) {
+        return err;
+    }
+
     size_t findBeginIndex = itemIndex;
     if (findBeginIndex >= ENTRY_COUNT) {
         return ESP_ERR_NVS_NOT_FOUND;
@@ -1070,7 +1173,8 @@ esp_err_t Page::erase()
     mFirstUsedEntry = INVALID_ENTRY;
     mNextFreeEntry = INVALID_ENTRY;
     mState = PageState::UNINITIALIZED;
-    mHashList.clear();
+    hashListClear();
+    setItemsLoaded();
     return ESP_OK;
 }
 
@@ -1101,6 +1205,94 @@ size_t Page::getVarDataTailroom() const
     return ((mNextFreeEntry < (ENTRY_COUNT - 1)) ? ((ENTRY_COUNT - mNextFreeEntry - 1) * ENTRY_SIZE) : 0);
 }
 
+size_t Page::getFreeEntryCount() const
+{
+    if (mState == PageState::UNINITIALIZED) {
+        return ENTRY_COUNT;
+    } else if (mState != PageState::ACTIVE || mNextFreeEntry > ENTRY_COUNT) {
+        return 0;
+    }
+    return ENTRY_COUNT - mNextFreeEntry;
+}
+
+esp_err_t Page::beginBatch(size_t entryCount)
+{
+    NVS_ASSERT_OR_RETURN(mBatch == nullptr, ESP_FAIL);
+
+    if (mState == PageState::UNINITIALIZED) {
+        esp_err_t err = initialize();
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    if (mState != PageState::ACTIVE && entryCount > 0) {
+        return ESP_ERR_NVS_PAGE_FULL;
+    }
+
+    Batch* batch = new (std::nothrow) Batch;
+    if (!batch) {
+        return ESP_ERR_NO_MEM;
+    }
+    batch->mFirstEntry = mNextFreeEntry;
+    batch->mEntryCount = entryCount;
+    batch->mBeginWord = SIZE_MAX;
+    batch->mEndWord = 0;
+    batch->mData = nullptr;
+    batch->mEntryTable = mEntryTable;
+    if (entryCount > 0) {
+        batch->mData = new (std::nothrow) uint8_t[entryCount * ENTRY_SIZE];
+        if (!batch->mData) {
+            delete batch;
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    mBatch = batch;
+    return ESP_OK;
+}
+
+esp_err_t Page::commitBatch()
+{
+    NVS_ASSERT_OR_RETURN(mBatch != nullptr, ESP_FAIL);
+
+    Batch* batch = mBatch;
+    mBatch = nullptr;
+
+    esp_err_t err = ESP_OK;
+    if (mNextFreeEntry != INVALID_ENTRY && mNextFreeEntry > batch->mFirstEntry) {
+        err = writeEntries(batch->mFirstEntry, batch->mData, (mNextFreeEntry - batch->mFirstEntry) * ENTRY_SIZE);
+    }
+    // The entries only become valid with the entry table write. Entries erased in the batch keep their
+    // previous state in the first write, so that an item is never erased before its new value is valid.
+    if (err == ESP_OK && batch->mBeginWord < batch->mEndWord) {
+        bool erased = false;
+        for (size_t i = 0; i < ENTRY_COUNT; ++i) {
+            EntryState before, after;
+            batch->mEntryTable.get(i, &before);
+            mEntryTable.get(i, &after);
+            if (before == EntryState::EMPTY) {
+                batch->mEntryTable.set(i, after);
+            } else if (before != after) {
+                erased = true;
+            }
+        }
+        if (erased) {
+            err = mPartition->write_raw(mBaseAddress + ENTRY_TABLE_OFFSET + static_cast<uint32_t>(batch->mBeginWord) * 4,
+                                        batch->mEntryTable.data() + batch->mBeginWord, (batch->mEndWord - batch->mBeginWord) * 4);
+        }
+        if (err == ESP_OK) {
+            err = writeEntryTable(batch->mBeginWord, batch->mEndWord);
+        }
+    }
+    if (err != ESP_OK) {
+        mState = PageState::INVALID;
+    }
+
+    delete[] batch->mData;
+    delete batch;
+    return err;
+}
+
 const char* Page::pageStateToName(PageState ps)
 {
     switch (ps) {
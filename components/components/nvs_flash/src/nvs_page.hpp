@@ -15,6 +15,7 @@
 #include "compressed_enum_table.hpp"
 #include "intrusive_list.h"
 #include "nvs_item_hash_list.hpp"
+#include "nvs_item_index.hpp"
 #include "nvs_memory_management.hpp"
 #include "partition.hpp"
 #include "nvs_constants.h"
@@ -78,7 +79,12 @@ public:
         return mState;
     }
 
-    esp_err_t load(Partition *partition, uint32_t sectorNumber);
+    /**
+     * Reads the page header and entry state table. Unless deferItems is set, items of full and freeing pages
+     * are read and checked as well. Otherwise this is done the first time an item of the page is accessed.
+     * The active page is always loaded completely.
+     */
+    esp_err_t load(Partition *partition, uint32_t sectorNumber, ItemIndex *itemIndex = nullptr, bool deferItems = false);
 
     esp_err_t getSeqNumber(uint32_t& seqNumber) const;
 
@@ -137,8 +143,31 @@ public:
     }
     size_t getVarDataTailroom() const ;
 
+    size_t getFreeEntryCount() const;
+
+    /**
+     * Starts collecting the flash writes of the following writeItem() and eraseEntryAndSpan() calls in RAM, until
+     * commitBatch() is called. entryCount is the number of entries which will be written, it may be 0 if entries
+     * are only erased. Items must not be read from this page while the batch is open.
+     */
+    esp_err_t beginBatch(size_t entryCount);
+
+    /**
+     * Writes the data of all entries written since beginBatch() with one flash write, followed by one write of the
+     * changed part of the entry state table which makes the new entries valid. If entries were erased in the batch,
+     * a second entry state table write erases them. A power-off in between leaves duplicate items, which are removed
+     * when the page is loaded, but never loses an item.
+     */
+    esp_err_t commitBatch();
+
     esp_err_t markFull();
 
+    /**
+     * Returns true if the entry state table in flash still matches the one in memory,
+     * i.e. the page wasn't written outside of this object since it was loaded.
+     */
+    bool isEntryTableInSync() const;
+
     esp_err_t markFreeing();
 
     esp_err_t copyItems(Page& other);
@@ -176,7 +205,16 @@ protected:
         INVALID = NVS_CONST_ENTRY_STATE_INVALID // entry is in inconsistent state (write started but ESB_WRITTEN has not been set yet)
     };
 
-    esp_err_t mLoadEntryTable();
+    esp_err_t mLoadEntryTable(bool deferItems);
+
+    esp_err_t loadItems();
+
+    void setItemsLoaded();
+
+    esp_err_t ensureItemsLoaded()
+    {
+        return mItemsLoaded ? ESP_OK : loadItems();
+    }
 
     esp_err_t initialize();
 
@@ -192,8 +230,18 @@ protected:
 
     esp_err_t writeEntryData(const uint8_t* data, size_t size);
 
+    esp_err_t writeEntries(size_t index, const void* data, size_t size);
+
+    esp_err_t writeEntryTable(size_t beginWord, size_t endWord);
+
     esp_err_t updateFirstUsedEntry(size_t index, size_t span);
 
+    esp_err_t hashListInsert(const Item& item, size_t index);
+
+    void hashListErase(size_t index);
+
+    void hashListClear();
+
     static constexpr size_t getAlignmentForType(ItemType type)
     {
         return static_cast<uint8_t>(type) & 0x0f;
@@ -220,12 +268,32 @@ protected:
     size_t mFirstUsedEntry = INVALID_ENTRY;
     uint16_t mUsedEntryCount = 0;
     uint16_t mErasedEntryCount = 0;
+    bool mItemsLoaded = true;
 
     /**
      * This hash list stores hashes of namespace index, key, and ChunkIndex for quick lookup when searching items.
      */
     HashList mHashList;
 
+    /**
+     * Optional partition-wide index, kept in sync with mHashList.
+     */
+    ItemIndex *mItemIndex = nullptr;
+
+    /**
+     * Flash writes collected between beginBatch() and commitBatch().
+     */
+    struct Batch : public ExceptionlessAllocatable {
+        size_t mFirstEntry;     // first entry written in the batch
+        size_t mEntryCount;     // number of entries mData can hold
+        size_t mBeginWord;      // range of entry table words changed in the batch
+        size_t mEndWord;
+        uint8_t* mData;
+        TEntryTable mEntryTable; // entry states before the batch
+    };
+
+    Batch *mBatch = nullptr;
+
     Partition *mPartition;
 
     static const uint32_t HEADER_OFFSET = NVS_CONST_PAGE_HEADER_OFFSET;
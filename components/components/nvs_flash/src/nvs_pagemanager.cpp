@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -20,11 +20,20 @@ esp_err_t PageManager::load(Partition *partition, uint32_t baseSector, uint32_t
     mPageList.clear();
     mFreePageList.clear();
     mPages.reset(new (nothrow) Page[sectorCount]);
+    mItemIndex.clear();
+    mCheckpointNsIndex = 0;
 
     if (!mPages) return ESP_ERR_NO_MEM;
 
+#ifdef CONFIG_NVS_FAST_BOOT
+    // items of full pages are read when they are accessed for the first time
+    const bool deferItems = true;
+#else
+    const bool deferItems = false;
+#endif
+
     for (uint32_t i = 0; i < sectorCount; ++i) {
-        auto err = mPages[i].load(partition, baseSector + i);
+        auto err = mPages[i].load(partition, baseSector + i, getItemIndex(), deferItems);
         if (err != ESP_OK) {
             return err;
         }
@@ -56,22 +65,38 @@ esp_err_t PageManager::load(Partition *partition, uint32_t baseSector, uint32_t
         mSeqNumber = lastSeqNo + 1;
     }
 
+    mCheckpointNsIndex = findCheckpoint();
+
     // if power went out after a new item for the given key was written,
-    // but before the old one was erased, we end up with a duplicate item
-    if (!partition->get_readonly()) {
+    // but before the old one was erased, we end up with a duplicate item.
+    // Usually this can only be the last item of the last page, but a batch write (Storage::writeItems)
+    // makes several items valid at once, so the other items of the last page are checked as well.
+    // After a clean deinitialization (checkpoint found), there can't be any duplicates.
+    if (!partition->get_readonly() && !hasCheckpoint()) {
         Page& lastPage = back();
+        auto last = PageManager::TPageListIterator(&lastPage);
+        TPageListIterator it;
         size_t lastItemIndex = SIZE_MAX;
         Item item;
+        Item previousItem;
         size_t itemIndex = 0;
         while (lastPage.findItem(Page::NS_ANY, ItemType::ANY, nullptr, itemIndex, item) == ESP_OK) {
+            // blobs are never part of a batch write, they are only checked if they are the last item
+            if (lastItemIndex != SIZE_MAX && previousItem.datatype != ItemType::BLOB_DATA
+                    && previousItem.datatype != ItemType::BLOB_IDX) {
+                for (it = begin(); it != last; ++it) {
+                    if ((it->state() != Page::PageState::FREEING) &&
+                            (it->eraseItem(previousItem.nsIndex, previousItem.datatype, previousItem.key, previousItem.chunkIndex) == ESP_OK)) {
+                        break;
+                    }
+                }
+            }
+            previousItem = item;
             itemIndex += item.span;
             lastItemIndex = itemIndex;
         }
 
         if (lastItemIndex != SIZE_MAX) {
-            auto last = PageManager::TPageListIterator(&lastPage);
-            TPageListIterator it;
-
             for (it = begin(); it != last; ++it) {
 
                 if ((it->state() != Page::PageState::FREEING) &&
@@ -92,6 +117,9 @@ esp_err_t PageManager::load(Partition *partition, uint32_t baseSector, uint32_t
             }
         }
 
+    }
+
+    if (!partition->get_readonly()) {
         // check if power went out while page was being freed
         for (auto it = begin(); it!= end(); ++it) {
             if (it->state() == Page::PageState::FREEING) {
@@ -136,6 +164,41 @@ esp_err_t PageManager::load(Partition *partition, uint32_t baseSector, uint32_t
     return ESP_OK;
 }
 
+uint8_t PageManager::findCheckpoint()
+{
+#ifdef CONFIG_NVS_FAST_BOOT
+    Page& lastPage = back();
+    if (lastPage.state() != Page::PageState::ACTIVE) {
+        return 0;
+    }
+
+    // the index of the checkpoint namespace isn't known before the namespaces are loaded, items of other
+    // types with the same key (e.g. the entry of the namespace) are skipped
+    size_t itemIndex = 0;
+    Item item;
+    esp_err_t err;
+    while ((err = lastPage.findItem(Page::NS_ANY, ItemType::SZ, CHECKPOINT_KEY, itemIndex, item)) == ESP_OK
+            || err == ESP_ERR_NVS_TYPE_MISMATCH) {
+        // anything written after the checkpoint, even partially, may have changed the partition
+        if (err == ESP_OK && itemIndex + item.span == Page::ENTRY_COUNT - lastPage.getFreeEntryCount()) {
+            return item.nsIndex;
+        }
+        itemIndex += item.span;
+    }
+#endif
+    return 0;
+}
+
+esp_err_t PageManager::eraseCheckpoint()
+{
+    if (!hasCheckpoint()) {
+        return ESP_OK;
+    }
+    uint8_t nsIndex = mCheckpointNsIndex;
+    mCheckpointNsIndex = 0;
+    return back().eraseItem(nsIndex, ItemType::SZ, CHECKPOINT_KEY);
+}
+
 esp_err_t PageManager::requestNewPage()
 {
     if (mFreePageList.empty()) {
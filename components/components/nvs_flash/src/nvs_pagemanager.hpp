@@ -16,8 +16,10 @@
 
 #include <memory>
 #include <list>
+#include "sdkconfig.h"
 #include "nvs_types.hpp"
 #include "nvs_page.hpp"
+#include "nvs_item_index.hpp"
 #include "partition.hpp"
 #include "intrusive_list.h"
 
@@ -61,17 +63,70 @@ public:
         return mBaseSector;
     }
 
+    /**
+     * Returns true if the last item written to the partition is a checkpoint written by Storage::writeCheckpoint(),
+     * i.e. the partition wasn't modified since it was deinitialized cleanly (CONFIG_NVS_FAST_BOOT).
+     */
+    bool hasCheckpoint() const
+    {
+        return mCheckpointNsIndex != 0;
+    }
+
+    /**
+     * Returns the index of the namespace the checkpoint found by load() is stored in.
+     */
+    uint8_t getCheckpointNsIndex() const
+    {
+        return mCheckpointNsIndex;
+    }
+
+    /**
+     * Forgets the checkpoint found by load() without erasing it, if it turns out not to be one.
+     */
+    void clearCheckpoint()
+    {
+        mCheckpointNsIndex = 0;
+    }
+
+    /**
+     * Erases the checkpoint found by load(). Has to be called before the partition is modified.
+     */
+    esp_err_t eraseCheckpoint();
+
+    /**
+     * Name of the namespace and key of the checkpoint item. The checkpoint is stored as a string in a namespace
+     * of its own, which versions without CONFIG_NVS_FAST_BOOT load like any other namespace.
+     */
+    static constexpr char CHECKPOINT_NAMESPACE[] = "nvs.checkpoint";
+    static constexpr char CHECKPOINT_KEY[] = "nvs.checkpoint";
+
+    /**
+     * Returns the partition-wide item index or nullptr if it is disabled (CONFIG_NVS_KEY_INDEX).
+     */
+    ItemIndex* getItemIndex()
+    {
+#ifdef CONFIG_NVS_KEY_INDEX
+        return &mItemIndex;
+#else
+        return nullptr;
+#endif
+    }
+
 protected:
     friend class Iterator;
 
     esp_err_t activatePage();
 
+    uint8_t findCheckpoint();
+
     TPageList mPageList;
     TPageList mFreePageList;
+    ItemIndex mItemIndex;
     std::unique_ptr<Page[]> mPages;
     uint32_t mBaseSector;
     uint32_t mPageCount;
     uint32_t mSeqNumber;
+    uint8_t mCheckpointNsIndex = 0;
 }; // class PageManager
 
 
@@ -159,6 +159,9 @@ esp_err_t NVSPartitionManager::deinit_partition(const char *partition_label)
         }
     }
 
+    /* Let the next initialization skip the checks of the partition (CONFIG_NVS_FAST_BOOT), errors only make it slower */
+    storage->writeCheckpoint();
+
     /* Finally delete the storage and its partition */
     nvs_storage_list.erase(storage);
     delete storage;
@@ -1,9 +1,10 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
 #include "nvs_storage.hpp"
+#include <utility>
 #if __has_include(<bsd/string.h>)
 // for strlcpy
 #include <bsd/string.h>
@@ -47,6 +48,7 @@ Storage::~Storage()
 void Storage::clearNamespaces()
 {
     mNamespaces.clearAndFreeNodes();
+    mCheckpointNsIndex = 0;
 }
 
 esp_err_t Storage::populateBlobIndices(TBlobIndexList& blobIdxList)
@@ -182,13 +184,84 @@ void Storage::eraseOrphanDataBlobs(TBlobIndexList& blobIdxList)
 
 esp_err_t Storage::init(uint32_t baseSector, uint32_t sectorCount)
 {
+    mValueCache.clear();
+
     auto err = mPageManager.load(mPartition, baseSector, sectorCount);
     if(err != ESP_OK) {
         mState = StorageState::INVALID;
         return err;
     }
 
-    // load namespaces list
+    // After a clean deinit, the namespaces are read from the checkpoint and the partition doesn't need to be checked.
+    bool clean = false;
+    if(mPageManager.hasCheckpoint()) {
+        err = loadCheckpoint();
+        if(err == ESP_ERR_NO_MEM) {
+            mState = StorageState::INVALID;
+            return err;
+        }
+        clean = (err == ESP_OK);
+        if(!clean) {
+            // the item may be a string of the application, an invalid checkpoint is removed below
+            mPageManager.clearCheckpoint();
+        }
+    }
+
+    if(!clean) {
+        err = loadNamespaces();
+        if(err != ESP_OK) {
+            return err;
+        }
+
+        // A checkpoint which is not used was left by a later modification of the partition, possibly by a
+        // version without fast boot
+        if(mCheckpointNsIndex != 0 && !mPartition->get_readonly()) {
+            for(auto it = mPageManager.begin(); it != mPageManager.end(); ++it) {
+                while((err = it->eraseItem(mCheckpointNsIndex, ItemType::SZ, PageManager::CHECKPOINT_KEY)) == ESP_OK) {
+                }
+                if(err != ESP_ERR_NVS_NOT_FOUND) {
+                    mState = StorageState::INVALID;
+                    return err;
+                }
+            }
+        }
+    }
+    if(mNamespaceUsage.set(0, true) != ESP_OK) {
+        return ESP_FAIL;
+    }
+    if(mNamespaceUsage.set(255, true) != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    if(!clean) {
+        // Populate list of multi-page index entries.
+        TBlobIndexList blobIdxList;
+        err = populateBlobIndices(blobIdxList);
+        if(err != ESP_OK) {
+            mState = StorageState::INVALID;
+            return ESP_ERR_NO_MEM;
+        }
+
+        // remove blob indexes with mismatched blob data length or chunk count
+        eraseMismatchedBlobIndexes(blobIdxList);
+
+        // Remove the entries for which there is no parent multi-page index.
+        eraseOrphanDataBlobs(blobIdxList);
+
+        // Purge the blob index list
+        blobIdxList.clearAndFreeNodes();
+    }
+
+    mState = StorageState::ACTIVE;
+
+#ifdef DEBUG_STORAGE
+    debugCheck();
+#endif
+    return ESP_OK;
+}
+
+esp_err_t Storage::loadNamespaces()
+{
     clearNamespaces();
     std::fill_n(mNamespaceUsage.data(), mNamespaceUsage.byteSize() / 4, 0);
     for(auto it = mPageManager.begin(); it != mPageManager.end(); ++it) {
@@ -204,7 +277,7 @@ esp_err_t Storage::init(uint32_t baseSector, uint32_t sectorCount)
             }
 
             item.getKey(entry->mName, sizeof(entry->mName));
-            err = item.getValue(entry->mIndex);
+            auto err = item.getValue(entry->mIndex);
             if(err != ESP_OK) {
                 delete entry;
                 return err;
@@ -213,40 +286,153 @@ esp_err_t Storage::init(uint32_t baseSector, uint32_t sectorCount)
                 delete entry;
                 return ESP_FAIL;
             }
-            mNamespaces.push_back(entry);
             itemIndex += item.span;
+            if(strcmp(entry->mName, PageManager::CHECKPOINT_NAMESPACE) == 0) {
+                mCheckpointNsIndex = entry->mIndex;
+                delete entry;
+                continue;
+            }
+            mNamespaces.push_back(entry);
         }
     }
-    if(mNamespaceUsage.set(0, true) != ESP_OK) {
-        return ESP_FAIL;
-    }
-    if(mNamespaceUsage.set(255, true) != ESP_OK) {
-        return ESP_FAIL;
-    }
+    return ESP_OK;
+}
 
-    // Populate list of multi-page index entries.
-    TBlobIndexList blobIdxList;
-    err = populateBlobIndices(blobIdxList);
+esp_err_t Storage::loadCheckpoint()
+{
+    Page& page = getCurrentPage();
+    const uint8_t nsIndex = mPageManager.getCheckpointNsIndex();
+    size_t itemIndex = 0;
+    Item item;
+    auto err = page.findItem(nsIndex, ItemType::SZ, PageManager::CHECKPOINT_KEY, itemIndex, item);
     if(err != ESP_OK) {
-        mState = StorageState::INVALID;
+        return err;
+    }
+
+    const size_t dataSize = item.varLength.dataSize;
+    if(dataSize < sizeof(CheckpointHeader)) {
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    uint8_t* data = new (std::nothrow) uint8_t[dataSize];
+    if(!data) {
         return ESP_ERR_NO_MEM;
     }
+    err = page.readItem(nsIndex, ItemType::SZ, PageManager::CHECKPOINT_KEY, data, dataSize);
+    if(err != ESP_OK) {
+        delete[] data;
+        return err;
+    }
 
-    // remove blob indexes with mismatched blob data length or chunk count
-    eraseMismatchedBlobIndexes(blobIdxList);
+    CheckpointHeader header;
+    memcpy(&header, data, sizeof(header));
+    if(header.mVersion != CHECKPOINT_VERSION ||
+            dataSize != sizeof(header) + header.mNamespaceCount * sizeof(CheckpointNamespace)) {
+        delete[] data;
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
 
-    // Remove the entries for which there is no parent multi-page index.
-    eraseOrphanDataBlobs(blobIdxList);
+    clearNamespaces();
+    std::fill_n(mNamespaceUsage.data(), mNamespaceUsage.byteSize() / 4, 0);
+    err = ESP_OK;
+    for(size_t i = 0; i < header.mNamespaceCount; ++i) {
+        CheckpointNamespace record;
+        memcpy(&record, data + sizeof(header) + i * sizeof(record), sizeof(record));
+
+        if(strncmp(record.mName, PageManager::CHECKPOINT_NAMESPACE, sizeof(record.mName)) == 0) {
+            mCheckpointNsIndex = record.mIndex;
+            if(mNamespaceUsage.set(record.mIndex, true) != ESP_OK) {
+                err = ESP_FAIL;
+                break;
+            }
+            continue;
+        }
 
-    // Purge the blob index list
-    blobIdxList.clearAndFreeNodes();
+        NamespaceEntry* entry = new (std::nothrow) NamespaceEntry;
+        if(!entry) {
+            err = ESP_ERR_NO_MEM;
+            break;
+        }
+        memcpy(entry->mName, record.mName, sizeof(record.mName));
+        entry->mName[sizeof(record.mName)] = 0;
+        entry->mIndex = record.mIndex;
+        if(mNamespaceUsage.set(entry->mIndex, true) != ESP_OK) {
+            delete entry;
+            err = ESP_FAIL;
+            break;
+        }
+        mNamespaces.push_back(entry);
+    }
+    delete[] data;
+    // a string of the application with the key of the checkpoint isn't stored in the checkpoint namespace
+    if(err == ESP_OK && mCheckpointNsIndex != nsIndex) {
+        err = ESP_ERR_NVS_NOT_FOUND;
+    }
+    return err;
+}
 
-    mState = StorageState::ACTIVE;
+esp_err_t Storage::writeCheckpoint()
+{
+#ifdef CONFIG_NVS_FAST_BOOT
+    if(mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    if(mPartition->get_readonly() || mPageManager.hasCheckpoint()) {
+        return ESP_OK;
+    }
+    // the chunks of a blob stream which is not committed have no blob index yet, only the checks in init()
+    // remove them if the stream is never completed
+    if(mUncommittedStreams > 0 || mOrphanedChunks) {
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+    // a failed write may have left the partition in a state which only the checks in init() can repair
+    for(auto it = std::begin(mPageManager); it != std::end(mPageManager); ++it) {
+        if(it->state() == Page::PageState::INVALID || it->state() == Page::PageState::CORRUPT) {
+            return ESP_ERR_NVS_INVALID_STATE;
+        }
+    }
+    if(!getCurrentPage().isEntryTableInSync()) {
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
 
-#ifdef DEBUG_STORAGE
-    debugCheck();
-#endif
+    size_t count = mNamespaces.size() + 1;
+    if(count > CHECKPOINT_MAX_NAMESPACES) {
+        return ESP_ERR_NVS_VALUE_TOO_LONG;
+    }
+
+    // the checkpoint namespace is created by the first checkpoint and kept afterwards
+    esp_err_t err;
+    if(mCheckpointNsIndex == 0) {
+        err = addNamespace(PageManager::CHECKPOINT_NAMESPACE, mCheckpointNsIndex);
+        if(err != ESP_OK) {
+            return err;
+        }
+    }
+
+    const size_t dataSize = sizeof(CheckpointHeader) + count * sizeof(CheckpointNamespace);
+    uint8_t* data = new (std::nothrow) uint8_t[dataSize];
+    if(!data) {
+        return ESP_ERR_NO_MEM;
+    }
+    CheckpointHeader header = { CHECKPOINT_VERSION, static_cast<uint32_t>(count) };
+    memcpy(data, &header, sizeof(header));
+    CheckpointNamespace record;
+    record.mIndex = mCheckpointNsIndex;
+    strncpy(record.mName, PageManager::CHECKPOINT_NAMESPACE, sizeof(record.mName));
+    memcpy(data + sizeof(header), &record, sizeof(record));
+    size_t offset = sizeof(header) + sizeof(record);
+    for(auto it = std::begin(mNamespaces); it != std::end(mNamespaces); ++it) {
+        record.mIndex = it->mIndex;
+        memcpy(record.mName, it->mName, sizeof(record.mName));
+        memcpy(data + offset, &record, sizeof(record));
+        offset += sizeof(record);
+    }
+
+    err = writeItem(mCheckpointNsIndex, ItemType::SZ, PageManager::CHECKPOINT_KEY, data, dataSize);
+    delete[] data;
+    return err;
+#else
     return ESP_OK;
+#endif
 }
 
 bool Storage::isValid() const
@@ -256,6 +442,16 @@ bool Storage::isValid() const
 
 esp_err_t Storage::findItem(uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item, uint8_t chunkIdx, VerOffset chunkStart, size_t* itemIndex)
 {
+    // The item index uses the same hash as the page hash list, so it can only be used for the same lookups (see Page::findItem)
+    ItemIndex* index = mPageManager.getItemIndex();
+    if(index != nullptr && !index->hasPendingPages() && nsIndex != Page::NS_ANY && key != nullptr && (datatype != ItemType::BLOB_DATA || chunkIdx != Page::CHUNK_ANY)) {
+        Page* pages[INDEX_MAX_PAGES];
+        size_t pageCount = index->findPages(Item(nsIndex, datatype, 0, key, chunkIdx), pages, INDEX_MAX_PAGES);
+        if(pageCount <= INDEX_MAX_PAGES) {
+            return findIndexedItem(pages, pageCount, nsIndex, datatype, key, page, item, chunkIdx, chunkStart, itemIndex);
+        }
+    }
+
     for(auto it = std::begin(mPageManager); it != std::end(mPageManager); ++it) {
         size_t tmpItemIndex = 0;
         auto err = it->findItem(nsIndex, datatype, key, tmpItemIndex, item, chunkIdx, chunkStart);
@@ -270,6 +466,35 @@ esp_err_t Storage::findItem(uint8_t nsIndex, ItemType datatype, const char* key,
     return ESP_ERR_NVS_NOT_FOUND;
 }
 
+// Searches only the pages returned by the item index. Pages are visited in the same order as
+// in the page manager (ascending sequence number), so the result is the same as for the full search.
+esp_err_t Storage::findIndexedItem(Page** pages, size_t pageCount, uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item, uint8_t chunkIdx, VerOffset chunkStart, size_t* itemIndex)
+{
+    uint32_t seqNumbers[INDEX_MAX_PAGES];
+    for(size_t i = 0; i < pageCount; ++i) {
+        if(pages[i]->getSeqNumber(seqNumbers[i]) != ESP_OK) {
+            seqNumbers[i] = UINT32_MAX;
+        }
+        for(size_t j = i; j > 0 && seqNumbers[j - 1] > seqNumbers[j]; --j) {
+            std::swap(seqNumbers[j - 1], seqNumbers[j]);
+            std::swap(pages[j - 1], pages[j]);
+        }
+    }
+
+    for(size_t i = 0; i < pageCount; ++i) {
+        size_t tmpItemIndex = 0;
+        auto err = pages[i]->findItem(nsIndex, datatype, key, tmpItemIndex, item, chunkIdx, chunkStart);
+        if(err == ESP_OK) {
+            page = pages[i];
+            if(itemIndex) {
+                *itemIndex = tmpItemIndex;
+            }
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+
 esp_err_t Storage::writeMultiPageBlob(uint8_t nsIndex, const char* key, const void* data, size_t dataSize, VerOffset chunkStart)
 {
     uint8_t chunkCount = 0;
@@ -278,14 +503,7 @@ esp_err_t Storage::writeMultiPageBlob(uint8_t nsIndex, const char* key, const vo
     size_t offset = 0;
     esp_err_t err = ESP_OK;
 
-    /* Check how much maximum data can be accommodated**/
-    uint32_t max_pages = mPageManager.getPageCount() - 1;
-
-    if(max_pages > (Page::CHUNK_ANY-1)/2) {
-       max_pages = (Page::CHUNK_ANY-1)/2;
-    }
-
-    if(dataSize > max_pages * Page::CHUNK_MAX_SIZE) {
+    if(dataSize > getMaxBlobSize()) {
         return ESP_ERR_NVS_VALUE_TOO_LONG;
     }
 
@@ -375,6 +593,389 @@ esp_err_t Storage::writeMultiPageBlob(uint8_t nsIndex, const char* key, const vo
     return err;
 }
 
+size_t Storage::getMaxBlobSize()
+{
+    /* Check how much maximum data can be accommodated**/
+    uint32_t max_pages = mPageManager.getPageCount() - 1;
+
+    if(max_pages > (Page::CHUNK_ANY-1)/2) {
+       max_pages = (Page::CHUNK_ANY-1)/2;
+    }
+    return max_pages * Page::CHUNK_MAX_SIZE;
+}
+
+esp_err_t Storage::openBlobStreamWrite(uint8_t nsIndex, const char* key, size_t dataSize, BlobStream& stream)
+{
+    if(mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    if(strlen(key) > Item::MAX_KEY_LENGTH) {
+        return ESP_ERR_NVS_KEY_TOO_LONG;
+    }
+    if(dataSize > getMaxBlobSize()) {
+        return ESP_ERR_NVS_VALUE_TOO_LONG;
+    }
+
+    // the new chunks get the other version than the current value, like in writeItem()
+    Page* findPage = nullptr;
+    Item item;
+    stream.mOldDatatype = ItemType::ANY;
+    stream.mChunkStart = VerOffset::VER_0_OFFSET;
+    auto err = findItem(nsIndex, ItemType::BLOB_IDX, key, findPage, item);
+    if(err == ESP_OK) {
+        stream.mOldDatatype = ItemType::BLOB_IDX;
+        stream.mOldChunkStart = item.blobIndex.chunkStart;
+        stream.mChunkStart = (item.blobIndex.chunkStart == VerOffset::VER_1_OFFSET) ? VerOffset::VER_0_OFFSET : VerOffset::VER_1_OFFSET;
+    }
+#ifndef CONFIG_NVS_LEGACY_DUP_KEYS_COMPATIBILITY
+    else if(err == ESP_ERR_NVS_NOT_FOUND) {
+        err = findItem(nsIndex, ItemType::ANY, key, findPage, item);
+        if(err == ESP_OK) {
+            stream.mOldDatatype = item.datatype;
+        }
+    }
+#endif
+    if(err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+        return err;
+    }
+
+    stream.mBufferSize = (dataSize < Page::CHUNK_MAX_SIZE) ? dataSize : Page::CHUNK_MAX_SIZE;
+    stream.mBuffer = new (std::nothrow) uint8_t[stream.mBufferSize > 0 ? stream.mBufferSize : 1];
+    if(!stream.mBuffer) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    stream.mNsIndex = nsIndex;
+    strlcpy(stream.mKey, key, sizeof(stream.mKey));
+    stream.mDataSize = dataSize;
+    stream.mChunkCount = 0;
+    stream.mWritten = 0;
+    stream.mBuffered = 0;
+    stream.mWriting = true;
+    ++mUncommittedStreams;
+    return ESP_OK;
+}
+
+// Writes the buffered data as one chunk as soon as it fills the tailroom of the current page,
+// splitting the blob over pages the same way as writeMultiPageBlob()
+esp_err_t Storage::flushBlobStream(BlobStream& stream, bool commit)
+{
+    esp_err_t err;
+    while(stream.mBuffered > 0 || (commit && stream.mChunkCount == 0)) {
+        Page& page = getCurrentPage();
+        size_t tailroom = page.getVarDataTailroom();
+        size_t remainingSize = stream.mDataSize - stream.mWritten;
+        if(tailroom == 0 || (stream.mChunkCount == 0 && tailroom < remainingSize && tailroom < Page::CHUNK_MAX_SIZE/10)) {
+            if(page.state() != Page::PageState::FULL) {
+                err = page.markFull();
+                if(err != ESP_OK) {
+                    return err;
+                }
+            }
+            err = mPageManager.requestNewPage();
+            if(err != ESP_OK) {
+                return err;
+            } else if(getCurrentPage().getVarDataTailroom() == tailroom) {
+                /* We got the same page or we are not improving.*/
+                return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+            }
+            continue;
+        }
+
+        size_t chunkSize = (remainingSize > tailroom) ? tailroom : remainingSize;
+        if(stream.mBuffered < chunkSize) {
+            return ESP_OK;
+        }
+        if(stream.mChunkCount >= (Page::CHUNK_ANY-1)/2) {
+            return ESP_ERR_NVS_VALUE_TOO_LONG;
+        }
+
+        err = page.writeItem(stream.mNsIndex, ItemType::BLOB_DATA, stream.mKey, stream.mBuffer, chunkSize,
+                static_cast<uint8_t> (stream.mChunkStart) + stream.mChunkCount);
+        if(err != ESP_OK) {
+            NVS_ASSERT_OR_RETURN(err != ESP_ERR_NVS_PAGE_FULL, err);
+            return err;
+        }
+        stream.mChunkCount++;
+        stream.mWritten += chunkSize;
+        stream.mBuffered -= chunkSize;
+        memmove(stream.mBuffer, stream.mBuffer + chunkSize, stream.mBuffered);
+
+        if(stream.mWritten < stream.mDataSize || (tailroom - chunkSize) < Page::ENTRY_SIZE) {
+            if(page.state() != Page::PageState::FULL) {
+                err = page.markFull();
+                if(err != ESP_OK) {
+                    return err;
+                }
+            }
+            err = mPageManager.requestNewPage();
+            if(err != ESP_OK) {
+                return err;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t Storage::writeBlobStream(BlobStream& stream, const void* data, size_t length)
+{
+    if(mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    if(!stream.mWriting) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if(length > stream.mDataSize - stream.mWritten - stream.mBuffered) {
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+
+    esp_err_t err = eraseCheckpoint();
+    if(err != ESP_OK) {
+        return err;
+    }
+
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    while(length > 0) {
+        size_t copySize = stream.mBufferSize - stream.mBuffered;
+        copySize = (length < copySize) ? length : copySize;
+        memcpy(stream.mBuffer + stream.mBuffered, src, copySize);
+        stream.mBuffered += copySize;
+        src += copySize;
+        length -= copySize;
+
+        err = flushBlobStream(stream, false);
+        if(err != ESP_OK) {
+            return err;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t Storage::commitBlobStream(BlobStream& stream)
+{
+    if(mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    if(!stream.mWriting) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if(stream.mWritten + stream.mBuffered != stream.mDataSize) {
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+
+    mValueCache.invalidate(stream.mNsIndex, stream.mKey);
+
+    esp_err_t err = eraseCheckpoint();
+    if(err != ESP_OK) {
+        return err;
+    }
+
+    err = flushBlobStream(stream, true);
+    if(err != ESP_OK) {
+        return err;
+    }
+    NVS_ASSERT_OR_RETURN(stream.mBuffered == 0, ESP_FAIL);
+
+    /* All chunks are stored. Now store the index.*/
+    Item item;
+    std::fill_n(item.data, sizeof(item.data), 0xff);
+    item.blobIndex.dataSize = stream.mDataSize;
+    item.blobIndex.chunkCount = stream.mChunkCount;
+    item.blobIndex.chunkStart = stream.mChunkStart;
+
+    Page& page = getCurrentPage();
+    err = page.writeItem(stream.mNsIndex, ItemType::BLOB_IDX, stream.mKey, item.data, sizeof(item.data));
+    if(err == ESP_ERR_NVS_PAGE_FULL) {
+        if(page.state() != Page::PageState::FULL) {
+            err = page.markFull();
+            if(err != ESP_OK) {
+                return err;
+            }
+        }
+        err = mPageManager.requestNewPage();
+        if(err != ESP_OK) {
+            return err;
+        }
+        err = getCurrentPage().writeItem(stream.mNsIndex, ItemType::BLOB_IDX, stream.mKey, item.data, sizeof(item.data));
+        if(err == ESP_ERR_NVS_PAGE_FULL) {
+            return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        }
+    }
+    if(err != ESP_OK) {
+        return err;
+    }
+    stream.mWriting = false;
+    --mUncommittedStreams;
+
+    // Delete previous value
+    if(stream.mOldDatatype == ItemType::BLOB_IDX) {
+        err = eraseMultiPageBlob(stream.mNsIndex, stream.mKey, stream.mOldChunkStart);
+    } else if(stream.mOldDatatype != ItemType::ANY) {
+        Page* findPage = nullptr;
+        size_t itemIndex = 0;
+        err = findItem(stream.mNsIndex, stream.mOldDatatype, stream.mKey, findPage, item, Page::CHUNK_ANY, VerOffset::VER_ANY, &itemIndex);
+        if(err == ESP_OK) {
+            err = findPage->eraseEntryAndSpan(itemIndex);
+        }
+    }
+    if(err == ESP_ERR_NVS_NOT_FOUND) {
+        // the previous value was erased while the stream was open
+        err = ESP_OK;
+    } else if(err == ESP_ERR_FLASH_OP_FAIL) {
+        return ESP_ERR_NVS_REMOVE_FAILED;
+    }
+    return err;
+}
+
+void Storage::abortBlobStream(BlobStream& stream)
+{
+    if(mState != StorageState::ACTIVE || !stream.mWriting) {
+        return;
+    }
+    stream.mWriting = false;
+    --mUncommittedStreams;
+
+    for(uint8_t chunkNum = 0; chunkNum < stream.mChunkCount; chunkNum++) {
+        Page* findPage = nullptr;
+        Item item;
+        const uint8_t chunkIdx = static_cast<uint8_t> (stream.mChunkStart) + chunkNum;
+        auto err = findItem(stream.mNsIndex, ItemType::BLOB_DATA, stream.mKey, findPage, item, chunkIdx);
+        if(err == ESP_OK) {
+            err = findPage->eraseItem(stream.mNsIndex, ItemType::BLOB_DATA, stream.mKey, chunkIdx);
+        }
+        if(err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+            mOrphanedChunks = true;
+        }
+    }
+}
+
+esp_err_t Storage::openBlobStreamRead(uint8_t nsIndex, const char* key, BlobStream& stream)
+{
+    if(mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    Page* findPage = nullptr;
+    Item item;
+    auto err = findItem(nsIndex, ItemType::BLOB_IDX, key, findPage, item);
+    if(err == ESP_OK) {
+        stream.mDataSize = item.blobIndex.dataSize;
+        stream.mChunkCount = item.blobIndex.chunkCount;
+        stream.mChunkStart = item.blobIndex.chunkStart;
+        stream.mLegacy = false;
+    } else if(err == ESP_ERR_NVS_NOT_FOUND) {
+        err = findItem(nsIndex, ItemType::BLOB, key, findPage, item);
+        if(err != ESP_OK) {
+            return err;
+        }
+        stream.mDataSize = item.varLength.dataSize;
+        stream.mChunkCount = 1;
+        stream.mChunkStart = VerOffset::VER_ANY;
+        stream.mLegacy = true;
+    } else {
+        return err;
+    }
+
+    stream.mNsIndex = nsIndex;
+    strlcpy(stream.mKey, key, sizeof(stream.mKey));
+    stream.mWriting = false;
+    stream.mChunk = 0;
+    stream.mChunkOffset = 0;
+    stream.mChunkFound = false;
+    stream.mChunkLoaded = false;
+    return ESP_OK;
+}
+
+esp_err_t Storage::findBlobStreamChunk(BlobStream& stream, Page* &page, Item& item, size_t& itemIndex)
+{
+    if(stream.mChunk >= stream.mChunkCount) {
+        // the index promises more data than the chunks hold
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    esp_err_t err;
+    if(stream.mLegacy) {
+        err = findItem(stream.mNsIndex, ItemType::BLOB, stream.mKey, page, item, Page::CHUNK_ANY, VerOffset::VER_ANY, &itemIndex);
+    } else {
+        err = findItem(stream.mNsIndex, ItemType::BLOB_DATA, stream.mKey, page, item,
+                static_cast<uint8_t> (stream.mChunkStart) + stream.mChunk, VerOffset::VER_ANY, &itemIndex);
+    }
+    if(err != ESP_OK) {
+        return err;
+    }
+    NVS_ASSERT_OR_RETURN(item.varLength.dataSize <= Page::CHUNK_MAX_SIZE, ESP_FAIL);
+    stream.mChunkSize = item.varLength.dataSize;
+    stream.mChunkFound = true;
+    return ESP_OK;
+}
+
+esp_err_t Storage::readBlobStream(BlobStream& stream, size_t offset, void* data, size_t length)
+{
+    if(mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    if(offset > stream.mDataSize || length > stream.mDataSize - offset) {
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+
+    // chunk sizes are only known from their headers, so going backwards starts from the first chunk
+    if(offset < stream.mChunkOffset) {
+        stream.mChunk = 0;
+        stream.mChunkOffset = 0;
+        stream.mChunkFound = false;
+        stream.mChunkLoaded = false;
+    }
+
+    uint8_t* dst = static_cast<uint8_t*>(data);
+    while(length > 0) {
+        Page* findPage = nullptr;
+        Item item;
+        size_t itemIndex = 0;
+        if(!stream.mChunkFound) {
+            auto err = findBlobStreamChunk(stream, findPage, item, itemIndex);
+            if(err != ESP_OK) {
+                return err;
+            }
+        }
+        if(offset >= stream.mChunkOffset + stream.mChunkSize) {
+            stream.mChunkOffset += stream.mChunkSize;
+            stream.mChunk++;
+            stream.mChunkFound = false;
+            stream.mChunkLoaded = false;
+            continue;
+        }
+
+        if(!stream.mChunkLoaded) {
+            if(findPage == nullptr) {
+                auto err = findBlobStreamChunk(stream, findPage, item, itemIndex);
+                if(err != ESP_OK) {
+                    return err;
+                }
+            }
+            if(stream.mBufferSize < stream.mChunkSize) {
+                delete[] stream.mBuffer;
+                stream.mBuffer = new (std::nothrow) uint8_t[stream.mChunkSize];
+                stream.mBufferSize = stream.mBuffer ? stream.mChunkSize : 0;
+                if(!stream.mBuffer) {
+                    return ESP_ERR_NO_MEM;
+                }
+            }
+            auto err = findPage->readVariableLengthItemData(item, itemIndex, stream.mBuffer);
+            if(err != ESP_OK) {
+                return err;
+            }
+            stream.mChunkLoaded = true;
+        }
+
+        size_t copySize = stream.mChunkOffset + stream.mChunkSize - offset;
+        copySize = (length < copySize) ? length : copySize;
+        memcpy(dst, stream.mBuffer + (offset - stream.mChunkOffset), copySize);
+        dst += copySize;
+        offset += copySize;
+        length -= copySize;
+    }
+    return ESP_OK;
+}
+
 // datatype BLOB is written as BLOB_INDEX and BLOB_DATA and is searched for previous value as BLOB_INDEX and/or BLOB
 // datatype BLOB_INDEX and BLOB_DATA are not supported as input parameters, the layer above should always use BLOB
 esp_err_t Storage::writeItem(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize)
@@ -383,6 +984,13 @@ esp_err_t Storage::writeItem(uint8_t nsIndex, ItemType datatype, const char* key
         return ESP_ERR_NVS_NOT_INITIALIZED;
     }
 
+    mValueCache.invalidate(nsIndex, key);
+
+    esp_err_t err = eraseCheckpoint();
+    if(err != ESP_OK) {
+        return err;
+    }
+
     // pointer to the page where the existing item was found
     Page* findPage = nullptr;
     // index of the item in the page where the existing item was found
@@ -396,8 +1004,6 @@ esp_err_t Storage::writeItem(uint8_t nsIndex, ItemType datatype, const char* key
     // contains the item with the old value, if found
     Item item;
 
-    esp_err_t err = ESP_OK;
-
     // Try to find existing item with the same key and namespace index
     // We are performing the findItem with datatype specified (it is not ANY) to ensure the hash list lookup is done.
     if(datatype == ItemType::BLOB) {
@@ -574,11 +1180,173 @@ esp_err_t Storage::writeItem(uint8_t nsIndex, ItemType datatype, const char* key
     return err;
 }
 
+// Looks up the previous value of each batch item and counts the entries needed to write the changed ones.
+esp_err_t Storage::findBatchItems(uint8_t nsIndex, TBatch& batch, size_t& entryCount)
+{
+    entryCount = 0;
+    for(auto it = batch.begin(); it != batch.end(); ++it) {
+        Item item;
+        it->mOldPage = nullptr;
+        it->mUnchanged = false;
+
+        esp_err_t err = findItem(nsIndex, it->mDatatype, it->mKey, it->mOldPage, item, Page::CHUNK_ANY, VerOffset::VER_ANY, &it->mOldIndex);
+        if(err == ESP_OK) {
+            it->mUnchanged = (it->mOldPage->cmpItem(nsIndex, it->mDatatype, it->mKey, it->data(), it->mDataSize) == ESP_OK);
+        }
+#ifndef CONFIG_NVS_LEGACY_DUP_KEYS_COMPATIBILITY
+        if(err == ESP_ERR_NVS_NOT_FOUND) {
+            err = findItem(nsIndex, ItemType::ANY, it->mKey, it->mOldPage, item, Page::CHUNK_ANY, VerOffset::VER_ANY, &it->mOldIndex);
+        }
+#endif
+        if(err == ESP_ERR_NVS_NOT_FOUND) {
+            it->mOldPage = nullptr;
+        } else if(err != ESP_OK) {
+            return err;
+        } else {
+            it->mOldDatatype = item.datatype;
+            it->mOldChunkStart = item.blobIndex.chunkStart;
+        }
+
+        if(!it->mUnchanged) {
+            entryCount += 1;
+            if(isVariableLengthType(it->mDatatype)) {
+                entryCount += (it->mDataSize + Page::ENTRY_SIZE - 1) / Page::ENTRY_SIZE;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t Storage::writeItems(uint8_t nsIndex, TBatch& batch)
+{
+    if(mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    for(auto it = batch.begin(); it != batch.end(); ++it) {
+        mValueCache.invalidate(nsIndex, it->mKey);
+    }
+
+    esp_err_t err = eraseCheckpoint();
+    if(err != ESP_OK) {
+        return err;
+    }
+
+    size_t entryCount;
+    err = findBatchItems(nsIndex, batch, entryCount);
+    if(err != ESP_OK) {
+        return err;
+    }
+    if(entryCount == 0) {
+        return ESP_OK;
+    }
+
+    // All new values are written to the active page together. If they don't fit, continue with a new page.
+    // This may relocate items, so their previous values have to be looked up again.
+    if(getCurrentPage().getFreeEntryCount() < entryCount && entryCount <= Page::ENTRY_COUNT) {
+        Page& page = getCurrentPage();
+        if(page.state() != Page::PageState::FULL) {
+            err = page.markFull();
+            if(err != ESP_OK) {
+                return err;
+            }
+        }
+        err = mPageManager.requestNewPage();
+        if(err != ESP_OK) {
+            return err;
+        }
+        err = findBatchItems(nsIndex, batch, entryCount);
+        if(err != ESP_OK) {
+            return err;
+        }
+    }
+
+    if(getCurrentPage().getFreeEntryCount() < entryCount) {
+        // The batch doesn't fit into a single page, write the items one by one.
+        for(auto it = batch.begin(); it != batch.end(); ++it) {
+            if(!it->mUnchanged) {
+                err = writeItem(nsIndex, it->mDatatype, it->mKey, it->data(), it->mDataSize);
+                if(err != ESP_OK) {
+                    return err;
+                }
+            }
+        }
+        return ESP_OK;
+    }
+
+    // Write the new values and erase the previous values on the same page. Nothing is read from
+    // the page until the batch is committed, as the new entries are only written to flash then.
+    Page& page = getCurrentPage();
+    err = page.beginBatch(entryCount);
+    if(err != ESP_OK) {
+        return err;
+    }
+    for(auto it = batch.begin(); it != batch.end() && err == ESP_OK; ++it) {
+        if(it->mUnchanged) {
+            continue;
+        }
+        err = page.writeItem(nsIndex, it->mDatatype, it->mKey, it->data(), it->mDataSize);
+        if(err == ESP_OK && it->mOldPage == &page && it->mOldDatatype != ItemType::BLOB_IDX) {
+            err = page.eraseEntryAndSpan(it->mOldIndex);
+            it->mOldPage = nullptr;
+        }
+    }
+    esp_err_t commitErr = page.commitBatch();
+    if(err == ESP_OK) {
+        err = commitErr;
+    }
+    if(err != ESP_OK) {
+        return err;
+    }
+
+    // Erase the previous values on other pages, with one entry table write per page.
+    for(auto it = batch.begin(); it != batch.end(); ++it) {
+        Page* oldPage = it->mOldPage;
+        if(it->mUnchanged || oldPage == nullptr) {
+            continue;
+        }
+
+        if(it->mOldDatatype == ItemType::BLOB_IDX) {
+            err = eraseMultiPageBlob(nsIndex, it->mKey, it->mOldChunkStart);
+            it->mOldPage = nullptr;
+        } else {
+            err = oldPage->beginBatch(0);
+            if(err == ESP_OK) {
+                for(auto jt = it; jt != batch.end() && err == ESP_OK; ++jt) {
+                    if(!jt->mUnchanged && jt->mOldPage == oldPage && jt->mOldDatatype != ItemType::BLOB_IDX) {
+                        err = oldPage->eraseEntryAndSpan(jt->mOldIndex);
+                        jt->mOldPage = nullptr;
+                    }
+                }
+                commitErr = oldPage->commitBatch();
+                if(err == ESP_OK) {
+                    err = commitErr;
+                }
+            }
+        }
+        if(err == ESP_ERR_FLASH_OP_FAIL) {
+            return ESP_ERR_NVS_REMOVE_FAILED;
+        }
+        if(err != ESP_OK) {
+            return err;
+        }
+    }
+
+#ifdef DEBUG_STORAGE
+    debugCheck();
+#endif
+    return ESP_OK;
+}
+
 esp_err_t Storage::createOrOpenNamespace(const char* nsName, bool canCreate, uint8_t& nsIndex)
 {
     if(mState != StorageState::ACTIVE) {
         return ESP_ERR_NVS_NOT_INITIALIZED;
     }
+    // reserved for the checkpoint (CONFIG_NVS_FAST_BOOT)
+    if(strncmp(nsName, PageManager::CHECKPOINT_NAMESPACE, Item::MAX_KEY_LENGTH) == 0) {
+        return canCreate ? ESP_ERR_NVS_INVALID_NAME : ESP_ERR_NVS_NOT_FOUND;
+    }
     auto it = std::find_if(mNamespaces.begin(), mNamespaces.end(), [=] (const NamespaceEntry& e) -> bool {
         return strncmp(nsName, e.mName, sizeof(e.mName) - 1) == 0;
     });
@@ -588,27 +1356,10 @@ esp_err_t Storage::createOrOpenNamespace(const char* nsName, bool canCreate, uin
         }
 
         uint8_t ns;
-        bool ns_state;
-        for(ns = 1; ns < 255; ++ns) {
-            if(mNamespaceUsage.get(ns, &ns_state) != ESP_OK) {
-                return ESP_FAIL;
-            }
-            if(!ns_state) {
-                break;
-            }
-        }
-
-        if(ns == 255) {
-            return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
-        }
-
-        auto err = writeItem(Page::NS_INDEX, ItemType::U8, nsName, &ns, sizeof(ns));
+        auto err = addNamespace(nsName, ns);
         if(err != ESP_OK) {
             return err;
         }
-        if(mNamespaceUsage.set(ns, true) != ESP_OK) {
-            return ESP_FAIL;
-        }
         nsIndex = ns;
 
         NamespaceEntry* entry = new (std::nothrow) NamespaceEntry;
@@ -627,6 +1378,34 @@ esp_err_t Storage::createOrOpenNamespace(const char* nsName, bool canCreate, uin
     return ESP_OK;
 }
 
+esp_err_t Storage::addNamespace(const char* nsName, uint8_t& nsIndex)
+{
+    uint8_t ns;
+    bool ns_state;
+    for(ns = 1; ns < 255; ++ns) {
+        if(mNamespaceUsage.get(ns, &ns_state) != ESP_OK) {
+            return ESP_FAIL;
+        }
+        if(!ns_state) {
+            break;
+        }
+    }
+
+    if(ns == 255) {
+        return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+
+    auto err = writeItem(Page::NS_INDEX, ItemType::U8, nsName, &ns, sizeof(ns));
+    if(err != ESP_OK) {
+        return err;
+    }
+    if(mNamespaceUsage.set(ns, true) != ESP_OK) {
+        return ESP_FAIL;
+    }
+    nsIndex = ns;
+    return ESP_OK;
+}
+
 esp_err_t Storage::readMultiPageBlob(uint8_t nsIndex, const char* key, void* data, size_t dataSize)
 {
     Item item;
@@ -676,6 +1455,11 @@ esp_err_t Storage::readMultiPageBlob(uint8_t nsIndex, const char* key, void* dat
     if(err == ESP_ERR_NVS_NOT_FOUND || err == ESP_ERR_NVS_INVALID_LENGTH) {
         // cleanup if a chunk is not found or the size is inconsistent
         eraseMultiPageBlob(nsIndex, key);
+        // init() skips erasing incomplete blobs after a clean deinit (CONFIG_NVS_FAST_BOOT), a chunk removed
+        // as corrupted while loading its page is found missing here
+        if(err == ESP_ERR_NVS_NOT_FOUND) {
+            return err;
+        }
     }
 
     NVS_ASSERT_OR_RETURN(offset == dataSize, ESP_FAIL);
@@ -745,10 +1529,17 @@ esp_err_t Storage::readItem(uint8_t nsIndex, ItemType datatype, const char* key,
         return ESP_ERR_NVS_NOT_INITIALIZED;
     }
 
+    if(mValueCache.read(nsIndex, datatype, key, data, dataSize)) {
+        return ESP_OK;
+    }
+
     Item item;
     Page* findPage = nullptr;
     if(datatype == ItemType::BLOB) {
         auto err = readMultiPageBlob(nsIndex, key, data, dataSize);
+        if(err == ESP_OK) {
+            mValueCache.insert(nsIndex, datatype, key, data, dataSize);
+        }
         if(err != ESP_ERR_NVS_NOT_FOUND) {
             return err;
         } // else check if the blob is stored with earlier version format without index
@@ -758,7 +1549,11 @@ esp_err_t Storage::readItem(uint8_t nsIndex, ItemType datatype, const char* key,
     if(err != ESP_OK) {
         return err;
     }
-    return findPage->readItem(nsIndex, datatype, key, data, dataSize);
+    err = findPage->readItem(nsIndex, datatype, key, data, dataSize);
+    if(err == ESP_OK) {
+        mValueCache.insert(nsIndex, datatype, key, data, isVariableLengthType(datatype) ? item.varLength.dataSize : dataSize);
+    }
+    return err;
 
 }
 
@@ -767,12 +1562,20 @@ esp_err_t Storage::eraseMultiPageBlob(uint8_t nsIndex, const char* key, VerOffse
     if(mState != StorageState::ACTIVE) {
         return ESP_ERR_NVS_NOT_INITIALIZED;
     }
+
+    mValueCache.invalidate(nsIndex, key);
+
+    auto err = eraseCheckpoint();
+    if(err != ESP_OK) {
+        return err;
+    }
+
     Item item;
     Page* findPage = nullptr;
     size_t itemIndex = 0;
     uint8_t chunkCount = 0;
 
-    auto err = findItem(nsIndex, ItemType::BLOB_IDX, key, findPage, item, Page::CHUNK_ANY, chunkStart, &itemIndex);
+    err = findItem(nsIndex, ItemType::BLOB_IDX, key, findPage, item, Page::CHUNK_ANY, chunkStart, &itemIndex);
     if(err != ESP_OK) {
         return err;
     }
@@ -869,9 +1672,15 @@ esp_err_t Storage::eraseItem(uint8_t nsIndex, ItemType datatype, const char* key
         return ESP_ERR_NVS_NOT_INITIALIZED;
     }
 
+    mValueCache.invalidate(nsIndex, key);
+
+    esp_err_t err = eraseCheckpoint();
+    if(err != ESP_OK) {
+        return err;
+    }
+
     Item item;
     Page* findPage = nullptr;
-    esp_err_t err = ESP_OK;
     size_t itemIndex = 0;
 
     err = findItem(nsIndex, datatype, key, findPage, item, Page::CHUNK_ANY, VerOffset::VER_ANY, &itemIndex);
@@ -892,6 +1701,13 @@ esp_err_t Storage::eraseNamespace(uint8_t nsIndex)
         return ESP_ERR_NVS_NOT_INITIALIZED;
     }
 
+    mValueCache.invalidateNamespace(nsIndex);
+
+    esp_err_t err = eraseCheckpoint();
+    if(err != ESP_OK) {
+        return err;
+    }
+
     for(auto it = std::begin(mPageManager); it != std::end(mPageManager); ++it) {
         while(true) {
             auto err = it->eraseItem(nsIndex, ItemType::ANY, nullptr);
@@ -933,6 +1749,10 @@ esp_err_t Storage::getItemDataSize(uint8_t nsIndex, ItemType datatype, const cha
         return ESP_ERR_NVS_NOT_INITIALIZED;
     }
 
+    if(isVariableLengthType(datatype) && mValueCache.getSize(nsIndex, datatype, key, dataSize)) {
+        return ESP_OK;
+    }
+
     Item item;
     Page* findPage = nullptr;
     esp_err_t err = ESP_OK;
@@ -997,6 +1817,11 @@ esp_err_t Storage::fillStats(nvs_stats_t& nvsStats)
     return mPageManager.fillStats(nvsStats);
 }
 
+void Storage::fillCacheStats(nvs_cache_stats_t& cacheStats) const
+{
+    mValueCache.fillStats(cacheStats);
+}
+
 esp_err_t Storage::calcEntriesInNamespace(uint8_t nsIndex, size_t& usedEntries)
 {
     usedEntries = 0;
@@ -1085,7 +1910,7 @@ bool Storage::nextEntry(nvs_opaque_iterator_t* it)
         do {
             err = page->findItem(it->nsIndex, (ItemType)it->type, nullptr, it->entryIndex, item);
             it->entryIndex += item.span;
-            if(err == ESP_OK && isIterableItem(item) && !isMultipageBlob(item)) {
+            if(err == ESP_OK && isIterableItem(item) && !isMultipageBlob(item) && item.nsIndex != mCheckpointNsIndex) {
                 fillEntryInfo(item, it->entry_info);
                 it->page = page;
                 return true;
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -13,6 +13,7 @@
 #include "nvs_types.hpp"
 #include "nvs_page.hpp"
 #include "nvs_pagemanager.hpp"
+#include "nvs_value_cache.hpp"
 #include "nvs_memory_management.hpp"
 #include "partition.hpp"
 
@@ -36,6 +37,23 @@ class Storage : public intrusive_list_node<Storage>, public ExceptionlessAllocat
 
     typedef intrusive_list<NamespaceEntry> TNamespaces;
 
+    /**
+     * Layout of the checkpoint item: header followed by one record per namespace, including the checkpoint
+     * namespace.
+     */
+    struct CheckpointHeader {
+        uint32_t mVersion;
+        uint32_t mNamespaceCount;
+    };
+
+    struct CheckpointNamespace {
+        uint8_t mIndex;
+        char mName[Item::MAX_KEY_LENGTH];   // not null-terminated if the name has the maximum length
+    };
+
+    static const uint32_t CHECKPOINT_VERSION = 0x4e534301;
+    static const size_t CHECKPOINT_MAX_NAMESPACES = (Page::CHUNK_MAX_SIZE - sizeof(CheckpointHeader)) / sizeof(CheckpointNamespace);
+
     struct UsedPageNode: public intrusive_list_node<UsedPageNode>, public ExceptionlessAllocatable {
         public: Page* mPage;
     };
@@ -56,6 +74,74 @@ class Storage : public intrusive_list_node<Storage>, public ExceptionlessAllocat
     typedef intrusive_list<BlobIndexNode> TBlobIndexList;
 
 public:
+    /**
+     * Value staged in a transaction (see NVSHandle::begin_transaction()) to be written by writeItems().
+     * Only primitive types and strings can be staged.
+     */
+    struct BatchItem : public intrusive_list_node<BatchItem>, public ExceptionlessAllocatable {
+    public:
+        ~BatchItem()
+        {
+            delete[] mData;
+        }
+
+        ItemType mDatatype;
+        char mKey[Item::MAX_KEY_LENGTH + 1];
+        size_t mDataSize;
+        uint8_t mValue[8];          // value of primitive types
+        uint8_t* mData = nullptr;   // value of strings
+
+        const void* data() const
+        {
+            return mData ? mData : mValue;
+        }
+
+        // filled in by writeItems()
+        Page* mOldPage;
+        size_t mOldIndex;
+        ItemType mOldDatatype;
+        VerOffset mOldChunkStart;
+        bool mUnchanged;
+    };
+
+    typedef intrusive_list<BatchItem> TBatch;
+
+    /**
+     * Blob which is written or read in pieces (see nvs_blob_stream_open_write() and nvs_blob_stream_open_read()).
+     * The pieces are mapped onto the BLOB_DATA chunks of the multi-page blob format, at most one chunk is kept
+     * in mBuffer.
+     */
+    struct BlobStream : public intrusive_list_node<BlobStream>, public ExceptionlessAllocatable {
+    public:
+        ~BlobStream()
+        {
+            delete[] mBuffer;
+        }
+
+        uint8_t mNsIndex;
+        char mKey[Item::MAX_KEY_LENGTH + 1];
+        size_t mDataSize;               // size of the whole blob
+        VerOffset mChunkStart;          // version of the chunks being written or read
+        uint8_t mChunkCount = 0;        // number of chunks written so far, or of the blob being read
+        uint8_t* mBuffer = nullptr;
+        size_t mBufferSize = 0;
+
+        // writing: mWritten bytes are stored in chunks, the next mBuffered bytes are in mBuffer
+        bool mWriting = false;
+        size_t mWritten = 0;
+        size_t mBuffered = 0;
+        ItemType mOldDatatype;          // previous value of the key, erased by commitBlobStream(), or ANY
+        VerOffset mOldChunkStart;
+
+        // reading: chunk number mChunk starts at mChunkOffset, its size is known if mChunkFound
+        bool mLegacy = false;           // blob written before multi-page blob support, read as a single chunk
+        uint8_t mChunk = 0;
+        size_t mChunkOffset = 0;
+        size_t mChunkSize = 0;
+        bool mChunkFound = false;
+        bool mChunkLoaded = false;
+    };
+
     ~Storage();
 
     Storage(Partition *partition) : mPartition(partition) {
@@ -72,6 +158,8 @@ public:
 
     esp_err_t writeItem(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize);
 
+    esp_err_t writeItems(uint8_t nsIndex, TBatch& batch);
+
     esp_err_t readItem(uint8_t nsIndex, ItemType datatype, const char* key, void* data, size_t dataSize);
 
     esp_err_t findKey(const uint8_t nsIndex, const char* key, ItemType* datatype);
@@ -122,14 +210,44 @@ public:
 
     esp_err_t eraseMultiPageBlob(uint8_t nsIndex, const char* key, VerOffset chunkStart = VerOffset::VER_ANY);
 
+    /**
+     * Starts writing a blob of dataSize bytes in pieces. The chunks are written with the version which isn't used
+     * by the current value of the key, which stays readable until commitBlobStream() writes the blob index.
+     */
+    esp_err_t openBlobStreamWrite(uint8_t nsIndex, const char* key, size_t dataSize, BlobStream& stream);
+
+    esp_err_t writeBlobStream(BlobStream& stream, const void* data, size_t length);
+
+    esp_err_t commitBlobStream(BlobStream& stream);
+
+    /**
+     * Erases the chunks written by a stream which is not committed. Chunks which can't be erased are left
+     * to the removal of orphaned chunks by the next init().
+     */
+    void abortBlobStream(BlobStream& stream);
+
+    esp_err_t openBlobStreamRead(uint8_t nsIndex, const char* key, BlobStream& stream);
+
+    esp_err_t readBlobStream(BlobStream& stream, size_t offset, void* data, size_t length);
+
     void debugDump();
 
     void debugCheck();
 
     esp_err_t fillStats(nvs_stats_t& nvsStats);
 
+    void fillCacheStats(nvs_cache_stats_t& cacheStats) const;
+
     esp_err_t calcEntriesInNamespace(uint8_t nsIndex, size_t& usedEntries);
 
+    /**
+     * Writes the namespace table as the last item of the partition, so that the next init() can skip reading
+     * all pages and the consistency checks (CONFIG_NVS_FAST_BOOT). The checkpoint is erased on the first
+     * modification of the partition. Does nothing if fast boot is disabled or the partition is read-only.
+     * Fails with ESP_ERR_NVS_INVALID_STATE while a blob write stream is neither committed nor closed.
+     */
+    esp_err_t writeCheckpoint();
+
     bool findEntry(nvs_opaque_iterator_t* it, const char* name);
 
     bool findEntryNs(nvs_opaque_iterator_t* it, uint8_t nsIndex);
@@ -145,6 +263,17 @@ protected:
 
     void clearNamespaces();
 
+    esp_err_t loadNamespaces();
+
+    esp_err_t loadCheckpoint();
+
+    esp_err_t addNamespace(const char* nsName, uint8_t& nsIndex);
+
+    esp_err_t eraseCheckpoint()
+    {
+        return mPageManager.eraseCheckpoint();
+    }
+
     esp_err_t populateBlobIndices(TBlobIndexList&);
 
     void eraseMismatchedBlobIndexes(TBlobIndexList&);
@@ -153,8 +282,24 @@ protected:
 
     void fillEntryInfo(Item &item, nvs_entry_info_t &info);
 
+    esp_err_t findBatchItems(uint8_t nsIndex, TBatch& batch, size_t& entryCount);
+
+    esp_err_t flushBlobStream(BlobStream& stream, bool commit);
+
+    esp_err_t findBlobStreamChunk(BlobStream& stream, Page* &page, Item& item, size_t& itemIndex);
+
+    size_t getMaxBlobSize();
+
     esp_err_t findItem(uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item, uint8_t chunkIdx = Page::CHUNK_ANY, VerOffset chunkStart = VerOffset::VER_ANY, size_t* itemIndex = NULL);
 
+    esp_err_t findIndexedItem(Page** pages, size_t pageCount, uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item, uint8_t chunkIdx, VerOffset chunkStart, size_t* itemIndex);
+
+    /**
+     * Maximum number of candidate pages returned by the item index which are searched directly.
+     * If more pages share the hash of a key, all pages are searched.
+     */
+    static const size_t INDEX_MAX_PAGES = 8;
+
 protected:
     Partition *mPartition;
     size_t mPageCount;
@@ -162,6 +307,27 @@ protected:
     TNamespaces mNamespaces;
     CompressedEnumTable<bool, 1, 256> mNamespaceUsage;
     StorageState mState = StorageState::INVALID;
+
+    /**
+     * Index of the namespace holding the checkpoint, 0 if there is none. It is not part of mNamespaces.
+     */
+    uint8_t mCheckpointNsIndex = 0;
+
+    /**
+     * Blob write streams which are neither committed nor closed. Their chunks have no blob index yet.
+     */
+    size_t mUncommittedStreams = 0;
+
+    /**
+     * Chunks of an aborted stream could not be erased. They are removed by the checks of the next init(),
+     * which no checkpoint may skip.
+     */
+    bool mOrphanedChunks = false;
+
+    /**
+     * Values read recently, invalidated by every write and erase of their key.
+     */
+    ValueCache mValueCache{CONFIG_NVS_VALUE_CACHE_SIZE};
 };
 
 } // namespace nvs
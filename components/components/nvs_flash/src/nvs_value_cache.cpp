@@ -0,0 +1,205 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <cstring>
+#if __has_include(<bsd/string.h>)
+// for strlcpy
+#include <bsd/string.h>
+#endif
+#include "nvs_value_cache.hpp"
+
+namespace nvs
+{
+
+ValueCache::~ValueCache()
+{
+    clear();
+}
+
+ValueCache::Namespace* ValueCache::findNamespace(uint8_t nsIndex)
+{
+    for (auto it = mNamespaces.begin(); it != mNamespaces.end(); ++it) {
+        if (it->mIndex == nsIndex) {
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+ValueCache::Entry* ValueCache::findEntry(Namespace* ns, ItemType datatype, const char* key)
+{
+    for (auto it = ns->mEntries.begin(); it != ns->mEntries.end(); ++it) {
+        if (it->mDatatype == datatype && strncmp(it->mKey, key, sizeof(it->mKey)) == 0) {
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+void ValueCache::eraseEntry(Namespace* ns, Entry* entry)
+{
+    const size_t cost = getCost(entry->mDataSize);
+    ns->mUsedBytes -= cost;
+    mUsedBytes -= cost;
+    ns->mEntries.erase(entry);
+    delete entry;
+    if (ns->mEntries.empty()) {
+        mNamespaces.erase(ns);
+        delete ns;
+    }
+}
+
+bool ValueCache::read(uint8_t nsIndex, ItemType datatype, const char* key, void* data, size_t dataSize)
+{
+    if (!isEnabled()) {
+        return false;
+    }
+
+    Namespace* ns = findNamespace(nsIndex);
+    Entry* entry = (ns != nullptr) ? findEntry(ns, datatype, key) : nullptr;
+    if (entry == nullptr) {
+        ++mMisses;
+        return false;
+    }
+
+    // let the flash read path report the error for a buffer of the wrong size
+    bool sizeOk = (datatype == ItemType::SZ) ? (dataSize >= entry->mDataSize) : (dataSize == entry->mDataSize);
+    if (!sizeOk) {
+        ++mMisses;
+        return false;
+    }
+
+    memcpy(data, entry->mData, entry->mDataSize);
+    if (&ns->mEntries.front() != entry) {
+        ns->mEntries.erase(entry);
+        ns->mEntries.push_front(entry);
+    }
+    ++mHits;
+    return true;
+}
+
+bool ValueCache::getSize(uint8_t nsIndex, ItemType datatype, const char* key, size_t& dataSize)
+{
+    if (!isEnabled()) {
+        return false;
+    }
+
+    Namespace* ns = findNamespace(nsIndex);
+    Entry* entry = (ns != nullptr) ? findEntry(ns, datatype, key) : nullptr;
+    if (entry == nullptr) {
+        return false;
+    }
+    dataSize = entry->mDataSize;
+    return true;
+}
+
+bool ValueCache::evictOne()
+{
+    Namespace* largest = nullptr;
+    for (auto it = mNamespaces.begin(); it != mNamespaces.end(); ++it) {
+        if (largest == nullptr || it->mUsedBytes > largest->mUsedBytes) {
+            largest = it;
+        }
+    }
+    if (largest == nullptr) {
+        return false;
+    }
+    eraseEntry(largest, &largest->mEntries.back());
+    ++mEvictions;
+    return true;
+}
+
+void ValueCache::insert(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize)
+{
+    const size_t cost = getCost(dataSize);
+    if (!isEnabled() || cost > mCapacity / 4) {
+        return;
+    }
+
+    Namespace* ns = findNamespace(nsIndex);
+    Entry* old = (ns != nullptr) ? findEntry(ns, datatype, key) : nullptr;
+    if (old != nullptr) {
+        eraseEntry(ns, old);
+    }
+    while (mUsedBytes + cost > mCapacity && evictOne()) {
+    }
+    // the namespace is freed together with its last entry, so it has to be looked up again
+    ns = findNamespace(nsIndex);
+
+    Entry* entry = new (std::nothrow) Entry;
+    if (entry == nullptr) {
+        return;
+    }
+    entry->mData = new (std::nothrow) uint8_t[dataSize > 0 ? dataSize : 1];
+    if (entry->mData == nullptr) {
+        delete entry;
+        return;
+    }
+    if (ns == nullptr) {
+        ns = new (std::nothrow) Namespace;
+        if (ns == nullptr) {
+            delete entry;
+            return;
+        }
+        ns->mIndex = nsIndex;
+        mNamespaces.push_back(ns);
+    }
+
+    entry->mDatatype = datatype;
+    strlcpy(entry->mKey, key, sizeof(entry->mKey));
+    entry->mDataSize = dataSize;
+    memcpy(entry->mData, data, dataSize);
+    ns->mEntries.push_front(entry);
+    ns->mUsedBytes += cost;
+    mUsedBytes += cost;
+}
+
+void ValueCache::invalidate(uint8_t nsIndex, const char* key)
+{
+    Namespace* ns = findNamespace(nsIndex);
+    if (ns == nullptr) {
+        return;
+    }
+    for (auto it = ns->mEntries.begin(); it != ns->mEntries.end();) {
+        Entry* entry = it;
+        ++it;
+        if (strncmp(entry->mKey, key, sizeof(entry->mKey)) == 0) {
+            if (ns->mEntries.size() == 1) {
+                // the namespace is freed together with its last entry
+                eraseEntry(ns, entry);
+                return;
+            }
+            eraseEntry(ns, entry);
+        }
+    }
+}
+
+void ValueCache::invalidateNamespace(uint8_t nsIndex)
+{
+    Namespace* ns = findNamespace(nsIndex);
+    if (ns == nullptr) {
+        return;
+    }
+    mUsedBytes -= ns->mUsedBytes;
+    mNamespaces.erase(ns);
+    delete ns;
+}
+
+void ValueCache::clear()
+{
+    mNamespaces.clearAndFreeNodes();
+    mUsedBytes = 0;
+}
+
+void ValueCache::fillStats(nvs_cache_stats_t& stats) const
+{
+    stats.size = mCapacity;
+    stats.used_bytes = mUsedBytes;
+    stats.hits = mHits;
+    stats.misses = mMisses;
+    stats.evictions = mEvictions;
+}
+
+} // namespace nvs
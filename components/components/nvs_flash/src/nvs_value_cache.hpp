@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef nvs_value_cache_hpp
+#define nvs_value_cache_hpp
+
+#include "nvs.h"
+#include "nvs_types.hpp"
+#include "intrusive_list.h"
+#include "nvs_memory_management.hpp"
+
+namespace nvs
+{
+
+/**
+ * Bounded cache of item values read by Storage::readItem.
+ *
+ * Values are kept per namespace in least recently used order. When the cache is full, the least recently used value
+ * of the namespace occupying the most memory is evicted, so a namespace which reads many different keys can't push
+ * the values of all other namespaces out of the cache.
+ *
+ * The cache doesn't know when values change, Storage has to invalidate the key on each write or erase.
+ * The memory used by a value is counted as its size plus the size of the bookkeeping structure.
+ */
+class ValueCache
+{
+public:
+    ValueCache(size_t capacity) : mCapacity(capacity) { }
+
+    ~ValueCache();
+
+    /**
+     * Copies a cached value to data.
+     *
+     * For fixed length types, dataSize has to match the size of the value. For strings it has to be large enough
+     * and for blobs it has to be equal to the size of the value, as Storage::readItem would require.
+     *
+     * @return true if the value was found and copied, false if it has to be read from flash
+     */
+    bool read(uint8_t nsIndex, ItemType datatype, const char* key, void* data, size_t dataSize);
+
+    /**
+     * Returns the size of a cached value, without counting a hit or miss.
+     */
+    bool getSize(uint8_t nsIndex, ItemType datatype, const char* key, size_t& dataSize);
+
+    /**
+     * Adds a value which has just been read from flash. Values which would occupy more than a quarter
+     * of the cache are not cached. Allocation failures are ignored.
+     */
+    void insert(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize);
+
+    /**
+     * Removes the values of all data types stored under the key.
+     */
+    void invalidate(uint8_t nsIndex, const char* key);
+
+    void invalidateNamespace(uint8_t nsIndex);
+
+    void clear();
+
+    bool isEnabled() const
+    {
+        return mCapacity > 0;
+    }
+
+    void fillStats(nvs_cache_stats_t& stats) const;
+
+protected:
+    struct Entry : public intrusive_list_node<Entry>, public ExceptionlessAllocatable {
+        ~Entry()
+        {
+            delete[] mData;
+        }
+
+        ItemType mDatatype;
+        char mKey[Item::MAX_KEY_LENGTH + 1];
+        size_t mDataSize;
+        uint8_t* mData = nullptr;
+    };
+
+    struct Namespace : public intrusive_list_node<Namespace>, public ExceptionlessAllocatable {
+        ~Namespace()
+        {
+            mEntries.clearAndFreeNodes();
+        }
+
+        uint8_t mIndex;
+        size_t mUsedBytes = 0;
+        intrusive_list<Entry> mEntries;    // most recently used first
+    };
+
+    static size_t getCost(size_t dataSize)
+    {
+        return sizeof(Entry) + dataSize;
+    }
+
+    Namespace* findNamespace(uint8_t nsIndex);
+
+    Entry* findEntry(Namespace* ns, ItemType datatype, const char* key);
+
+    void eraseEntry(Namespace* ns, Entry* entry);
+
+    bool evictOne();
+
+    size_t mCapacity;
+    size_t mUsedBytes = 0;
+    uint32_t mHits = 0;
+    uint32_t mMisses = 0;
+    uint32_t mEvictions = 0;
+    intrusive_list<Namespace> mNamespaces;
+}; // class ValueCache
+
+} // namespace nvs
+
+#endif /* nvs_value_cache_hpp */
@@ -0,0 +1,169 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <catch2/catch_test_macros.hpp>
+#include "esp_transport.h"
+#include "esp_transport_ssl.h"
+#include "esp_transport_tcp.h"
+
+namespace {
+
+// Room left in the send buffer of the socket, a sendmsg() with no room fails
+size_t send_room;
+int sendmsg_calls;
+std::string sent_data;
+
+// Data of each esp_tls_conn_write(), which makes a TLS record
+std::vector<std::string> records;
+
+// Socket of the connection, a real file so that it can be polled for write
+int sockfd;
+
+}
+
+extern "C" {
+#include "Mockesp_tls.h"
+
+    ssize_t lwip_sendmsg(int s, const struct msghdr *message, int flags)
+    {
+        sendmsg_calls++;
+        if (send_room == 0) {
+            errno = ECONNRESET;
+            return -1;
+        }
+        size_t len = 0;
+        for (size_t i = 0; i < message->msg_iovlen && len < send_room; i++) {
+            size_t part = std::min(message->msg_iov[i].iov_len, send_room - len);
+            sent_data.append(static_cast<const char *>(message->msg_iov[i].iov_base), part);
+            len += part;
+        }
+        return len;
+    }
+}
+
+using unique_transport = std::unique_ptr<std::remove_pointer_t<esp_transport_handle_t>, decltype(&esp_transport_destroy)>;
+
+TEST_CASE("TCP transport writev", "[success]")
+{
+    constexpr static auto timeout = 50;
+    // Closed by the transport
+    sockfd = open("/dev/null", O_WRONLY);
+    REQUIRE(sockfd >= 0);
+    esp_tls_plain_tcp_connect_Stub([](const char *host, int hostlen, int port, const esp_tls_cfg_t *cfg,
+    esp_tls_error_handle_t error_handle, int *fd, int num_call) -> esp_err_t {
+        *fd = sockfd;
+        return ESP_OK;
+    });
+
+    unique_transport tcp{esp_transport_tcp_init(), esp_transport_destroy};
+    REQUIRE(tcp);
+    REQUIRE(esp_transport_connect(tcp.get(), "localhost", 80, timeout) == 0);
+
+    char header[] = "header";
+    char payload[] = "payload";
+    struct iovec iov[] = {
+        { .iov_base = header, .iov_len = sizeof(header) - 1 },
+        { .iov_base = payload, .iov_len = sizeof(payload) - 1 },
+    };
+    sendmsg_calls = 0;
+    sent_data.clear();
+
+    SECTION("The buffers are sent with one sendmsg()") {
+        send_room = SIZE_MAX;
+        REQUIRE(esp_transport_writev(tcp.get(), iov, 2, timeout) == 13);
+        REQUIRE(sendmsg_calls == 1);
+        REQUIRE(sent_data == "headerpayload");
+    }
+
+    SECTION("A partial sendmsg() returns the length sent, across the buffers") {
+        send_room = 8;
+        REQUIRE(esp_transport_writev(tcp.get(), iov, 2, timeout) == 8);
+        REQUIRE(sendmsg_calls == 1);
+        REQUIRE(sent_data == "headerpa");
+
+        // The caller writes the rest of the second buffer
+        struct iovec rest = { .iov_base = payload + 2, .iov_len = sizeof(payload) - 3 };
+        send_room = SIZE_MAX;
+        REQUIRE(esp_transport_writev(tcp.get(), &rest, 1, timeout) == 5);
+        REQUIRE(sent_data == "headerpayload");
+    }
+
+    SECTION("A failed sendmsg() keeps the errno in the transport") {
+        send_room = 0;
+        REQUIRE(esp_transport_writev(tcp.get(), iov, 2, timeout) < 0);
+        REQUIRE(esp_transport_get_errno(tcp.get()) == ECONNRESET);
+    }
+}
+
+TEST_CASE("SSL transport writev", "[success]")
+{
+    constexpr static auto timeout = 50;
+    static char tls;
+    sockfd = open("/dev/null", O_WRONLY);
+    REQUIRE(sockfd >= 0);
+    esp_tls_init_IgnoreAndReturn(reinterpret_cast<esp_tls_t *>(&tls));
+    esp_tls_conn_new_sync_IgnoreAndReturn(1);
+    esp_tls_get_conn_sockfd_Stub([](esp_tls_t *tls, int *fd, int num_call) -> esp_err_t {
+        *fd = sockfd;
+        return ESP_OK;
+    });
+    esp_tls_conn_write_Stub([](esp_tls_t *tls, const void *data, size_t datalen, int num_call) -> ssize_t {
+        records.emplace_back(static_cast<const char *>(data), datalen);
+        return datalen;
+    });
+    esp_tls_conn_destroy_IgnoreAndReturn(0);
+
+    unique_transport ssl{esp_transport_ssl_init(), esp_transport_destroy};
+    REQUIRE(ssl);
+    REQUIRE(esp_transport_connect(ssl.get(), "localhost", 443, timeout) == 0);
+    records.clear();
+
+    std::string header = "header";
+    struct iovec iov[] = {
+        { .iov_base = header.data(), .iov_len = header.size() },
+        { .iov_base = nullptr, .iov_len = 0 },
+    };
+
+    SECTION("Buffers of up to 256 bytes in total are written in one record") {
+        std::string payload(256 - header.size(), 'p');
+        iov[1] = { .iov_base = payload.data(), .iov_len = payload.size() };
+        REQUIRE(esp_transport_writev(ssl.get(), iov, 2, timeout) == 256);
+        REQUIRE(records.size() == 1);
+        REQUIRE(records[0] == header + payload);
+    }
+
+    SECTION("Buffers of up to 16 KB in total are written in one record") {
+        std::string payload(16384 - header.size(), 'p');
+        iov[1] = { .iov_base = payload.data(), .iov_len = payload.size() };
+        REQUIRE(esp_transport_writev(ssl.get(), iov, 2, timeout) == 16384);
+        REQUIRE(records.size() == 1);
+        REQUIRE(records[0] == header + payload);
+    }
+
+    SECTION("Larger buffers are written one record each") {
+        std::string payload(16384 - header.size() + 1, 'p');
+        iov[1] = { .iov_base = payload.data(), .iov_len = payload.size() };
+        REQUIRE(esp_transport_writev(ssl.get(), iov, 2, timeout) == 16385);
+        REQUIRE(records.size() == 2);
+        REQUIRE(records[0] == header);
+        REQUIRE(records[1] == payload);
+    }
+
+    // The socket is owned by the mocked esp-tls connection
+    ssl.reset();
+    close(sockfd);
+}
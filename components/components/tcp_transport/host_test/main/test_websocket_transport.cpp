@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2024-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -10,8 +10,12 @@
 #include <string>
 #include <type_traits>
 #include <array>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 #include <vector>
 #include <netinet/in.h>
+#include <sys/socket.h>
 #include <netdb.h>
 #include "fmt/core.h"
 #include "fmt/ranges.h"
@@ -140,6 +144,28 @@ int mock_valid_poll_read_fragmented_callback(esp_transport_handle_t t, int timeo
     return mock_valid_read_fragmented_callback(t, nullptr, 0, 0, 0);
 }
 
+// Data written to the parent transport
+std::string written_data;
+
+int mock_write_capture_callback(esp_transport_handle_t transport, const char *buffer, int len, int timeout_ms, int num_call)
+{
+    written_data.append(buffer, len);
+    return len;
+}
+
+// Data read from the parent transport, in parts of uneven sizes
+std::string read_data;
+size_t read_pos;
+
+int mock_read_parts_callback(esp_transport_handle_t transport, char *buffer, int len, int timeout_ms, int num_call)
+{
+    static constexpr int read_sizes[] = { 1, 3, 40, 7, 2, 13 };
+    int size = std::min({len, read_sizes[num_call % std::size(read_sizes)], static_cast<int>(read_data.size() - read_pos)});
+    std::memcpy(buffer, read_data.data() + read_pos, size);
+    read_pos += size;
+    return size;
+}
+
 }
 
 TEST_CASE("WebSocket Transport Connection", "[success]")
@@ -342,3 +368,127 @@ TEST_CASE("WebSocket Transport Connection", "[failure]")
         REQUIRE(std::string(response_header_buffer.data()) == "");
     }
 }
+
+TEST_CASE("WebSocket Transport masked write", "[success]")
+{
+    constexpr static auto timeout = 50;
+    unique_transport parent_handle{esp_transport_init(), esp_transport_destroy};
+    REQUIRE(parent_handle);
+    esp_transport_set_func(parent_handle.get(), mock_connect, mock_read, mock_write, mock_close, mock_poll_read, mock_poll_write, mock_destroy);
+
+    unique_transport websocket_transport{esp_transport_ws_init(parent_handle.get()), esp_transport_destroy};
+    REQUIRE(websocket_transport);
+
+    mock_poll_write_Stub([](esp_transport_handle_t h, int tout, int n) {
+        return 1;
+    });
+    mock_write_Stub(mock_write_capture_callback);
+    mock_destroy_ExpectAnyArgsAndReturn(ESP_OK);
+
+    // Payloads larger than the masking buffer, at any alignment
+    std::vector<char> payload(3 * CONFIG_WS_MASK_BUFFER_SIZE + 8);
+    for (size_t i = 0; i < payload.size(); i++) {
+        payload[i] = static_cast<char>(i * 7 + 1);
+    }
+    const std::vector<char> original = payload;
+
+    for (int len : {0, 1, 5, 125, 126, CONFIG_WS_MASK_BUFFER_SIZE, 3 * CONFIG_WS_MASK_BUFFER_SIZE + 5}) {
+        for (int offset = 0; offset < 3; offset++) {
+            written_data.clear();
+            REQUIRE(esp_transport_ws_send_raw(websocket_transport.get(), static_cast<ws_transport_opcodes_t>(WS_TRANSPORT_OPCODES_BINARY | WS_TRANSPORT_OPCODES_FIN),
+                                              payload.data() + offset, len, timeout) == len);
+
+            // The data of the caller is left untouched
+            REQUIRE(payload == original);
+
+            // The frame is masked and unmasks back to the payload
+            const auto *frame = reinterpret_cast<const uint8_t *>(written_data.data());
+            size_t header_len = len < 126 ? 2 : 4;
+            REQUIRE(written_data.size() == header_len + 4 + len);
+            REQUIRE((frame[1] & 0x80) != 0);
+            const uint8_t *mask_key = frame + header_len;
+            for (int i = 0; i < len; i++) {
+                REQUIRE(static_cast<char>(frame[header_len + 4 + i] ^ mask_key[i % 4]) == payload[offset + i]);
+            }
+        }
+    }
+}
+
+TEST_CASE("WebSocket Transport masked read in parts", "[success]")
+{
+    constexpr static auto timeout = 50;
+    unique_transport parent_handle{esp_transport_init(), esp_transport_destroy};
+    REQUIRE(parent_handle);
+    esp_transport_set_func(parent_handle.get(), mock_connect, mock_read, mock_write, mock_close, mock_poll_read, mock_poll_write, mock_destroy);
+
+    unique_transport websocket_transport{esp_transport_ws_init(parent_handle.get()), esp_transport_destroy};
+    REQUIRE(websocket_transport);
+
+    mock_poll_read_Stub([](esp_transport_handle_t h, int tout, int n) {
+        return 1;
+    });
+    mock_read_Stub(mock_read_parts_callback);
+    mock_destroy_ExpectAnyArgsAndReturn(ESP_OK);
+
+    // A binary frame with a 16-bit length, masked
+    std::vector<char> payload(300);
+    for (size_t i = 0; i < payload.size(); i++) {
+        payload[i] = static_cast<char>(i * 7 + 1);
+    }
+    const char mask_key[] = { 0x12, 0x34, 0x56, 0x78 };
+    read_data = { '\x82', '\xfe', 0x01, 0x2c };
+    read_data.append(mask_key, sizeof(mask_key));
+    for (size_t i = 0; i < payload.size(); i++) {
+        read_data.push_back(payload[i] ^ mask_key[i % 4]);
+    }
+    read_pos = 0;
+
+    // The parts start at any position of the mask key, and are stored at any alignment
+    std::vector<char> received(payload.size() + 1);
+    static constexpr int part_sizes[] = { 5, 1, 22, 3, 64, 9 };
+    size_t pos = 0;
+    for (int n = 0; pos < payload.size(); n++) {
+        int len = std::min(part_sizes[n % std::size(part_sizes)], static_cast<int>(payload.size() - pos));
+        int ret = esp_transport_read(websocket_transport.get(), received.data() + 1 + pos, len, timeout);
+        REQUIRE(ret > 0);
+        REQUIRE(ret <= len);
+        pos += ret;
+    }
+    REQUIRE(std::equal(payload.begin(), payload.end(), received.begin() + 1));
+    REQUIRE(read_pos == read_data.size());
+}
+
+TEST_CASE("Transport writev without writev function", "[success]")
+{
+    constexpr static auto timeout = 50;
+    unique_transport parent_handle{esp_transport_init(), esp_transport_destroy};
+    REQUIRE(parent_handle);
+    esp_transport_set_func(parent_handle.get(), mock_connect, mock_read, mock_write, mock_close, mock_poll_read, mock_poll_write, mock_destroy);
+
+    mock_write_Stub(mock_write_capture_callback);
+    mock_destroy_ExpectAnyArgsAndReturn(ESP_OK);
+
+    char header[] = "header";
+    char payload[] = "payload";
+    struct iovec iov[] = {
+        { .iov_base = header, .iov_len = sizeof(header) - 1 },
+        { .iov_base = nullptr, .iov_len = 0 },
+        { .iov_base = payload, .iov_len = sizeof(payload) - 1 },
+    };
+
+    SECTION("The buffers are written one after the other") {
+        written_data.clear();
+        REQUIRE(esp_transport_writev(parent_handle.get(), iov, 3, timeout) == 13);
+        REQUIRE(written_data == "headerpayload");
+    }
+
+    SECTION("The writes stop at the first short one") {
+        written_data.clear();
+        mock_write_Stub([](esp_transport_handle_t t, const char *buffer, int len, int tout, int n) {
+            written_data.append(buffer, len - 1);
+            return len - 1;
+        });
+        REQUIRE(esp_transport_writev(parent_handle.get(), iov, 3, timeout) == 5);
+        REQUIRE(written_data == "heade");
+    }
+}
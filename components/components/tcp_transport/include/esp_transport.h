@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -35,6 +35,9 @@ typedef int (*poll_func)(esp_transport_handle_t t, int timeout_ms);
 typedef int (*connect_async_func)(esp_transport_handle_t t, const char *host, int port, int timeout_ms);
 typedef esp_transport_handle_t (*payload_transfer_func)(esp_transport_handle_t);
 
+struct iovec;
+typedef int (*io_writev_func)(esp_transport_handle_t t, const struct iovec *iov, int iovcnt, int timeout_ms);
+
 typedef struct esp_tls_last_error* esp_tls_error_handle_t;
 
 /**
@@ -220,6 +223,25 @@ int esp_transport_poll_read(esp_transport_handle_t t, int timeout_ms);
  */
 int esp_transport_write(esp_transport_handle_t t, const char *buffer, int len, int timeout_ms);
 
+/**
+ * @brief      Transport write function for a set of buffers
+ *
+ * Writes the buffers one after the other, like writev(). TCP sends them at once, and SSL in one TLS record
+ * when they total up to 16 KB, so that e.g. a header and its payload go out together without being
+ * copied together by the caller. Other transports write the buffers one by one with esp_transport_write(),
+ * a WebSocket transport thus sends each buffer as a frame of its own.
+ *
+ * @param      t           The transport handle
+ * @param[in]  iov         Array of buffers to write
+ * @param[in]  iovcnt      Number of buffers in the array
+ * @param[in]  timeout_ms  The timeout milliseconds (-1 indicates wait forever)
+ *
+ * @return
+ *  - Number of bytes was written, which may be less than the total length of the buffers
+ *  - (-1) if there are any errors, should check errno
+ */
+int esp_transport_writev(esp_transport_handle_t t, const struct iovec *iov, int iovcnt, int timeout_ms);
+
 /**
  * @brief      Poll the transport until writeable or timeout
  *
@@ -312,6 +334,20 @@ esp_err_t esp_transport_set_func(esp_transport_handle_t t,
  */
 esp_err_t esp_transport_set_async_connect_func(esp_transport_handle_t t, connect_async_func _connect_async_func);
 
+/**
+ * @brief      Set the function writing a set of buffers at once for the transport handle
+ *
+ * @note       esp_transport_set_func() clears it, so it has to be set after the write function.
+ *
+ * @param[in]  t        The transport handle
+ * @param[in]  _writev  The writev function pointer
+ *
+ * @return
+ *     - ESP_OK
+ *     - ESP_FAIL
+ */
+esp_err_t esp_transport_set_writev_func(esp_transport_handle_t t, io_writev_func _writev);
+
 /**
  * @brief      Set parent transport function to the handle
  *
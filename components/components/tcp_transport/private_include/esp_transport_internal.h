@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2020-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2020-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -45,6 +45,7 @@ struct esp_transport_item_t {
     connect_func    _connect;       /*!< Connect function of this transport */
     io_read_func    _read;          /*!< Read */
     io_func         _write;         /*!< Write */
+    io_writev_func  _writev;        /*!< Write a set of buffers at once */
     trans_func      _close;         /*!< Close */
     poll_func       _poll_read;     /*!< Poll and read */
     poll_func       _poll_write;    /*!< Poll and write */
@@ -93,6 +94,22 @@ struct esp_transport_item_t {
  */
 struct timeval* esp_transport_utils_ms_to_timeval(int timeout_ms, struct timeval *tv);
 
+/**
+ * @brief      Writes a set of buffers with the write function of the transport, one by one
+ *
+ *             Used by esp_transport_writev() for the transports which cannot write them at once
+ *
+ * @param[in]  t           The transport handle
+ * @param[in]  iov         Array of buffers to write
+ * @param[in]  iovcnt      Number of buffers in the array
+ * @param[in]  timeout_ms  The timeout milliseconds (-1 indicates wait forever)
+ *
+ * @return
+ * - Number of bytes written, up to the first short write
+ * - (-1) or the result of the write function, if it fails on the first buffer
+ */
+int esp_transport_writev_each(esp_transport_handle_t t, const struct iovec *iov, int iovcnt, int timeout_ms);
+
 /**
  * @brief  Initialize foundation struct
  *
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -146,6 +146,12 @@ static int socks_write(esp_transport_handle_t transport, const char *buffer, int
     return esp_transport_write(socks_transport->parent, buffer, len, timeout_ms);
 }
 
+static int socks_writev(esp_transport_handle_t transport, const struct iovec *iov, int iovcnt, int timeout_ms)
+{
+    transport_socks_t *socks_transport = esp_transport_get_context_data(transport);
+    return esp_transport_writev(socks_transport->parent, iov, iovcnt, timeout_ms);
+}
+
 static int socks_read(esp_transport_handle_t transport, char *buffer, int len, int timeout_ms)
 {
     transport_socks_t *socks_transport = esp_transport_get_context_data(transport);
@@ -208,6 +214,7 @@ esp_transport_handle_t esp_transport_socks_proxy_init(esp_transport_handle_t par
     SOCKS_ERROR_IF(socks_context == NULL, ESP_ERR_NO_MEM,  "Failed to allocate transport context");
     esp_transport_set_context_data(transport, socks_context);
     esp_transport_set_func(transport, socks_connect, socks_read, socks_write, socks_close, socks_poll_read, socks_poll_write, socks_destroy);
+    esp_transport_set_writev_func(transport, socks_writev);
 
     socks_context->parent = parent_handle;
     socks_context->proxy_address = strdup(config->address);
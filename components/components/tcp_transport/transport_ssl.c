@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -18,6 +18,11 @@
 
 #define INVALID_SOCKET (-1)
 
+/* Buffers of a vectored write totalling up to this size are gathered on the stack, larger ones on the heap */
+#define SSL_WRITEV_BUFFER_SIZE 256
+/* Buffers of a vectored write totalling up to this size are sent in one TLS record, the maximum plaintext length */
+#define SSL_WRITEV_MAX_SIZE 16384
+
 #define GET_SSL_FROM_TRANSPORT_OR_RETURN(ssl, t)         \
     transport_esp_tls_t *ssl = ssl_get_context_data(t);  \
     if (!ssl) { return; }
@@ -257,6 +262,61 @@ static int tcp_write(esp_transport_handle_t t, const char *buffer, int len, int
     return ret;
 }
 
+static int ssl_writev(esp_transport_handle_t t, const struct iovec *iov, int iovcnt, int timeout_ms)
+{
+    char stack_buffer[SSL_WRITEV_BUFFER_SIZE];
+    size_t len = 0;
+
+    for (int i = 0; i < iovcnt; i++) {
+        len += iov[i].iov_len;
+    }
+
+    // Each write of esp-tls makes at least one record, so the buffers are gathered into one write;
+    // messages larger than a record are split into records anyway, and written buffer by buffer
+    if (len > SSL_WRITEV_MAX_SIZE) {
+        return esp_transport_writev_each(t, iov, iovcnt, timeout_ms);
+    }
+    char *buffer = stack_buffer;
+    if (len > sizeof(stack_buffer)) {
+        buffer = malloc(len);
+        if (!buffer) {
+            return esp_transport_writev_each(t, iov, iovcnt, timeout_ms);
+        }
+    }
+    size_t offset = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        memcpy(buffer + offset, iov[i].iov_base, iov[i].iov_len);
+        offset += iov[i].iov_len;
+    }
+    int ret = ssl_write(t, buffer, len, timeout_ms);
+    if (buffer != stack_buffer) {
+        free(buffer);
+    }
+    return ret;
+}
+
+static int tcp_writev(esp_transport_handle_t t, const struct iovec *iov, int iovcnt, int timeout_ms)
+{
+    int poll;
+    transport_esp_tls_t *ssl = ssl_get_context_data(t);
+    ESP_STATIC_ANALYZER_CHECK(ssl == NULL, -1);
+
+    if ((poll = esp_transport_poll_write(t, timeout_ms)) <= 0) {
+        ESP_LOGW(TAG, "Poll timeout or error, errno=%s, fd=%d, timeout_ms=%d", strerror(errno), ssl->sockfd, timeout_ms);
+        return poll;
+    }
+    struct msghdr msg = {
+        .msg_iov = (struct iovec *) iov,
+        .msg_iovlen = iovcnt,
+    };
+    int ret = sendmsg(ssl->sockfd, &msg, 0);
+    if (ret < 0) {
+        ESP_LOGE(TAG, "tcp_writev error, errno=%s", strerror(errno));
+        esp_transport_capture_errno(t, errno);
+    }
+    return ret;
+}
+
 static int ssl_read(esp_transport_handle_t t, char *buffer, int len, int timeout_ms)
 {
     transport_esp_tls_t *ssl = ssl_get_context_data(t);
@@ -559,6 +619,7 @@ esp_transport_handle_t esp_transport_ssl_init(void)
     }
     ((transport_esp_tls_t *)ssl_transport->data)->cfg.is_plain_tcp = false;
     esp_transport_set_func(ssl_transport, ssl_connect, ssl_read, ssl_write, base_close, base_poll_read, base_poll_write, base_destroy);
+    esp_transport_set_writev_func(ssl_transport, ssl_writev);
     esp_transport_set_async_connect_func(ssl_transport, ssl_connect_async);
     ssl_transport->_get_socket = base_get_socket;
     return ssl_transport;
@@ -581,6 +642,7 @@ esp_transport_handle_t esp_transport_tcp_init(void)
     }
     ((transport_esp_tls_t *)tcp_transport->data)->cfg.is_plain_tcp = true;
     esp_transport_set_func(tcp_transport, tcp_connect, tcp_read, tcp_write, base_close, base_poll_read, base_poll_write, base_destroy);
+    esp_transport_set_writev_func(tcp_transport, tcp_writev);
     esp_transport_set_async_connect_func(tcp_transport, tcp_connect_async);
     tcp_transport->_get_socket = base_get_socket;
     return tcp_transport;
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -8,6 +8,7 @@
 #include <string.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <sys/param.h>
 #include <sys/random.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
@@ -18,11 +19,13 @@
 #include "esp_transport_internal.h"
 #include "errno.h"
 #include "esp_tls_crypto.h"
+#include "esp_private/websocket_mask.h"
 #include <arpa/inet.h>
 
 static const char *TAG = "transport_ws";
 
 #define WS_BUFFER_SIZE              CONFIG_WS_BUFFER_SIZE
+#define WS_MASK_BUFFER_SIZE         CONFIG_WS_MASK_BUFFER_SIZE
 #define WS_FIN                      0x80
 #define WS_OPCODE_CONT              0x00
 #define WS_OPCODE_TEXT              0x01
@@ -66,6 +69,7 @@ typedef struct {
     char *auth;
     char *buffer;             /*!< Initial HTTP connection buffer, which may include data beyond the handshake headers, such as the next WebSocket packet*/
     size_t buffer_len;        /*!< The buffer length */
+    char *mask_buffer;        /*!< Buffer the frames sent are masked into, up to WS_MASK_BUFFER_SIZE bytes of payload */
     int http_status_code;
     bool propagate_control_frames;
     ws_transport_frame_state_t frame_state;
@@ -381,13 +385,12 @@ static int ws_connect(esp_transport_handle_t t, const char *host, int port, int
     return 0;
 }
 
-static int _ws_write(esp_transport_handle_t t, int opcode, int mask_flag, const char *b, int len, int timeout_ms)
+static int _ws_write(esp_transport_handle_t t, int opcode, const char *b, int len, int timeout_ms)
 {
     transport_ws_t *ws = esp_transport_get_context_data(t);
-    char *buffer = (char *)b;
     char ws_header[MAX_WEBSOCKET_HEADER_SIZE];
     char *mask;
-    int header_len = 0, i;
+    int header_len = 0;
 
     int poll_write;
     if ((poll_write = esp_transport_poll_write(ws->parent, timeout_ms)) <= 0) {
@@ -396,14 +399,15 @@ static int _ws_write(esp_transport_handle_t t, int opcode, int mask_flag, const
     }
     ws_header[header_len++] = opcode;
 
+    // Frames sent by a client are always masked, RFC6455 Section 5.3
     if (len <= 125) {
-        ws_header[header_len++] = (uint8_t)(len | mask_flag);
+        ws_header[header_len++] = (uint8_t)(len | WS_MASK);
     } else if (len < 65536) {
-        ws_header[header_len++] = WS_SIZE16 | mask_flag;
+        ws_header[header_len++] = WS_SIZE16 | WS_MASK;
         ws_header[header_len++] = (uint8_t)(len >> 8);
         ws_header[header_len++] = (uint8_t)(len & 0xFF);
     } else {
-        ws_header[header_len++] = WS_SIZE64 | mask_flag;
+        ws_header[header_len++] = WS_SIZE64 | WS_MASK;
         /* Support maximum 4 bytes length */
         ws_header[header_len++] = 0; //(uint8_t)((len >> 56) & 0xFF);
         ws_header[header_len++] = 0; //(uint8_t)((len >> 48) & 0xFF);
@@ -415,38 +419,58 @@ static int _ws_write(esp_transport_handle_t t, int opcode, int mask_flag, const
         ws_header[header_len++] = (uint8_t)((len >> 0) & 0xFF);
     }
 
-    if (mask_flag) {
-        mask = &ws_header[header_len];
-        ssize_t rc;
-        if ((rc = getrandom(ws_header + header_len, 4, 0)) < 0) {
-            ESP_LOGD(TAG, "getrandom() returned %zd", rc);
-            return -1;
-        }
-        header_len += 4;
-
-        for (i = 0; i < len; ++i) {
-            buffer[i] = (buffer[i] ^ mask[i % 4]);
-        }
-    }
-
-    if (esp_transport_write(ws->parent, ws_header, header_len, timeout_ms) != header_len) {
-        ESP_LOGE(TAG, "Error write header");
+    mask = &ws_header[header_len];
+    ssize_t rc;
+    if ((rc = getrandom(ws_header + header_len, 4, 0)) < 0) {
+        ESP_LOGD(TAG, "getrandom() returned %zd", rc);
         return -1;
     }
-    if (len == 0) {
-        return 0;
-    }
+    header_len += 4;
 
-    int ret = esp_transport_write(ws->parent, buffer, len, timeout_ms);
-    // in case of masked transport we have to revert back to the original data, as ws layer
-    // does not create its own copy of data to be sent
-    if (mask_flag) {
-        mask = &ws_header[header_len - 4];
-        for (i = 0; i < len; ++i) {
-            buffer[i] = (buffer[i] ^ mask[i % 4]);
+    // The payload is masked into mask_buffer, leaving the caller's data untouched, and written in parts of
+    // up to WS_MASK_BUFFER_SIZE bytes, the first one along with the header in a single vectored write
+    if (!ws->mask_buffer) {
+        ws->mask_buffer = malloc(WS_MASK_BUFFER_SIZE + sizeof(size_t));
+        if (!ws->mask_buffer) {
+            ESP_LOGE(TAG, "Cannot allocate buffer for masking, need-%zu", WS_MASK_BUFFER_SIZE + sizeof(size_t));
+            return -1;
         }
     }
-    return ret;
+
+    struct iovec iov[2] = {
+        { .iov_base = ws_header, .iov_len = header_len },
+    };
+    int written = 0;
+    do {
+        // Start the part at the alignment of b within the buffer, so that it is masked a word at a time
+        const char *src = b + written;
+        char *part = ws->mask_buffer + (uintptr_t)src % sizeof(size_t);
+        int part_len = MIN(len - written, WS_MASK_BUFFER_SIZE);
+
+        websocket_mask((uint8_t *)part, (const uint8_t *)src, part_len, (const uint8_t *)mask, written);
+        iov[1].iov_base = part;
+        iov[1].iov_len = part_len;
+        int ret = header_len ? esp_transport_writev(ws->parent, iov, 2, timeout_ms)
+                  : esp_transport_write(ws->parent, part, part_len, timeout_ms);
+        if (ret < header_len) {
+            if (header_len) {
+                ESP_LOGE(TAG, "Error write header");
+            }
+            written = header_len ? -1 : ret;
+            break;
+        }
+        written += ret - header_len;
+        if (ret != header_len + part_len) {
+            break;
+        }
+        header_len = 0;
+    } while (written < len);
+
+#ifdef CONFIG_WS_DYNAMIC_BUFFER
+    free(ws->mask_buffer);
+    ws->mask_buffer = NULL;
+#endif
+    return written;
 }
 
 int esp_transport_ws_send_raw(esp_transport_handle_t t, ws_transport_opcodes_t opcode, const char *b, int len, int timeout_ms)
@@ -457,7 +481,7 @@ int esp_transport_ws_send_raw(esp_transport_handle_t t, ws_transport_opcodes_t o
         return ESP_ERR_INVALID_ARG;
     }
     ESP_LOGD(TAG, "Sending raw ws message with opcode %d", op_code);
-    return _ws_write(t, op_code, WS_MASK, b, len, timeout_ms);
+    return _ws_write(t, op_code, b, len, timeout_ms);
 }
 
 static int ws_write(esp_transport_handle_t t, const char *b, int len, int timeout_ms)
@@ -467,9 +491,9 @@ static int ws_write(esp_transport_handle_t t, const char *b, int len, int timeou
         // This behaviour could however be altered in IDF 5.0, since a separate API for sending
         // messages with user defined opcodes has been introduced.
         ESP_LOGD(TAG, "Write PING message");
-        return _ws_write(t, WS_OPCODE_PING | WS_FIN, WS_MASK, NULL, 0, timeout_ms);
+        return _ws_write(t, WS_OPCODE_PING | WS_FIN, NULL, 0, timeout_ms);
     }
-    return _ws_write(t, WS_OPCODE_BINARY | WS_FIN, WS_MASK, b, len, timeout_ms);
+    return _ws_write(t, WS_OPCODE_BINARY | WS_FIN, b, len, timeout_ms);
 }
 
 
@@ -493,11 +517,11 @@ static int ws_read_payload(esp_transport_handle_t t, char *buffer, int len, int
         ESP_LOGE(TAG, "Error read data(%d)", rlen);
         return rlen;
     }
+    // The key continues from the position of this part in the payload
+    int offset = ws->frame_state.payload_len - ws->frame_state.bytes_remaining;
     ws->frame_state.bytes_remaining -= rlen;
 
-    for (int i = 0; i < bytes_to_read; i++) {
-        buffer[i] = (buffer[i] ^ ws->frame_state.mask_key[i % 4]);
-    }
+    websocket_mask((uint8_t *)buffer, (const uint8_t *)buffer, rlen, (const uint8_t *)ws->frame_state.mask_key, offset);
     return rlen;
 }
 
@@ -713,6 +737,7 @@ static esp_err_t ws_destroy(esp_transport_handle_t t)
 {
     transport_ws_t *ws = esp_transport_get_context_data(t);
     free(ws->buffer);
+    free(ws->mask_buffer);
     free(ws->path);
     free(ws->sub_protocol);
     free(ws->user_agent);
@@ -1007,7 +1032,7 @@ static int esp_transport_ws_handle_control_frames(esp_transport_handle_t t, char
 
     if (ws->frame_state.opcode == WS_OPCODE_PING) {
         // handle PING frames internally: just send a PONG with the same payload
-        actual_len = _ws_write(t, WS_OPCODE_PONG | WS_FIN, WS_MASK, buffer,
+        actual_len = _ws_write(t, WS_OPCODE_PONG | WS_FIN, buffer,
                             payload_len, timeout_ms);
         if (actual_len != payload_len) {
             ESP_LOGE(TAG, "PONG send failed (payload_len=%d, written_len=%d)", payload_len, actual_len);
@@ -1028,7 +1053,7 @@ static int esp_transport_ws_handle_control_frames(esp_transport_handle_t t, char
 
         if (client_closed == false) {
             // Only echo the closing frame if not initiated by the client
-            if (_ws_write(t, WS_OPCODE_CLOSE | WS_FIN, WS_MASK, NULL, 0, timeout_ms) < 0) {
+            if (_ws_write(t, WS_OPCODE_CLOSE | WS_FIN, NULL, 0, timeout_ms) < 0) {
                 ESP_LOGE(TAG, "Sending CLOSE frame with 0 payload failed");
                 return -1;
             }